@@ -27,6 +27,17 @@ def register_scons_options(env, is_extension):
     Help(env_vars.GenerateHelpText(env))
 
 
+# Tells if a source file contains voxel graph code, or math and noise code graphs run.
+# GCC and Clang may fuse multiplications and additions into FMA instructions where the target has them, which changes
+# rounding. The deterministic mode of voxel graphs relies on results being the same on every platform, so these files
+# are compiled with `-ffp-contract=off`. MSVC doesn't do this with its default `/fp:precise` model.
+def is_deterministic_float_source(path):
+    path = path.replace("\\", "/")
+    return (path.startswith("generators/graph/")
+        or path.startswith("util/math/")
+        or path.startswith("util/noise/fast_noise_lite/"))
+
+
 # Gets sources and configurations that are common to compiling as a module and an extension.
 # For module-specific configuration, see `SCsub`.
 # For extension-specific configuration, see `SConstruct`.
@@ -150,6 +161,7 @@ def get_sources(env, is_editor_build):
         # Thirdparty
 
         "thirdparty/lz4/*.c",
+        "thirdparty/meshoptimizer/*.cpp",
         # "thirdparty/sqlite/*.c",
     ]
 
@@ -194,10 +206,12 @@ def get_sources(env, is_editor_build):
             "tests/voxel/test_region_file.cpp",
             "tests/voxel/test_storage_funcs.cpp",
             "tests/voxel/test_util.cpp",
+            "tests/voxel/test_voxel_archive.cpp",
             "tests/voxel/test_voxel_buffer.cpp",
             "tests/voxel/test_voxel_data_map.cpp",
             "tests/voxel/test_voxel_graph.cpp",
             "tests/voxel/test_voxel_instancer.cpp",
+            "tests/voxel/test_voxel_mesher_blocky.cpp",
             "tests/voxel/test_voxel_mesher_cubes.cpp",
         ]
 
@@ -209,10 +223,11 @@ def get_sources(env, is_editor_build):
             
             "engine/detail_rendering/detail_rendering.cpp",
             "engine/detail_rendering/render_detail_texture_task.cpp",
-
-            "thirdparty/meshoptimizer/*.cpp"
         ]
 
+        if tests_enabled:
+            sources += ["tests/voxel/test_voxel_mesher_transvoxel.cpp"]
+
         if gpu_enabled:
             sources += ["engine/detail_rendering/render_detail_texture_gpu_task.cpp"]
 
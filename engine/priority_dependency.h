@@ -19,6 +19,8 @@ struct PriorityDependency {
 		// This vector is never resized after the instance is created. It is just big enough to have room for all
 		// viewers.
 		StdVector<Vector3f> viewers;
+		// Velocity of each viewer, in the same order as `viewers`. Has the same size as `viewers`.
+		StdVector<Vector3f> viewer_velocities;
 		// Use this count instead of `viewers.size()`. Can change, but will always be <= `viewers.size()`
 		std::atomic_uint32_t viewers_count;
 		float highest_view_distance = 999999;
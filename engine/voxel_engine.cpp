@@ -10,6 +10,7 @@
 #include "../util/godot/classes/rd_sampler_state.h"
 #include "../util/godot/classes/rendering_device.h"
 #include "../util/godot/classes/rendering_server.h"
+#include "../util/godot/classes/time.h"
 #include "../util/io/log.h"
 #include "../util/macros.h"
 #include "../util/math/conv.h"
@@ -65,6 +66,7 @@ VoxelEngine::VoxelEngine(Config config) {
 	_world.shared_priority_dependency = make_shared_instance<PriorityDependency::ViewersData>();
 	// Give initial capacity to make invalidation less likely
 	_world.shared_priority_dependency->viewers.resize(64);
+	_world.shared_priority_dependency->viewer_velocities.resize(64);
 
 	ZN_PRINT_VERBOSE(format("Size of LoadBlockDataTask: {}", sizeof(LoadBlockDataTask)));
 	ZN_PRINT_VERBOSE(format("Size of SaveBlockDataTask: {}", sizeof(SaveBlockDataTask)));
@@ -345,14 +347,41 @@ void VoxelEngine::sync_viewers_task_priority_data() {
 		// TODO We can avoid the invalidation by using an atomic size or memory barrier?
 		_world.shared_priority_dependency = make_shared_instance<PriorityDependency::ViewersData>();
 		_world.shared_priority_dependency->viewers.resize(viewer_count);
+		_world.shared_priority_dependency->viewer_velocities.resize(viewer_count);
 	}
 
 	PriorityDependency::ViewersData &dep = *_world.shared_priority_dependency;
 
+	const uint64_t now_usec = Time::get_singleton()->get_ticks_usec();
+	const float delta_time = _world.last_viewers_sync_time_usec == 0
+			? 0.f
+			: static_cast<float>(now_usec - _world.last_viewers_sync_time_usec) / 1'000'000.f;
+	_world.last_viewers_sync_time_usec = now_usec;
+
 	size_t i = 0;
 	unsigned int max_distance = 0;
-	_world.viewers.for_each_value([&i, &max_distance, &dep](Viewer &viewer) {
+	_world.viewers.for_each_value([&i, &max_distance, &dep, delta_time](Viewer &viewer) {
+		if (!viewer.has_previous_world_position) {
+			// First sync of this viewer, there is no motion to measure yet
+			viewer.world_velocity = Vector3();
+			viewer.previous_world_position = viewer.world_position;
+			viewer.has_previous_world_position = true;
+
+		} else if (delta_time > 0.f) {
+			const Vector3 motion = viewer.world_position - viewer.previous_world_position;
+			// Both are in world units: view distances only get converted into voxels by each volume
+			const real_t teleport_distance = static_cast<real_t>(viewer.view_distances.max());
+			if (motion.length_squared() > math::squared(teleport_distance)) {
+				// Moving further than view distance in a single frame is a teleport, not something we can anticipate
+				viewer.world_velocity = Vector3();
+			} else {
+				// Smooth out a bit, frame times and positions can be jittery
+				viewer.world_velocity = viewer.world_velocity.lerp(motion / delta_time, 0.5f);
+			}
+			viewer.previous_world_position = viewer.world_position;
+		}
 		dep.viewers[i] = to_vec3f(viewer.world_position);
+		dep.viewer_velocities[i] = to_vec3f(viewer.world_velocity);
 		max_distance = math::max(max_distance, viewer.view_distances.max());
 		++i;
 	});
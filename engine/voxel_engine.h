@@ -65,6 +65,10 @@ public:
 		bool has_mesh_resource;
 		// Tells if the meshing task was required to build a rendering mesh if possible.
 		bool visual_was_required;
+		// Copied from the task that produced this output
+		uint32_t meshing_version = 0;
+		// Transition sides the mesh was built with. Copied from the task that produced this output.
+		uint8_t transition_mask = 0b111111;
 #ifdef VOXEL_ENABLE_SMOOTH_MESHING
 		// Can be null. Attached to meshing output so it is tracked more easily, because it is baked asynchronously
 		// starting from the mesh task, and it might complete earlier or later than the mesh.
@@ -124,6 +128,7 @@ public:
 	};
 
 	struct Viewer {
+		// In world units. Volumes convert them into voxels using their own scale.
 		struct Distances {
 			unsigned int horizontal = 128;
 			unsigned int vertical = 128;
@@ -139,6 +144,12 @@ public:
 		// 	FLAGS_COUNT = 3
 		// };
 		Vector3 world_position;
+		// Estimated from positions across frames. Used to anticipate which blocks will be needed soon.
+		Vector3 world_velocity;
+		// Position the viewer had when velocity was last estimated
+		Vector3 previous_world_position;
+		// False until the viewer went through its first sync, so it doesn't get a velocity from an arbitrary position
+		bool has_previous_world_position = false;
 		Distances view_distances;
 		bool require_collisions = true;
 		bool require_visuals = true;
@@ -212,6 +223,11 @@ public:
 
 	void push_main_thread_progressive_task(IProgressiveTask *task);
 
+	// Gets how many threads run tasks pushed with `push_async_task`
+	unsigned int get_thread_count() const {
+		return _general_thread_pool.get_thread_count();
+	}
+
 	// Thread-safe.
 	void push_async_task(IThreadedTask *task);
 	// Thread-safe.
@@ -331,6 +347,8 @@ private:
 	struct World {
 		SlotMap<Volume, uint16_t, uint16_t> volumes;
 		SlotMap<Viewer, uint16_t, uint16_t> viewers;
+		// Time at which viewers were last synced, used to estimate their velocity
+		uint64_t last_viewers_sync_time_usec = 0;
 
 		// Must be overwritten with a new instance if count changes.
 		std::shared_ptr<PriorityDependency::ViewersData> shared_priority_dependency;
@@ -82,6 +82,9 @@ struct NodeType {
 	bool debug_only = false;
 	// Pseudo nodes are replaced during compilation with one or multiple real nodes, they have no logic on their own
 	bool is_pseudo_node = false;
+	// Elementwise nodes compute each output value only from input values at the same index, reading them before
+	// writing. Their outputs may then re-use the data of their inputs, and they may run on sub-ranges of buffers.
+	bool is_elementwise = false;
 	Category category;
 	StdVector<Port> inputs;
 	StdVector<Port> outputs;
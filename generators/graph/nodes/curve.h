@@ -69,6 +69,9 @@ void register_curve_node(Span<NodeType> types) {
 		};
 #ifdef VOXEL_ENABLE_GPU
 		t.shader_gen_func = [](ShaderGenContext &ctx) {
+			if (!ctx.require_glsl()) {
+				return;
+			}
 			Ref<Curve> curve = ctx.get_param(0);
 			if (curve.is_null()) {
 				ctx.make_error(String(ZN_TTR("{0} instance is null")).format(varray(Curve::get_class_static())));
@@ -1,5 +1,6 @@
 #include "../../../constants/voxel_constants.h"
 #include "../../../util/godot/classes/image.h"
+#include "../../../util/math/deterministic_funcs.h"
 #include "../../../util/profiling.h"
 #include "../image_range_grid.h"
 #include "../node_type_db.h"
@@ -47,7 +48,8 @@ inline float sdf_sphere_heightmap(
 		float min_h,
 		float max_h,
 		float norm_x,
-		float norm_y
+		float norm_y,
+		bool deterministic
 ) {
 	const float d = Math::sqrt(x * x + y * y + z * z) + 0.0001f;
 	const float sd = d - r;
@@ -62,7 +64,8 @@ inline float sdf_sphere_heightmap(
 	const float nz = z / d;
 	// TODO Could use fast atan2, it doesn't have to be precise
 	// https://github.com/ducha-aiki/fast_atan2/blob/master/fast_atan.cpp
-	const float uvx = -Math::atan2(nz, nx) * zylann::math::INV_TAU<float> + 0.5f;
+	const float angle = deterministic ? math::deterministic_atan2(nz, nx) : Math::atan2(nz, nx);
+	const float uvx = -angle * zylann::math::INV_TAU<float> + 0.5f;
 	// This is an approximation of asin(ny)/(PI/2)
 	// TODO It may be desirable to use the real function though,
 	// in cases where we want to combine the same map in shaders
@@ -259,6 +262,7 @@ void register_image_nodes(Span<NodeType> types) {
 			// TODO Allow to use bilinear filtering?
 			const Params p = ctx.get_params<Params>();
 			const Image &im = *p.image;
+			const bool deterministic = ctx.is_deterministic();
 			for (uint32_t i = 0; i < out.size; ++i) {
 				out.data[i] = sdf_sphere_heightmap(
 						x.data[i],
@@ -270,7 +274,8 @@ void register_image_nodes(Span<NodeType> types) {
 						p.min_height,
 						p.max_height,
 						p.norm_x,
-						p.norm_y
+						p.norm_y,
+						deterministic
 				);
 			}
 		};
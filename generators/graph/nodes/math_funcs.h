@@ -1,9 +1,42 @@
+#include "../../../util/math/deterministic_funcs.h"
 #include "../node_type_db.h"
 #include "../voxel_graph_runtime.h"
 #include "util.h"
 
 namespace zylann::voxel::pg {
 
+// Range analysis variants used in deterministic mode. Values coming out of them can end up in generated voxels (when
+// a region is found uniform), so they must use the same functions as processing.
+
+inline math::Interval deterministic_sin(const math::Interval &x) {
+	if (x.is_single_value()) {
+		return math::Interval::from_single_value(math::deterministic_sin(x.min));
+	}
+	return math::Interval(-1, 1);
+}
+
+inline math::Interval deterministic_pow(const math::Interval &x, const math::Interval &p) {
+	if (p.is_single_value()) {
+		if (x.is_single_value()) {
+			return math::Interval::from_single_value(math::deterministic_pow(x.min, p.min));
+		}
+		// Same as `math::powi`, only the case of exact positive integer powers is handled
+		const int pi = p.min;
+		if (pi >= 0 && static_cast<float>(pi) == p.min) {
+			const float v0 = math::deterministic_pow(x.min, p.min);
+			const float v1 = math::deterministic_pow(x.max, p.min);
+			if (pi % 2 == 1) {
+				return math::Interval(v0, v1);
+			}
+			if (x.min < 0 && x.max > 0) {
+				return math::Interval(0, math::max(v0, v1));
+			}
+			return x.max <= 0 ? math::Interval(v1, v0) : math::Interval(v0, v1);
+		}
+	}
+	return math::Interval::from_infinity();
+}
+
 void register_math_func_nodes(Span<NodeType> types) {
 	typedef Runtime::ProcessBufferContext ProcessBufferContext;
 	typedef Runtime::RangeAnalysisContext RangeAnalysisContext;
@@ -14,14 +47,23 @@ void register_math_func_nodes(Span<NodeType> types) {
 		NodeType &t = types[VoxelGraphFunction::NODE_SIN];
 		t.name = "Sin";
 		t.category = CATEGORY_MATH;
+		t.is_elementwise = true;
 		t.inputs.push_back(NodeType::Port("x", 0.f, VoxelGraphFunction::AUTO_CONNECT_NONE, false));
 		t.outputs.push_back(NodeType::Port("out"));
-		t.process_buffer_func = [](ProcessBufferContext &ctx) { //
-			do_monop(ctx, [](float a) { return Math::sin(a); });
+		t.process_buffer_func = [](ProcessBufferContext &ctx) {
+			if (ctx.is_deterministic()) {
+				do_monop(ctx, [](float a) { return math::deterministic_sin(a); });
+			} else {
+				do_monop(ctx, [](float a) { return Math::sin(a); });
+			}
 		};
 		t.range_analysis_func = [](RangeAnalysisContext &ctx) {
 			const Interval a = ctx.get_input(0);
-			ctx.set_output(0, sin(a));
+			if (ctx.is_deterministic()) {
+				ctx.set_output(0, pg::deterministic_sin(a));
+			} else {
+				ctx.set_output(0, sin(a));
+			}
 		};
 		t.expression_func_name = "sin";
 		t.expression_func = [](Span<const float> args) { //
@@ -35,6 +77,7 @@ void register_math_func_nodes(Span<NodeType> types) {
 		NodeType &t = types[VoxelGraphFunction::NODE_FLOOR];
 		t.name = "Floor";
 		t.category = CATEGORY_MATH;
+		t.is_elementwise = true;
 		t.inputs.push_back(NodeType::Port("x", 0.f, VoxelGraphFunction::AUTO_CONNECT_NONE, false));
 		t.outputs.push_back(NodeType::Port("out"));
 		t.process_buffer_func = [](ProcessBufferContext &ctx) {
@@ -56,10 +99,11 @@ void register_math_func_nodes(Span<NodeType> types) {
 		NodeType &t = types[VoxelGraphFunction::NODE_ABS];
 		t.name = "Abs";
 		t.category = CATEGORY_MATH;
+		t.is_elementwise = true;
 		t.inputs.push_back(NodeType::Port("x", 0.f, VoxelGraphFunction::AUTO_CONNECT_NONE, false));
 		t.outputs.push_back(NodeType::Port("out"));
 		t.process_buffer_func = [](ProcessBufferContext &ctx) { //
-			do_monop(ctx, [](float a) { return Math::abs(a); });
+			do_monop_simd(ctx, [](auto a) { return simd::abs(a); });
 		};
 		t.range_analysis_func = [](RangeAnalysisContext &ctx) {
 			const Interval a = ctx.get_input(0);
@@ -77,10 +121,13 @@ void register_math_func_nodes(Span<NodeType> types) {
 		NodeType &t = types[VoxelGraphFunction::NODE_SQRT];
 		t.name = "Sqrt";
 		t.category = CATEGORY_MATH;
+		t.is_elementwise = true;
 		t.inputs.push_back(NodeType::Port("x", 0.f, VoxelGraphFunction::AUTO_CONNECT_NONE, false));
 		t.outputs.push_back(NodeType::Port("out"));
 		t.process_buffer_func = [](ProcessBufferContext &ctx) { //
-			do_monop(ctx, [](float a) { return Math::sqrt(math::max(a, 0.f)); });
+			do_monop_simd(ctx, [](auto a) { //
+				return simd::sqrt(simd::max(a, simd::splat<decltype(a)>(0.f)));
+			});
 		};
 		t.range_analysis_func = [](RangeAnalysisContext &ctx) {
 			const Interval a = ctx.get_input(0);
@@ -98,6 +145,7 @@ void register_math_func_nodes(Span<NodeType> types) {
 		NodeType &t = types[VoxelGraphFunction::NODE_FRACT];
 		t.name = "Fract";
 		t.category = CATEGORY_MATH;
+		t.is_elementwise = true;
 		t.inputs.push_back(NodeType::Port("x", 0.f, VoxelGraphFunction::AUTO_CONNECT_NONE, false));
 		t.outputs.push_back(NodeType::Port("out"));
 		t.process_buffer_func = [](ProcessBufferContext &ctx) {
@@ -119,6 +167,7 @@ void register_math_func_nodes(Span<NodeType> types) {
 		NodeType &t = types[VoxelGraphFunction::NODE_STEPIFY];
 		t.name = "Stepify";
 		t.category = CATEGORY_CONVERT;
+		t.is_elementwise = true;
 		t.inputs.push_back(NodeType::Port("x", 0.f, VoxelGraphFunction::AUTO_CONNECT_NONE, false));
 		t.inputs.push_back(NodeType::Port("step", 1.f, VoxelGraphFunction::AUTO_CONNECT_NONE, false));
 		t.outputs.push_back(NodeType::Port("out"));
@@ -138,7 +187,7 @@ void register_math_func_nodes(Span<NodeType> types) {
 			ctx.require_lib_code(
 					"stepify",
 					"float vg_stepify(float value, float step) {\n"
-					"	return floor(p_value / step + 0.5f) * step;\n"
+					"	return floor(value / step + 0.5) * step;\n"
 					"}\n"
 			);
 			ctx.add_format(
@@ -150,6 +199,7 @@ void register_math_func_nodes(Span<NodeType> types) {
 		NodeType &t = types[VoxelGraphFunction::NODE_WRAP];
 		t.name = "Wrap";
 		t.category = CATEGORY_MATH;
+		t.is_elementwise = true;
 		t.inputs.push_back(NodeType::Port("x", 0.f, VoxelGraphFunction::AUTO_CONNECT_NONE, false));
 		t.inputs.push_back(NodeType::Port("length", 1.f, VoxelGraphFunction::AUTO_CONNECT_NONE, false));
 		t.outputs.push_back(NodeType::Port("out"));
@@ -181,11 +231,12 @@ void register_math_func_nodes(Span<NodeType> types) {
 		NodeType &t = types[VoxelGraphFunction::NODE_MIN];
 		t.name = "Min";
 		t.category = CATEGORY_MATH;
+		t.is_elementwise = true;
 		t.inputs.push_back(NodeType::Port("a", 0.f, VoxelGraphFunction::AUTO_CONNECT_NONE, false));
 		t.inputs.push_back(NodeType::Port("b", 0.f, VoxelGraphFunction::AUTO_CONNECT_NONE, false));
 		t.outputs.push_back(NodeType::Port("out"));
 		t.process_buffer_func = [](ProcessBufferContext &ctx) {
-			do_binop(ctx, [](float a, float b) { return min(a, b); });
+			do_binop_simd(ctx, [](auto a, auto b) { return simd::min(a, b); });
 		};
 		t.range_analysis_func = [](RangeAnalysisContext &ctx) {
 			const Interval a = ctx.get_input(0);
@@ -204,11 +255,12 @@ void register_math_func_nodes(Span<NodeType> types) {
 		NodeType &t = types[VoxelGraphFunction::NODE_MAX];
 		t.name = "Max";
 		t.category = CATEGORY_MATH;
+		t.is_elementwise = true;
 		t.inputs.push_back(NodeType::Port("a", 0.f, VoxelGraphFunction::AUTO_CONNECT_NONE, false));
 		t.inputs.push_back(NodeType::Port("b", 0.f, VoxelGraphFunction::AUTO_CONNECT_NONE, false));
 		t.outputs.push_back(NodeType::Port("out"));
 		t.process_buffer_func = [](ProcessBufferContext &ctx) {
-			do_binop(ctx, [](float a, float b) { return max(a, b); });
+			do_binop_simd(ctx, [](auto a, auto b) { return simd::max(a, b); });
 		};
 		t.range_analysis_func = [](RangeAnalysisContext &ctx) {
 			const Interval a = ctx.get_input(0);
@@ -227,6 +279,7 @@ void register_math_func_nodes(Span<NodeType> types) {
 		NodeType &t = types[VoxelGraphFunction::NODE_CLAMP];
 		t.name = "Clamp";
 		t.category = CATEGORY_CONVERT;
+		t.is_elementwise = true;
 		t.inputs.push_back(NodeType::Port("x"));
 		t.inputs.push_back(NodeType::Port("min", -1.f));
 		t.inputs.push_back(NodeType::Port("max", 1.f));
@@ -236,9 +289,13 @@ void register_math_func_nodes(Span<NodeType> types) {
 			const Runtime::Buffer &minv = ctx.get_input(1);
 			const Runtime::Buffer &maxv = ctx.get_input(2);
 			Runtime::Buffer &out = ctx.get_output(0);
-			for (uint32_t i = 0; i < out.size; ++i) {
-				out.data[i] = clamp(a.data[i], minv.data[i], maxv.data[i]);
-			}
+			simd::for_each(out.size, [&a, &minv, &maxv, &out](uint32_t i, auto tag) {
+				using T = decltype(tag);
+				const T v = simd::load_as<T>(a.data + i);
+				const T vmin = simd::load_as<T>(minv.data + i);
+				const T vmax = simd::load_as<T>(maxv.data + i);
+				simd::store(out.data + i, simd::clamp(v, vmin, vmax));
+			});
 		};
 		t.range_analysis_func = [](RangeAnalysisContext &ctx) {
 			const Interval a = ctx.get_input(0);
@@ -268,6 +325,7 @@ void register_math_func_nodes(Span<NodeType> types) {
 		NodeType &t = types[VoxelGraphFunction::NODE_CLAMP_C];
 		t.name = "ClampC";
 		t.category = CATEGORY_CONVERT;
+		t.is_elementwise = true;
 		t.inputs.push_back(NodeType::Port("x"));
 		t.outputs.push_back(NodeType::Port("out"));
 		t.params.push_back(NodeType::Param("min", Variant::FLOAT, -1.f));
@@ -279,12 +337,11 @@ void register_math_func_nodes(Span<NodeType> types) {
 			ctx.set_params(p);
 		};
 		t.process_buffer_func = [](ProcessBufferContext &ctx) {
-			const Runtime::Buffer &a = ctx.get_input(0);
-			Runtime::Buffer &out = ctx.get_output(0);
 			const Params p = ctx.get_params<Params>();
-			for (uint32_t i = 0; i < out.size; ++i) {
-				out.data[i] = clamp(a.data[i], p.min, p.max);
-			}
+			do_monop_simd(ctx, [p](auto a) { //
+				using T = decltype(a);
+				return simd::clamp(a, simd::splat<T>(p.min), simd::splat<T>(p.max));
+			});
 		};
 		t.range_analysis_func = [](RangeAnalysisContext &ctx) {
 			const Interval a = ctx.get_input(0);
@@ -307,6 +364,7 @@ void register_math_func_nodes(Span<NodeType> types) {
 		NodeType &t = types[VoxelGraphFunction::NODE_MIX];
 		t.name = "Mix";
 		t.category = CATEGORY_CONVERT;
+		t.is_elementwise = true;
 		t.inputs.push_back(NodeType::Port("a"));
 		t.inputs.push_back(NodeType::Port("b"));
 		t.inputs.push_back(NodeType::Port("ratio"));
@@ -324,18 +382,23 @@ void register_math_func_nodes(Span<NodeType> types) {
 				const float ca = a.constant_value;
 				if (b.is_constant) {
 					const float cb = b.constant_value;
-					for (uint32_t i = 0; i < buffer_size; ++i) {
-						out.data[i] = Math::lerp(ca, cb, r.data[i]);
-					}
+					simd::for_each(buffer_size, [ca, cb, &r, &out](uint32_t i, auto tag) {
+						using T = decltype(tag);
+						const T ratio = simd::load_as<T>(r.data + i);
+						simd::store(out.data + i, simd::lerp(simd::splat<T>(ca), simd::splat<T>(cb), ratio));
+					});
 				} else {
 					if (b_ignored) {
 						for (uint32_t i = 0; i < buffer_size; ++i) {
 							out.data[i] = ca;
 						}
 					} else {
-						for (uint32_t i = 0; i < buffer_size; ++i) {
-							out.data[i] = Math::lerp(ca, b.data[i], r.data[i]);
-						}
+						simd::for_each(buffer_size, [ca, &b, &r, &out](uint32_t i, auto tag) {
+							using T = decltype(tag);
+							const T ratio = simd::load_as<T>(r.data + i);
+							const T vb = simd::load_as<T>(b.data + i);
+							simd::store(out.data + i, simd::lerp(simd::splat<T>(ca), vb, ratio));
+						});
 					}
 				}
 			} else if (b.is_constant) {
@@ -345,9 +408,11 @@ void register_math_func_nodes(Span<NodeType> types) {
 						out.data[i] = cb;
 					}
 				} else {
-					for (uint32_t i = 0; i < buffer_size; ++i) {
-						out.data[i] = Math::lerp(a.data[i], cb, r.data[i]);
-					}
+					simd::for_each(buffer_size, [cb, &a, &r, &out](uint32_t i, auto tag) {
+						using T = decltype(tag);
+						const T ratio = simd::load_as<T>(r.data + i);
+						simd::store(out.data + i, simd::lerp(simd::load_as<T>(a.data + i), simd::splat<T>(cb), ratio));
+					});
 				}
 			} else {
 				if (a_ignored) {
@@ -359,9 +424,13 @@ void register_math_func_nodes(Span<NodeType> types) {
 						out.data[i] = a.data[i];
 					}
 				} else {
-					for (uint32_t i = 0; i < buffer_size; ++i) {
-						out.data[i] = Math::lerp(a.data[i], b.data[i], r.data[i]);
-					}
+					simd::for_each(buffer_size, [&a, &b, &r, &out](uint32_t i, auto tag) {
+						using T = decltype(tag);
+						const T ratio = simd::load_as<T>(r.data + i);
+						const T va = simd::load_as<T>(a.data + i);
+						const T vb = simd::load_as<T>(b.data + i);
+						simd::store(out.data + i, simd::lerp(va, vb, ratio));
+					});
 				}
 			}
 		};
@@ -411,6 +480,7 @@ void register_math_func_nodes(Span<NodeType> types) {
 		NodeType &t = types[VoxelGraphFunction::NODE_REMAP];
 		t.name = "Remap";
 		t.category = CATEGORY_CONVERT;
+		t.is_elementwise = true;
 		t.inputs.push_back(NodeType::Port("x"));
 		t.outputs.push_back(NodeType::Port("out"));
 		t.params.push_back(NodeType::Param("min0", Variant::FLOAT, -1.f));
@@ -425,12 +495,10 @@ void register_math_func_nodes(Span<NodeType> types) {
 			ctx.set_params(Params::from_intervals(min0, max0, min1, max1));
 		};
 		t.process_buffer_func = [](ProcessBufferContext &ctx) {
-			const Runtime::Buffer &x = ctx.get_input(0);
-			Runtime::Buffer &out = ctx.get_output(0);
 			const Params p = ctx.get_params<Params>();
-			for (uint32_t i = 0; i < out.size; ++i) {
-				out.data[i] = p.a * x.data[i] + p.b;
-			}
+			do_monop_simd(ctx, [p](auto x) { //
+				return x * p.a + p.b;
+			});
 		};
 		t.range_analysis_func = [](RangeAnalysisContext &ctx) {
 			const Interval x = ctx.get_input(0);
@@ -452,6 +520,7 @@ void register_math_func_nodes(Span<NodeType> types) {
 		NodeType &t = types[VoxelGraphFunction::NODE_SMOOTHSTEP];
 		t.name = "Smoothstep";
 		t.category = CATEGORY_CONVERT;
+		t.is_elementwise = true;
 		t.inputs.push_back(NodeType::Port("x"));
 		t.outputs.push_back(NodeType::Port("out"));
 		t.params.push_back(NodeType::Param("edge0", Variant::FLOAT, 0.f));
@@ -493,6 +562,7 @@ void register_math_func_nodes(Span<NodeType> types) {
 		NodeType &t = types[VoxelGraphFunction::NODE_POWI];
 		t.name = "Powi";
 		t.category = CATEGORY_MATH;
+		t.is_elementwise = true;
 		t.inputs.push_back(NodeType::Port("x"));
 		t.params.push_back(NodeType::Param("power", Variant::INT, 2));
 		t.outputs.push_back(NodeType::Port("out"));
@@ -556,6 +626,7 @@ void register_math_func_nodes(Span<NodeType> types) {
 		NodeType &t = types[VoxelGraphFunction::NODE_POW];
 		t.name = "Pow";
 		t.category = CATEGORY_MATH;
+		t.is_elementwise = true;
 		t.inputs.push_back(NodeType::Port("x"));
 		t.inputs.push_back(NodeType::Port("p", 2.f));
 		t.outputs.push_back(NodeType::Port("out"));
@@ -564,15 +635,25 @@ void register_math_func_nodes(Span<NodeType> types) {
 			const Runtime::Buffer &x = ctx.get_input(0);
 			const Runtime::Buffer &p = ctx.get_input(1);
 			Runtime::Buffer &out = ctx.get_output(0);
-			for (unsigned int i = 0; i < out.size; ++i) {
-				out.data[i] = Math::pow(x.data[i], p.data[i]);
+			if (ctx.is_deterministic()) {
+				for (unsigned int i = 0; i < out.size; ++i) {
+					out.data[i] = math::deterministic_pow(x.data[i], p.data[i]);
+				}
+			} else {
+				for (unsigned int i = 0; i < out.size; ++i) {
+					out.data[i] = Math::pow(x.data[i], p.data[i]);
+				}
 			}
 		};
 
 		t.range_analysis_func = [](RangeAnalysisContext &ctx) {
 			const Interval x = ctx.get_input(0);
 			const Interval y = ctx.get_input(1);
-			ctx.set_output(0, pow(x, y));
+			if (ctx.is_deterministic()) {
+				ctx.set_output(0, pg::deterministic_pow(x, y));
+			} else {
+				ctx.set_output(0, pow(x, y));
+			}
 		};
 
 		t.shader_gen_func = [](ShaderGenContext &ctx) {
@@ -15,9 +15,12 @@ void do_division(Runtime::ProcessBufferContext &ctx) {
 		if (!b.is_constant) {
 			const float c = a.constant_value;
 			const float *v = b.data;
-			for (uint32_t i = 0; i < buffer_size; ++i) {
-				out.data[i] = v[i] == 0.f ? 0.f : c / v[i];
-			}
+			simd::for_each(buffer_size, ctx.is_deterministic(), [c, v, &out](uint32_t i, auto tag) {
+				using T = decltype(tag);
+				const T d = simd::load_as<T>(v + i);
+				const T zero = simd::splat<T>(0.f);
+				simd::store(out.data + i, simd::select(simd::equal_mask(d, zero), zero, simd::splat<T>(c) / d));
+			});
 
 		} else if (!a.is_constant) {
 			if (b.constant_value == 0.f) {
@@ -27,9 +30,10 @@ void do_division(Runtime::ProcessBufferContext &ctx) {
 			} else {
 				const float c = 1.f / b.constant_value;
 				const float *v = a.data;
-				for (uint32_t i = 0; i < buffer_size; ++i) {
-					out.data[i] = v[i] * c;
-				}
+				simd::for_each(buffer_size, [c, v, &out](uint32_t i, auto tag) {
+					using T = decltype(tag);
+					simd::store(out.data + i, simd::load_as<T>(v + i) * simd::splat<T>(c));
+				});
 			}
 		} else {
 			// Normally this case should have been optimized out at compile-time
@@ -40,13 +44,14 @@ void do_division(Runtime::ProcessBufferContext &ctx) {
 		}
 
 	} else {
-		for (uint32_t i = 0; i < buffer_size; ++i) {
-			if (b.data[i] == 0.f) {
-				out.data[i] = 0.f;
-			} else {
-				out.data[i] = a.data[i] / b.data[i];
-			}
-		}
+		simd::for_each(buffer_size, ctx.is_deterministic(), [&a, &b, &out](uint32_t i, auto tag) {
+			using T = decltype(tag);
+			const T d = simd::load_as<T>(b.data + i);
+			const T zero = simd::splat<T>(0.f);
+			// Lanes dividing by zero are discarded
+			const T q = simd::load_as<T>(a.data + i) / d;
+			simd::store(out.data + i, simd::select(simd::equal_mask(d, zero), zero, q));
+		});
 	}
 }
 
@@ -57,12 +62,13 @@ void register_math_ops_nodes(Span<NodeType> types) {
 		NodeType &t = types[VoxelGraphFunction::NODE_ADD];
 		t.name = "Add";
 		t.category = CATEGORY_MATH;
+		t.is_elementwise = true;
 		t.inputs.push_back(NodeType::Port("a", 0.f, VoxelGraphFunction::AUTO_CONNECT_NONE, false));
 		t.inputs.push_back(NodeType::Port("b", 0.f, VoxelGraphFunction::AUTO_CONNECT_NONE, false));
 		t.outputs.push_back(NodeType::Port("out"));
 		t.compile_func = nullptr;
 		t.process_buffer_func = [](Runtime::ProcessBufferContext &ctx) {
-			do_binop(ctx, [](float a, float b) { return a + b; });
+			do_binop_simd(ctx, [](auto a, auto b) { return a + b; });
 		};
 		t.range_analysis_func = [](Runtime::RangeAnalysisContext &ctx) {
 			const Interval a = ctx.get_input(0);
@@ -77,11 +83,12 @@ void register_math_ops_nodes(Span<NodeType> types) {
 		NodeType &t = types[VoxelGraphFunction::NODE_SUBTRACT];
 		t.name = "Subtract";
 		t.category = CATEGORY_MATH;
+		t.is_elementwise = true;
 		t.inputs.push_back(NodeType::Port("a", 0.f, VoxelGraphFunction::AUTO_CONNECT_NONE, false));
 		t.inputs.push_back(NodeType::Port("b", 0.f, VoxelGraphFunction::AUTO_CONNECT_NONE, false));
 		t.outputs.push_back(NodeType::Port("out"));
 		t.process_buffer_func = [](Runtime::ProcessBufferContext &ctx) {
-			do_binop(ctx, [](float a, float b) { return a - b; });
+			do_binop_simd(ctx, [](auto a, auto b) { return a - b; });
 		};
 		t.range_analysis_func = [](Runtime::RangeAnalysisContext &ctx) {
 			const Interval a = ctx.get_input(0);
@@ -96,11 +103,12 @@ void register_math_ops_nodes(Span<NodeType> types) {
 		NodeType &t = types[VoxelGraphFunction::NODE_MULTIPLY];
 		t.name = "Multiply";
 		t.category = CATEGORY_MATH;
+		t.is_elementwise = true;
 		t.inputs.push_back(NodeType::Port("a", 0.f, VoxelGraphFunction::AUTO_CONNECT_NONE, false));
 		t.inputs.push_back(NodeType::Port("b", 0.f, VoxelGraphFunction::AUTO_CONNECT_NONE, false));
 		t.outputs.push_back(NodeType::Port("out"));
 		t.process_buffer_func = [](Runtime::ProcessBufferContext &ctx) {
-			do_binop(ctx, [](float a, float b) { return a * b; });
+			do_binop_simd(ctx, [](auto a, auto b) { return a * b; });
 		};
 		t.range_analysis_func = [](Runtime::RangeAnalysisContext &ctx) {
 			const Interval a = ctx.get_input(0);
@@ -120,6 +128,7 @@ void register_math_ops_nodes(Span<NodeType> types) {
 		NodeType &t = types[VoxelGraphFunction::NODE_DIVIDE];
 		t.name = "Divide";
 		t.category = CATEGORY_MATH;
+		t.is_elementwise = true;
 		t.inputs.push_back(NodeType::Port("a", 0.f, VoxelGraphFunction::AUTO_CONNECT_NONE, false));
 		t.inputs.push_back(NodeType::Port("b", 1.f, VoxelGraphFunction::AUTO_CONNECT_NONE, false));
 		t.outputs.push_back(NodeType::Port("out"));
@@ -130,7 +139,20 @@ void register_math_ops_nodes(Span<NodeType> types) {
 			ctx.set_output(0, a / b);
 		};
 		t.shader_gen_func = [](ShaderGenContext &ctx) {
-			ctx.add_format("{} = {} / {};\n", ctx.get_output_name(0), ctx.get_input_name(0), ctx.get_input_name(1));
+			if (ctx.get_language() == CODE_GEN_CPP) {
+				// Match the runtime, which avoids NaNs caused by zeros
+				ctx.add_format(
+						"{} = {} == 0.0 ? 0.0 : {} / {};\n",
+						ctx.get_output_name(0),
+						ctx.get_input_name(1),
+						ctx.get_input_name(0),
+						ctx.get_input_name(1)
+				);
+			} else {
+				ctx.add_format(
+						"{} = {} / {};\n", ctx.get_output_name(0), ctx.get_input_name(0), ctx.get_input_name(1)
+				);
+			}
 		};
 	}
 }
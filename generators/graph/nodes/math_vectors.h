@@ -1,3 +1,4 @@
+#include "../../../util/math/simd.h"
 #include "../../../util/profiling.h"
 #include "../node_type_db.h"
 
@@ -10,6 +11,7 @@ void register_math_vector_nodes(Span<NodeType> types) {
 		NodeType &t = types[VoxelGraphFunction::NODE_DISTANCE_2D];
 		t.name = "Distance2D";
 		t.category = CATEGORY_MATH;
+		t.is_elementwise = true;
 		t.inputs.push_back(NodeType::Port("x0"));
 		t.inputs.push_back(NodeType::Port("y0"));
 		t.inputs.push_back(NodeType::Port("x1", 0.f, VoxelGraphFunction::AUTO_CONNECT_X));
@@ -21,9 +23,12 @@ void register_math_vector_nodes(Span<NodeType> types) {
 			const Runtime::Buffer &x1 = ctx.get_input(2);
 			const Runtime::Buffer &y1 = ctx.get_input(3);
 			Runtime::Buffer &out = ctx.get_output(0);
-			for (uint32_t i = 0; i < out.size; ++i) {
-				out.data[i] = Math::sqrt(squared(x1.data[i] - x0.data[i]) + squared(y1.data[i] - y0.data[i]));
-			}
+			simd::for_each(out.size, [&x0, &y0, &x1, &y1, &out](uint32_t i, auto tag) {
+				using T = decltype(tag);
+				const T dx = simd::load_as<T>(x1.data + i) - simd::load_as<T>(x0.data + i);
+				const T dy = simd::load_as<T>(y1.data + i) - simd::load_as<T>(y0.data + i);
+				simd::store(out.data + i, simd::sqrt(dx * dx + dy * dy));
+			});
 		};
 		t.range_analysis_func = [](Runtime::RangeAnalysisContext &ctx) {
 			const Interval x0 = ctx.get_input(0);
@@ -50,6 +55,7 @@ void register_math_vector_nodes(Span<NodeType> types) {
 		NodeType &t = types[VoxelGraphFunction::NODE_DISTANCE_3D];
 		t.name = "Distance3D";
 		t.category = CATEGORY_MATH;
+		t.is_elementwise = true;
 		t.inputs.push_back(NodeType::Port("x0"));
 		t.inputs.push_back(NodeType::Port("y0"));
 		t.inputs.push_back(NodeType::Port("z0"));
@@ -65,12 +71,13 @@ void register_math_vector_nodes(Span<NodeType> types) {
 			const Runtime::Buffer &y1 = ctx.get_input(4);
 			const Runtime::Buffer &z1 = ctx.get_input(5);
 			Runtime::Buffer &out = ctx.get_output(0);
-			for (uint32_t i = 0; i < out.size; ++i) {
-				out.data[i] = Math::sqrt(
-						squared(x1.data[i] - x0.data[i]) + squared(y1.data[i] - y0.data[i]) +
-						squared(z1.data[i] - z0.data[i])
-				);
-			}
+			simd::for_each(out.size, [&x0, &y0, &z0, &x1, &y1, &z1, &out](uint32_t i, auto tag) {
+				using T = decltype(tag);
+				const T dx = simd::load_as<T>(x1.data + i) - simd::load_as<T>(x0.data + i);
+				const T dy = simd::load_as<T>(y1.data + i) - simd::load_as<T>(y0.data + i);
+				const T dz = simd::load_as<T>(z1.data + i) - simd::load_as<T>(z0.data + i);
+				simd::store(out.data + i, simd::sqrt(dx * dx + dy * dy + dz * dz));
+			});
 		};
 		t.range_analysis_func = [](Runtime::RangeAnalysisContext &ctx) {
 			const Interval x0 = ctx.get_input(0);
@@ -102,6 +109,7 @@ void register_math_vector_nodes(Span<NodeType> types) {
 		NodeType &t = types[VoxelGraphFunction::NODE_NORMALIZE_3D];
 		t.name = "Normalize";
 		t.category = CATEGORY_MATH;
+		t.is_elementwise = true;
 		t.inputs.push_back(NodeType::Port("x", 1.f, VoxelGraphFunction::AUTO_CONNECT_X));
 		t.inputs.push_back(NodeType::Port("y", 1.f, VoxelGraphFunction::AUTO_CONNECT_Y));
 		t.inputs.push_back(NodeType::Port("z", 1.f, VoxelGraphFunction::AUTO_CONNECT_Z));
@@ -120,16 +128,17 @@ void register_math_vector_nodes(Span<NodeType> types) {
 			Runtime::Buffer &out_nz = ctx.get_output(2);
 			Runtime::Buffer &out_len = ctx.get_output(3);
 			const uint32_t buffer_size = out_nx.size;
-			for (uint32_t i = 0; i < buffer_size; ++i) {
-				const float x = xb.data[i];
-				const float y = yb.data[i];
-				const float z = zb.data[i];
-				const float len = Math::sqrt(squared(x) + squared(y) + squared(z));
-				out_nx.data[i] = x / len;
-				out_ny.data[i] = y / len;
-				out_nz.data[i] = z / len;
-				out_len.data[i] = len;
-			}
+			simd::for_each(buffer_size, ctx.is_deterministic(), [&](uint32_t i, auto tag) {
+				using T = decltype(tag);
+				const T x = simd::load_as<T>(xb.data + i);
+				const T y = simd::load_as<T>(yb.data + i);
+				const T z = simd::load_as<T>(zb.data + i);
+				const T len = simd::sqrt(x * x + y * y + z * z);
+				simd::store(out_nx.data + i, x / len);
+				simd::store(out_ny.data + i, y / len);
+				simd::store(out_nz.data + i, z / len);
+				simd::store(out_len.data + i, len);
+			});
 		};
 
 		t.range_analysis_func = [](Runtime::RangeAnalysisContext &ctx) {
@@ -147,15 +156,23 @@ void register_math_vector_nodes(Span<NodeType> types) {
 		};
 
 		t.shader_gen_func = [](ShaderGenContext &ctx) {
+			// Output parameters are references in C++
 			ctx.require_lib_code(
 					"vg_normalize",
-					"void vg_normalize(vec3 v, out float x, out float y, out float z, out float mag) {\n"
-					"    mag = length(v);\n"
-					"    v /= mag;\n"
-					"    x = v.x;\n"
-					"    y = v.y;\n"
-					"    z = v.z;\n"
-					"}\n"
+					ctx.get_language() == CODE_GEN_CPP
+							? "void vg_normalize(vec3 v, float &x, float &y, float &z, float &mag) {\n"
+							  "    mag = length(v);\n"
+							  "    x = v.x / mag;\n"
+							  "    y = v.y / mag;\n"
+							  "    z = v.z / mag;\n"
+							  "}\n"
+							: "void vg_normalize(vec3 v, out float x, out float y, out float z, out float mag) {\n"
+							  "    mag = length(v);\n"
+							  "    v /= mag;\n"
+							  "    x = v.x;\n"
+							  "    y = v.y;\n"
+							  "    z = v.z;\n"
+							  "}\n"
 			);
 			ctx.add_format(
 					"vg_normalize(vec3({}, {}, {}), {}, {}, {}, {});\n",
@@ -152,6 +152,9 @@ void register_noise_nodes(Span<NodeType> types) {
 
 #ifdef VOXEL_ENABLE_GPU
 		t.shader_gen_func = [](ShaderGenContext &ctx) {
+			if (!ctx.require_glsl()) {
+				return;
+			}
 			Ref<Noise> noise = ctx.get_param(0);
 			if (noise.is_null()) {
 				ctx.make_error(String(ZN_TTR("{0} instance is null")).format(varray(Noise::get_class_static())));
@@ -233,6 +236,9 @@ void register_noise_nodes(Span<NodeType> types) {
 
 #ifdef VOXEL_ENABLE_GPU
 		t.shader_gen_func = [](ShaderGenContext &ctx) {
+			if (!ctx.require_glsl()) {
+				return;
+			}
 			Ref<Noise> noise = ctx.get_param(0);
 			if (noise.is_null()) {
 				ctx.make_error(String(ZN_TTR("{0} instance is null")).format(varray(Noise::get_class_static())));
@@ -300,9 +306,18 @@ void register_noise_nodes(Span<NodeType> types) {
 			const Runtime::Buffer &y = ctx.get_input(1);
 			Runtime::Buffer &out = ctx.get_output(0);
 			const Params p = ctx.get_params<Params>();
-			for (uint32_t i = 0; i < out.size; ++i) {
-				out.data[i] = p.noise->get_noise_2d(x.data[i], y.data[i]);
+			if (ctx.is_deterministic()) {
+				// The batch version uses SIMD instructions, some of which are approximations on some platforms
+				for (unsigned int i = 0; i < out.size; ++i) {
+					out.data[i] = p.noise->get_noise_2d(x.data[i], y.data[i]);
+				}
+				return;
 			}
+			p.noise->get_noise_2d_series(
+					Span<const float>(x.data, out.size),
+					Span<const float>(y.data, out.size),
+					Span<float>(out.data, out.size)
+			);
 		};
 
 		t.range_analysis_func = [](Runtime::RangeAnalysisContext &ctx) {
@@ -315,6 +330,9 @@ void register_noise_nodes(Span<NodeType> types) {
 
 #ifdef VOXEL_ENABLE_GPU
 		t.shader_gen_func = [](ShaderGenContext &ctx) {
+			if (!ctx.require_glsl()) {
+				return;
+			}
 			Ref<ZN_FastNoiseLite> noise = ctx.get_param(0);
 			if (noise.is_null()) {
 				ctx.make_error(
@@ -371,9 +389,18 @@ void register_noise_nodes(Span<NodeType> types) {
 			const Runtime::Buffer &z = ctx.get_input(2);
 			Runtime::Buffer &out = ctx.get_output(0);
 			const Params p = ctx.get_params<Params>();
-			for (uint32_t i = 0; i < out.size; ++i) {
-				out.data[i] = p.noise->get_noise_3d(x.data[i], y.data[i], z.data[i]);
+			if (ctx.is_deterministic()) {
+				for (unsigned int i = 0; i < out.size; ++i) {
+					out.data[i] = p.noise->get_noise_3d(x.data[i], y.data[i], z.data[i]);
+				}
+				return;
 			}
+			p.noise->get_noise_3d_series(
+					Span<const float>(x.data, out.size),
+					Span<const float>(y.data, out.size),
+					Span<const float>(z.data, out.size),
+					Span<float>(out.data, out.size)
+			);
 		};
 
 		t.range_analysis_func = [](Runtime::RangeAnalysisContext &ctx) {
@@ -387,6 +414,9 @@ void register_noise_nodes(Span<NodeType> types) {
 
 #ifdef VOXEL_ENABLE_GPU
 		t.shader_gen_func = [](ShaderGenContext &ctx) {
+			if (!ctx.require_glsl()) {
+				return;
+			}
 			Ref<ZN_FastNoiseLite> noise = ctx.get_param(0);
 			if (noise.is_null()) {
 				ctx.make_error(
@@ -466,6 +496,9 @@ void register_noise_nodes(Span<NodeType> types) {
 
 #ifdef VOXEL_ENABLE_GPU
 		t.shader_gen_func = [](ShaderGenContext &ctx) {
+			if (!ctx.require_glsl()) {
+				return;
+			}
 			Ref<ZN_FastNoiseLiteGradient> noise = ctx.get_param(0);
 			if (noise.is_null()) {
 				ctx.make_error(String(ZN_TTR("{0} instance is null"))
@@ -556,6 +589,9 @@ void register_noise_nodes(Span<NodeType> types) {
 
 #ifdef VOXEL_ENABLE_GPU
 		t.shader_gen_func = [](ShaderGenContext &ctx) {
+			if (!ctx.require_glsl()) {
+				return;
+			}
 			Ref<ZN_FastNoiseLiteGradient> noise = ctx.get_param(0);
 			if (noise.is_null()) {
 				ctx.make_error(String(ZN_TTR("{0} instance is null"))
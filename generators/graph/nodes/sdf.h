@@ -12,11 +12,12 @@ void register_sdf_nodes(Span<NodeType> types) {
 		NodeType &t = types[VoxelGraphFunction::NODE_SDF_PLANE];
 		t.name = "SdfPlane";
 		t.category = CATEGORY_SDF;
+		t.is_elementwise = true;
 		t.inputs.push_back(NodeType::Port("y", 0.f, VoxelGraphFunction::AUTO_CONNECT_Y));
 		t.inputs.push_back(NodeType::Port("height"));
 		t.outputs.push_back(NodeType::Port("sdf"));
 		t.process_buffer_func = [](Runtime::ProcessBufferContext &ctx) {
-			do_binop(ctx, [](float a, float b) { return a - b; });
+			do_binop_simd(ctx, [](auto a, auto b) { return a - b; });
 		};
 		t.range_analysis_func = [](Runtime::RangeAnalysisContext &ctx) {
 			const Interval a = ctx.get_input(0);
@@ -36,6 +37,7 @@ void register_sdf_nodes(Span<NodeType> types) {
 		NodeType &t = types[VoxelGraphFunction::NODE_SDF_BOX];
 		t.name = "SdfBox";
 		t.category = CATEGORY_SDF;
+		t.is_elementwise = true;
 		t.inputs.push_back(NodeType::Port("x", 0.f, VoxelGraphFunction::AUTO_CONNECT_X));
 		t.inputs.push_back(NodeType::Port("y", 0.f, VoxelGraphFunction::AUTO_CONNECT_Y));
 		t.inputs.push_back(NodeType::Port("z", 0.f, VoxelGraphFunction::AUTO_CONNECT_Z));
@@ -56,10 +58,19 @@ void register_sdf_nodes(Span<NodeType> types) {
 			const Runtime::Buffer &z = ctx.get_input(2);
 			const Params p = ctx.get_params<Params>();
 			Runtime::Buffer &out = ctx.get_output(0);
-			const Vector3f size(p.size_x, p.size_y, p.size_z);
-			for (uint32_t i = 0; i < out.size; ++i) {
-				out.data[i] = math::sdf_box(Vector3f(x.data[i], y.data[i], z.data[i]), size);
-			}
+			simd::for_each(out.size, [&x, &y, &z, &p, &out](uint32_t i, auto tag) {
+				using T = decltype(tag);
+				// Same as `math::sdf_box`
+				const T zero = simd::splat<T>(0.f);
+				const T dx = simd::abs(simd::load_as<T>(x.data + i)) - p.size_x;
+				const T dy = simd::abs(simd::load_as<T>(y.data + i)) - p.size_y;
+				const T dz = simd::abs(simd::load_as<T>(z.data + i)) - p.size_z;
+				const T ox = simd::max(dx, zero);
+				const T oy = simd::max(dy, zero);
+				const T oz = simd::max(dz, zero);
+				const T inside = simd::min(simd::max(dx, simd::max(dy, dz)), zero);
+				simd::store(out.data + i, inside + simd::sqrt(ox * ox + oy * oy + oz * oz));
+			});
 		};
 		t.range_analysis_func = [](Runtime::RangeAnalysisContext &ctx) {
 			const Interval x = ctx.get_input(0);
@@ -95,6 +106,7 @@ void register_sdf_nodes(Span<NodeType> types) {
 		NodeType &t = types[VoxelGraphFunction::NODE_SDF_SPHERE];
 		t.name = "SdfSphere";
 		t.category = CATEGORY_SDF;
+		t.is_elementwise = true;
 		t.inputs.push_back(NodeType::Port("x", 0.f, VoxelGraphFunction::AUTO_CONNECT_X));
 		t.inputs.push_back(NodeType::Port("y", 0.f, VoxelGraphFunction::AUTO_CONNECT_Y));
 		t.inputs.push_back(NodeType::Port("z", 0.f, VoxelGraphFunction::AUTO_CONNECT_Z));
@@ -108,14 +120,22 @@ void register_sdf_nodes(Span<NodeType> types) {
 			const Runtime::Buffer &r = ctx.get_input(3);
 			Runtime::Buffer &out = ctx.get_output(0);
 			if (r.is_constant) {
-				for (uint32_t i = 0; i < out.size; ++i) {
-					out.data[i] =
-							Math::sqrt(squared(x.data[i]) + squared(y.data[i]) + squared(z.data[i])) - r.constant_value;
-				}
+				const float radius = r.constant_value;
+				simd::for_each(out.size, [&x, &y, &z, radius, &out](uint32_t i, auto tag) {
+					using T = decltype(tag);
+					const T vx = simd::load_as<T>(x.data + i);
+					const T vy = simd::load_as<T>(y.data + i);
+					const T vz = simd::load_as<T>(z.data + i);
+					simd::store(out.data + i, simd::sqrt(vx * vx + vy * vy + vz * vz) - radius);
+				});
 			} else {
-				for (uint32_t i = 0; i < out.size; ++i) {
-					out.data[i] = Math::sqrt(squared(x.data[i]) + squared(y.data[i]) + squared(z.data[i])) - r.data[i];
-				}
+				simd::for_each(out.size, [&x, &y, &z, &r, &out](uint32_t i, auto tag) {
+					using T = decltype(tag);
+					const T vx = simd::load_as<T>(x.data + i);
+					const T vy = simd::load_as<T>(y.data + i);
+					const T vz = simd::load_as<T>(z.data + i);
+					simd::store(out.data + i, simd::sqrt(vx * vx + vy * vy + vz * vz) - simd::load_as<T>(r.data + i));
+				});
 			}
 		};
 		t.range_analysis_func = [](Runtime::RangeAnalysisContext &ctx) {
@@ -144,6 +164,7 @@ void register_sdf_nodes(Span<NodeType> types) {
 		NodeType &t = types[VoxelGraphFunction::NODE_SDF_TORUS];
 		t.name = "SdfTorus";
 		t.category = CATEGORY_SDF;
+		t.is_elementwise = true;
 		t.inputs.push_back(NodeType::Port("x", 0.f, VoxelGraphFunction::AUTO_CONNECT_X));
 		t.inputs.push_back(NodeType::Port("y", 0.f, VoxelGraphFunction::AUTO_CONNECT_Y));
 		t.inputs.push_back(NodeType::Port("z", 0.f, VoxelGraphFunction::AUTO_CONNECT_Z));
@@ -162,9 +183,15 @@ void register_sdf_nodes(Span<NodeType> types) {
 			const Runtime::Buffer &z = ctx.get_input(2);
 			const Params p = ctx.get_params<Params>();
 			Runtime::Buffer &out = ctx.get_output(0);
-			for (uint32_t i = 0; i < out.size; ++i) {
-				out.data[i] = math::sdf_torus(x.data[i], y.data[i], z.data[i], p.r1, p.r2);
-			}
+			simd::for_each(out.size, [&x, &y, &z, &p, &out](uint32_t i, auto tag) {
+				using T = decltype(tag);
+				// Same as `math::sdf_torus`
+				const T vx = simd::load_as<T>(x.data + i);
+				const T vy = simd::load_as<T>(y.data + i);
+				const T vz = simd::load_as<T>(z.data + i);
+				const T qx = simd::sqrt(vx * vx + vz * vz) - p.r1;
+				simd::store(out.data + i, simd::sqrt(qx * qx + vy * vy) - p.r2);
+			});
 		};
 		t.range_analysis_func = [](Runtime::RangeAnalysisContext &ctx) {
 			const Interval x = ctx.get_input(0);
@@ -179,7 +206,7 @@ void register_sdf_nodes(Span<NodeType> types) {
 			ctx.require_lib_code(
 					"sdf_torus",
 					"float vg_sdf_torus(vec3 p, vec2 t) {\n"
-					"	vec2 q = vec2(length(p.xz) - t.x, p.y);\n"
+					"	vec2 q = vec2(length(vec2(p.x, p.z)) - t.x, p.y);\n"
 					"	return length(q) - t.y;\n"
 					"}\n"
 			);
@@ -201,6 +228,7 @@ void register_sdf_nodes(Span<NodeType> types) {
 		NodeType &t = types[VoxelGraphFunction::NODE_SDF_SMOOTH_UNION];
 		t.name = "SdfSmoothUnion";
 		t.category = CATEGORY_SDF;
+		t.is_elementwise = true;
 		t.inputs.push_back(NodeType::Port("a"));
 		t.inputs.push_back(NodeType::Port("b"));
 		t.outputs.push_back(NodeType::Port("sdf"));
@@ -227,14 +255,21 @@ void register_sdf_nodes(Span<NodeType> types) {
 					out.data[i] = a.data[i];
 				}
 			} else if (params.smoothness > 0.0001f) {
-				for (uint32_t i = 0; i < out.size; ++i) {
-					out.data[i] = math::sdf_smooth_union(a.data[i], b.data[i], params.smoothness);
-				}
+				const float s = params.smoothness;
+				simd::for_each(out.size, [&a, &b, s, &out](uint32_t i, auto tag) {
+					using T = decltype(tag);
+					// Same as `math::sdf_smooth_union`
+					const T va = simd::load_as<T>(a.data + i);
+					const T vb = simd::load_as<T>(b.data + i);
+					const T h = simd::clamp((vb - va) * (0.5f / s) + 0.5f, simd::splat<T>(0.f), simd::splat<T>(1.f));
+					simd::store(out.data + i, simd::lerp(vb, va, h) - h * (1.f - h) * s);
+				});
 			} else {
 				// Fallback on hard-union, smooth union does not support zero smoothness
-				for (uint32_t i = 0; i < out.size; ++i) {
-					out.data[i] = math::sdf_union(a.data[i], b.data[i]);
-				}
+				simd::for_each(out.size, [&a, &b, &out](uint32_t i, auto tag) {
+					using T = decltype(tag);
+					simd::store(out.data + i, simd::min(simd::load_as<T>(a.data + i), simd::load_as<T>(b.data + i)));
+				});
 			}
 		};
 		t.range_analysis_func = [](Runtime::RangeAnalysisContext &ctx) {
@@ -305,6 +340,7 @@ void register_sdf_nodes(Span<NodeType> types) {
 		NodeType &t = types[VoxelGraphFunction::NODE_SDF_SMOOTH_SUBTRACT];
 		t.name = "SdfSmoothSubtract";
 		t.category = CATEGORY_SDF;
+		t.is_elementwise = true;
 		t.inputs.push_back(NodeType::Port("a"));
 		t.inputs.push_back(NodeType::Port("b"));
 		t.outputs.push_back(NodeType::Port("sdf"));
@@ -331,14 +367,21 @@ void register_sdf_nodes(Span<NodeType> types) {
 					out.data[i] = a.data[i];
 				}
 			} else if (params.smoothness > 0.0001f) {
-				for (uint32_t i = 0; i < out.size; ++i) {
-					out.data[i] = math::sdf_smooth_subtract(a.data[i], b.data[i], params.smoothness);
-				}
+				const float s = params.smoothness;
+				simd::for_each(out.size, [&a, &b, s, &out](uint32_t i, auto tag) {
+					using T = decltype(tag);
+					// Same as `math::sdf_smooth_subtract`
+					const T va = simd::load_as<T>(a.data + i);
+					const T vb = simd::load_as<T>(b.data + i);
+					const T h = simd::clamp(0.5f - (va + vb) * (0.5f / s), simd::splat<T>(0.f), simd::splat<T>(1.f));
+					simd::store(out.data + i, simd::lerp(va, -vb, h) + h * (1.f - h) * s);
+				});
 			} else {
 				// Fallback on hard-subtract, smooth subtract does not support zero smoothness
-				for (uint32_t i = 0; i < out.size; ++i) {
-					out.data[i] = math::sdf_subtract(a.data[i], b.data[i]);
-				}
+				simd::for_each(out.size, [&a, &b, &out](uint32_t i, auto tag) {
+					using T = decltype(tag);
+					simd::store(out.data + i, simd::max(simd::load_as<T>(a.data + i), -simd::load_as<T>(b.data + i)));
+				});
 			}
 		};
 		t.range_analysis_func = [](Runtime::RangeAnalysisContext &ctx) {
@@ -1,6 +1,7 @@
 #ifndef VOXEL_GRAPH_NODES_UTIL_H
 #define VOXEL_GRAPH_NODES_UTIL_H
 
+#include "../../../util/math/simd.h"
 #include "../voxel_graph_runtime.h"
 
 namespace zylann::voxel::pg {
@@ -59,6 +60,68 @@ inline void do_binop(pg::Runtime::ProcessBufferContext &ctx, F f) {
 	}
 }
 
+// Same as `do_monop`, but `f` must be a generic lambda accepting either `float` or `simd::Float4`, so that values can
+// be processed several at a time.
+template <typename F>
+inline void do_monop_simd(pg::Runtime::ProcessBufferContext &ctx, F f) {
+	const Runtime::Buffer &a = ctx.get_input(0);
+	Runtime::Buffer &out = ctx.get_output(0);
+	if (a.is_constant) {
+		// Normally this case should have been optimized out at compile-time
+		const float v = f(a.constant_value);
+		for (uint32_t i = 0; i < a.size; ++i) {
+			out.data[i] = v;
+		}
+	} else {
+		simd::for_each(a.size, [&a, &out, &f](uint32_t i, auto tag) {
+			using T = decltype(tag);
+			simd::store(out.data + i, f(simd::load_as<T>(a.data + i)));
+		});
+	}
+}
+
+// Same as `do_binop`, but `f` must be a generic lambda accepting either `float` or `simd::Float4`, so that values can
+// be processed several at a time.
+template <typename F>
+inline void do_binop_simd(pg::Runtime::ProcessBufferContext &ctx, F f) {
+	const Runtime::Buffer &a = ctx.get_input(0);
+	const Runtime::Buffer &b = ctx.get_input(1);
+	Runtime::Buffer &out = ctx.get_output(0);
+	const uint32_t buffer_size = out.size;
+
+	if (a.is_constant || b.is_constant) {
+		if (!b.is_constant) {
+			const float c = a.constant_value;
+			const float *v = b.data;
+			simd::for_each(buffer_size, [c, v, &out, &f](uint32_t i, auto tag) {
+				using T = decltype(tag);
+				simd::store(out.data + i, f(simd::splat<T>(c), simd::load_as<T>(v + i)));
+			});
+
+		} else if (!a.is_constant) {
+			const float c = b.constant_value;
+			const float *v = a.data;
+			simd::for_each(buffer_size, [c, v, &out, &f](uint32_t i, auto tag) {
+				using T = decltype(tag);
+				simd::store(out.data + i, f(simd::load_as<T>(v + i), simd::splat<T>(c)));
+			});
+
+		} else {
+			// Normally this case should have been optimized out at compile-time
+			const float c = f(a.constant_value, b.constant_value);
+			for (uint32_t i = 0; i < buffer_size; ++i) {
+				out.data[i] = c;
+			}
+		}
+
+	} else {
+		simd::for_each(buffer_size, [&a, &b, &out, &f](uint32_t i, auto tag) {
+			using T = decltype(tag);
+			simd::store(out.data + i, f(simd::load_as<T>(a.data + i), simd::load_as<T>(b.data + i)));
+		});
+	}
+}
+
 } // namespace zylann::voxel::pg
 
 #endif // VOXEL_GRAPH_NODES_UTIL_H
@@ -0,0 +1,55 @@
+#include "range_analysis_cache.h"
+#include "../../util/errors.h"
+#include "../../util/profiling.h"
+
+namespace zylann::voxel {
+
+bool RangeAnalysisCache::find(Vector3i origin, int size, float clip_threshold, Entry &out_entry) const {
+#ifdef DEBUG_ENABLED
+	ZN_ASSERT_RETURN_V(is_region_aligned(origin, size), false);
+#endif
+
+	RWLockRead rlock(_lock);
+
+	// Go up the octree until a uniform region is found. Sizes double at each level, the same way block sizes do across
+	// LODs.
+	for (int s = size; s <= _max_size; s <<= 1) {
+		const Key key{ math::floordiv(origin, s), s };
+		auto it = _entries.find(key);
+		if (it != _entries.end()) {
+			const Entry &entry = it->second;
+			if (entry.clip_threshold >= clip_threshold) {
+				out_entry = entry;
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+void RangeAnalysisCache::add(Vector3i origin, int size, const Entry &entry) {
+#ifdef DEBUG_ENABLED
+	ZN_ASSERT_RETURN(is_region_aligned(origin, size));
+#endif
+
+	RWLockWrite wlock(_lock);
+
+	if (_entries.size() >= MAX_ENTRIES) {
+		ZN_PROFILE_SCOPE_NAMED("Range analysis cache reset");
+		_entries.clear();
+		_max_size = 0;
+	}
+
+	const Key key{ math::floordiv(origin, size), size };
+	_entries[key] = entry;
+	_max_size = math::max(_max_size, size);
+}
+
+void RangeAnalysisCache::clear() {
+	RWLockWrite wlock(_lock);
+	_entries.clear();
+	_max_size = 0;
+}
+
+} // namespace zylann::voxel
@@ -0,0 +1,79 @@
+#ifndef VOXEL_RANGE_ANALYSIS_CACHE_H
+#define VOXEL_RANGE_ANALYSIS_CACHE_H
+
+#include "../../util/containers/std_unordered_map.h"
+#include "../../util/math/vector3i.h"
+#include "../../util/thread/rw_lock.h"
+
+namespace zylann::voxel {
+
+// Remembers regions of space where range analysis of a voxel graph found all outputs to be uniform, so later queries
+// in the same area can fill voxels without running the analysis again.
+// Regions are cubes aligned to their own size, stored as a sparse octree (each size has its own cells). Because range
+// analysis is conservative, a region found uniform also answers for every smaller region it contains, which is what
+// happens when higher LODs get generated before lower ones.
+// It can be used by multiple threads. Results are only valid for the compiled graph they were obtained with.
+class RangeAnalysisCache {
+public:
+	enum SdfState : uint8_t {
+		// SDF is above the clip threshold
+		SDF_AIR,
+		// SDF is below the negative clip threshold
+		SDF_MATTER,
+		// SDF is the same everywhere, stored in `sdf_value`
+		SDF_VALUE
+	};
+
+	struct Entry {
+		float sdf_value = 0.f;
+		int32_t type = 0;
+		int32_t single_texture_index = 0;
+		SdfState sdf_state = SDF_AIR;
+		// Clip threshold used when the SDF state was determined, scaled by LOD. Regions found beyond a threshold
+		// are also beyond any lower one.
+		float clip_threshold = 0.f;
+	};
+
+	// Finds a uniform region of size `size` at `origin`, or a bigger one containing it. `origin` must be a multiple of
+	// `size`. Only regions found with a clip threshold greater or equal to `clip_threshold` are returned.
+	bool find(Vector3i origin, int size, float clip_threshold, Entry &out_entry) const;
+
+	// Stores a region found uniform. `origin` must be a multiple of `size`.
+	void add(Vector3i origin, int size, const Entry &entry);
+
+	void clear();
+
+	static inline bool is_region_aligned(Vector3i origin, int size) {
+		return size > 0 && math::wrap(origin.x, size) == 0 && math::wrap(origin.y, size) == 0 &&
+				math::wrap(origin.z, size) == 0;
+	}
+
+private:
+	struct Key {
+		// In units of `size`
+		Vector3i position;
+		int size;
+
+		inline bool operator==(const Key &other) const {
+			return position == other.position && size == other.size;
+		}
+	};
+
+	struct KeyHasher {
+		inline size_t operator()(const Key &key) const {
+			return hash_djb2_one_32(key.size, Vector3iHasher::hash(key.position));
+		}
+	};
+
+	// Past this amount of regions, the cache starts over, which bounds memory usage
+	static const unsigned int MAX_ENTRIES = 65536;
+
+	StdUnorderedMap<Key, Entry, KeyHasher> _entries;
+	// Largest region size stored so far, which bounds how far up lookups need to go
+	int _max_size = 0;
+	mutable RWLock _lock;
+};
+
+} // namespace zylann::voxel
+
+#endif // VOXEL_RANGE_ANALYSIS_CACHE_H
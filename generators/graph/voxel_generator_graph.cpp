@@ -17,6 +17,7 @@
 #include "../../util/string/expression_parser.h"
 #include "../../util/string/format.h"
 #include "node_type_db.h"
+#include "voxel_graph_cpp_generator.h"
 #include "voxel_graph_function.h"
 
 namespace zylann::voxel {
@@ -121,6 +122,14 @@ int VoxelGeneratorGraph::get_subdivision_size() const {
 	return _subdivision_size;
 }
 
+void VoxelGeneratorGraph::set_use_adaptive_subdivision(bool use) {
+	_use_adaptive_subdivision = use;
+}
+
+bool VoxelGeneratorGraph::is_using_adaptive_subdivision() const {
+	return _use_adaptive_subdivision;
+}
+
 void VoxelGeneratorGraph::set_debug_clipped_blocks(bool enabled) {
 	_debug_clipped_blocks = enabled;
 }
@@ -146,6 +155,14 @@ VoxelGeneratorGraph::TextureMode VoxelGeneratorGraph::get_texture_mode() const {
 	return _texture_mode;
 }
 
+void VoxelGeneratorGraph::set_deterministic(bool enabled) {
+	_deterministic = enabled;
+}
+
+bool VoxelGeneratorGraph::is_deterministic() const {
+	return _deterministic;
+}
+
 // TODO Optimization: generating indices and weights on every voxel of a block might be avoidable
 // Instead, we could only generate them near zero-crossings, because this is where materials will be seen.
 // The problem is that it's harder to manage at the moment, to support edited blocks and LOD...
@@ -717,15 +734,18 @@ VoxelGenerator::Result VoxelGeneratorGraph::generate_block(VoxelGenerator::Voxel
 	// Slice is on the Y axis
 	const unsigned int slice_buffer_size = section_size.x * section_size.z;
 	pg::Runtime &runtime = runtime_ptr->runtime;
-	runtime.prepare_state(cache.state, slice_buffer_size, false);
 
-	cache.x_cache.resize(slice_buffer_size);
-	cache.y_cache.resize(slice_buffer_size);
-	cache.z_cache.resize(slice_buffer_size);
+	// Inputs come from the same arena as graph buffers
+	const size_t volume = Vector3iUtil::get_volume_u64(bs);
+	unsigned int scratch_size = 3 * slice_buffer_size;
+	if (runtime_ptr->sdf_input_index != -1) {
+		scratch_size += slice_buffer_size + static_cast<unsigned int>(volume);
+	}
+	runtime.prepare_state(cache.state, slice_buffer_size, false, scratch_size);
 
-	Span<float> x_cache = to_span(cache.x_cache);
-	Span<float> y_cache = to_span(cache.y_cache);
-	Span<float> z_cache = to_span(cache.z_cache);
+	Span<float> x_cache = cache.state.allocate_scratch(slice_buffer_size);
+	Span<float> y_cache = cache.state.allocate_scratch(slice_buffer_size);
+	Span<float> z_cache = cache.state.allocate_scratch(slice_buffer_size);
 
 	const float air_sdf = _debug_clipped_blocks ? constants::SDF_FAR_INSIDE : constants::SDF_FAR_OUTSIDE;
 	const float matter_sdf = _debug_clipped_blocks ? constants::SDF_FAR_OUTSIDE : constants::SDF_FAR_INSIDE;
@@ -742,12 +762,8 @@ VoxelGenerator::Result VoxelGeneratorGraph::generate_block(VoxelGenerator::Voxel
 	Span<float> input_sdf_slice_cache;
 	if (runtime_ptr->sdf_input_index != -1) {
 		ZN_PROFILE_SCOPE();
-		cache.input_sdf_slice_cache.resize(slice_buffer_size);
-		input_sdf_slice_cache = to_span(cache.input_sdf_slice_cache);
-
-		const size_t volume = Vector3iUtil::get_volume_u64(bs);
-		cache.input_sdf_full_cache.resize(volume);
-		input_sdf_full_cache = to_span(cache.input_sdf_full_cache);
+		input_sdf_slice_cache = cache.state.allocate_scratch(slice_buffer_size);
+		input_sdf_full_cache = cache.state.allocate_scratch(volume);
 
 		// Note, a copy of the data is notably needed because we are going to write into that same buffer.
 		get_unscaled_sdf(out_buffer, input_sdf_full_cache);
@@ -758,205 +774,301 @@ VoxelGenerator::Result VoxelGeneratorGraph::generate_block(VoxelGenerator::Voxel
 		}
 	}
 
-	// For each subdivision of the block
-	for (int sz = 0; sz < bs.z; sz += section_size.z) {
-		for (int sy = 0; sy < bs.y; sy += section_size.y) {
-			for (int sx = 0; sx < bs.x; sx += section_size.x) {
-				ZN_PROFILE_SCOPE_NAMED("Section");
-
-				const Vector3i rmin(sx, sy, sz);
-				const Vector3i rmax = rmin + Vector3i(section_size);
-				const Vector3i gmin = origin + (rmin << input.lod);
-				const Vector3i gmax = origin + (rmax << input.lod);
-
-				// Do a quick analysis of the area. We'll only compute voxels if necessary.
-				{
-					QueryInputs<math::Interval> range_inputs(
-							*runtime_ptr,
-							math::Interval(gmin.x, gmax.x),
-							math::Interval(gmin.y, gmax.y),
-							math::Interval(gmin.z, gmax.z),
-							sdf_input_range
-					);
-					runtime.analyze_range(cache.state, range_inputs.get());
-				}
+	// Range analysis results can be re-used only if they don't depend on the block's existing voxels
+	const bool can_use_range_analysis_cache = runtime_ptr->sdf_input_index == -1;
 
-				SmallVector<unsigned int, pg::Runtime::MAX_OUTPUTS> required_outputs;
+	// Adaptive subdivision starts from the whole block, and only splits areas range analysis could not resolve. It
+	// requires a cubic block whose size is the subdivision size times a power of two, so all areas are cubes.
+	const bool use_adaptive_subdivision = _use_subdivision && _use_adaptive_subdivision && can_use_subdivision &&
+			bs.x == bs.y && bs.x == bs.z && math::is_power_of_two(bs.x / _subdivision_size);
 
-				bool sdf_is_air = true;
-				bool sdf_is_uniform = true;
-				if (sdf_output_buffer_index != -1) {
-					const math::Interval sdf_range = cache.state.get_range(sdf_output_buffer_index);
-					bool sdf_is_matter = false;
+	StdVector<Box3i> &sections = cache.sections;
+	sections.clear();
+	if (use_adaptive_subdivision) {
+		sections.push_back(Box3i(Vector3i(), bs));
+	} else {
+		for (int sz = 0; sz < bs.z; sz += section_size.z) {
+			for (int sy = 0; sy < bs.y; sy += section_size.y) {
+				for (int sx = 0; sx < bs.x; sx += section_size.x) {
+					sections.push_back(Box3i(Vector3i(sx, sy, sz), section_size));
+				}
+			}
+		}
+	}
 
-					if (sdf_range.min > clip_threshold && sdf_range.max > clip_threshold) {
-						out_buffer.fill_area_f(air_sdf, rmin, rmax, sdf_channel);
-						sdf_is_air = true;
+	// For each subdivision of the block
+	while (sections.size() > 0) {
+		ZN_PROFILE_SCOPE_NAMED("Section");
+
+		const Box3i section = sections.back();
+		sections.pop_back();
+
+		const Vector3i rmin = section.position;
+		const Vector3i rmax = rmin + section.size;
+		const Vector3i gmin = origin + (rmin << input.lod);
+		const Vector3i gmax = origin + (rmax << input.lod);
+
+		const int section_world_size = section.size.x << input.lod;
+		RangeAnalysisCache *range_analysis_cache = nullptr;
+		if (can_use_range_analysis_cache && section.size.x == section.size.y && section.size.x == section.size.z &&
+			RangeAnalysisCache::is_region_aligned(gmin, section_world_size)) {
+			range_analysis_cache = &runtime_ptr->range_analysis_cache;
+		}
 
-					} else if (sdf_range.min < -clip_threshold && sdf_range.max < -clip_threshold) {
+		RangeAnalysisCache::Entry cache_entry;
+		cache_entry.clip_threshold = clip_threshold;
+
+		if (range_analysis_cache != nullptr &&
+			range_analysis_cache->find(gmin, section_world_size, clip_threshold, cache_entry)) {
+			// This area was already found uniform, no need to analyze it again
+			bool sdf_is_air = true;
+			if (sdf_output_buffer_index != -1) {
+				bool sdf_is_matter = false;
+				switch (cache_entry.sdf_state) {
+					case RangeAnalysisCache::SDF_AIR:
+						out_buffer.fill_area_f(air_sdf, rmin, rmax, sdf_channel);
+						break;
+					case RangeAnalysisCache::SDF_MATTER:
 						out_buffer.fill_area_f(matter_sdf, rmin, rmax, sdf_channel);
 						sdf_is_air = false;
 						sdf_is_matter = true;
-
-					} else if (sdf_range.is_single_value()) {
-						out_buffer.fill_area_f(sdf_range.min, rmin, rmax, sdf_channel);
-						sdf_is_air = sdf_range.min > 0.f;
+						break;
+					case RangeAnalysisCache::SDF_VALUE:
+						out_buffer.fill_area_f(cache_entry.sdf_value, rmin, rmax, sdf_channel);
+						sdf_is_air = cache_entry.sdf_value > 0.f;
 						sdf_is_matter = !sdf_is_air;
+						break;
+				}
+				all_sdf_is_air = all_sdf_is_air && sdf_is_air;
+				all_sdf_is_matter = all_sdf_is_matter && sdf_is_matter;
+			}
+			if (type_output_buffer_index != -1) {
+				out_buffer.fill_area(cache_entry.type, rmin, rmax, type_channel);
+			}
+			if (runtime_ptr->single_texture_output_index != -1 && !sdf_is_air) {
+				fill_texturing_data_from_single_texture_index(
+						out_buffer, cache_entry.single_texture_index, rmin, rmax, _texture_mode
+				);
+			}
+			continue;
+		}
 
-					} else {
-						// SDF is not uniform, we'll need to compute it per voxel
-						required_outputs.push_back(runtime_ptr->sdf_output_index);
-						sdf_is_air = false;
-						sdf_is_uniform = false;
-					}
+		// Do a quick analysis of the area. We'll only compute voxels if necessary.
+		{
+			QueryInputs<math::Interval> range_inputs(
+					*runtime_ptr,
+					math::Interval(gmin.x, gmax.x),
+					math::Interval(gmin.y, gmax.y),
+					math::Interval(gmin.z, gmax.z),
+					sdf_input_range
+			);
+			runtime.analyze_range(cache.state, range_inputs.get());
+		}
 
-					all_sdf_is_air = all_sdf_is_air && sdf_is_air;
-					all_sdf_is_matter = all_sdf_is_matter && sdf_is_matter;
-				}
+		SmallVector<unsigned int, pg::Runtime::MAX_OUTPUTS> required_outputs;
 
-				bool type_is_uniform = false;
-				if (type_output_buffer_index != -1) {
-					const math::Interval type_range = cache.state.get_range(type_output_buffer_index);
-					if (type_range.is_single_value()) {
-						out_buffer.fill_area(int(type_range.min), rmin, rmax, type_channel);
-						type_is_uniform = true;
-					} else {
-						// Types are not uniform, we'll need to compute them per voxel
-						required_outputs.push_back(runtime_ptr->type_output_index);
-					}
-				}
+		bool sdf_is_air = true;
+		bool sdf_is_matter = false;
+		bool sdf_is_uniform = true;
+		if (sdf_output_buffer_index != -1) {
+			const math::Interval sdf_range = cache.state.get_range(sdf_output_buffer_index);
 
-				if (runtime_ptr->weight_outputs_count > 0 && !sdf_is_air) {
-					// We can skip this when SDF is air because there won't be any matter to give a texture to
-					// TODO Range analysis on that?
-					// Not easy to do that from here, they would have to ALL be locally constant in order to use a
-					// short-circuit...
-					for (unsigned int i = 0; i < runtime_ptr->weight_outputs_count; ++i) {
-						required_outputs.push_back(runtime_ptr->weight_output_indices[i]);
-					}
-				}
+			if (sdf_range.min > clip_threshold && sdf_range.max > clip_threshold) {
+				out_buffer.fill_area_f(air_sdf, rmin, rmax, sdf_channel);
+				sdf_is_air = true;
+				cache_entry.sdf_state = RangeAnalysisCache::SDF_AIR;
 
-				// TODO Instead of filling this ourselves, can we leave this to the graph runtime?
-				// Because currently our logic seems redundant and more complicated, since we also have to not request
-				// those outputs later if any other output isn't uniform. Instead, the graph runtime can figure out
-				// that stuff is constant.
-				bool single_texture_is_uniform = false;
-				if (runtime_ptr->single_texture_output_index != -1 && !sdf_is_air) {
-					const math::Interval index_range =
-							cache.state.get_range(runtime_ptr->single_texture_output_buffer_index);
-
-					if (index_range.is_single_value()) {
-						single_texture_is_uniform = true;
-						fill_texturing_data_from_single_texture_index(
-								out_buffer, static_cast<int>(index_range.min), rmin, rmax, _texture_mode
-						);
-					} else {
-						required_outputs.push_back(runtime_ptr->single_texture_output_index);
-					}
-				}
+			} else if (sdf_range.min < -clip_threshold && sdf_range.max < -clip_threshold) {
+				out_buffer.fill_area_f(matter_sdf, rmin, rmax, sdf_channel);
+				sdf_is_air = false;
+				sdf_is_matter = true;
+				cache_entry.sdf_state = RangeAnalysisCache::SDF_MATTER;
 
-				if (required_outputs.size() == 0) {
-					// We found all we need with range analysis, no need to calculate per voxel.
-					continue;
-				}
+			} else if (sdf_range.is_single_value()) {
+				out_buffer.fill_area_f(sdf_range.min, rmin, rmax, sdf_channel);
+				sdf_is_air = sdf_range.min > 0.f;
+				sdf_is_matter = !sdf_is_air;
+				cache_entry.sdf_state = RangeAnalysisCache::SDF_VALUE;
+				cache_entry.sdf_value = sdf_range.min;
 
-				// At least one channel needs per-voxel computation.
+			} else {
+				// SDF is not uniform, we'll need to compute it per voxel
+				required_outputs.push_back(runtime_ptr->sdf_output_index);
+				sdf_is_air = false;
+				sdf_is_uniform = false;
+			}
+		}
 
-				if (_use_optimized_execution_map) {
-					runtime.generate_optimized_execution_map(
-							cache.state, cache.optimized_execution_map, to_span(required_outputs), false
-					);
-				}
+		bool type_is_uniform = false;
+		if (type_output_buffer_index != -1) {
+			const math::Interval type_range = cache.state.get_range(type_output_buffer_index);
+			if (type_range.is_single_value()) {
+				out_buffer.fill_area(int(type_range.min), rmin, rmax, type_channel);
+				type_is_uniform = true;
+				cache_entry.type = int(type_range.min);
+			} else {
+				// Types are not uniform, we'll need to compute them per voxel
+				required_outputs.push_back(runtime_ptr->type_output_index);
+			}
+		}
 
-				{
-					unsigned int i = 0;
-					for (int rz = rmin.z, gz = gmin.z; rz < rmax.z; ++rz, gz += stride) {
-						for (int rx = rmin.x, gx = gmin.x; rx < rmax.x; ++rx, gx += stride) {
-							x_cache[i] = gx;
-							z_cache[i] = gz;
-							++i;
-						}
+		if (runtime_ptr->weight_outputs_count > 0 && !sdf_is_air) {
+			// We can skip this when SDF is air because there won't be any matter to give a texture to
+			// TODO Range analysis on that?
+			// Not easy to do that from here, they would have to ALL be locally constant in order to use a
+			// short-circuit...
+			for (unsigned int i = 0; i < runtime_ptr->weight_outputs_count; ++i) {
+				required_outputs.push_back(runtime_ptr->weight_output_indices[i]);
+			}
+		}
+
+		// TODO Instead of filling this ourselves, can we leave this to the graph runtime?
+		// Because currently our logic seems redundant and more complicated, since we also have to not request
+		// those outputs later if any other output isn't uniform. Instead, the graph runtime can figure out
+		// that stuff is constant.
+		bool single_texture_is_uniform = false;
+		if (runtime_ptr->single_texture_output_index != -1 && !sdf_is_air) {
+			const math::Interval index_range =
+					cache.state.get_range(runtime_ptr->single_texture_output_buffer_index);
+
+			if (index_range.is_single_value()) {
+				single_texture_is_uniform = true;
+				cache_entry.single_texture_index = static_cast<int>(index_range.min);
+				fill_texturing_data_from_single_texture_index(
+						out_buffer, cache_entry.single_texture_index, rmin, rmax, _texture_mode
+				);
+			} else {
+				required_outputs.push_back(runtime_ptr->single_texture_output_index);
+			}
+		}
+
+		if (use_adaptive_subdivision && section.size.x > _subdivision_size && required_outputs.size() > 0) {
+			// Per-voxel evaluation uses slice buffers sized for subdivisions, so areas requiring any output to be
+			// computed per voxel must be split until they reach that size. That includes weights, which are never
+			// found uniform, even when the SDF is.
+			const Vector3i half_size = section.size / 2;
+			for (int cz = 0; cz < 2; ++cz) {
+				for (int cy = 0; cy < 2; ++cy) {
+					for (int cx = 0; cx < 2; ++cx) {
+						sections.push_back(Box3i(rmin + Vector3i(cx, cy, cz) * half_size, half_size));
 					}
 				}
+			}
+			continue;
+		}
 
-				for (int ry = rmin.y, gy = gmin.y; ry < rmax.y; ++ry, gy += stride) {
-					ZN_PROFILE_SCOPE_NAMED("Full slice");
+		if (sdf_output_buffer_index != -1) {
+			all_sdf_is_air = all_sdf_is_air && sdf_is_air;
+			all_sdf_is_matter = all_sdf_is_matter && sdf_is_matter;
+		}
 
-					y_cache.fill(gy);
+		if (required_outputs.size() == 0) {
+			// We found all we need with range analysis, no need to calculate per voxel.
+			if (range_analysis_cache != nullptr) {
+				range_analysis_cache->add(gmin, section_world_size, cache_entry);
+			}
+			continue;
+		}
 
-					if (input_sdf_full_cache.size() != 0) {
-						// Copy input SDF using expected coordinate convention.
-						// VoxelBuffer is ZXY, but the graph runs in YXZ.
-						unsigned int i = 0;
-						for (int rz = rmin.z; rz < rmax.z; ++rz) {
-							for (int rx = rmin.x; rx < rmax.x; ++rx) {
-								const unsigned int loc = Vector3iUtil::get_zxy_index(rx, ry, rz, bs.x, bs.y);
-								input_sdf_slice_cache[i] = input_sdf_full_cache[loc];
-								++i;
-							}
-						}
-					}
+		// At least one channel needs per-voxel computation.
 
-					// Full query (unless using execution map)
-					{
-						QueryInputs<Span<const float>> query_inputs(
-								*runtime_ptr, x_cache, y_cache, z_cache, input_sdf_slice_cache
-						);
-						runtime.generate_set(
-								cache.state,
-								query_inputs.get(),
-								_use_xz_caching && ry != rmin.y,
-								_use_optimized_execution_map ? &cache.optimized_execution_map : nullptr
-						);
-					}
+		ZN_ASSERT(static_cast<unsigned int>(section.size.x * section.size.z) <= slice_buffer_size);
 
-					if (sdf_output_buffer_index != -1
-						// If SDF was found uniform, we already filled the results, and we did not require it in the
-						// query. But if another output exists, a query might still run (so we end up at this
-						// `if`), and we should not gather SDF results. Otherwise it would overwrite the slice with
-						// garbage since SDF was skipped.
-						// The same logic goes for other outputs: if they aren't in the query, we must not fill
-						// them.
-						&& !sdf_is_uniform) {
-						const pg::Runtime::Buffer &sdf_buffer = cache.state.get_buffer(sdf_output_buffer_index);
-						fill_zx_sdf_slice(
-								sdf_buffer, out_buffer, sdf_channel, sdf_channel_depth, sdf_scale, rmin, rmax, ry
-						);
-					}
+		if (_use_optimized_execution_map) {
+			runtime.generate_optimized_execution_map(
+					cache.state, cache.optimized_execution_map, to_span(required_outputs), false
+			);
+		}
 
-					if (type_output_buffer_index != -1 && !type_is_uniform) {
-						const pg::Runtime::Buffer &type_buffer = cache.state.get_buffer(type_output_buffer_index);
-						fill_zx_integer_slice(
-								type_buffer, out_buffer, type_channel, type_channel_depth, rmin, rmax, ry
-						);
-					}
+		{
+			unsigned int i = 0;
+			for (int rz = rmin.z, gz = gmin.z; rz < rmax.z; ++rz, gz += stride) {
+				for (int rx = rmin.x, gx = gmin.x; rx < rmax.x; ++rx, gx += stride) {
+					x_cache[i] = gx;
+					z_cache[i] = gz;
+					++i;
+				}
+			}
+		}
 
-					if (runtime_ptr->single_texture_output_index != -1 && !single_texture_is_uniform) {
-						gather_texturing_data_from_single_texture_output(
-								runtime_ptr->single_texture_output_buffer_index,
-								cache.state,
-								rmin,
-								rmax,
-								ry,
-								out_buffer,
-								_texture_mode
-						);
-					}
+		for (int ry = rmin.y, gy = gmin.y; ry < rmax.y; ++ry, gy += stride) {
+			ZN_PROFILE_SCOPE_NAMED("Full slice");
 
-					if (runtime_ptr->weight_outputs_count > 0) {
-						gather_texturing_data_from_weight_outputs(
-								to_span_const(runtime_ptr->weight_outputs, runtime_ptr->weight_outputs_count),
-								cache.state,
-								rmin,
-								rmax,
-								ry,
-								out_buffer,
-								spare_texture_indices,
-								_texture_mode
-						);
+			y_cache.fill(gy);
+
+			if (input_sdf_full_cache.size() != 0) {
+				// Copy input SDF using expected coordinate convention.
+				// VoxelBuffer is ZXY, but the graph runs in YXZ.
+				unsigned int i = 0;
+				for (int rz = rmin.z; rz < rmax.z; ++rz) {
+					for (int rx = rmin.x; rx < rmax.x; ++rx) {
+						const unsigned int loc = Vector3iUtil::get_zxy_index(rx, ry, rz, bs.x, bs.y);
+						input_sdf_slice_cache[i] = input_sdf_full_cache[loc];
+						++i;
 					}
 				}
 			}
+
+			// Full query (unless using execution map)
+			{
+				QueryInputs<Span<const float>> query_inputs(
+						*runtime_ptr, x_cache, y_cache, z_cache, input_sdf_slice_cache
+				);
+				runtime.generate_set(
+						cache.state,
+						query_inputs.get(),
+						_use_xz_caching && ry != rmin.y,
+						_use_optimized_execution_map ? &cache.optimized_execution_map : nullptr,
+						// Slices are laid out in rows along X
+						_use_xz_caching ? section.size.x : 0
+				);
+			}
+
+			if (sdf_output_buffer_index != -1
+				// If SDF was found uniform, we already filled the results, and we did not require it in the
+				// query. But if another output exists, a query might still run (so we end up at this
+				// `if`), and we should not gather SDF results. Otherwise it would overwrite the slice with
+				// garbage since SDF was skipped.
+				// The same logic goes for other outputs: if they aren't in the query, we must not fill
+				// them.
+				&& !sdf_is_uniform) {
+				const pg::Runtime::Buffer &sdf_buffer = cache.state.get_buffer(sdf_output_buffer_index);
+				fill_zx_sdf_slice(
+						sdf_buffer, out_buffer, sdf_channel, sdf_channel_depth, sdf_scale, rmin, rmax, ry
+				);
+			}
+
+			if (type_output_buffer_index != -1 && !type_is_uniform) {
+				const pg::Runtime::Buffer &type_buffer = cache.state.get_buffer(type_output_buffer_index);
+				fill_zx_integer_slice(
+						type_buffer, out_buffer, type_channel, type_channel_depth, rmin, rmax, ry
+				);
+			}
+
+			if (runtime_ptr->single_texture_output_index != -1 && !single_texture_is_uniform) {
+				gather_texturing_data_from_single_texture_output(
+						runtime_ptr->single_texture_output_buffer_index,
+						cache.state,
+						rmin,
+						rmax,
+						ry,
+						out_buffer,
+						_texture_mode
+				);
+			}
+
+			if (runtime_ptr->weight_outputs_count > 0) {
+				gather_texturing_data_from_weight_outputs(
+						to_span_const(runtime_ptr->weight_outputs, runtime_ptr->weight_outputs_count),
+						cache.state,
+						rmin,
+						rmax,
+						ry,
+						out_buffer,
+						spare_texture_indices,
+						_texture_mode
+				);
+			}
 		}
 	}
 
@@ -1154,6 +1266,7 @@ pg::CompilationResult VoxelGeneratorGraph::compile(bool debug) {
 	// TODO This bypasses VoxelGraphFunction's compiling method, we should probably use it now
 	// Core compilation
 	pg::Runtime &runtime = r->runtime;
+	runtime.set_deterministic(_deterministic);
 	const pg::CompilationResult result = runtime.compile(**_main_function, debug);
 
 	if (!result.success) {
@@ -1339,17 +1452,18 @@ void VoxelGeneratorGraph::generate_set(Span<const float> in_x, Span<const float>
 	Cache &cache = get_tls_cache();
 	pg::Runtime &runtime = _runtime->runtime;
 
+	const bool has_sdf_input = _runtime->sdf_input_index != -1;
+	runtime.prepare_state(cache.state, in_x.size(), false, has_sdf_input ? in_x.size() : 0);
+
 	Span<float> in_sdf;
-	if (_runtime->sdf_input_index != -1) {
+	if (has_sdf_input) {
 		// Support graphs having an SDF input, give it default values
-		cache.input_sdf_full_cache.resize(in_x.size());
-		in_sdf = to_span(cache.input_sdf_full_cache);
+		in_sdf = cache.state.allocate_scratch(in_x.size());
 		in_sdf.fill(0.f);
 	}
 
 	QueryInputs<Span<const float>> inputs(*_runtime, in_x, in_y, in_z, in_sdf);
 
-	runtime.prepare_state(cache.state, in_x.size(), false);
 	runtime.generate_set(cache.state, inputs.get(), false, nullptr);
 	// Note, when generating SDF, we don't scale it because the return values are uncompressed floats. Scale only
 	// matters if we are storing it inside 16-bit or 8-bit VoxelBuffer.
@@ -1429,6 +1543,124 @@ void VoxelGeneratorGraph::generate_series(
 	memcpy(out_values.data(), buffer.data, sizeof(float) * out_values.size());
 }
 
+void VoxelGeneratorGraph::generate_points(
+		Span<const float> positions_x,
+		Span<const float> positions_y,
+		Span<const float> positions_z,
+		uint32_t channels_mask,
+		PointsOutput out
+) {
+	ZN_PROFILE_SCOPE();
+
+	const unsigned int point_count = positions_x.size();
+	ZN_ASSERT_RETURN(positions_y.size() == point_count);
+	ZN_ASSERT_RETURN(positions_z.size() == point_count);
+
+	struct ChannelOutput {
+		Span<float> values;
+		int output_index;
+		int buffer_index;
+		float default_value;
+	};
+
+	std::shared_ptr<const Runtime> runtime_ptr;
+	{
+		RWLockRead rlock(_runtime_lock);
+		runtime_ptr = _runtime;
+	}
+	if (runtime_ptr == nullptr) {
+		ZN_PRINT_ERROR_ONCE("No compiled graph available");
+		return;
+	}
+
+	const ChannelOutput candidates[] = {
+		{ out.sdf, runtime_ptr->sdf_output_index, runtime_ptr->sdf_output_buffer_index, constants::SDF_FAR_OUTSIDE },
+		{ out.type, runtime_ptr->type_output_index, runtime_ptr->type_output_buffer_index, 0.f },
+		{ out.single_texture,
+		  runtime_ptr->single_texture_output_index,
+		  runtime_ptr->single_texture_output_buffer_index,
+		  0.f },
+	};
+	const uint32_t candidate_channels[] = {
+		VoxelBuffer::CHANNEL_SDF, VoxelBuffer::CHANNEL_TYPE, VoxelBuffer::CHANNEL_INDICES
+	};
+
+	FixedArray<ChannelOutput, 3> channel_outputs;
+	unsigned int channel_outputs_count = 0;
+
+	for (unsigned int i = 0; i < channel_outputs.size(); ++i) {
+		if ((channels_mask & (1 << candidate_channels[i])) == 0) {
+			continue;
+		}
+		const ChannelOutput &co = candidates[i];
+		ZN_ASSERT_RETURN(co.values.size() == point_count);
+		if (co.buffer_index == -1) {
+			// The graph does not define such output
+			co.values.fill(co.default_value);
+			continue;
+		}
+		channel_outputs[channel_outputs_count] = co;
+		++channel_outputs_count;
+	}
+
+	if (channel_outputs_count == 0 || point_count == 0) {
+		return;
+	}
+
+	Cache &cache = get_tls_cache();
+	const pg::Runtime &runtime = runtime_ptr->runtime;
+
+	// Only run operations needed by the requested channels
+	const pg::Runtime::ExecutionMap *execution_map = nullptr;
+	if (channel_outputs_count < runtime.get_output_count()) {
+		FixedArray<unsigned int, 3> required_outputs;
+		for (unsigned int i = 0; i < channel_outputs_count; ++i) {
+			required_outputs[i] = channel_outputs[i].output_index;
+		}
+		runtime.generate_execution_map_for_outputs(
+				cache.points_execution_map, to_span_const(required_outputs, channel_outputs_count)
+		);
+		execution_map = &cache.points_execution_map;
+	}
+
+	// Process points in chunks so the size of the state stays bounded regardless of the number of points
+	const unsigned int chunk_size = 4096;
+
+	for (unsigned int chunk_begin = 0; chunk_begin < point_count; chunk_begin += chunk_size) {
+		const unsigned int count = math::min(chunk_size, point_count - chunk_begin);
+
+		const bool has_sdf_input = runtime_ptr->sdf_input_index != -1;
+		runtime.prepare_state(cache.state, count, false, has_sdf_input ? count : 0);
+
+		Span<float> in_sdf;
+		if (has_sdf_input) {
+			// Support graphs having an SDF input, give it default values
+			in_sdf = cache.state.allocate_scratch(count);
+			in_sdf.fill(0.f);
+		}
+
+		QueryInputs<Span<const float>> inputs(
+				*runtime_ptr,
+				positions_x.sub(chunk_begin, count),
+				positions_y.sub(chunk_begin, count),
+				positions_z.sub(chunk_begin, count),
+				in_sdf
+		);
+
+		runtime.generate_set(cache.state, inputs.get(), false, execution_map);
+
+		for (unsigned int i = 0; i < channel_outputs_count; ++i) {
+			const ChannelOutput &co = channel_outputs[i];
+			const pg::Runtime::Buffer &buffer = cache.state.get_buffer(co.buffer_index);
+			if (buffer.is_constant) {
+				co.values.sub(chunk_begin, count).fill(buffer.constant_value);
+			} else {
+				memcpy(co.values.data() + chunk_begin, buffer.data, sizeof(float) * count);
+			}
+		}
+	}
+}
+
 const pg::Runtime::State &VoxelGeneratorGraph::get_last_state_from_current_thread() {
 	return get_tls_cache().state;
 }
@@ -2235,6 +2467,61 @@ Vector2 VoxelGeneratorGraph::_b_debug_analyze_range(Vector3 min_pos, Vector3 max
 	return Vector2(r.min, r.max);
 }
 
+Dictionary VoxelGeneratorGraph::_b_generate_points(PackedVector3Array positions, int channels_mask) {
+	const unsigned int count = positions.size();
+
+	StdVector<float> x;
+	StdVector<float> y;
+	StdVector<float> z;
+	x.resize(count);
+	y.resize(count);
+	z.resize(count);
+	{
+		Span<const Vector3> positions_s = to_span(positions);
+		for (unsigned int i = 0; i < count; ++i) {
+			const Vector3 p = positions_s[i];
+			x[i] = p.x;
+			y[i] = p.y;
+			z[i] = p.z;
+		}
+	}
+
+	const uint32_t supported_channels = (1 << VoxelBuffer::CHANNEL_SDF) | (1 << VoxelBuffer::CHANNEL_TYPE) |
+			(1 << VoxelBuffer::CHANNEL_INDICES);
+	ERR_FAIL_COND_V_MSG((channels_mask & ~supported_channels) != 0, Dictionary(), "Unsupported channels requested");
+
+	PackedFloat32Array sdf;
+	PackedFloat32Array type;
+	PackedFloat32Array single_texture;
+	PointsOutput out;
+	if ((channels_mask & (1 << VoxelBuffer::CHANNEL_SDF)) != 0) {
+		sdf.resize(count);
+		out.sdf = Span<float>(sdf.ptrw(), count);
+	}
+	if ((channels_mask & (1 << VoxelBuffer::CHANNEL_TYPE)) != 0) {
+		type.resize(count);
+		out.type = Span<float>(type.ptrw(), count);
+	}
+	if ((channels_mask & (1 << VoxelBuffer::CHANNEL_INDICES)) != 0) {
+		single_texture.resize(count);
+		out.single_texture = Span<float>(single_texture.ptrw(), count);
+	}
+
+	generate_points(to_span_const(x), to_span_const(y), to_span_const(z), channels_mask, out);
+
+	Dictionary d;
+	if ((channels_mask & (1 << VoxelBuffer::CHANNEL_SDF)) != 0) {
+		d[VoxelBuffer::CHANNEL_SDF] = sdf;
+	}
+	if ((channels_mask & (1 << VoxelBuffer::CHANNEL_TYPE)) != 0) {
+		d[VoxelBuffer::CHANNEL_TYPE] = type;
+	}
+	if ((channels_mask & (1 << VoxelBuffer::CHANNEL_INDICES)) != 0) {
+		d[VoxelBuffer::CHANNEL_INDICES] = single_texture;
+	}
+	return d;
+}
+
 Dictionary VoxelGeneratorGraph::_b_compile() {
 	pg::CompilationResult res = compile(false);
 	Dictionary d;
@@ -2246,11 +2533,38 @@ Dictionary VoxelGeneratorGraph::_b_compile() {
 	return d;
 }
 
+String VoxelGeneratorGraph::_b_generate_cpp_source(String function_name) const {
+	ERR_FAIL_COND_V(_main_function.is_null(), String());
+	ERR_FAIL_COND_V(function_name.is_empty(), String());
+	StdString code;
+	StdVector<pg::ShaderOutput> outputs;
+	const pg::CompilationResult res = pg::generate_cpp(
+			_main_function->get_graph(),
+			_main_function->get_input_definitions(),
+			zylann::godot::to_std_string(function_name),
+			code,
+			outputs
+	);
+	ERR_FAIL_COND_V_MSG(!res.success, String(), res.message);
+	return String::utf8(code.c_str());
+}
+
 float VoxelGeneratorGraph::_b_debug_measure_microseconds_per_voxel(bool singular) {
 	return debug_measure_microseconds_per_voxel(singular, nullptr);
 }
 
 void VoxelGeneratorGraph::_on_subresource_changed() {
+	// Resources used by the graph (like noise) can change without the graph being compiled again, so results of range
+	// analysis are no longer valid
+	std::shared_ptr<Runtime> runtime_ptr;
+	{
+		RWLockRead rlock(_runtime_lock);
+		runtime_ptr = _runtime;
+	}
+	if (runtime_ptr != nullptr) {
+		runtime_ptr->range_analysis_cache.clear();
+	}
+
 	emit_changed();
 }
 
@@ -2286,6 +2600,9 @@ void VoxelGeneratorGraph::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_subdivision_size", "size"), &Self::set_subdivision_size);
 	ClassDB::bind_method(D_METHOD("get_subdivision_size"), &Self::get_subdivision_size);
 
+	ClassDB::bind_method(D_METHOD("set_use_adaptive_subdivision", "use"), &Self::set_use_adaptive_subdivision);
+	ClassDB::bind_method(D_METHOD("is_using_adaptive_subdivision"), &Self::is_using_adaptive_subdivision);
+
 	ClassDB::bind_method(D_METHOD("set_debug_clipped_blocks", "enabled"), &Self::set_debug_clipped_blocks);
 	ClassDB::bind_method(D_METHOD("is_debug_clipped_blocks"), &Self::is_debug_clipped_blocks);
 
@@ -2295,9 +2612,14 @@ void VoxelGeneratorGraph::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_texture_mode", "mode"), &Self::set_texture_mode);
 	ClassDB::bind_method(D_METHOD("get_texture_mode"), &Self::get_texture_mode);
 
+	ClassDB::bind_method(D_METHOD("set_deterministic", "enabled"), &Self::set_deterministic);
+	ClassDB::bind_method(D_METHOD("is_deterministic"), &Self::is_deterministic);
+
 	ClassDB::bind_method(D_METHOD("compile"), &Self::_b_compile);
+	ClassDB::bind_method(D_METHOD("generate_cpp_source", "function_name"), &Self::_b_generate_cpp_source);
 
 	// ClassDB::bind_method(D_METHOD("generate_single"), &Self::_b_generate_single);
+	ClassDB::bind_method(D_METHOD("generate_points", "positions", "channels_mask"), &Self::_b_generate_points);
 	ClassDB::bind_method(D_METHOD("debug_analyze_range", "min_pos", "max_pos"), &Self::_b_debug_analyze_range);
 
 	ClassDB::bind_method(
@@ -2339,6 +2661,8 @@ void VoxelGeneratorGraph::_bind_methods() {
 			"get_texture_mode"
 	);
 
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "deterministic"), "set_deterministic", "is_deterministic");
+
 	ADD_GROUP("Performance Tuning", "");
 
 	ADD_PROPERTY(
@@ -2351,6 +2675,11 @@ void VoxelGeneratorGraph::_bind_methods() {
 	);
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_subdivision"), "set_use_subdivision", "is_using_subdivision");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "subdivision_size"), "set_subdivision_size", "get_subdivision_size");
+	ADD_PROPERTY(
+			PropertyInfo(Variant::BOOL, "use_adaptive_subdivision"),
+			"set_use_adaptive_subdivision",
+			"is_using_adaptive_subdivision"
+	);
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_xz_caching"), "set_use_xz_caching", "is_using_xz_caching");
 	ADD_PROPERTY(
 			PropertyInfo(Variant::BOOL, "debug_block_clipping"), "set_debug_clipped_blocks", "is_debug_clipped_blocks"
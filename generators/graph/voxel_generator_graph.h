@@ -6,6 +6,7 @@
 #include "../../util/containers/std_vector.h"
 #include "../../util/godot/core/dictionary.h"
 #include "../../util/macros.h"
+#include "../../util/math/box3i.h"
 #include "../../util/math/vector2.h"
 #include "../../util/math/vector3.h"
 #include "../../util/math/vector3f.h"
@@ -13,6 +14,7 @@
 #include "../../util/thread/rw_lock.h"
 #include "../voxel_generator.h"
 #include "program_graph.h"
+#include "range_analysis_cache.h"
 #include "voxel_graph_function.h"
 #include "voxel_graph_runtime.h"
 
@@ -61,6 +63,9 @@ public:
 	void set_subdivision_size(int size);
 	int get_subdivision_size() const;
 
+	void set_use_adaptive_subdivision(bool use);
+	bool is_using_adaptive_subdivision() const;
+
 	void set_debug_clipped_blocks(bool enabled);
 	bool is_debug_clipped_blocks() const;
 
@@ -70,6 +75,10 @@ public:
 	void set_texture_mode(const TextureMode mode);
 	TextureMode get_texture_mode() const;
 
+	// Takes effect the next time the graph is compiled
+	void set_deterministic(bool enabled);
+	bool is_deterministic() const;
+
 	// VoxelGenerator implementation
 
 	int get_used_channels_mask() const override;
@@ -95,6 +104,26 @@ public:
 			Vector3f max_pos
 	) override;
 
+	// Results of `generate_points`, one array per channel, each as large as the number of positions. Arrays of
+	// channels that were not requested can be left empty.
+	struct PointsOutput {
+		Span<float> sdf;
+		Span<float> type;
+		// Raw output of the single texture node, not encoded
+		Span<float> single_texture;
+	};
+
+	// Evaluates the graph at arbitrary positions. It is faster than `generate_single` when querying many points, and
+	// doesn't use range analysis, which wouldn't help with scattered points. Only operations contributing to channels
+	// in `channels_mask` (bits of `VoxelBuffer::ChannelId`) are run. Can be called from multiple threads.
+	void generate_points(
+			Span<const float> positions_x,
+			Span<const float> positions_y,
+			Span<const float> positions_z,
+			uint32_t channels_mask,
+			PointsOutput out
+	);
+
 	// Ref<Resource> duplicate(bool p_subresources) const ZN_OVERRIDE_UNLESS_GODOT_EXTENSION;
 
 	// Utility
@@ -155,8 +184,10 @@ public:
 private:
 	void _on_subresource_changed();
 	float _b_generate_single(Vector3 pos);
+	Dictionary _b_generate_points(PackedVector3Array positions, int channels_mask);
 	Vector2 _b_debug_analyze_range(Vector3 min_pos, Vector3 max_pos) const;
 	Dictionary _b_compile();
+	String _b_generate_cpp_source(String function_name) const;
 	float _b_debug_measure_microseconds_per_voxel(bool singular);
 #ifdef TOOLS_ENABLED
 	// This exists because some custom editors will edit an internal object instead of the resource itself
@@ -199,16 +230,24 @@ private:
 	// Blocks size must be a multiple of the subdivision size.
 	bool _use_subdivision = true;
 	int _subdivision_size = 16;
+	// When enabled, blocks are split octree-style starting from their full size, and only areas that range analysis
+	// can't resolve get split further, down to the subdivision size. Far LOD blocks are often entirely air or matter,
+	// so they can be filled after very few analyses.
+	bool _use_adaptive_subdivision = false;
 	// When enabled, the generator will attempt to optimize out nodes that don't need to run in specific areas,
 	// if their output range is considered to not affect the final result.
 	bool _use_optimized_execution_map = true;
 	// When enabled, nodes using only the X and Z coordinates will be cached when generating blocks in slices along Y.
 	// This prevents recalculating values that would otherwise be the same on each slice.
 	// It helps a lot when part of the graph is generating a heightmap for example.
+	// Nodes using only Y also run once per slice, and nodes using only X and Y run once per row of a slice.
 	bool _use_xz_caching = true;
 	// If true, inverts clipped blocks so they create visual artifacts making the clipped area visible.
 	bool _debug_clipped_blocks = false;
 	TextureMode _texture_mode = TEXTURE_MODE_MIXEL4;
+	// If true, the graph is compiled so it produces bit-identical results on every platform, at some performance cost.
+	// Useful when several machines must generate the same terrain, like a server and its clients.
+	bool _deterministic = false;
 
 	// Only compiling and generation methods are thread-safe.
 
@@ -239,6 +278,10 @@ private:
 		// List of indices to feed queries. The order doesn't matter, can be different from `weight_outputs`.
 		FixedArray<unsigned int, 16> weight_output_indices;
 		unsigned int weight_outputs_count = 0;
+
+		// Sections of blocks previously found uniform. Belongs to the runtime so it gets discarded when the graph is
+		// compiled again.
+		RangeAnalysisCache range_analysis_cache;
 	};
 
 	// Helper to setup inputs for runtime queries
@@ -272,14 +315,14 @@ private:
 	RWLock _runtime_lock;
 
 	struct Cache {
-		StdVector<float> x_cache;
-		StdVector<float> y_cache;
-		StdVector<float> z_cache;
-		StdVector<float> input_sdf_slice_cache;
-		StdVector<float> input_sdf_full_cache;
 		// TODO Use the runtime and state from `VoxelGraphFunction`
+		// Also provides scratch memory for inputs
 		pg::Runtime::State state;
 		pg::Runtime::ExecutionMap optimized_execution_map;
+		// Sections of the block left to process
+		StdVector<Box3i> sections;
+		// Operations needed by the channels requested in `generate_points`
+		pg::Runtime::ExecutionMap points_execution_map;
 	};
 
 	static Cache &get_tls_cache();
@@ -310,7 +310,8 @@ CompilationResult expand_expression_node(
 		uint32_t original_node_id,
 		ProgramGraph::PortLocation &expanded_output_port,
 		StdVector<uint32_t> &expanded_nodes,
-		const NodeTypeDB &type_db
+		const NodeTypeDB &type_db,
+		const bool fold_constants
 ) {
 	ZN_PROFILE_SCOPE();
 	const ProgramGraph::Node &original_node = graph.get_node(original_node_id);
@@ -322,7 +323,10 @@ CompilationResult expand_expression_node(
 
 	// Extract the AST, so we can convert it into graph nodes,
 	// and benefit from all features of range analysis and buffer processing
-	ExpressionParser::Result parse_result = ExpressionParser::parse(code_utf8.get_data(), functions);
+	// Constants are not folded when constant reduction is off, because folding evaluates functions with their
+	// expression callbacks, which aren't deterministic implementations
+	ExpressionParser::Result parse_result =
+			ExpressionParser::parse(code_utf8.get_data(), functions, fold_constants);
 
 	if (parse_result.error.id != ExpressionParser::ERROR_NONE) {
 		// Error in expression
@@ -396,7 +400,8 @@ CompilationResult expand_expression_node(
 CompilationResult expand_expression_nodes(
 		ProgramGraph &graph,
 		const NodeTypeDB &type_db,
-		GraphRemappingInfo *remap_info
+		GraphRemappingInfo *remap_info,
+		const bool fold_constants
 ) {
 	ZN_PROFILE_SCOPE();
 	const unsigned int initial_node_count = graph.get_nodes_count();
@@ -414,8 +419,9 @@ CompilationResult expand_expression_nodes(
 	for (const uint32_t node_id : expression_node_ids) {
 		ProgramGraph::PortLocation expanded_output_port;
 		expanded_node_ids.clear();
-		const CompilationResult result =
-				expand_expression_node(graph, node_id, expanded_output_port, expanded_node_ids, type_db);
+		const CompilationResult result = expand_expression_node(
+				graph, node_id, expanded_output_port, expanded_node_ids, type_db, fold_constants
+		);
 		if (!result.success) {
 			return result;
 		}
@@ -1279,7 +1285,7 @@ CompilationResult evaluate_single_node(
 		Span<const uint8_t> params_s = Runtime::read_params(program_s, pc);
 
 		pg::Runtime::ProcessBufferContext ctx(
-				to_span(input_indices), to_span(output_indices), params_s, to_span(buffers), false
+				to_span(input_indices), to_span(output_indices), params_s, to_span(buffers), false, false
 		);
 		node_type.process_buffer_func(ctx);
 	}
@@ -1389,7 +1395,8 @@ CompilationResult expand_graph(
 
 	remove_relays(expanded_graph, remap_info);
 
-	const CompilationResult expr_expand_result = expand_expression_nodes(expanded_graph, type_db, remap_info);
+	const CompilationResult expr_expand_result =
+			expand_expression_nodes(expanded_graph, type_db, remap_info, enable_constant_reduction);
 	if (!expr_expand_result.success) {
 		return expr_expand_result;
 	}
@@ -1421,8 +1428,16 @@ CompilationResult Runtime::compile(const VoxelGraphFunction &function, bool debu
 	ProgramGraph expanded_graph;
 	StdVector<uint32_t> input_node_ids;
 	Span<const VoxelGraphFunction::Port> input_defs = function.get_input_definitions();
+	// Constant reduction evaluates nodes once at compile time, not in deterministic mode
+	const bool enable_constant_reduction = !debug && !_deterministic;
 	CompilationResult expand_result = expand_graph(
-			function.get_graph(), expanded_graph, input_defs, &input_node_ids, type_db, &remap_info, !debug
+			function.get_graph(),
+			expanded_graph,
+			input_defs,
+			&input_node_ids,
+			type_db,
+			&remap_info,
+			enable_constant_reduction
 	);
 	if (!expand_result.success) {
 		expand_result.node_id = get_original_node_id(remap_info, expand_result.node_id);
@@ -1611,6 +1626,8 @@ CompilationResult Runtime::compile_preprocessed_graph(
 	StdVector<uint16_t> &operations = program.operations;
 	StdUnorderedMap<uint32_t, uint32_t> node_id_to_dependency_graph;
 	StdVector<uint16_t> input_buffer_indices;
+	// Dependency graph node of each operation of the default execution map
+	StdVector<uint32_t> default_operation_dependency_graph_nodes;
 
 	// Allocate input slots
 	// Note, even if an input isn't connected to anything, it still gets its binding space (but it won't be in `order`).
@@ -1724,6 +1741,7 @@ CompilationResult Runtime::compile_preprocessed_graph(
 		program.default_execution_map.operations.push_back(
 				ExecutionMap::OperationInfo{ uint16_t(operations.size()), 0 }
 		);
+		default_operation_dependency_graph_nodes.push_back(dg_node_index);
 		if (debug) {
 			// Will be remapped later if the node is an expanded one
 			program.default_execution_map.debug_nodes.push_back(node_id);
@@ -1863,6 +1881,89 @@ CompilationResult Runtime::compile_preprocessed_graph(
 
 	program.buffer_count = mem.next_address;
 
+	// Find which coordinates each operation depends on, so when blocks are generated in slices along Y, some of them
+	// can run on fewer positions
+	{
+		const uint8_t AXIS_X = 1;
+		const uint8_t AXIS_Y = 2;
+		const uint8_t AXIS_Z = 4;
+
+		Span<DependencyGraph::Node> dg_nodes = to_span(program.dependency_graph.nodes);
+		Span<const uint16_t> dg_dependencies = to_span_const(program.dependency_graph.dependencies);
+		StdVector<uint8_t> node_axes;
+		node_axes.resize(dg_nodes.size(), 0);
+
+		// Nodes are in execution order, so dependencies are visited first
+		for (unsigned int dg_node_index = 0; dg_node_index < dg_nodes.size(); ++dg_node_index) {
+			DependencyGraph::Node &dg_node = dg_nodes[dg_node_index];
+			uint8_t axes = 0;
+
+			if (dg_node.is_input) {
+				switch (graph.get_node(dg_node.debug_node_id).type_id) {
+					case VoxelGraphFunction::NODE_CONSTANT:
+						break;
+					case VoxelGraphFunction::NODE_INPUT_X:
+						axes = AXIS_X;
+						break;
+					case VoxelGraphFunction::NODE_INPUT_Y:
+						axes = AXIS_Y;
+						break;
+					case VoxelGraphFunction::NODE_INPUT_Z:
+						axes = AXIS_Z;
+						break;
+					default:
+						// Other inputs may vary in any direction
+						axes = AXIS_X | AXIS_Y | AXIS_Z;
+						break;
+				}
+			} else {
+				for (unsigned int i = dg_node.first_dependency; i < dg_node.end_dependency; ++i) {
+					axes |= node_axes[dg_dependencies[i]];
+				}
+			}
+
+			node_axes[dg_node_index] = axes;
+
+			if (axes == AXIS_Y) {
+				dg_node.slice_evaluation = SLICE_EVALUATION_SINGLE;
+			} else if (axes == (AXIS_X | AXIS_Y)) {
+				dg_node.slice_evaluation = SLICE_EVALUATION_ROW;
+			} else {
+				// Operations that don't depend on Y already run once per block when using the outer group
+				// optimization
+				dg_node.slice_evaluation = SLICE_EVALUATION_FULL;
+			}
+			dg_node.broadcast_outputs = false;
+		}
+
+		// Results of operations running on fewer positions must be repeated if other operations need more of them
+		for (const DependencyGraph::Node &dg_node : dg_nodes) {
+			if (dg_node.is_input) {
+				continue;
+			}
+			for (unsigned int i = dg_node.first_dependency; i < dg_node.end_dependency; ++i) {
+				DependencyGraph::Node &dependency = dg_nodes[dg_dependencies[i]];
+				if (!dependency.is_input && dependency.slice_evaluation != SLICE_EVALUATION_FULL &&
+					dependency.slice_evaluation != dg_node.slice_evaluation) {
+					dependency.broadcast_outputs = true;
+				}
+			}
+		}
+		// Outputs are read by the caller over the whole slice
+		for (unsigned int i = 0; i < program.outputs_count; ++i) {
+			DependencyGraph::Node &dg_node = dg_nodes[program.outputs[i].dependency_graph_node_index];
+			dg_node.broadcast_outputs = dg_node.slice_evaluation != SLICE_EVALUATION_FULL;
+		}
+
+		ZN_ASSERT(default_operation_dependency_graph_nodes.size() == program.default_execution_map.operations.size());
+		for (unsigned int i = 0; i < program.default_execution_map.operations.size(); ++i) {
+			ExecutionMap::OperationInfo &op_info = program.default_execution_map.operations[i];
+			const DependencyGraph::Node &dg_node = dg_nodes[default_operation_dependency_graph_nodes[i]];
+			op_info.slice_evaluation = dg_node.slice_evaluation;
+			op_info.broadcast_outputs = dg_node.broadcast_outputs;
+		}
+	}
+
 	// Pin buffers from the outer group that are read by operations of the inner group.
 	// Buffer data coming from the outer group must be pinned if it is read by the inner group,
 	// because it is re-used across multiple executions.
@@ -1966,6 +2067,27 @@ CompilationResult Runtime::compile_preprocessed_graph(
 				}
 			}
 
+			// Releases references on input datas, so they can be re-used by later operations
+			auto unref_input_datas = [&program, buffer_specs, &data_helper](const ProgramGraph::Node &node) {
+				for (const ProgramGraph::Port &input : node.inputs) {
+					if (input.connections.size() == 0) {
+						continue;
+					}
+					const ProgramGraph::PortLocation src_port = input.connections[0];
+					auto address_it = program.output_port_addresses.find(src_port);
+					ZN_ASSERT(address_it != program.output_port_addresses.end());
+					const BufferSpec &buffer_spec = buffer_specs[address_it->second];
+
+					// Bindings are user-provided.
+					// Pinned buffers are never re-used.
+					if (buffer_spec.is_binding || buffer_spec.is_pinned) {
+						continue;
+					}
+
+					data_helper.unref(buffer_spec.data_index);
+				}
+			};
+
 			// Allocate re-usable buffers.
 			// Run through every node in execution order, allocating buffers when they are needed using pooling logic,
 			// so we can precompute which buffers will actually be needed in total, ahead of running the generator.
@@ -1975,6 +2097,12 @@ CompilationResult Runtime::compile_preprocessed_graph(
 				const ProgramGraph::Node &node = graph.get_node(node_id);
 				const NodeType &type = type_db.get_type(node.type_id);
 
+				// Elementwise nodes can write their results in the data of inputs they are the last user of, so we
+				// release inputs first. Other nodes must not overwrite inputs they may still read.
+				if (type.is_elementwise) {
+					unref_input_datas(node);
+				}
+
 				uint16_t throwaway_data_index = 0;
 				bool has_throwaway_data = false;
 
@@ -2009,23 +2137,8 @@ CompilationResult Runtime::compile_preprocessed_graph(
 					data_helper.unref(throwaway_data_index);
 				}
 
-				// Release references on input datas, so they can be re-used by later operations
-				for (const ProgramGraph::Port &input : node.inputs) {
-					if (input.connections.size() == 0) {
-						continue;
-					}
-					const ProgramGraph::PortLocation src_port = input.connections[0];
-					auto address_it = program.output_port_addresses.find(src_port);
-					ZN_ASSERT(address_it != program.output_port_addresses.end());
-					const BufferSpec &buffer_spec = buffer_specs[address_it->second];
-
-					// Bindings are user-provided.
-					// Pinned buffers are never re-used.
-					if (buffer_spec.is_binding || buffer_spec.is_pinned) {
-						continue;
-					}
-
-					data_helper.unref(buffer_spec.data_index);
+				if (!type.is_elementwise) {
+					unref_input_datas(node);
 				}
 			}
 		}
@@ -0,0 +1,136 @@
+#include "voxel_graph_cpp_generator.h"
+#include "../../util/profiling.h"
+#include "../../util/string/format.h"
+#include "../../util/string/std_stringstream.h"
+#include "code_gen_helper.h"
+#include "voxel_graph_shader_generator.h"
+#include <algorithm>
+
+namespace zylann::voxel::pg {
+
+namespace {
+
+// Implements the subset of GLSL used by nodes. Generated code lives in a namespace nested in `vg`, so these functions
+// are found before those of the global namespace.
+const char *g_prelude = //
+		"#ifndef VG_CPP_PRELUDE\n"
+		"#define VG_CPP_PRELUDE\n"
+		"\n"
+		"#include <cmath>\n"
+		"\n"
+		"namespace vg {\n"
+		"\n"
+		"struct vec2 {\n"
+		"	float x;\n"
+		"	float y;\n"
+		"	vec2(float p_x, float p_y) : x(p_x), y(p_y) {}\n"
+		"};\n"
+		"\n"
+		"struct vec3 {\n"
+		"	float x;\n"
+		"	float y;\n"
+		"	float z;\n"
+		"	vec3(float p_x, float p_y, float p_z) : x(p_x), y(p_y), z(p_z) {}\n"
+		"};\n"
+		"\n"
+		"inline vec3 operator-(vec3 a, vec3 b) { return vec3(a.x - b.x, a.y - b.y, a.z - b.z); }\n"
+		"\n"
+		"inline float abs(float x) { return std::abs(x); }\n"
+		"inline float floor(float x) { return std::floor(x); }\n"
+		"inline float fract(float x) { return x - std::floor(x); }\n"
+		"inline float sqrt(float x) { return std::sqrt(x); }\n"
+		"inline float sin(float x) { return std::sin(x); }\n"
+		"inline float pow(float x, float p) { return std::pow(x, p); }\n"
+		"inline float min(float a, float b) { return a < b ? a : b; }\n"
+		"inline float max(float a, float b) { return a > b ? a : b; }\n"
+		"inline float clamp(float x, float lo, float hi) { return min(max(x, lo), hi); }\n"
+		"inline float mix(float a, float b, float t) { return a + t * (b - a); }\n"
+		"inline float smoothstep(float e0, float e1, float x) {\n"
+		"	const float t = clamp((x - e0) / (e1 - e0), 0.f, 1.f);\n"
+		"	return t * t * (3.f - 2.f * t);\n"
+		"}\n"
+		"\n"
+		"inline vec3 abs(vec3 v) { return vec3(abs(v.x), abs(v.y), abs(v.z)); }\n"
+		"inline vec3 max(vec3 v, float m) { return vec3(max(v.x, m), max(v.y, m), max(v.z, m)); }\n"
+		"inline float length(vec2 v) { return std::sqrt(v.x * v.x + v.y * v.y); }\n"
+		"inline float length(vec3 v) { return std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z); }\n"
+		"inline float distance(vec2 a, vec2 b) { return length(vec2(b.x - a.x, b.y - a.y)); }\n"
+		"inline float distance(vec3 a, vec3 b) { return length(b - a); }\n"
+		"\n"
+		"} // namespace vg\n"
+		"\n"
+		"#endif // VG_CPP_PRELUDE\n";
+
+} // namespace
+
+CompilationResult generate_cpp(
+		const ProgramGraph &p_graph,
+		Span<const VoxelGraphFunction::Port> input_defs,
+		const StdString &function_name,
+		StdString &out_source_code,
+		StdVector<ShaderOutput> &out_outputs
+) {
+	ZN_PROFILE_SCOPE();
+
+	StdStringStream main_ss;
+	StdStringStream lib_ss;
+	CodeGenHelper codegen(main_ss, lib_ss);
+
+	// Resources can't be used, so this is expected to remain empty
+	StdVector<ShaderParameter> uniforms;
+
+	codegen.add("inline ");
+
+	const CompilationResult result = generate_function(
+			p_graph,
+			input_defs,
+			CODE_GEN_CPP,
+			codegen,
+			uniforms,
+			out_outputs,
+			Span<const VoxelGraphFunction::NodeTypeID>()
+	);
+	if (!result.success) {
+		return result;
+	}
+	ZN_ASSERT(uniforms.size() == 0);
+
+	StdString function_code;
+	codegen.print(function_code);
+
+	StdStringStream ss;
+	ss << "// Generated from a voxel graph. Changes will be lost if the graph is generated again.\n\n";
+	ss << g_prelude;
+	ss << "\nnamespace vg {\nnamespace " << function_name << "_impl {\n";
+	ss << function_code;
+	ss << "} // namespace " << function_name << "_impl\n} // namespace vg\n\n";
+
+	ss << "extern \"C\" void " << function_name;
+	ss << "(const float *in_x, const float *in_y, const float *in_z, float *const *outputs, unsigned int count) {\n";
+	ss << "    for (unsigned int i = 0; i < count; ++i) {\n";
+	ss << "        vg::" << function_name << "_impl::generate(vg::vec3(in_x[i], in_y[i], in_z[i])";
+	// Parameters of `generate` are in graph order, but the entry point takes outputs sorted by type, which is
+	// predictable for callers
+	for (const ShaderOutput &output : out_outputs) {
+		unsigned int slot = 0;
+		for (const ShaderOutput &other_output : out_outputs) {
+			if (other_output.type < output.type) {
+				++slot;
+			}
+		}
+		ss << ", outputs[" << slot << "][i]";
+	}
+	ss << ");\n";
+	ss << "    }\n";
+	ss << "}\n";
+
+	out_source_code = ss.str();
+
+	std::sort(out_outputs.begin(), out_outputs.end(), [](const ShaderOutput &a, const ShaderOutput &b) {
+		return a.type < b.type;
+	});
+
+	return result;
+}
+
+} // namespace zylann::voxel::pg
@@ -0,0 +1,39 @@
+#ifndef VOXEL_GRAPH_CPP_GENERATOR_H
+#define VOXEL_GRAPH_CPP_GENERATOR_H
+
+#include "../../util/containers/span.h"
+#include "../../util/containers/std_vector.h"
+#include "../../util/string/std_string.h"
+#include "voxel_graph_function.h"
+#include "voxel_graph_runtime.h"
+
+namespace zylann::voxel::pg {
+
+// Signature of the entry point in generated C++ code.
+// Evaluates the graph at `count` positions. `outputs` has one array of `count` values per output, in the order of the
+// outputs returned by `generate_cpp`, which is sorted by `ShaderOutput::Type`.
+typedef void (*NativeGraphFunction)(
+		const float *in_x,
+		const float *in_y,
+		const float *in_z,
+		float *const *outputs,
+		unsigned int count
+);
+
+// Generates standalone C++ source code from the given graph, to be compiled ahead of time into the module or a
+// plugin, as an alternative to running the graph with `Runtime`. The whole graph is fused into a single loop over
+// positions, without intermediate buffers.
+// The source defines an `extern "C"` function named `function_name` matching `NativeGraphFunction`. It only depends on
+// the C++ standard library, and several generated sources can be compiled into the same binary if their names differ.
+// Only nodes that don't need resources (such as noise, images or curves) are supported.
+CompilationResult generate_cpp(
+		const ProgramGraph &p_graph,
+		Span<const VoxelGraphFunction::Port> input_defs,
+		const StdString &function_name,
+		StdString &out_source_code,
+		StdVector<ShaderOutput> &out_outputs
+);
+
+} // namespace zylann::voxel::pg
+
+#endif // VOXEL_GRAPH_CPP_GENERATOR_H
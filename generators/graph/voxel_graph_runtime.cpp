@@ -1,5 +1,6 @@
 #include "voxel_graph_runtime.h"
 #include "../../util/containers/container_funcs.h"
+#include "../../util/containers/small_vector.h"
 #include "../../util/godot/core/string.h"
 #include "../../util/io/log.h"
 #include "../../util/macros.h"
@@ -11,6 +12,9 @@
 #include "node_type_db.h"
 #include "voxel_generator_graph.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <sstream>
 #include <unordered_set>
 
@@ -45,6 +49,182 @@ Span<const uint16_t> get_outputs_from_op_address(Span<const uint16_t> operations
 	return operations.sub(op_address + 1 + inputs_count, outputs_count);
 }
 
+struct DecodedOperation {
+	const NodeType *type = nullptr;
+	Span<const uint16_t> inputs;
+	Span<const uint16_t> outputs;
+	Span<const uint8_t> params;
+};
+
+DecodedOperation decode_operation(Span<const uint16_t> operations, unsigned int pc) {
+	DecodedOperation op;
+
+	const uint16_t opid = operations[pc++];
+	op.type = &NodeTypeDB::get_singleton().get_type(opid);
+
+	const uint32_t inputs_count = op.type->inputs.size();
+	const uint32_t outputs_count = op.type->outputs.size();
+
+	op.inputs = operations.sub(pc, inputs_count);
+	pc += inputs_count;
+	op.outputs = operations.sub(pc, outputs_count);
+	pc += outputs_count;
+
+	op.params = Runtime::read_params(operations, pc);
+	return op;
+}
+
+// Consecutive elementwise operations are executed over tiles of this many values, one tile after the other. That way
+// intermediate results stay in cache, instead of going through memory once per operation with full-size buffers.
+const unsigned int FUSED_TILE_SIZE = 256;
+const unsigned int MAX_FUSED_OPERATIONS = 32;
+const unsigned int MAX_FUSED_BUFFERS = 64;
+
+struct FusedGroup {
+	SmallVector<DecodedOperation, MAX_FUSED_OPERATIONS> operations;
+	// Every buffer used by operations of the group, without duplicates
+	SmallVector<uint16_t, MAX_FUSED_BUFFERS> buffer_addresses;
+};
+
+bool try_add_to_fused_group(
+		FusedGroup &group,
+		const DecodedOperation &op,
+		Span<const Runtime::Buffer> buffers,
+		unsigned int buffer_size
+) {
+	if (!op.type->is_elementwise || op.type->process_buffer_func == nullptr ||
+		group.operations.size() == MAX_FUSED_OPERATIONS) {
+		return false;
+	}
+
+	const unsigned int prev_buffer_count = group.buffer_addresses.size();
+
+	for (unsigned int i = 0; i < op.inputs.size() + op.outputs.size(); ++i) {
+		const uint16_t address = i < op.inputs.size() ? op.inputs[i] : op.outputs[i - op.inputs.size()];
+
+		// Bindings may have a different size than internal buffers
+		if (buffers[address].size != buffer_size) {
+			group.buffer_addresses.resize(prev_buffer_count);
+			return false;
+		}
+
+		bool found = false;
+		for (unsigned int j = 0; j < group.buffer_addresses.size(); ++j) {
+			if (group.buffer_addresses[j] == address) {
+				found = true;
+				break;
+			}
+		}
+		if (found) {
+			continue;
+		}
+
+		if (group.buffer_addresses.size() == MAX_FUSED_BUFFERS) {
+			group.buffer_addresses.resize(prev_buffer_count);
+			return false;
+		}
+		group.buffer_addresses.push_back(address);
+	}
+
+	group.operations.push_back(op);
+	return true;
+}
+
+void run_fused_group(
+		const FusedGroup &group,
+		Span<Runtime::Buffer> buffers,
+		unsigned int buffer_size,
+		bool using_execution_map,
+		bool deterministic
+) {
+	ZN_PROFILE_SCOPE();
+
+	SmallVector<float *, MAX_FUSED_BUFFERS> base_datas;
+	for (unsigned int i = 0; i < group.buffer_addresses.size(); ++i) {
+		base_datas.push_back(buffers[group.buffer_addresses[i]].data);
+	}
+
+	// Make buffers temporarily point to tiles of their data
+	for (unsigned int begin = 0; begin < buffer_size; begin += FUSED_TILE_SIZE) {
+		const unsigned int tile_size = std::min(FUSED_TILE_SIZE, buffer_size - begin);
+
+		for (unsigned int i = 0; i < group.buffer_addresses.size(); ++i) {
+			Runtime::Buffer &buffer = buffers[group.buffer_addresses[i]];
+			// Constants may have no data
+			if (base_datas[i] != nullptr) {
+				buffer.data = base_datas[i] + begin;
+			}
+			buffer.size = tile_size;
+		}
+
+		for (unsigned int i = 0; i < group.operations.size(); ++i) {
+			const DecodedOperation &op = group.operations[i];
+			Runtime::ProcessBufferContext ctx(
+					op.inputs, op.outputs, op.params, buffers, using_execution_map, deterministic
+			);
+			op.type->process_buffer_func(ctx);
+		}
+	}
+
+	for (unsigned int i = 0; i < group.buffer_addresses.size(); ++i) {
+		Runtime::Buffer &buffer = buffers[group.buffer_addresses[i]];
+		buffer.data = base_datas[i];
+		buffer.size = buffer_size;
+	}
+}
+
+// Runs an operation on the first `reduced_size` values of its buffers only
+void run_reduced_operation(
+		const DecodedOperation &op,
+		Span<Runtime::Buffer> buffers,
+		unsigned int reduced_size,
+		bool broadcast_outputs,
+		bool using_execution_map,
+		bool deterministic
+) {
+	FixedArray<unsigned int, Runtime::MAX_INPUTS + Runtime::MAX_OUTPUTS> full_sizes;
+	const unsigned int buffer_count = op.inputs.size() + op.outputs.size();
+	ZN_ASSERT(buffer_count <= full_sizes.size());
+
+	for (unsigned int i = 0; i < buffer_count; ++i) {
+		const uint16_t address = i < op.inputs.size() ? op.inputs[i] : op.outputs[i - op.inputs.size()];
+		full_sizes[i] = buffers[address].size;
+	}
+	for (unsigned int i = 0; i < buffer_count; ++i) {
+		const uint16_t address = i < op.inputs.size() ? op.inputs[i] : op.outputs[i - op.inputs.size()];
+		buffers[address].size = reduced_size;
+	}
+
+	Runtime::ProcessBufferContext ctx(op.inputs, op.outputs, op.params, buffers, using_execution_map, deterministic);
+	op.type->process_buffer_func(ctx);
+
+	for (unsigned int i = 0; i < buffer_count; ++i) {
+		const uint16_t address = i < op.inputs.size() ? op.inputs[i] : op.outputs[i - op.inputs.size()];
+		buffers[address].size = full_sizes[i];
+	}
+
+	if (broadcast_outputs) {
+		// Repeat results over the rest of the buffers
+		for (const uint16_t address : op.outputs) {
+			Runtime::Buffer &buffer = buffers[address];
+			if (buffer.data == nullptr || buffer.is_constant) {
+				continue;
+			}
+			if (reduced_size == 1) {
+				const float v = buffer.data[0];
+				for (unsigned int i = 1; i < buffer.size; ++i) {
+					buffer.data[i] = v;
+				}
+			} else {
+				for (unsigned int begin = reduced_size; begin < buffer.size; begin += reduced_size) {
+					const unsigned int count = std::min(reduced_size, buffer.size - begin);
+					memcpy(buffer.data + begin, buffer.data, count * sizeof(float));
+				}
+			}
+		}
+	}
+}
+
 } // namespace
 
 bool Runtime::is_operation_constant(const State &state, uint16_t op_address) const {
@@ -72,6 +252,67 @@ void Runtime::generate_optimized_execution_map(const State &state, ExecutionMap
 	generate_optimized_execution_map(state, execution_map, to_span_const(all_outputs, _program.outputs_count), debug);
 }
 
+void Runtime::generate_execution_map_for_outputs(
+		ExecutionMap &execution_map,
+		Span<const unsigned int> required_outputs
+) const {
+	ZN_PROFILE_SCOPE();
+
+	const Program &program = _program;
+	const DependencyGraph &graph = program.dependency_graph;
+
+	execution_map.clear();
+
+	static thread_local StdVector<uint16_t> to_process;
+	to_process.clear();
+
+	static thread_local StdVector<bool> required;
+	required.clear();
+	required.resize(graph.nodes.size(), false);
+
+	for (const unsigned int output_index : required_outputs) {
+		ZN_ASSERT_CONTINUE(output_index < program.outputs_count);
+		const unsigned int dg_index = program.outputs[output_index].dependency_graph_node_index;
+		if (!required[dg_index]) {
+			required[dg_index] = true;
+			to_process.push_back(dg_index);
+		}
+	}
+
+	while (to_process.size() != 0) {
+		const DependencyGraph::Node &node = graph.nodes[to_process.back()];
+		to_process.pop_back();
+
+		for (uint32_t i = node.first_dependency; i < node.end_dependency; ++i) {
+			const uint32_t dep_node_index = graph.dependencies[i];
+			if (!required[dep_node_index]) {
+				required[dep_node_index] = true;
+				to_process.push_back(dep_node_index);
+			}
+		}
+	}
+
+	// Nodes are in execution order, same as in `generate_optimized_execution_map`
+	bool inner_group_start_not_assigned = true;
+
+	for (unsigned int node_index = 0; node_index < graph.nodes.size(); ++node_index) {
+		const DependencyGraph::Node &node = graph.nodes[node_index];
+
+		if (node.is_input || !required[node_index]) {
+			continue;
+		}
+
+		if (inner_group_start_not_assigned && node.op_address >= program.inner_group_start_op_index) {
+			execution_map.inner_group_start_index = execution_map.operations.size();
+			inner_group_start_not_assigned = false;
+		}
+
+		execution_map.operations.push_back(ExecutionMap::OperationInfo{ node.op_address, 0 });
+		execution_map.operations.back().slice_evaluation = node.slice_evaluation;
+		execution_map.operations.back().broadcast_outputs = node.broadcast_outputs;
+	}
+}
+
 const Runtime::ExecutionMap &Runtime::get_default_execution_map() const {
 	return _program.default_execution_map;
 }
@@ -242,6 +483,8 @@ void Runtime::generate_optimized_execution_map(
 				execution_map.operations.push_back(
 						ExecutionMap::OperationInfo{ node.op_address, uint16_t(tls_constant_fills.size()) }
 				);
+				execution_map.operations.back().slice_evaluation = node.slice_evaluation;
+				execution_map.operations.back().broadcast_outputs = node.broadcast_outputs;
 
 				// TODO Only do constant fills that actually get used
 				// The following approach isn't optimal. If 50% of a graph gets skipped and the remaining nodes don't
@@ -273,36 +516,68 @@ void Runtime::generate_single(State &state, Span<const float> inputs, const Exec
 	generate_set(state, to_span(input_bindings, inputs.size()), false, execution_map);
 }
 
-void Runtime::prepare_state(State &state, unsigned int buffer_size, bool with_profiling) const {
-	// Allocate memory
-
-	const unsigned int old_buffer_data_count = state.buffer_datas.size();
-	if (state.buffer_datas.size() < _program.buffer_data_count) {
-		// Create more buffer datas.
-		state.buffer_datas.resize(_program.buffer_data_count);
-		for (unsigned int i = old_buffer_data_count; i < state.buffer_datas.size(); ++i) {
-			BufferData &bd = state.buffer_datas[i];
-			ZN_ASSERT(bd.data == nullptr);
-			// These are new items, we always allocate.
-			bd.data = reinterpret_cast<float *>(ZN_ALLOC(buffer_size * sizeof(float)));
-			bd.capacity = buffer_size;
-		}
-	}
-
-	if (state.buffer_size < buffer_size) {
-		// Make existing buffer datas larger.
-		for (unsigned int i = 0; i < old_buffer_data_count; ++i) {
-			BufferData &bd = state.buffer_datas[i];
-			ZN_ASSERT(bd.data != nullptr);
-			if (bd.capacity < buffer_size) {
-				// These are existing items, we always realloc.
-				bd.data = reinterpret_cast<float *>(ZN_REALLOC(bd.data, buffer_size * sizeof(float)));
-				bd.capacity = buffer_size;
-			}
+namespace {
+
+// Highest arena size used by any state, in bytes
+std::atomic<size_t> g_state_arena_high_water_mark;
+
+void report_state_arena_high_water_mark(size_t size_in_bytes) {
+	size_t previous = g_state_arena_high_water_mark.load();
+	while (previous < size_in_bytes) {
+		if (g_state_arena_high_water_mark.compare_exchange_weak(previous, size_in_bytes)) {
+			ZN_PROFILE_PLOT("Graph state arena high-water mark", int64_t(size_in_bytes));
+			break;
 		}
-		// TODO Not sure if worth keeping capacity at state level. Buffer datas can have varying capacities depending on
-		// which multiple graphs were prepared before.
-		state.buffer_capacity = buffer_size;
+	}
+}
+
+} // namespace
+
+void Runtime::prepare_state(
+		State &state,
+		unsigned int buffer_size,
+		bool with_profiling,
+		unsigned int scratch_size
+) const {
+	// Allocate memory.
+	// Buffer datas come first in the arena, followed by scratch memory. Their count is known from buffer specs at
+	// compile time, so the whole arena is sized up-front and carving it is only a matter of offsets.
+
+	const unsigned int values_per_alignment = BUFFER_DATA_ALIGNMENT / sizeof(float);
+	// Padded so vectors never straddle the end of a buffer data, and so the next one stays aligned
+	const unsigned int buffer_data_capacity =
+			static_cast<unsigned int>(math::alignup(buffer_size, values_per_alignment));
+	const size_t buffer_datas_size = size_t(buffer_data_capacity) * _program.buffer_data_count;
+	const size_t arena_size = buffer_datas_size + scratch_size;
+
+	if (state.arena_capacity < arena_size) {
+		ZN_PROFILE_SCOPE_NAMED("Graph state arena allocation");
+		// Previous contents don't need to be preserved, so we don't use realloc
+		if (state.arena_allocation != nullptr) {
+			ZN_FREE(state.arena_allocation);
+		}
+		state.arena_allocation = ZN_ALLOC(arena_size * sizeof(float) + BUFFER_DATA_ALIGNMENT - 1);
+		ZN_ASSERT(state.arena_allocation != nullptr);
+		state.arena_data = reinterpret_cast<float *>(
+				math::alignup(reinterpret_cast<uintptr_t>(state.arena_allocation), BUFFER_DATA_ALIGNMENT)
+		);
+		state.arena_capacity = arena_size;
+	}
+
+	state.buffer_datas.resize(_program.buffer_data_count);
+	for (unsigned int i = 0; i < state.buffer_datas.size(); ++i) {
+		BufferData &bd = state.buffer_datas[i];
+		bd.data = state.arena_data + size_t(i) * buffer_data_capacity;
+		bd.capacity = buffer_data_capacity;
+	}
+	state.buffer_capacity = buffer_data_capacity;
+
+	state.arena_used = buffer_datas_size;
+	state.arena_reserved_end = arena_size;
+
+	if (arena_size > state.arena_high_water_mark) {
+		state.arena_high_water_mark = arena_size;
+		report_state_arena_high_water_mark(arena_size * sizeof(float));
 	}
 
 	// Initialize buffers
@@ -343,6 +618,8 @@ void Runtime::prepare_state(State &state, unsigned int buffer_size, bool with_pr
 		buffer.is_constant = buffer_spec.is_constant;
 		buffer.size = buffer_size;
 		buffer.buffer_data_index = buffer_spec.data_index;
+		// Until a range analysis says otherwise, every user of the buffer is considered to need it
+		buffer.local_users_count = buffer_spec.users_count;
 
 		// Always reset constants because we don't know if we'll run the same program as before...
 		if (buffer_spec.is_constant) {
@@ -394,7 +671,8 @@ void Runtime::generate_set(
 		State &state,
 		Span<const Span<const float>> p_inputs,
 		bool skip_outer_group,
-		const ExecutionMap *p_execution_map
+		const ExecutionMap *p_execution_map,
+		unsigned int slice_row_size
 ) const {
 	// I don't like putting private helper functions in headers.
 	struct L {
@@ -469,6 +747,12 @@ void Runtime::generate_set(
 	const bool profile = state.debug_profiler_times.size() > 0;
 #endif
 
+	bool fusion_enabled = true;
+#ifdef TOOLS_ENABLED
+	// Execution times are measured per operation
+	fusion_enabled = !profile;
+#endif
+
 	unsigned int constant_fill_index = 0;
 
 	for (unsigned int execution_map_index = 0; execution_map_index < operation_infos.size(); ++execution_map_index) {
@@ -483,25 +767,69 @@ void Runtime::generate_set(
 			++constant_fill_index;
 		}
 
-		unsigned int pc = op_info.address;
+		const DecodedOperation op = decode_operation(operations, op_info.address);
 
-		const uint16_t opid = operations[pc++];
-		const NodeType &node_type = NodeTypeDB::get_singleton().get_type(opid);
+		// TODO Buffers will stay bound if this error occurs!
+		ZN_ASSERT_RETURN(op.type->process_buffer_func != nullptr);
+
+		if (slice_row_size != 0 && op_info.slice_evaluation != SLICE_EVALUATION_FULL) {
+			const unsigned int reduced_size = op_info.slice_evaluation == SLICE_EVALUATION_SINGLE ? 1 : slice_row_size;
+			if (op.outputs.size() > 0 && reduced_size < buffers[op.outputs[0]].size) {
+				run_reduced_operation(
+						op,
+						buffers,
+						reduced_size,
+						op_info.broadcast_outputs,
+						p_execution_map != nullptr,
+						_deterministic
+				);
+#ifdef TOOLS_ENABLED
+				if (profile) {
+					const uint32_t elapsed_microseconds = profiling_clock.get_elapsed_microseconds();
+					state.add_execution_time(execution_map_index, elapsed_microseconds);
+					profiling_clock.restart();
+				}
+#endif
+				continue;
+			}
+		}
 
-		const uint32_t inputs_count = node_type.inputs.size();
-		const uint32_t outputs_count = node_type.outputs.size();
+		if (fusion_enabled && op.type->is_elementwise && op.outputs.size() > 0) {
+			const unsigned int fused_buffer_size = buffers[op.outputs[0]].size;
 
-		const Span<const uint16_t> op_inputs = operations.sub(pc, inputs_count);
-		pc += inputs_count;
-		const Span<const uint16_t> op_outputs = operations.sub(pc, outputs_count);
-		pc += outputs_count;
+			if (fused_buffer_size > FUSED_TILE_SIZE) {
+				FusedGroup group;
+				try_add_to_fused_group(group, op, buffers, fused_buffer_size);
 
-		Span<const uint8_t> op_params = read_params(operations, pc);
+				// Constant fills must run right before the operation they are associated with, because their data
+				// may be used by previous operations. So they interrupt the group.
+				while (group.operations.size() > 0 && execution_map_index + 1 < operation_infos.size()) {
+					const ExecutionMap::OperationInfo next_op_info = operation_infos[execution_map_index + 1];
+					if (next_op_info.constant_fill_count > 0) {
+						break;
+					}
+					// Operations running on fewer positions don't compute the same amount of values
+					if (slice_row_size != 0 && next_op_info.slice_evaluation != SLICE_EVALUATION_FULL) {
+						break;
+					}
+					const DecodedOperation next_op = decode_operation(operations, next_op_info.address);
+					if (!try_add_to_fused_group(group, next_op, buffers, fused_buffer_size)) {
+						break;
+					}
+					++execution_map_index;
+				}
 
-		// TODO Buffers will stay bound if this error occurs!
-		ZN_ASSERT_RETURN(node_type.process_buffer_func != nullptr);
-		ProcessBufferContext ctx(op_inputs, op_outputs, op_params, buffers, p_execution_map != nullptr);
-		node_type.process_buffer_func(ctx);
+				if (group.operations.size() > 0) {
+					run_fused_group(group, buffers, fused_buffer_size, p_execution_map != nullptr, _deterministic);
+					continue;
+				}
+			}
+		}
+
+		ProcessBufferContext ctx(
+				op.inputs, op.outputs, op.params, buffers, p_execution_map != nullptr, _deterministic
+		);
+		op.type->process_buffer_func(ctx);
 
 #ifdef TOOLS_ENABLED
 		if (profile) {
@@ -562,7 +890,7 @@ void Runtime::analyze_range(State &state, Span<const math::Interval> p_inputs) c
 		Span<const uint8_t> op_params = read_params(operations, pc);
 
 		ZN_ASSERT_RETURN(node_type.range_analysis_func != nullptr);
-		RangeAnalysisContext ctx(op_inputs, op_outputs, op_params, ranges, buffers);
+		RangeAnalysisContext ctx(op_inputs, op_outputs, op_params, ranges, buffers, _deterministic);
 		node_type.range_analysis_func(ctx);
 
 #ifdef VOXEL_DEBUG_GRAPH_PROG_SENTINEL
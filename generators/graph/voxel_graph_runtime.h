@@ -5,10 +5,12 @@
 #include "../../util/containers/span.h"
 #include "../../util/containers/std_unordered_map.h"
 #include "../../util/containers/std_vector.h"
+#include "../../util/errors.h"
 #include "../../util/godot/classes/ref_counted.h"
 #include "../../util/math/interval.h"
 #include "../../util/math/vector3f.h"
 #include "../../util/math/vector3i.h"
+#include "../../util/memory/memory.h"
 #include "program_graph.h"
 
 namespace zylann::voxel::pg {
@@ -45,8 +47,12 @@ public:
 	static const unsigned int MAX_INPUTS = 8;
 	static const unsigned int MAX_OUTPUTS = 24;
 
+	// Alignment of buffer datas, in bytes. Large enough for any SIMD register width node kernels may use.
+	static const unsigned int BUFFER_DATA_ALIGNMENT = 32;
+
 	struct BufferData {
-		// Owns the data.
+		// Aligned to `BUFFER_DATA_ALIGNMENT`. Capacity is padded so vectors never straddle the end of the buffer.
+		// Points into the arena of the state.
 		float *data = nullptr;
 		unsigned int capacity = 0;
 	};
@@ -75,6 +81,17 @@ public:
 		uint16_t buffer_data_index;
 	};
 
+	// When positions are given as a slice of a grid, where Y is the same everywhere and X varies along rows,
+	// operations depending on fewer coordinates can run on fewer positions, and have their results repeated.
+	enum SliceEvaluation : uint8_t {
+		// Runs on every position
+		SLICE_EVALUATION_FULL,
+		// Only depends on Y, runs on a single position
+		SLICE_EVALUATION_SINGLE,
+		// Only depends on X and Y, runs on the first row
+		SLICE_EVALUATION_ROW
+	};
+
 	// Contains a list of adresses to the operations to execute for a given query.
 	// If no local optimization is done, this can remain the same for any position lists.
 	// If local optimization is used, it may be recomputed before each query.
@@ -83,6 +100,10 @@ public:
 			uint16_t address = 0;
 			// How many constant fills to execute before this operation.
 			uint16_t constant_fill_count = 0;
+			SliceEvaluation slice_evaluation = SLICE_EVALUATION_FULL;
+			// If the operation runs on fewer positions, its results must be repeated over the whole slice because
+			// they are read by operations running on more positions, or by the caller.
+			bool broadcast_outputs = false;
 		};
 
 		StdVector<OperationInfo> operations;
@@ -146,13 +167,33 @@ public:
 			return buffer_size;
 		}
 
+		// Gets temporary memory from the arena, such as for inputs. It remains valid until the next call to
+		// `prepare_state`, which must have reserved it with `scratch_size`. It is not aligned.
+		Span<float> allocate_scratch(unsigned int count) {
+			ZN_ASSERT_RETURN_V_MSG(
+					arena_used + count <= arena_reserved_end, Span<float>(), "Not enough scratch memory reserved"
+			);
+			Span<float> scratch(arena_data + arena_used, count);
+			arena_used += count;
+			return scratch;
+		}
+
+		// Largest size of the arena this state needed so far, in bytes
+		inline size_t get_arena_high_water_mark() const {
+			return arena_high_water_mark * sizeof(float);
+		}
+
 		void clear() {
 			buffer_size = 0;
 			// buffer_capacity = 0;
-			for (BufferData &bd : buffer_datas) {
-				ZN_ASSERT(bd.data != nullptr);
-				memfree(bd.data);
+			if (arena_allocation != nullptr) {
+				ZN_FREE(arena_allocation);
+				arena_allocation = nullptr;
 			}
+			arena_data = nullptr;
+			arena_capacity = 0;
+			arena_used = 0;
+			arena_reserved_end = 0;
 			buffer_datas.clear();
 			buffers.clear();
 			ranges.clear();
@@ -179,6 +220,18 @@ public:
 		StdVector<math::Interval> ranges;
 		StdVector<Buffer> buffers;
 		StdVector<BufferData> buffer_datas;
+
+		// All buffer datas and scratch memory are carved out of a single allocation, one after the other. Preparing
+		// the state only resets the bump offset, and the allocation only grows when a program needs more than it did
+		// before. Sizes are in floats.
+		void *arena_allocation = nullptr;
+		// Aligned to `BUFFER_DATA_ALIGNMENT`
+		float *arena_data = nullptr;
+		size_t arena_capacity = 0;
+		size_t arena_used = 0;
+		size_t arena_reserved_end = 0;
+		size_t arena_high_water_mark = 0;
+
 		// [execution_map_index] => microseconds
 		StdVector<uint32_t> debug_profiler_times;
 
@@ -207,20 +260,40 @@ public:
 	void clear();
 	CompilationResult compile(const VoxelGraphFunction &function, bool debug);
 
+	// When enabled, nodes relying on functions whose results may vary across platforms and compilers (like `sin` or
+	// `pow`) use portable implementations instead, so the same graph produces bit-identical results everywhere. This
+	// is slower. Must be set before compiling, because it affects which optimizations are done.
+	inline void set_deterministic(bool enabled) {
+		_deterministic = enabled;
+	}
+
+	inline bool is_deterministic() const {
+		return _deterministic;
+	}
+
 	// Call this before you use a state with generation functions.
 	// You need to call it once, until you want to use a different graph, buffer size or buffer count.
 	// If none of these change, you can keep re-using it.
-	void prepare_state(State &state, unsigned int buffer_size, bool with_profiling) const;
+	// `scratch_size` is the number of floats the caller will get with `State::allocate_scratch` afterwards.
+	void prepare_state(
+			State &state,
+			unsigned int buffer_size,
+			bool with_profiling,
+			unsigned int scratch_size = 0
+	) const;
 
 	// Convenience for set generation with only one value
 	// TODO Evaluate needs for double-precision in pg::Runtime
 	void generate_single(State &state, Span<const float> inputs, const ExecutionMap *execution_map) const;
 
+	// If `slice_row_size` is not zero, inputs must be a slice of a grid where Y is the same everywhere, and X varies
+	// along rows of that size. Operations depending only on Y or on X and Y then run on fewer positions.
 	void generate_set(
 			State &state,
 			Span<const Span<const float>> p_inputs,
 			bool skip_outer_group,
-			const ExecutionMap *p_execution_map
+			const ExecutionMap *p_execution_map,
+			unsigned int slice_row_size = 0
 	) const;
 
 #ifdef DEBUG_ENABLED
@@ -259,6 +332,13 @@ public:
 	// Convenience function to require all outputs
 	void generate_optimized_execution_map(const State &state, ExecutionMap &execution_map, bool debug) const;
 
+	// Generates a map of the operations needed by specific outputs only. Unlike `generate_optimized_execution_map`, it
+	// doesn't need range analysis and is valid anywhere, so it suits queries on scattered positions.
+	void generate_execution_map_for_outputs(
+			ExecutionMap &execution_map,
+			Span<const unsigned int> required_outputs
+	) const;
+
 	const ExecutionMap &get_default_execution_map() const;
 
 	// Gets the buffer address of a specific output port
@@ -332,11 +412,13 @@ public:
 				const Span<const uint16_t> outputs,
 				const Span<const uint8_t> params,
 				Span<Buffer> buffers,
-				bool using_execution_map
+				bool using_execution_map,
+				bool deterministic
 		) :
 				_ProcessContext(inputs, outputs, params),
 				_buffers(buffers),
-				_using_execution_map(using_execution_map) {}
+				_using_execution_map(using_execution_map),
+				_deterministic(deterministic) {}
 
 		inline const Buffer &get_input(uint32_t i) const {
 			const uint32_t address = get_input_address(i);
@@ -368,9 +450,15 @@ public:
 			return b;
 		}
 
+		// If true, nodes must produce the same results on every platform, see `Runtime::set_deterministic`
+		inline bool is_deterministic() const {
+			return _deterministic;
+		}
+
 	private:
 		Span<Buffer> _buffers;
 		bool _using_execution_map;
+		bool _deterministic;
 	};
 
 	// Functions usable by node implementations during range analysis
@@ -381,9 +469,13 @@ public:
 				const Span<const uint16_t> outputs,
 				const Span<const uint8_t> params,
 				Span<math::Interval> ranges,
-				Span<Buffer> buffers
+				Span<Buffer> buffers,
+				bool deterministic
 		) :
-				_ProcessContext(inputs, outputs, params), _ranges(ranges), _buffers(buffers) {}
+				_ProcessContext(inputs, outputs, params),
+				_ranges(ranges),
+				_buffers(buffers),
+				_deterministic(deterministic) {}
 
 		inline const math::Interval get_input(uint32_t i) const {
 			const uint32_t address = get_input_address(i);
@@ -401,9 +493,15 @@ public:
 			--b.local_users_count;
 		}
 
+		// Ranges must be computed with the same functions as values, so they remain conservative
+		inline bool is_deterministic() const {
+			return _deterministic;
+		}
+
 	private:
 		Span<math::Interval> _ranges;
 		Span<Buffer> _buffers;
+		bool _deterministic;
 	};
 
 	typedef void (*ProcessBufferFunc)(ProcessBufferContext &);
@@ -455,6 +553,8 @@ private:
 			bool is_input;
 			// Node ID from the expanded ProgramGraph (non user-provided, so may need remap)
 			uint32_t debug_node_id;
+			SliceEvaluation slice_evaluation;
+			bool broadcast_outputs;
 		};
 
 		// Indexes to the `nodes` array
@@ -560,6 +660,7 @@ private:
 	};
 
 	Program _program;
+	bool _deterministic = false;
 };
 
 } // namespace zylann::voxel::pg
@@ -21,7 +21,18 @@ void ShaderGenContext::require_lib_code(const char *lib_name, const char **code)
 	_code_gen.require_lib_code(lib_name, code);
 }
 
+bool ShaderGenContext::require_glsl() {
+	if (_language != CODE_GEN_GLSL) {
+		make_error(ZN_TTR("This node can only be converted to shader code."));
+		return false;
+	}
+	return true;
+}
+
 StdString ShaderGenContext::add_uniform(std::shared_ptr<ComputeShaderResource> res) {
+	if (!require_glsl()) {
+		return StdString();
+	}
 	StdString name = format("u_vg_resource_{}", _uniforms.size());
 	_uniforms.push_back(ShaderParameter());
 	ShaderParameter &sp = _uniforms.back();
@@ -32,10 +43,11 @@ StdString ShaderGenContext::add_uniform(std::shared_ptr<ComputeShaderResource> r
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-CompilationResult generate_shader(
+CompilationResult generate_function(
 		const ProgramGraph &p_graph,
 		Span<const VoxelGraphFunction::Port> input_defs,
-		FwdMutableStdString source_code,
+		CodeGenLanguage language,
+		CodeGenHelper &codegen,
 		StdVector<ShaderParameter> &shader_params,
 		StdVector<ShaderOutput> &outputs,
 		Span<const VoxelGraphFunction::NodeTypeID> restricted_outputs
@@ -82,9 +94,8 @@ CompilationResult generate_shader(
 
 	expanded_graph.find_dependencies(to_span(terminal_nodes), order);
 
-	StdStringStream main_ss;
-	StdStringStream lib_ss;
-	CodeGenHelper codegen(main_ss, lib_ss);
+	// GLSL has `out` parameters, C++ uses references
+	const char *out_float = language == CODE_GEN_CPP ? "float &" : "out float ";
 
 	codegen.add("void generate(vec3 pos");
 
@@ -95,15 +106,15 @@ CompilationResult generate_shader(
 		if (node_type.category == CATEGORY_OUTPUT) {
 			switch (node.type_id) {
 				case VoxelGraphFunction::NODE_OUTPUT_SDF:
-					codegen.add(", out float out_sd");
+					codegen.add_format(", {}out_sd", out_float);
 					outputs.push_back(ShaderOutput{ ShaderOutput::TYPE_SDF });
 					break;
 				case VoxelGraphFunction::NODE_OUTPUT_SINGLE_TEXTURE:
-					codegen.add(", out float out_single_texture");
+					codegen.add_format(", {}out_single_texture", out_float);
 					outputs.push_back(ShaderOutput{ ShaderOutput::TYPE_SINGLE_TEXTURE });
 					break;
 				case VoxelGraphFunction::NODE_OUTPUT_TYPE:
-					codegen.add(", out float out_type");
+					codegen.add_format(", {}out_type", out_float);
 					outputs.push_back(ShaderOutput{ ShaderOutput::TYPE_TYPE });
 					break;
 				default:
@@ -246,7 +257,8 @@ CompilationResult generate_shader(
 				to_span(input_names, node.inputs.size()),
 				to_span(output_names, node.outputs.size()),
 				codegen,
-				shader_params
+				shader_params,
+				language
 		);
 		node_type.shader_gen_func(ctx);
 
@@ -265,11 +277,32 @@ CompilationResult generate_shader(
 	codegen.dedent();
 	codegen.add("}\n");
 
-	codegen.print(source_code);
-
 	CompilationResult result;
 	result.success = true;
 	return result;
 }
 
+CompilationResult generate_shader(
+		const ProgramGraph &p_graph,
+		Span<const VoxelGraphFunction::Port> input_defs,
+		FwdMutableStdString source_code,
+		StdVector<ShaderParameter> &shader_params,
+		StdVector<ShaderOutput> &outputs,
+		Span<const VoxelGraphFunction::NodeTypeID> restricted_outputs
+) {
+	StdStringStream main_ss;
+	StdStringStream lib_ss;
+	CodeGenHelper codegen(main_ss, lib_ss);
+
+	const CompilationResult result = generate_function(
+			p_graph, input_defs, CODE_GEN_GLSL, codegen, shader_params, outputs, restricted_outputs
+	);
+	if (!result.success) {
+		return result;
+	}
+
+	codegen.print(source_code);
+	return result;
+}
+
 } // namespace zylann::voxel::pg
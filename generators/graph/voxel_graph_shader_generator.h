@@ -12,6 +12,25 @@
 
 namespace zylann::voxel::pg {
 
+// Languages in which node code can be generated. Nodes emit GLSL-style code, which the C++ generator supports through a
+// small compatibility layer. Nodes that can't run on the CPU that way must check the language and fail.
+enum CodeGenLanguage {
+	CODE_GEN_GLSL,
+	CODE_GEN_CPP,
+};
+
+// Generates a `generate` function in the given language from the given graph, using `codegen`. It computes outputs
+// from a `vec3 pos` parameter. Lib code is written separately by `codegen`.
+CompilationResult generate_function(
+		const ProgramGraph &p_graph,
+		Span<const VoxelGraphFunction::Port> input_defs,
+		CodeGenLanguage language,
+		CodeGenHelper &codegen,
+		StdVector<ShaderParameter> &uniforms,
+		StdVector<ShaderOutput> &outputs,
+		Span<const VoxelGraphFunction::NodeTypeID> restricted_outputs
+);
+
 // Generates GLSL code from the given graph.
 CompilationResult generate_shader(
 		const ProgramGraph &p_graph,
@@ -30,13 +49,15 @@ public:
 			Span<const char *> input_names,
 			Span<const char *> output_names,
 			CodeGenHelper &code_gen,
-			StdVector<ShaderParameter> &uniforms
+			StdVector<ShaderParameter> &uniforms,
+			CodeGenLanguage language
 	) :
 			_params(params),
 			_input_names(input_names),
 			_output_names(output_names),
 			_code_gen(code_gen),
-			_uniforms(uniforms) {}
+			_uniforms(uniforms),
+			_language(language) {}
 
 	Variant get_param(size_t i) const {
 		ZN_ASSERT(i < _params.size());
@@ -60,6 +81,13 @@ public:
 		return _has_error;
 	}
 
+	CodeGenLanguage get_language() const {
+		return _language;
+	}
+
+	// For nodes which can only generate GLSL. Returns false and makes an error if another language is requested.
+	bool require_glsl();
+
 	const String &get_error_message() const {
 		return _error_message;
 	}
@@ -83,6 +111,7 @@ private:
 	String _error_message;
 	bool _has_error = false;
 	StdVector<ShaderParameter> &_uniforms;
+	CodeGenLanguage _language;
 };
 
 typedef void (*ShaderGenFunc)(ShaderGenContext &);
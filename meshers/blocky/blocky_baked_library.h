@@ -85,6 +85,14 @@ struct BakedModel {
 		// Bits are indexed with the Cube::Side enum.
 		uint8_t empty_sides_mask = 0;
 		uint8_t full_sides_mask = 0;
+		// Sides made of a single unit quad with a texture repeating every UV unit. Greedy meshing can merge them with
+		// the same side of neighbor voxels.
+		uint8_t mergeable_sides_mask = 0;
+		// Full sides that hide any side of neighbors touching them, because the model is opaque and culls neighbors.
+		uint8_t occluding_sides_mask = 0;
+		// True if all sides are full and there is no geometry inside. Such models produce nothing when all their
+		// neighbors occlude them.
+		bool is_full_cube = false;
 
 		// Tells what is the "shape" of each side in order to cull them quickly when in contact with neighbors.
 		// Side patterns are still determined based on a combination of all surfaces.
@@ -182,6 +190,12 @@ struct BakedLibrary {
 
 	unsigned int indexed_materials_count = 0;
 
+	// True if at least one side of a model can be merged by greedy meshing
+	bool has_mergeable_sides = false;
+
+	// Incremented each time the library is baked, so data derived from a previous bake can be detected as outdated
+	uint32_t bake_version = 0;
+
 	inline bool has_model(uint32_t i) const {
 		return i < models.size();
 	}
@@ -676,6 +676,65 @@ void rasterize_side_all_surfaces(
 	}
 }
 
+// Tells if a side can be stretched over several voxels by greedy meshing without changing how it looks
+bool is_side_mergeable(const BakedModel &model_data, const unsigned int side) {
+	if (model_data.fluid_index != NULL_FLUID_INDEX || model_data.cutout_sides_enabled) {
+		// Side geometry depends on neighbors
+		return false;
+	}
+	if (model_data.model.surface_count != 1) {
+		return false;
+	}
+	const BakedModel::SideSurface &surface = model_data.model.sides_surfaces[side][0];
+	if (surface.positions.size() != 4 || surface.uvs.size() != 4 || surface.indices.size() != 6) {
+		return false;
+	}
+
+	const unsigned int axis = side / 2;
+	const unsigned int u_axis = (axis + 1) % 3;
+	const unsigned int v_axis = (axis + 2) % 3;
+	const float plane = Cube::g_side_normals[side][axis] > 0 ? 1.f : 0.f;
+
+	// Find corners of the quad in the plane of the side
+	FixedArray<int, 4> corner_vertices;
+	fill(corner_vertices, -1);
+	for (unsigned int i = 0; i < surface.positions.size(); ++i) {
+		const Vector3f p = surface.positions[i];
+		if (p[axis] != plane) {
+			return false;
+		}
+		if ((p[u_axis] != 0.f && p[u_axis] != 1.f) || (p[v_axis] != 0.f && p[v_axis] != 1.f)) {
+			return false;
+		}
+		const unsigned int corner = static_cast<unsigned int>(p[u_axis]) + 2 * static_cast<unsigned int>(p[v_axis]);
+		if (corner_vertices[corner] != -1) {
+			return false;
+		}
+		corner_vertices[corner] = i;
+	}
+
+	// UVs must be an affine function of the position, with each axis of the quad mapping to exactly one UV unit along
+	// U or V, so the texture repeats seamlessly when the quad gets stretched.
+	// Tiles of a texture atlas are not supported: repeating them would require wrapping UVs inside the tile, which
+	// standard materials can't do.
+	const Vector2f uv00 = surface.uvs[corner_vertices[0]];
+	const Vector2f uv_u = surface.uvs[corner_vertices[1]] - uv00;
+	const Vector2f uv_v = surface.uvs[corner_vertices[2]] - uv00;
+	if (surface.uvs[corner_vertices[3]] != uv00 + uv_u + uv_v) {
+		return false;
+	}
+	struct L {
+		static inline bool is_unit_axis(const Vector2f v) {
+			return (Math::abs(v.x) == 1.f && v.y == 0.f) || (v.x == 0.f && Math::abs(v.y) == 1.f);
+		}
+	};
+	if (!L::is_unit_axis(uv_u) || !L::is_unit_axis(uv_v) || uv_u.x * uv_v.x + uv_u.y * uv_v.y != 0.f) {
+		return false;
+	}
+
+	return true;
+}
+
 void generate_side_culling_matrix(BakedLibrary &baked_data) {
 	ZN_PROFILE_SCOPE();
 	// When two blocky voxels are next to each other, they share a side.
@@ -699,10 +758,13 @@ void generate_side_culling_matrix(BakedLibrary &baked_data) {
 	StdVector<Pattern> patterns;
 	uint32_t full_side_pattern_index = VoxelBlockyLibraryBase::NULL_INDEX;
 
+	baked_data.has_mergeable_sides = false;
+
 	// Gather patterns for each model
 	for (uint16_t type_id = 0; type_id < baked_data.models.size(); ++type_id) {
 		BakedModel &model_data = baked_data.models[type_id];
 		model_data.contributes_to_ao = true;
+		model_data.model.mergeable_sides_mask = 0;
 
 		// For each side
 		for (uint16_t side = 0; side < Cube::SIDE_COUNT; ++side) {
@@ -731,6 +793,11 @@ void generate_side_culling_matrix(BakedLibrary &baked_data) {
 				}
 			}
 
+			if (is_side_mergeable(model_data, side)) {
+				model_data.model.mergeable_sides_mask |= (1 << side);
+				baked_data.has_mergeable_sides = true;
+			}
+
 			// Find if the same pattern already exists
 			uint32_t pattern_index = VoxelBlockyLibraryBase::NULL_INDEX;
 			for (unsigned int i = 0; i < patterns.size(); ++i) {
@@ -765,6 +832,21 @@ void generate_side_culling_matrix(BakedLibrary &baked_data) {
 			model_data.model.side_pattern_indices[side] = pattern_index;
 
 		} // side
+
+		// Full sides all share the same pattern, which occludes any other. If the neighbor is also opaque and culls
+		// neighbors, sides touching it are culled regardless of their own transparency.
+		model_data.model.occluding_sides_mask = 0;
+		if (!model_data.empty && model_data.culls_neighbors && model_data.transparency_index == 0) {
+			model_data.model.occluding_sides_mask = model_data.model.full_sides_mask;
+		}
+
+		model_data.model.is_full_cube = model_data.fluid_index == VoxelBlockyModel::NULL_FLUID_INDEX &&
+				model_data.model.full_sides_mask == (1 << Cube::SIDE_COUNT) - 1;
+		for (unsigned int surface_index = 0; surface_index < model_data.model.surface_count; ++surface_index) {
+			if (model_data.model.surfaces[surface_index].positions.size() > 0) {
+				model_data.model.is_full_cube = false;
+			}
+		}
 	} // type
 
 	// Find which pattern occludes which
@@ -1,12 +1,15 @@
 #include "voxel_mesher_blocky.h"
 #include "../../constants/cube_tables.h"
 #include "../../storage/voxel_buffer.h"
+#include "../../storage/voxel_buffer_padded_view.h"
 #include "../../util/containers/span.h"
 #include "../../util/godot/core/array.h"
 #include "../../util/godot/core/packed_arrays.h"
+#include "../../util/io/log.h"
 #include "../../util/macros.h"
 #include "../../util/math/conv.h"
 #include "../../util/math/funcs.h"
+#include "../../util/memory/memory.h"
 // TODO GDX: String has no `operator+=`
 #include "../../util/containers/container_funcs.h"
 #include "../../util/godot/core/string.h"
@@ -34,43 +37,423 @@ StdVector<int> &get_tls_index_offsets() {
 	return tls_index_offsets;
 }
 
+// Faces deferred to greedy meshing are stored with one bit per side, followed by 2 bits of ambient occlusion per side
+static constexpr unsigned int GREEDY_FACE_AO_SHIFT = Cube::SIDE_COUNT;
+
+// Merges faces deferred by `generate_mesh` into larger quads, slice by slice, the same way `VoxelMesherCubes` does.
 template <typename Type_T>
-void generate_mesh(
+void generate_greedy_faces(
+		StdVector<VoxelMesherBlocky::Arrays> &out_arrays_per_material,
+		VoxelMesher::Output::CollisionSurface *collision_surface,
+		StdVector<int> &index_offsets,
+		int &collision_surface_index_offset,
+		const Span<const Type_T> type_buffer,
+		const Span<const uint32_t> greedy_faces,
+		const Vector3i block_size,
+		const Vector3i min_pos,
+		const Vector3i max_pos,
+		const BakedLibrary &library,
+		const float baked_occlusion_darkness,
+		const TintSampler tint_sampler,
+		StdVector<GreedyFace> &mask
+) {
+	ZN_PROFILE_SCOPE();
+
+	const int row_size = block_size.y;
+	const int deck_size = block_size.x * row_size;
+
+	struct L {
+		static inline bool is_range_equal(
+				const StdVector<GreedyFace> &mask,
+				unsigned int begin,
+				unsigned int end,
+				const GreedyFace &face
+		) {
+			for (unsigned int i = begin; i < end; ++i) {
+				if (mask[i] != face) {
+					return false;
+				}
+			}
+			return true;
+		}
+	};
+
+	for (unsigned int side = 0; side < Cube::SIDE_COUNT; ++side) {
+		// Same axes as the ones used to find mergeable sides when baking
+		const unsigned int za = side / 2;
+		const unsigned int ua = (za + 1) % 3;
+		const unsigned int va = (za + 2) % 3;
+
+		const unsigned int mask_size_u = max_pos[ua] - min_pos[ua];
+		const unsigned int mask_size_v = max_pos[va] - min_pos[va];
+		mask.resize(mask_size_u * mask_size_v);
+
+		const Vector3f normal = to_vec3f(Cube::g_side_normals[side]);
+
+		// For each deck
+		for (int d = min_pos[za]; d < max_pos[za]; ++d) {
+			// For each cell of the deck, gather faces
+			for (unsigned int fv = 0; fv < mask_size_v; ++fv) {
+				for (unsigned int fu = 0; fu < mask_size_u; ++fu) {
+					Vector3i pos;
+					pos[ua] = fu + min_pos[ua];
+					pos[va] = fv + min_pos[va];
+					pos[za] = d;
+
+					const unsigned int voxel_index = pos.y + pos.x * row_size + pos.z * deck_size;
+					const uint32_t flags = greedy_faces[voxel_index];
+
+					GreedyFace &face = mask[fu + fv * mask_size_u];
+					face.present = (flags & (1 << side)) != 0;
+					if (!face.present) {
+						continue;
+					}
+					face.voxel_id = type_buffer[voxel_index];
+					face.ao = (flags >> (GREEDY_FACE_AO_SHIFT + 2 * side)) & 0b11;
+					face.color = library.models[face.voxel_id].color * tint_sampler.evaluate(pos);
+				}
+			}
+
+			// Greedy quads
+			for (unsigned int fv = 0; fv < mask_size_v; ++fv) {
+				for (unsigned int fu = 0; fu < mask_size_u; ++fu) {
+					const GreedyFace face = mask[fu + fv * mask_size_u];
+					if (!face.present) {
+						continue;
+					}
+
+					// Check if the next faces are the same along U
+					unsigned int ru = fu + 1;
+					while (ru < mask_size_u && mask[ru + fv * mask_size_u] == face) {
+						++ru;
+					}
+
+					// Check if the next rows of faces are the same along V
+					unsigned int rv = fv + 1;
+					while (rv < mask_size_v &&
+						   L::is_range_equal(mask, fu + rv * mask_size_u, ru + rv * mask_size_u, face)) {
+						++rv;
+					}
+
+					for (unsigned int j = fv; j < rv; ++j) {
+						for (unsigned int i = fu; i < ru; ++i) {
+							mask[i + j * mask_size_u].present = false;
+						}
+					}
+
+					// Commit face to the mesh
+
+					const BakedModel::Model &model = library.models[face.voxel_id].model;
+					const BakedModel::Surface &surface = model.surfaces[0];
+					const BakedModel::SideSurface &side_surface = model.sides_surfaces[side][0];
+
+					VoxelMesherBlocky::Arrays &arrays = out_arrays_per_material[surface.material_id];
+					ZN_ASSERT(surface.material_id < index_offsets.size());
+					int &index_offset = index_offsets[surface.material_id];
+
+					// Mask coordinates don't include padding
+					Vector3f origin;
+					origin[ua] = fu;
+					origin[va] = fv;
+					origin[za] = d - VoxelMesherBlocky::PADDING;
+
+					const float size_u = ru - fu;
+					const float size_v = rv - fv;
+
+					// The side is a unit quad, and its UVs vary by one unit along each of its axes, which was checked
+					// when baking. Stretching the quad makes the texture repeat.
+					Vector2f corner_uvs[4];
+					for (unsigned int i = 0; i < 4; ++i) {
+						const Vector3f p = side_surface.positions[i];
+						corner_uvs[static_cast<unsigned int>(p[ua]) + 2 * static_cast<unsigned int>(p[va])] =
+								side_surface.uvs[i];
+					}
+					const Vector2f uv_u = corner_uvs[1] - corner_uvs[0];
+					const Vector2f uv_v = corner_uvs[2] - corner_uvs[0];
+
+					// Only faces with the same occlusion on all corners are merged. Corners of a unit quad are only
+					// shaded by their own amount.
+					const float gs = 1.f - baked_occlusion_darkness * static_cast<float>(face.ao);
+					const Color color = Color(gs, gs, gs) * face.color;
+
+					for (unsigned int i = 0; i < 4; ++i) {
+						const Vector3f p = side_surface.positions[i];
+						Vector3f stretched = p;
+						stretched[ua] *= size_u;
+						stretched[va] *= size_v;
+
+						arrays.positions.push_back(stretched + origin);
+						arrays.uvs.push_back(
+								side_surface.uvs[i] + uv_u * (p[ua] * (size_u - 1.f)) +
+								uv_v * (p[va] * (size_v - 1.f))
+						);
+						arrays.normals.push_back(normal);
+						arrays.colors.push_back(color);
+					}
+
+					if (side_surface.tangents.size() > 0) {
+						const int append_index = arrays.tangents.size();
+						arrays.tangents.resize(arrays.tangents.size() + side_surface.tangents.size());
+						memcpy(arrays.tangents.data() + append_index,
+							   side_surface.tangents.data(),
+							   side_surface.tangents.size() * sizeof(float));
+					}
+
+					for (const int i : side_surface.indices) {
+						arrays.indices.push_back(index_offset + i);
+					}
+
+					if (collision_surface != nullptr && surface.collision_enabled) {
+						for (unsigned int i = 0; i < 4; ++i) {
+							collision_surface->positions.push_back(arrays.positions[arrays.positions.size() - 4 + i]);
+						}
+						for (const int i : side_surface.indices) {
+							collision_surface->indices.push_back(collision_surface_index_offset + i);
+						}
+						collision_surface_index_offset += 4;
+					}
+
+					index_offset += 4;
+				}
+			}
+		}
+	}
+}
+
+// Per row of voxels along Y, bitmasks of voxels having a given property. Rows longer than 64 voxels use several words.
+enum RowMaskIndex {
+	ROW_MASK_SOLID = 0,
+	ROW_MASK_FULL_CUBE,
+	// One per side
+	ROW_MASK_OCCLUDING_SIDES,
+	ROW_MASK_COUNT = ROW_MASK_OCCLUDING_SIDES + Cube::SIDE_COUNT
+};
+
+// Masks are laid out as [z][x][word][mask index]
+template <typename Type_T>
+void build_row_masks(
+		StdVector<uint64_t> &row_masks,
+		const Span<const Type_T> type_buffer,
+		const Vector3i block_size,
+		const unsigned int row_word_count,
+		const BakedLibrary &library
+) {
+	ZN_PROFILE_SCOPE();
+
+	const unsigned int row_size = block_size.y;
+	row_masks.clear();
+	row_masks.resize(block_size.x * block_size.z * row_word_count * ROW_MASK_COUNT, 0);
+
+	// Padding voxels are never meshed, but they can occlude
+	const unsigned int min_y = VoxelMesherBlocky::PADDING;
+	const unsigned int max_y = block_size.y - VoxelMesherBlocky::PADDING;
+
+	for (unsigned int row_index = 0; row_index < static_cast<unsigned int>(block_size.x * block_size.z); ++row_index) {
+		// Rows are contiguous in the buffer, in the same order as masks
+		const Type_T *row_voxels = type_buffer.data() + row_index * row_size;
+		uint64_t *masks = row_masks.data() + row_index * row_word_count * ROW_MASK_COUNT;
+
+		for (unsigned int y = 0; y < row_size; ++y) {
+			const uint32_t voxel_id = row_voxels[y];
+			if (voxel_id == AIR_ID || !library.has_model(voxel_id)) {
+				continue;
+			}
+			const BakedModel::Model &model = library.models[voxel_id].model;
+
+			uint64_t *word_masks = masks + (y >> 6) * ROW_MASK_COUNT;
+			const uint64_t bit = uint64_t(1) << (y & 63);
+
+			if (y >= min_y && y < max_y) {
+				word_masks[ROW_MASK_SOLID] |= bit;
+			}
+			if (model.is_full_cube) {
+				word_masks[ROW_MASK_FULL_CUBE] |= bit;
+			}
+			for (unsigned int side = 0; side < Cube::SIDE_COUNT; ++side) {
+				word_masks[ROW_MASK_OCCLUDING_SIDES + side] |= bit * ((model.occluding_sides_mask >> side) & 1);
+			}
+		}
+	}
+}
+
+// Bits of the word `w` of a row mask, corresponding to voxels in [begin_y, end_y). The word must overlap that range.
+inline uint64_t get_row_word_range_mask(unsigned int w, unsigned int begin_y, unsigned int end_y) {
+	const unsigned int word_begin = w * 64;
+	const unsigned int b = math::max(begin_y, word_begin) - word_begin;
+	const unsigned int e = math::min(end_y, word_begin + 64) - word_begin;
+	const uint64_t below_end = e == 64 ? ~uint64_t(0) : (uint64_t(1) << e) - 1;
+	return below_end & ~((uint64_t(1) << b) - 1);
+}
+
+// Gets which voxels of a word of a row have sides touching an occluding side of their neighbor
+inline void get_row_word_occluded_sides(
+		const uint64_t *row,
+		const unsigned int deck_stride,
+		const unsigned int row_stride,
+		const unsigned int w,
+		const unsigned int row_word_count,
+		uint64_t out_occluded_sides[Cube::SIDE_COUNT]
+) {
+	const unsigned int wi = w * ROW_MASK_COUNT;
+	// Neighbor rows, named after the side of the current row they touch
+	const uint64_t *row_left = row + row_stride;
+	const uint64_t *row_right = row - row_stride;
+	const uint64_t *row_front = row + deck_stride;
+	const uint64_t *row_back = row - deck_stride;
+
+	out_occluded_sides[Cube::SIDE_LEFT] = row_left[wi + ROW_MASK_OCCLUDING_SIDES + Cube::SIDE_RIGHT];
+	out_occluded_sides[Cube::SIDE_RIGHT] = row_right[wi + ROW_MASK_OCCLUDING_SIDES + Cube::SIDE_LEFT];
+	out_occluded_sides[Cube::SIDE_BACK] = row_back[wi + ROW_MASK_OCCLUDING_SIDES + Cube::SIDE_FRONT];
+	out_occluded_sides[Cube::SIDE_FRONT] = row_front[wi + ROW_MASK_OCCLUDING_SIDES + Cube::SIDE_BACK];
+	// Neighbors along Y are in the same row, one bit away, carried over between words
+	out_occluded_sides[Cube::SIDE_BOTTOM] = row[wi + ROW_MASK_OCCLUDING_SIDES + Cube::SIDE_TOP] << 1;
+	if (w > 0) {
+		out_occluded_sides[Cube::SIDE_BOTTOM] |=
+				row[wi - ROW_MASK_COUNT + ROW_MASK_OCCLUDING_SIDES + Cube::SIDE_TOP] >> 63;
+	}
+	out_occluded_sides[Cube::SIDE_TOP] = row[wi + ROW_MASK_OCCLUDING_SIDES + Cube::SIDE_BOTTOM] >> 1;
+	if (w + 1 < row_word_count) {
+		out_occluded_sides[Cube::SIDE_TOP] |=
+				row[wi + ROW_MASK_COUNT + ROW_MASK_OCCLUDING_SIDES + Cube::SIDE_BOTTOM] << 63;
+	}
+}
+
+// Gets which sides of a voxel are not hidden by its neighbors
+template <typename Type_T>
+inline uint32_t get_visible_sides_mask(
+		const BakedLibrary &library,
+		const BakedModel &voxel,
+		const uint64_t occluded_sides[Cube::SIDE_COUNT],
+		const unsigned int y_bit,
+		const Span<const Type_T> type_buffer,
+		const unsigned int voxel_index,
+		const FixedArray<int, Cube::SIDE_COUNT> &side_neighbor_lut
+) {
+	const BakedModel::Model &model = voxel.model;
+
+	// Full sides touching occluding sides are culled without looking at neighbors
+	uint32_t occluded_sides_mask = 0;
+	for (unsigned int side = 0; side < Cube::SIDE_COUNT; ++side) {
+		occluded_sides_mask |= ((occluded_sides[side] >> y_bit) & 1) << side;
+	}
+	const uint32_t culled_sides_mask = model.empty_sides_mask | (occluded_sides_mask & model.full_sides_mask);
+
+	uint32_t visible_sides_mask = 0;
+	for (unsigned int side = 0; side < Cube::SIDE_COUNT; ++side) {
+		if ((culled_sides_mask & (1 << side)) != 0) {
+			// This side is empty or occluded
+			continue;
+		}
+
+		const uint32_t neighbor_voxel_id = type_buffer[voxel_index + side_neighbor_lut[side]];
+
+		// Invalid voxels are treated like air
+		if (neighbor_voxel_id < library.models.size()) {
+			const BakedModel &other_vt = library.models[neighbor_voxel_id];
+			if (!is_face_visible_regardless_of_shape(voxel, other_vt)) {
+				// Visibility depends on the shape
+				if (!is_face_visible_according_to_shape(library, voxel, other_vt, side)) {
+					// Completely occluded
+					continue;
+				}
+			}
+		}
+
+		visible_sides_mask |= (1 << side);
+	}
+
+	return visible_sides_mask;
+}
+
+// Gets the geometry of a visible side. It may be pre-cut to only show the part that isn't hidden by the neighbor.
+template <typename Type_T>
+inline const FixedArray<BakedModel::SideSurface, MAX_SURFACES> &get_visible_side_surfaces(
+		const BakedLibrary &library,
+		const BakedModel &voxel,
+		const FixedArray<FixedArray<BakedModel::SideSurface, MAX_SURFACES>, Cube::SIDE_COUNT> &model_sides_surfaces,
+		const unsigned int side,
+		const Span<const Type_T> type_buffer,
+		const unsigned int voxel_index,
+		const FixedArray<int, Cube::SIDE_COUNT> &side_neighbor_lut
+) {
+	// By default we render the whole side if we consider it visible
+	if (!voxel.cutout_sides_enabled) {
+		return model_sides_surfaces[side];
+	}
+
+	// Might be only partially visible
+	const uint32_t neighbor_voxel_id = type_buffer[voxel_index + side_neighbor_lut[side]];
+
+	// Invalid voxels are treated like air
+	if (neighbor_voxel_id < library.models.size()) {
+		const BakedModel &other_vt = library.models[neighbor_voxel_id];
+
+		const StdUnorderedMap<uint32_t, FixedArray<BakedModel::SideSurface, MAX_SURFACES>>
+				&cutout_side_surfaces_by_neighbor_shape = voxel.model.cutout_side_surfaces[side];
+
+		const unsigned int neighbor_shape_id = other_vt.model.side_pattern_indices[Cube::g_opposite_side[side]];
+
+		// That's a hashmap lookup on a hot path. Cutting out sides like this should be used
+		// sparsely if possible.
+		// Unfortunately, use cases include certain water styles, which means oceans...
+		// Eventually we should provide another approach for these
+		auto it = cutout_side_surfaces_by_neighbor_shape.find(neighbor_shape_id);
+
+		if (it != cutout_side_surfaces_by_neighbor_shape.end()) {
+			// Use pre-cut side instead
+			return it->second;
+		}
+	}
+
+	return model_sides_surfaces[side];
+}
+
+// Appends geometry of voxels found between `min` and `max` in the padded buffer.
+// Output arrays are expected to be empty.
+template <typename Type_T>
+void generate_mesh_region(
 		StdVector<VoxelMesherBlocky::Arrays> &out_arrays_per_material,
 		VoxelMesher::Output::CollisionSurface *collision_surface,
 		const Span<const Type_T> type_buffer,
 		const Vector3i block_size,
+		const Vector3i min,
+		const Vector3i max,
 		const BakedLibrary &library,
 		const bool bake_occlusion,
 		const float baked_occlusion_darkness,
-		const TintSampler tint_sampler
+		const TintSampler tint_sampler,
+		// If not null, faces that can be merged with their neighbors are output with greedy meshing
+		StdVector<uint32_t> *greedy_faces,
+		StdVector<GreedyFace> &greedy_mask,
+		const Span<const uint64_t> row_masks
 ) {
 	// TODO Optimization: not sure if this mandates a template function. There is so much more happening in this
 	// function other than reading voxels, although reading is on the hottest path. It needs to be profiled. If
 	// changing makes no difference, we could use a function pointer or switch inside instead to reduce executable size.
 
-	ERR_FAIL_COND(
-			block_size.x < static_cast<int>(2 * VoxelMesherBlocky::PADDING) ||
-			block_size.y < static_cast<int>(2 * VoxelMesherBlocky::PADDING) ||
-			block_size.z < static_cast<int>(2 * VoxelMesherBlocky::PADDING)
-	);
-
 	// Build lookup tables so to speed up voxel access.
 	// These are values to add to an address in order to get given neighbor.
 
 	const int row_size = block_size.y;
 	const int deck_size = block_size.x * row_size;
 
-	// Data must be padded, hence the off-by-one
-	const Vector3i min = Vector3iUtil::create(VoxelMesherBlocky::PADDING);
-	const Vector3i max = block_size - Vector3iUtil::create(VoxelMesherBlocky::PADDING);
-
 	StdVector<int> &index_offsets = get_tls_index_offsets();
 	index_offsets.clear();
 	index_offsets.resize(out_arrays_per_material.size(), 0);
 
 	int collision_surface_index_offset = 0;
 
+	if (greedy_faces != nullptr) {
+		// Only faces of the region are read afterward
+		greedy_faces->resize(Vector3iUtil::get_volume_u64(block_size));
+		for (int z = min.z; z < max.z; ++z) {
+			for (int x = min.x; x < max.x; ++x) {
+				uint32_t *row_faces = greedy_faces->data() + x * row_size + z * deck_size;
+				std::fill(row_faces + min.y, row_faces + max.y, 0);
+			}
+		}
+	}
+
 	FixedArray<int, Cube::SIDE_COUNT> side_neighbor_lut;
 	side_neighbor_lut[Cube::SIDE_LEFT] = row_size;
 	side_neighbor_lut[Cube::SIDE_RIGHT] = -row_size;
@@ -127,256 +510,353 @@ void generate_mesh(
 	// uint64_t time_prep = Time::get_singleton()->get_ticks_usec() - time_before;
 	// time_before = Time::get_singleton()->get_ticks_usec();
 
+	// Masks of the whole block are built beforehand, see `build_row_masks`
+	const unsigned int row_word_count = (block_size.y + 63) / 64;
+	const unsigned int row_masks_stride = row_word_count * ROW_MASK_COUNT;
+	const unsigned int begin_word = min.y / 64;
+	const unsigned int end_word = (max.y + 63) / 64;
+
 	for (unsigned int z = min.z; z < (unsigned int)max.z; ++z) {
 		for (unsigned int x = min.x; x < (unsigned int)max.x; ++x) {
-			for (unsigned int y = min.y; y < (unsigned int)max.y; ++y) {
-				// min and max are chosen such that you can visit 1 neighbor away from the current voxel without size
-				// check
+			const uint64_t *row = row_masks.data() + (x + z * block_size.x) * row_masks_stride;
 
-				const unsigned int voxel_index = y + x * row_size + z * deck_size;
-				const unsigned int voxel_id = type_buffer[voxel_index];
+			for (unsigned int w = begin_word; w < end_word; ++w) {
+				const unsigned int wi = w * ROW_MASK_COUNT;
 
-				// TODO Don't assume air is 0?
-				if (voxel_id == AIR_ID || !library.has_model(voxel_id)) {
-					continue;
+				uint64_t occluded_sides[Cube::SIDE_COUNT];
+				get_row_word_occluded_sides(
+						row, block_size.x * row_masks_stride, row_masks_stride, w, row_word_count, occluded_sides
+				);
+
+				uint64_t hidden_mask = row[wi + ROW_MASK_FULL_CUBE];
+				for (unsigned int side = 0; side < Cube::SIDE_COUNT; ++side) {
+					hidden_mask &= occluded_sides[side];
 				}
 
-				const BakedModel &voxel = library.models[voxel_id];
-				const BakedModel::Model &model = voxel.model;
+				// Only visit voxels that can produce geometry. Air, invalid voxels and padding are not in the mask.
+				for (uint64_t visit_mask = row[wi + ROW_MASK_SOLID] & ~hidden_mask &
+							 get_row_word_range_mask(w, min.y, max.y);
+					 visit_mask != 0;
+					 visit_mask &= visit_mask - 1) {
+					const unsigned int y_bit = math::get_lowest_bit_index_u64(visit_mask);
+					const unsigned int y = w * 64 + y_bit;
 
-				// Calculate visibility of sides
-				uint32_t visible_sides_mask = 0;
-				for (unsigned int side = 0; side < Cube::SIDE_COUNT; ++side) {
-					if ((model.empty_sides_mask & (1 << side)) != 0) {
-						// This side is empty
-						continue;
+					// min and max are chosen such that you can visit 1 neighbor away from the current voxel without
+					// size check
+
+					const unsigned int voxel_index = y + x * row_size + z * deck_size;
+					const unsigned int voxel_id = type_buffer[voxel_index];
+
+					const BakedModel &voxel = library.models[voxel_id];
+					const BakedModel::Model &model = voxel.model;
+
+					const uint32_t visible_sides_mask = get_visible_sides_mask(
+							library, voxel, occluded_sides, y_bit, type_buffer, voxel_index, side_neighbor_lut
+					);
+
+					uint8_t model_surface_count = model.surface_count;
+
+					Span<const BakedModel::Surface> model_surfaces = to_span(model.surfaces);
+
+					const FixedArray<FixedArray<BakedModel::SideSurface, MAX_SURFACES>, Cube::SIDE_COUNT>
+							*model_sides_surfaces = &model.sides_surfaces;
+
+					// Hybrid approach: extract cube faces and decimate those that aren't visible,
+					// and still allow voxels to have geometry that is not a cube.
+
+					if (voxel.fluid_index != NULL_FLUID_INDEX) {
+						if (!generate_fluid_model(
+									voxel,
+									type_buffer,
+									voxel_index,
+									1,
+									row_size,
+									deck_size,
+									visible_sides_mask,
+									library,
+									model_surfaces,
+									model_sides_surfaces
+							)) {
+							continue;
+						}
+						model_surface_count = 1;
 					}
 
-					const uint32_t neighbor_voxel_id = type_buffer[voxel_index + side_neighbor_lut[side]];
+					const Color modulate_color = voxel.color * tint_sampler.evaluate(Vector3i(x, y, z));
 
-					// Invalid voxels are treated like air
-					if (neighbor_voxel_id < library.models.size()) {
-						const BakedModel &other_vt = library.models[neighbor_voxel_id];
-						if (!is_face_visible_regardless_of_shape(voxel, other_vt)) {
-							// Visibility depends on the shape
-							if (!is_face_visible_according_to_shape(library, voxel, other_vt, side)) {
-								// Completely occluded
+					// Sides
+					for (unsigned int side = 0; side < Cube::SIDE_COUNT; ++side) {
+						if ((visible_sides_mask & (1 << side)) == 0) {
+							// This side is culled
+							continue;
+						}
+
+						const FixedArray<BakedModel::SideSurface, MAX_SURFACES> *side_surfaces =
+								&get_visible_side_surfaces(
+										library,
+										voxel,
+										*model_sides_surfaces,
+										side,
+										type_buffer,
+										voxel_index,
+										side_neighbor_lut
+								);
+
+						// The face is visible
+
+						int8_t shaded_corner[8] = { 0 };
+
+						if (bake_occlusion) {
+							// Combinatory solution for
+							// https://0fps.net/2013/07/03/ambient-occlusion-for-minecraft-like-worlds/ (inverted)
+							//	function vertexAO(side1, side2, corner) {
+							//	  if(side1 && side2) {
+							//		return 0
+							//	  }
+							//	  return 3 - (side1 + side2 + corner)
+							//	}
+
+							for (unsigned int j = 0; j < 4; ++j) {
+								const unsigned int edge = Cube::g_side_edges[side][j];
+								const int edge_neighbor_id = type_buffer[voxel_index + edge_neighbor_lut[edge]];
+								if (contributes_to_ao(library, edge_neighbor_id)) {
+									++shaded_corner[Cube::g_edge_corners[edge][0]];
+									++shaded_corner[Cube::g_edge_corners[edge][1]];
+								}
+							}
+							for (unsigned int j = 0; j < 4; ++j) {
+								const unsigned int corner = Cube::g_side_corners[side][j];
+								if (shaded_corner[corner] == 2) {
+									shaded_corner[corner] = 3;
+								} else {
+									const int corner_neigbor_id =
+											type_buffer[voxel_index + corner_neighbor_lut[corner]];
+									if (contributes_to_ao(library, corner_neigbor_id)) {
+										++shaded_corner[corner];
+									}
+								}
+							}
+						}
+
+						if (greedy_faces != nullptr && (model.mergeable_sides_mask & (1 << side)) != 0) {
+							const int8_t ao = shaded_corner[Cube::g_side_corners[side][0]];
+							if (shaded_corner[Cube::g_side_corners[side][1]] == ao &&
+								shaded_corner[Cube::g_side_corners[side][2]] == ao &&
+								shaded_corner[Cube::g_side_corners[side][3]] == ao) {
+								// Output later, merged with similar neighbor faces
+								(*greedy_faces)[voxel_index] |=
+										(1 << side) | (ao << (GREEDY_FACE_AO_SHIFT + 2 * side));
 								continue;
 							}
 						}
-					}
 
-					visible_sides_mask |= (1 << side);
-				}
+						// Subtracting 1 because the data is padded
+						const Vector3f pos(x - 1, y - 1, z - 1);
 
-				uint8_t model_surface_count = model.surface_count;
-
-				Span<const BakedModel::Surface> model_surfaces = to_span(model.surfaces);
-
-				const FixedArray<FixedArray<BakedModel::SideSurface, MAX_SURFACES>, Cube::SIDE_COUNT>
-						*model_sides_surfaces = &model.sides_surfaces;
-
-				// Hybrid approach: extract cube faces and decimate those that aren't visible,
-				// and still allow voxels to have geometry that is not a cube.
-
-				if (voxel.fluid_index != NULL_FLUID_INDEX) {
-					if (!generate_fluid_model(
-								voxel,
-								type_buffer,
-								voxel_index,
-								1,
-								row_size,
-								deck_size,
-								visible_sides_mask,
-								library,
-								model_surfaces,
-								model_sides_surfaces
-						)) {
-						continue;
-					}
-					model_surface_count = 1;
-				}
+						// TODO Move this into a function
+						for (unsigned int surface_index = 0; surface_index < model_surface_count; ++surface_index) {
+							const BakedModel::Surface &surface = model_surfaces[surface_index];
 
-				const Color modulate_color = voxel.color * tint_sampler.evaluate(Vector3i(x, y, z));
+							VoxelMesherBlocky::Arrays &arrays = out_arrays_per_material[surface.material_id];
 
-				// Sides
-				for (unsigned int side = 0; side < Cube::SIDE_COUNT; ++side) {
-					if ((visible_sides_mask & (1 << side)) == 0) {
-						// This side is culled
-						continue;
-					}
+							ZN_ASSERT(surface.material_id < index_offsets.size());
+							int &index_offset = index_offsets[surface.material_id];
 
-					// By default we render the whole side if we consider it visible
-					const FixedArray<BakedModel::SideSurface, MAX_SURFACES> *side_surfaces =
-							&((*model_sides_surfaces)[side]);
+							const BakedModel::SideSurface &side_surface = (*side_surfaces)[surface_index];
 
-					// Might be only partially visible
-					if (voxel.cutout_sides_enabled) {
-						const uint32_t neighbor_voxel_id = type_buffer[voxel_index + side_neighbor_lut[side]];
+							const StdVector<Vector3f> &side_positions = side_surface.positions;
+							const unsigned int vertex_count = side_surface.positions.size();
 
-						// Invalid voxels are treated like air
-						if (neighbor_voxel_id < library.models.size()) {
-							const BakedModel &other_vt = library.models[neighbor_voxel_id];
+							const StdVector<Vector2f> &side_uvs = side_surface.uvs;
+							const StdVector<float> &side_tangents = side_surface.tangents;
 
-							const StdUnorderedMap<uint32_t, FixedArray<BakedModel::SideSurface, MAX_SURFACES>>
-									&cutout_side_surfaces_by_neighbor_shape = model.cutout_side_surfaces[side];
+							// Append vertices of the faces in one go, don't use push_back
 
-							const unsigned int neighbor_shape_id =
-									other_vt.model.side_pattern_indices[Cube::g_opposite_side[side]];
+							{
+								const int append_index = arrays.positions.size();
+								arrays.positions.resize(arrays.positions.size() + vertex_count);
+								Vector3f *w = arrays.positions.data() + append_index;
+								for (unsigned int i = 0; i < vertex_count; ++i) {
+									w[i] = side_positions[i] + pos;
+								}
+							}
 
-							// That's a hashmap lookup on a hot path. Cutting out sides like this should be used
-							// sparsely if possible.
-							// Unfortunately, use cases include certain water styles, which means oceans...
-							// Eventually we should provide another approach for these
-							auto it = cutout_side_surfaces_by_neighbor_shape.find(neighbor_shape_id);
+							{
+								const int append_index = arrays.uvs.size();
+								arrays.uvs.resize(arrays.uvs.size() + vertex_count);
+								memcpy(arrays.uvs.data() + append_index,
+									   side_uvs.data(),
+									   vertex_count * sizeof(Vector2f));
+							}
 
-							if (it != cutout_side_surfaces_by_neighbor_shape.end()) {
-								// Use pre-cut side instead
-								side_surfaces = &it->second;
+							if (side_tangents.size() > 0) {
+								const int append_index = arrays.tangents.size();
+								arrays.tangents.resize(arrays.tangents.size() + vertex_count * 4);
+								memcpy(arrays.tangents.data() + append_index,
+									   side_tangents.data(),
+									   (vertex_count * 4) * sizeof(float));
 							}
-						}
-					}
 
-					// The face is visible
-
-					int8_t shaded_corner[8] = { 0 };
-
-					if (bake_occlusion) {
-						// Combinatory solution for
-						// https://0fps.net/2013/07/03/ambient-occlusion-for-minecraft-like-worlds/ (inverted)
-						//	function vertexAO(side1, side2, corner) {
-						//	  if(side1 && side2) {
-						//		return 0
-						//	  }
-						//	  return 3 - (side1 + side2 + corner)
-						//	}
-
-						for (unsigned int j = 0; j < 4; ++j) {
-							const unsigned int edge = Cube::g_side_edges[side][j];
-							const int edge_neighbor_id = type_buffer[voxel_index + edge_neighbor_lut[edge]];
-							if (contributes_to_ao(library, edge_neighbor_id)) {
-								++shaded_corner[Cube::g_edge_corners[edge][0]];
-								++shaded_corner[Cube::g_edge_corners[edge][1]];
+							{
+								const int append_index = arrays.normals.size();
+								arrays.normals.resize(arrays.normals.size() + vertex_count);
+								Vector3f *w = arrays.normals.data() + append_index;
+								for (unsigned int i = 0; i < vertex_count; ++i) {
+									w[i] = to_vec3f(Cube::g_side_normals[side]);
+								}
 							}
-						}
-						for (unsigned int j = 0; j < 4; ++j) {
-							const unsigned int corner = Cube::g_side_corners[side][j];
-							if (shaded_corner[corner] == 2) {
-								shaded_corner[corner] = 3;
-							} else {
-								const int corner_neigbor_id = type_buffer[voxel_index + corner_neighbor_lut[corner]];
-								if (contributes_to_ao(library, corner_neigbor_id)) {
-									++shaded_corner[corner];
+
+							{
+								const int append_index = arrays.colors.size();
+								arrays.colors.resize(arrays.colors.size() + vertex_count);
+								Color *w = arrays.colors.data() + append_index;
+
+								if (bake_occlusion) {
+									for (unsigned int i = 0; i < vertex_count; ++i) {
+										const Vector3f vertex_pos = side_positions[i];
+
+										// General purpose occlusion colouring.
+										// TODO Optimize for cubes
+										// TODO Fix occlusion inconsistency caused by triangles orientation? Not sure if
+										// worth it
+										float shade = 0;
+										for (unsigned int j = 0; j < 4; ++j) {
+											unsigned int corner = Cube::g_side_corners[side][j];
+											if (shaded_corner[corner] != 0) {
+												float s = baked_occlusion_darkness *
+														static_cast<float>(shaded_corner[corner]);
+												// float k = 1.f - Cube::g_corner_position[corner].distance_to(v);
+												float k = 1.f -
+														math::distance_squared(
+																Cube::g_corner_position[corner], vertex_pos
+														);
+												if (k < 0.0) {
+													k = 0.0;
+												}
+												s *= k;
+												if (s > shade) {
+													shade = s;
+												}
+											}
+										}
+										const float gs = 1.0 - shade;
+										w[i] = Color(gs, gs, gs) * modulate_color;
+									}
+
+								} else {
+									for (unsigned int i = 0; i < vertex_count; ++i) {
+										w[i] = modulate_color;
+									}
 								}
 							}
+
+							const StdVector<int> &side_indices = side_surface.indices;
+							const unsigned int index_count = side_indices.size();
+
+							{
+								int i = arrays.indices.size();
+								arrays.indices.resize(arrays.indices.size() + index_count);
+								int *w = arrays.indices.data();
+								for (unsigned int j = 0; j < index_count; ++j) {
+									w[i++] = index_offset + side_indices[j];
+								}
+							}
+
+							if (collision_surface != nullptr && surface.collision_enabled) {
+								StdVector<Vector3f> &dst_positions = collision_surface->positions;
+								StdVector<int> &dst_indices = collision_surface->indices;
+
+								{
+									const unsigned int append_index = dst_positions.size();
+									dst_positions.resize(dst_positions.size() + vertex_count);
+									Vector3f *w = dst_positions.data() + append_index;
+									for (unsigned int i = 0; i < vertex_count; ++i) {
+										w[i] = side_positions[i] + pos;
+									}
+								}
+
+								{
+									int i = dst_indices.size();
+									dst_indices.resize(dst_indices.size() + index_count);
+									int *w = dst_indices.data();
+									for (unsigned int j = 0; j < index_count; ++j) {
+										w[i++] = collision_surface_index_offset + side_indices[j];
+									}
+								}
+
+								collision_surface_index_offset += vertex_count;
+							}
+
+							index_offset += vertex_count;
 						}
 					}
 
-					// Subtracting 1 because the data is padded
-					const Vector3f pos(x - 1, y - 1, z - 1);
-
-					// TODO Move this into a function
+					// Inside
 					for (unsigned int surface_index = 0; surface_index < model_surface_count; ++surface_index) {
 						const BakedModel::Surface &surface = model_surfaces[surface_index];
+						if (surface.positions.size() == 0) {
+							continue;
+						}
 
 						VoxelMesherBlocky::Arrays &arrays = out_arrays_per_material[surface.material_id];
 
 						ZN_ASSERT(surface.material_id < index_offsets.size());
 						int &index_offset = index_offsets[surface.material_id];
 
-						const BakedModel::SideSurface &side_surface = (*side_surfaces)[surface_index];
+						const StdVector<Vector3f> &positions = surface.positions;
+						const unsigned int vertex_count = positions.size();
+
+						const StdVector<Vector3f> &normals = surface.normals;
+						const StdVector<Vector2f> &uvs = surface.uvs;
+						const StdVector<float> &tangents = surface.tangents;
 
-						const StdVector<Vector3f> &side_positions = side_surface.positions;
-						const unsigned int vertex_count = side_surface.positions.size();
+						const Vector3f pos(x - 1, y - 1, z - 1);
 
-						const StdVector<Vector2f> &side_uvs = side_surface.uvs;
-						const StdVector<float> &side_tangents = side_surface.tangents;
+						if (tangents.size() > 0) {
+							const int append_index = arrays.tangents.size();
+							arrays.tangents.resize(arrays.tangents.size() + vertex_count * 4);
+							memcpy(arrays.tangents.data() + append_index,
+								   tangents.data(),
+								   (vertex_count * 4) * sizeof(float));
+						}
 
-						// Append vertices of the faces in one go, don't use push_back
+						// Append vertices in one go, don't use push_back
 
 						{
 							const int append_index = arrays.positions.size();
 							arrays.positions.resize(arrays.positions.size() + vertex_count);
 							Vector3f *w = arrays.positions.data() + append_index;
 							for (unsigned int i = 0; i < vertex_count; ++i) {
-								w[i] = side_positions[i] + pos;
+								w[i] = positions[i] + pos;
 							}
 						}
 
-						{
-							const int append_index = arrays.uvs.size();
-							arrays.uvs.resize(arrays.uvs.size() + vertex_count);
-							memcpy(arrays.uvs.data() + append_index, side_uvs.data(), vertex_count * sizeof(Vector2f));
-						}
-
-						if (side_tangents.size() > 0) {
-							const int append_index = arrays.tangents.size();
-							arrays.tangents.resize(arrays.tangents.size() + vertex_count * 4);
-							memcpy(arrays.tangents.data() + append_index,
-								   side_tangents.data(),
-								   (vertex_count * 4) * sizeof(float));
-						}
-
 						{
 							const int append_index = arrays.normals.size();
 							arrays.normals.resize(arrays.normals.size() + vertex_count);
-							Vector3f *w = arrays.normals.data() + append_index;
-							for (unsigned int i = 0; i < vertex_count; ++i) {
-								w[i] = to_vec3f(Cube::g_side_normals[side]);
-							}
+							memcpy(arrays.normals.data() + append_index,
+								   normals.data(),
+								   vertex_count * sizeof(Vector3f));
 						}
 
 						{
-							const int append_index = arrays.colors.size();
-							arrays.colors.resize(arrays.colors.size() + vertex_count);
-							Color *w = arrays.colors.data() + append_index;
-
-							if (bake_occlusion) {
-								for (unsigned int i = 0; i < vertex_count; ++i) {
-									const Vector3f vertex_pos = side_positions[i];
-
-									// General purpose occlusion colouring.
-									// TODO Optimize for cubes
-									// TODO Fix occlusion inconsistency caused by triangles orientation? Not sure if
-									// worth it
-									float shade = 0;
-									for (unsigned int j = 0; j < 4; ++j) {
-										unsigned int corner = Cube::g_side_corners[side][j];
-										if (shaded_corner[corner] != 0) {
-											float s = baked_occlusion_darkness *
-													static_cast<float>(shaded_corner[corner]);
-											// float k = 1.f - Cube::g_corner_position[corner].distance_to(v);
-											float k = 1.f -
-													math::distance_squared(Cube::g_corner_position[corner], vertex_pos);
-											if (k < 0.0) {
-												k = 0.0;
-											}
-											s *= k;
-											if (s > shade) {
-												shade = s;
-											}
-										}
-									}
-									const float gs = 1.0 - shade;
-									w[i] = Color(gs, gs, gs) * modulate_color;
-								}
-
-							} else {
-								for (unsigned int i = 0; i < vertex_count; ++i) {
-									w[i] = modulate_color;
-								}
-							}
+							const int append_index = arrays.uvs.size();
+							arrays.uvs.resize(arrays.uvs.size() + vertex_count);
+							memcpy(arrays.uvs.data() + append_index, uvs.data(), vertex_count * sizeof(Vector2f));
 						}
 
-						const StdVector<int> &side_indices = side_surface.indices;
-						const unsigned int index_count = side_indices.size();
+						// TODO handle ambient occlusion on inner parts
+						arrays.colors.resize(arrays.colors.size() + vertex_count, modulate_color);
+
+						const StdVector<int> &indices = surface.indices;
+						const unsigned int index_count = indices.size();
 
 						{
 							int i = arrays.indices.size();
 							arrays.indices.resize(arrays.indices.size() + index_count);
 							int *w = arrays.indices.data();
 							for (unsigned int j = 0; j < index_count; ++j) {
-								w[i++] = index_offset + side_indices[j];
+								w[i++] = index_offset + indices[j];
 							}
 						}
 
@@ -389,7 +869,7 @@ void generate_mesh(
 								dst_positions.resize(dst_positions.size() + vertex_count);
 								Vector3f *w = dst_positions.data() + append_index;
 								for (unsigned int i = 0; i < vertex_count; ++i) {
-									w[i] = side_positions[i] + pos;
+									w[i] = positions[i] + pos;
 								}
 							}
 
@@ -398,7 +878,7 @@ void generate_mesh(
 								dst_indices.resize(dst_indices.size() + index_count);
 								int *w = dst_indices.data();
 								for (unsigned int j = 0; j < index_count; ++j) {
-									w[i++] = collision_surface_index_offset + side_indices[j];
+									w[i++] = collision_surface_index_offset + indices[j];
 								}
 							}
 
@@ -408,67 +888,430 @@ void generate_mesh(
 						index_offset += vertex_count;
 					}
 				}
+			}
+		}
+	}
 
-				// Inside
-				for (unsigned int surface_index = 0; surface_index < model_surface_count; ++surface_index) {
-					const BakedModel::Surface &surface = model_surfaces[surface_index];
-					if (surface.positions.size() == 0) {
-						continue;
-					}
-					// TODO Get rid of push_backs
+	if (greedy_faces != nullptr) {
+		generate_greedy_faces(
+				out_arrays_per_material,
+				collision_surface,
+				index_offsets,
+				collision_surface_index_offset,
+				type_buffer,
+				to_span_const(*greedy_faces),
+				block_size,
+				min,
+				max,
+				library,
+				baked_occlusion_darkness,
+				tint_sampler,
+				greedy_mask
+		);
+	}
+}
 
-					VoxelMesherBlocky::Arrays &arrays = out_arrays_per_material[surface.material_id];
+void append_arrays(VoxelMesherBlocky::Arrays &dst, const VoxelMesherBlocky::Arrays &src) {
+	const int index_offset = dst.positions.size();
+	append_array(dst.positions, src.positions);
+	append_array(dst.normals, src.normals);
+	append_array(dst.uvs, src.uvs);
+	append_array(dst.colors, src.colors);
+	append_array(dst.tangents, src.tangents);
+
+	const unsigned int append_index = dst.indices.size();
+	dst.indices.resize(append_index + src.indices.size());
+	int *w = dst.indices.data() + append_index;
+	for (unsigned int i = 0; i < src.indices.size(); ++i) {
+		w[i] = src.indices[i] + index_offset;
+	}
+}
 
-					ZN_ASSERT(surface.material_id < index_offsets.size());
-					int &index_offset = index_offsets[surface.material_id];
+void append_collision_surface(
+		VoxelMesher::Output::CollisionSurface &dst,
+		const VoxelMesher::Output::CollisionSurface &src
+) {
+	const int index_offset = dst.positions.size();
+	append_array(dst.positions, src.positions);
+
+	const unsigned int append_index = dst.indices.size();
+	dst.indices.resize(append_index + src.indices.size());
+	int *w = dst.indices.data() + append_index;
+	for (unsigned int i = 0; i < src.indices.size(); ++i) {
+		w[i] = src.indices[i] + index_offset;
+	}
+}
 
-					const StdVector<Vector3f> &positions = surface.positions;
-					const unsigned int vertex_count = positions.size();
+template <typename Type_T>
+void generate_mesh(
+		StdVector<VoxelMesherBlocky::Arrays> &out_arrays_per_material,
+		VoxelMesher::Output::CollisionSurface *collision_surface,
+		const Span<const Type_T> type_buffer,
+		const Vector3i block_size,
+		const BakedLibrary &library,
+		const bool bake_occlusion,
+		const float baked_occlusion_darkness,
+		const TintSampler tint_sampler,
+		StdVector<uint32_t> *greedy_faces,
+		StdVector<GreedyFace> &greedy_mask,
+		StdVector<uint64_t> &row_masks,
+		// If not null, the mesh is built brick by brick, and only bricks intersecting `dirty_box` are built again.
+		// The others are re-used as they are.
+		StdVector<VoxelMesherBlocky::MeshBrick> *bricks,
+		const Box3i dirty_box
+) {
+	ERR_FAIL_COND(
+			block_size.x < static_cast<int>(2 * VoxelMesherBlocky::PADDING) ||
+			block_size.y < static_cast<int>(2 * VoxelMesherBlocky::PADDING) ||
+			block_size.z < static_cast<int>(2 * VoxelMesherBlocky::PADDING)
+	);
 
-					const StdVector<Vector3f> &normals = surface.normals;
-					const StdVector<Vector2f> &uvs = surface.uvs;
-					const StdVector<float> &tangents = surface.tangents;
+	// Sides touching a full side of an opaque neighbor are always culled. Such neighbors are found for whole rows of
+	// voxels along Y using bitmasks, which also allows to skip voxels that are entirely hidden, like most of the
+	// ground.
+	const unsigned int row_word_count = (block_size.y + 63) / 64;
+	build_row_masks(row_masks, type_buffer, block_size, row_word_count, library);
+
+	// Data must be padded, hence the off-by-one
+	const Vector3i min = Vector3iUtil::create(VoxelMesherBlocky::PADDING);
+	const Vector3i max = block_size - Vector3iUtil::create(VoxelMesherBlocky::PADDING);
+
+	if (bricks == nullptr) {
+		generate_mesh_region(
+				out_arrays_per_material,
+				collision_surface,
+				type_buffer,
+				block_size,
+				min,
+				max,
+				library,
+				bake_occlusion,
+				baked_occlusion_darkness,
+				tint_sampler,
+				greedy_faces,
+				greedy_mask,
+				to_span_const(row_masks)
+		);
+		return;
+	}
 
+	const Vector3i brick_count = math::ceildiv(max - min, VoxelMesherBlocky::INCREMENTAL_BRICK_SIZE);
+	ZN_ASSERT_RETURN(bricks->size() == Vector3iUtil::get_volume_u64(brick_count));
+
+	unsigned int brick_index = 0;
+	Vector3i bpos;
+	for (bpos.z = 0; bpos.z < brick_count.z; ++bpos.z) {
+		for (bpos.y = 0; bpos.y < brick_count.y; ++bpos.y) {
+			for (bpos.x = 0; bpos.x < brick_count.x; ++bpos.x) {
+				VoxelMesherBlocky::MeshBrick &brick = (*bricks)[brick_index];
+				++brick_index;
+
+				const Vector3i brick_min = min + bpos * VoxelMesherBlocky::INCREMENTAL_BRICK_SIZE;
+				const Vector3i brick_max =
+						math::min(brick_min + Vector3iUtil::create(VoxelMesherBlocky::INCREMENTAL_BRICK_SIZE), max);
+
+				if (dirty_box.is_empty() || !dirty_box.intersects(Box3i::from_min_max(brick_min, brick_max))) {
+					continue;
+				}
+
+				brick.arrays_per_material.resize(out_arrays_per_material.size());
+				for (VoxelMesherBlocky::Arrays &arrays : brick.arrays_per_material) {
+					arrays.clear();
+				}
+				brick.collision_surface.positions.clear();
+				brick.collision_surface.indices.clear();
+
+				generate_mesh_region(
+						brick.arrays_per_material,
+						collision_surface != nullptr ? &brick.collision_surface : nullptr,
+						type_buffer,
+						block_size,
+						brick_min,
+						brick_max,
+						library,
+						bake_occlusion,
+						baked_occlusion_darkness,
+						tint_sampler,
+						greedy_faces,
+						greedy_mask,
+						to_span_const(row_masks)
+				);
+			}
+		}
+	}
+
+	// Stitch bricks together
+	for (const VoxelMesherBlocky::MeshBrick &brick : *bricks) {
+		const unsigned int material_count =
+				math::min(brick.arrays_per_material.size(), out_arrays_per_material.size());
+		for (unsigned int material_index = 0; material_index < material_count; ++material_index) {
+			append_arrays(out_arrays_per_material[material_index], brick.arrays_per_material[material_index]);
+		}
+		if (collision_surface != nullptr) {
+			append_collision_surface(*collision_surface, brick.collision_surface);
+		}
+	}
+}
+
+void append_collision_geometry(
+		VoxelMesher::Output::CollisionSurface &collision_surface,
+		const StdVector<Vector3f> &positions,
+		const StdVector<int> &indices,
+		const Vector3f pos
+) {
+	const unsigned int index_offset = collision_surface.positions.size();
+
+	const unsigned int append_vertex_index = collision_surface.positions.size();
+	collision_surface.positions.resize(append_vertex_index + positions.size());
+	Vector3f *positions_w = collision_surface.positions.data() + append_vertex_index;
+	for (unsigned int i = 0; i < positions.size(); ++i) {
+		positions_w[i] = positions[i] + pos;
+	}
+
+	const unsigned int append_index = collision_surface.indices.size();
+	collision_surface.indices.resize(append_index + indices.size());
+	int *indices_w = collision_surface.indices.data() + append_index;
+	for (unsigned int i = 0; i < indices.size(); ++i) {
+		indices_w[i] = index_offset + indices[i];
+	}
+}
+
+// Tells if a side can be merged with the same side of neighbors when only collision geometry is needed. Its shape must
+// cover the whole side, and all of it must have collision.
+inline bool is_side_collision_mergeable(const BakedModel &voxel, const unsigned int side) {
+	const BakedModel::Model &model = voxel.model;
+	if ((model.full_sides_mask & (1 << side)) == 0 || //
+		voxel.fluid_index != NULL_FLUID_INDEX || //
+		voxel.cutout_sides_enabled) {
+		return false;
+	}
+	for (unsigned int surface_index = 0; surface_index < model.surface_count; ++surface_index) {
+		if (!model.surfaces[surface_index].collision_enabled && //
+			model.sides_surfaces[side][surface_index].positions.size() > 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Generates only positions and indices of collision geometry, skipping all other work needed for rendering. Full sides
+// are merged into larger quads regardless of materials, textures and colors, since physics doesn't use them.
+template <typename Type_T>
+void generate_collision_mesh(
+		VoxelMesher::Output::CollisionSurface &collision_surface,
+		const Span<const Type_T> type_buffer,
+		const Vector3i block_size,
+		const BakedLibrary &library,
+		StdVector<uint64_t> &row_masks,
+		// Per voxel, sides deferred to merging
+		StdVector<uint32_t> &merged_faces,
+		StdVector<uint8_t> &merge_mask
+) {
+	ZN_PROFILE_SCOPE();
+
+	ERR_FAIL_COND(
+			block_size.x < static_cast<int>(2 * VoxelMesherBlocky::PADDING) ||
+			block_size.y < static_cast<int>(2 * VoxelMesherBlocky::PADDING) ||
+			block_size.z < static_cast<int>(2 * VoxelMesherBlocky::PADDING)
+	);
+
+	const unsigned int row_word_count = (block_size.y + 63) / 64;
+	build_row_masks(row_masks, type_buffer, block_size, row_word_count, library);
+
+	const Vector3i min = Vector3iUtil::create(VoxelMesherBlocky::PADDING);
+	const Vector3i max = block_size - Vector3iUtil::create(VoxelMesherBlocky::PADDING);
+
+	const int row_size = block_size.y;
+	const int deck_size = block_size.x * row_size;
+
+	FixedArray<int, Cube::SIDE_COUNT> side_neighbor_lut;
+	side_neighbor_lut[Cube::SIDE_LEFT] = row_size;
+	side_neighbor_lut[Cube::SIDE_RIGHT] = -row_size;
+	side_neighbor_lut[Cube::SIDE_BACK] = -deck_size;
+	side_neighbor_lut[Cube::SIDE_FRONT] = deck_size;
+	side_neighbor_lut[Cube::SIDE_BOTTOM] = -1;
+	side_neighbor_lut[Cube::SIDE_TOP] = 1;
+
+	merged_faces.clear();
+	merged_faces.resize(Vector3iUtil::get_volume_u64(block_size), 0);
+
+	const unsigned int row_masks_stride = row_word_count * ROW_MASK_COUNT;
+	const unsigned int end_word = (max.y + 63) / 64;
+
+	for (unsigned int z = min.z; z < (unsigned int)max.z; ++z) {
+		for (unsigned int x = min.x; x < (unsigned int)max.x; ++x) {
+			const uint64_t *row = row_masks.data() + (x + z * block_size.x) * row_masks_stride;
+
+			for (unsigned int w = 0; w < end_word; ++w) {
+				const unsigned int wi = w * ROW_MASK_COUNT;
+
+				uint64_t occluded_sides[Cube::SIDE_COUNT];
+				get_row_word_occluded_sides(
+						row, block_size.x * row_masks_stride, row_masks_stride, w, row_word_count, occluded_sides
+				);
+
+				uint64_t hidden_mask = row[wi + ROW_MASK_FULL_CUBE];
+				for (unsigned int side = 0; side < Cube::SIDE_COUNT; ++side) {
+					hidden_mask &= occluded_sides[side];
+				}
+
+				for (uint64_t visit_mask = row[wi + ROW_MASK_SOLID] & ~hidden_mask &
+							 get_row_word_range_mask(w, min.y, max.y);
+					 visit_mask != 0;
+					 visit_mask &= visit_mask - 1) {
+					const unsigned int y_bit = math::get_lowest_bit_index_u64(visit_mask);
+					const unsigned int y = w * 64 + y_bit;
+
+					const unsigned int voxel_index = y + x * row_size + z * deck_size;
+					const BakedModel &voxel = library.models[type_buffer[voxel_index]];
+					const BakedModel::Model &model = voxel.model;
+
+					const uint32_t visible_sides_mask = get_visible_sides_mask(
+							library, voxel, occluded_sides, y_bit, type_buffer, voxel_index, side_neighbor_lut
+					);
+
+					uint8_t model_surface_count = model.surface_count;
+					Span<const BakedModel::Surface> model_surfaces = to_span(model.surfaces);
+					const FixedArray<FixedArray<BakedModel::SideSurface, MAX_SURFACES>, Cube::SIDE_COUNT>
+							*model_sides_surfaces = &model.sides_surfaces;
+
+					if (voxel.fluid_index != NULL_FLUID_INDEX) {
+						if (!generate_fluid_model(
+									voxel,
+									type_buffer,
+									voxel_index,
+									1,
+									row_size,
+									deck_size,
+									visible_sides_mask,
+									library,
+									model_surfaces,
+									model_sides_surfaces
+							)) {
+							continue;
+						}
+						model_surface_count = 1;
+					}
+
+					// Subtracting 1 because the data is padded
 					const Vector3f pos(x - 1, y - 1, z - 1);
 
-					if (tangents.size() > 0) {
-						const int append_index = arrays.tangents.size();
-						arrays.tangents.resize(arrays.tangents.size() + vertex_count * 4);
-						memcpy(arrays.tangents.data() + append_index,
-							   tangents.data(),
-							   (vertex_count * 4) * sizeof(float));
+					for (unsigned int side = 0; side < Cube::SIDE_COUNT; ++side) {
+						if ((visible_sides_mask & (1 << side)) == 0) {
+							continue;
+						}
+
+						if (is_side_collision_mergeable(voxel, side)) {
+							merged_faces[voxel_index] |= (1 << side);
+							continue;
+						}
+
+						const FixedArray<BakedModel::SideSurface, MAX_SURFACES> &side_surfaces =
+								get_visible_side_surfaces(
+										library,
+										voxel,
+										*model_sides_surfaces,
+										side,
+										type_buffer,
+										voxel_index,
+										side_neighbor_lut
+								);
+
+						for (unsigned int surface_index = 0; surface_index < model_surface_count; ++surface_index) {
+							if (model_surfaces[surface_index].collision_enabled) {
+								const BakedModel::SideSurface &side_surface = side_surfaces[surface_index];
+								append_collision_geometry(
+										collision_surface, side_surface.positions, side_surface.indices, pos
+								);
+							}
+						}
 					}
 
-					for (unsigned int i = 0; i < vertex_count; ++i) {
-						arrays.normals.push_back(normals[i]);
-						arrays.uvs.push_back(uvs[i]);
-						arrays.positions.push_back(positions[i] + pos);
-						// TODO handle ambient occlusion on inner parts
-						arrays.colors.push_back(modulate_color);
+					// Inside
+					for (unsigned int surface_index = 0; surface_index < model_surface_count; ++surface_index) {
+						const BakedModel::Surface &surface = model_surfaces[surface_index];
+						if (surface.collision_enabled) {
+							append_collision_geometry(collision_surface, surface.positions, surface.indices, pos);
+						}
 					}
+				}
+			}
+		}
+	}
+
+	// Merge sides into rectangles, slice by slice, like `generate_greedy_faces`
+	for (unsigned int side = 0; side < Cube::SIDE_COUNT; ++side) {
+		const unsigned int za = side / 2;
+		const unsigned int ua = (za + 1) % 3;
+		const unsigned int va = (za + 2) % 3;
+
+		const unsigned int mask_size_u = max[ua] - min[ua];
+		const unsigned int mask_size_v = max[va] - min[va];
+		merge_mask.resize(mask_size_u * mask_size_v);
+
+		// Unit quad of the side, which gets stretched
+		FixedArray<Vector3f, 4> side_positions;
+		for (unsigned int i = 0; i < 4; ++i) {
+			side_positions[i] = Cube::g_corner_position[Cube::g_side_corners[side][i]];
+		}
 
-					const StdVector<int> &indices = surface.indices;
-					const unsigned int index_count = indices.size();
+		for (int d = min[za]; d < max[za]; ++d) {
+			for (unsigned int fv = 0; fv < mask_size_v; ++fv) {
+				for (unsigned int fu = 0; fu < mask_size_u; ++fu) {
+					Vector3i pos;
+					pos[ua] = fu + min[ua];
+					pos[va] = fv + min[va];
+					pos[za] = d;
+					const unsigned int voxel_index = pos.y + pos.x * row_size + pos.z * deck_size;
+					merge_mask[fu + fv * mask_size_u] = (merged_faces[voxel_index] >> side) & 1;
+				}
+			}
 
-					for (unsigned int i = 0; i < index_count; ++i) {
-						arrays.indices.push_back(index_offset + indices[i]);
+			for (unsigned int fv = 0; fv < mask_size_v; ++fv) {
+				for (unsigned int fu = 0; fu < mask_size_u; ++fu) {
+					if (merge_mask[fu + fv * mask_size_u] == 0) {
+						continue;
 					}
 
-					if (collision_surface != nullptr && surface.collision_enabled) {
-						StdVector<Vector3f> &dst_positions = collision_surface->positions;
-						StdVector<int> &dst_indices = collision_surface->indices;
+					unsigned int ru = fu + 1;
+					while (ru < mask_size_u && merge_mask[ru + fv * mask_size_u] != 0) {
+						++ru;
+					}
 
-						for (unsigned int i = 0; i < vertex_count; ++i) {
-							dst_positions.push_back(positions[i] + pos);
-						}
-						for (unsigned int i = 0; i < index_count; ++i) {
-							dst_indices.push_back(collision_surface_index_offset + indices[i]);
+					unsigned int rv = fv + 1;
+					while (rv < mask_size_v) {
+						const uint8_t *mask_row = merge_mask.data() + rv * mask_size_u;
+						if (std::find(mask_row + fu, mask_row + ru, 0) != mask_row + ru) {
+							break;
 						}
+						++rv;
+					}
 
-						collision_surface_index_offset += vertex_count;
+					for (unsigned int j = fv; j < rv; ++j) {
+						uint8_t *mask_row = merge_mask.data() + j * mask_size_u;
+						std::fill(mask_row + fu, mask_row + ru, 0);
 					}
 
-					index_offset += vertex_count;
+					// Mask coordinates don't include padding
+					Vector3f origin;
+					origin[ua] = fu;
+					origin[va] = fv;
+					origin[za] = d - VoxelMesherBlocky::PADDING;
+
+					const float size_u = ru - fu;
+					const float size_v = rv - fv;
+
+					const int index_offset = collision_surface.positions.size();
+
+					for (unsigned int i = 0; i < 4; ++i) {
+						Vector3f p = side_positions[i];
+						p[ua] *= size_u;
+						p[va] *= size_v;
+						collision_surface.positions.push_back(p + origin);
+					}
+					for (unsigned int i = 0; i < 6; ++i) {
+						collision_surface.indices.push_back(index_offset + Cube::g_side_quad_triangles[side][i]);
+					}
 				}
 			}
 		}
@@ -499,6 +1342,38 @@ VoxelMesherBlocky::Cache &VoxelMesherBlocky::get_tls_cache() {
 	return cache;
 }
 
+namespace {
+
+template <typename T>
+inline size_t get_capacity_in_bytes(const StdVector<T> &v) {
+	return v.capacity() * sizeof(T);
+}
+
+} // namespace
+
+size_t VoxelMesherBlocky::get_tls_cache_capacity_in_bytes() {
+	const Cache &cache = get_tls_cache();
+	size_t size = 0;
+	for (const Arrays &arrays : cache.arrays_per_material) {
+		size += get_capacity_in_bytes(arrays.positions);
+		size += get_capacity_in_bytes(arrays.normals);
+		size += get_capacity_in_bytes(arrays.uvs);
+		size += get_capacity_in_bytes(arrays.colors);
+		size += get_capacity_in_bytes(arrays.indices);
+		size += get_capacity_in_bytes(arrays.tangents);
+	}
+	size += get_capacity_in_bytes(cache.greedy_faces);
+	size += get_capacity_in_bytes(cache.greedy_mask);
+	size += get_capacity_in_bytes(cache.row_masks);
+	size += get_capacity_in_bytes(cache.collision_merge_mask);
+	size += get_capacity_in_bytes(cache.padded_view_voxels);
+	size += get_capacity_in_bytes(cache.collision_surface.positions);
+	size += get_capacity_in_bytes(cache.collision_surface.indices);
+	size += get_capacity_in_bytes(cache.occluder_arrays.vertices);
+	size += get_capacity_in_bytes(cache.occluder_arrays.indices);
+	return size;
+}
+
 void VoxelMesherBlocky::set_library(Ref<VoxelBlockyLibraryBase> library) {
 	RWLockWrite wlock(_parameters_lock);
 	_parameters.library = library;
@@ -529,6 +1404,26 @@ bool VoxelMesherBlocky::get_occlusion_enabled() const {
 	return _parameters.bake_occlusion;
 }
 
+void VoxelMesherBlocky::set_greedy_meshing_enabled(bool enable) {
+	RWLockWrite wlock(_parameters_lock);
+	_parameters.greedy_meshing = enable;
+}
+
+bool VoxelMesherBlocky::is_greedy_meshing_enabled() const {
+	RWLockRead rlock(_parameters_lock);
+	return _parameters.greedy_meshing;
+}
+
+void VoxelMesherBlocky::set_vertex_compression_enabled(bool enable) {
+	RWLockWrite wlock(_parameters_lock);
+	_parameters.vertex_compression = enable;
+}
+
+bool VoxelMesherBlocky::is_vertex_compression_enabled() const {
+	RWLockRead rlock(_parameters_lock);
+	return _parameters.vertex_compression;
+}
+
 void VoxelMesherBlocky::set_shadow_occluder_side(Side side, bool enabled) {
 	RWLockWrite wlock(_parameters_lock);
 	if (enabled) {
@@ -588,12 +1483,12 @@ void VoxelMesherBlocky::build(VoxelMesher::Output &output, const VoxelMesher::In
 	}
 
 	// The technique is Culled faces.
-	// Could be improved with greedy meshing: https://0fps.net/2012/06/30/meshing-in-a-minecraft-game/
-	// However I don't feel it's worth it yet:
+	// Optionally, greedy meshing merges sides that are unit quads with a repeating texture:
+	// https://0fps.net/2012/06/30/meshing-in-a-minecraft-game/
+	// It is not the default:
 	// - Not so much gain for organic worlds with lots of texture variations
-	// - Works well with cubes but not with any shape
+	// - Works well with cubes but not with any shape, and not with texture atlases
 	// - Slower
-	// => Could be implemented in a separate class?
 
 	const VoxelBuffer &voxels = input.voxels;
 
@@ -604,25 +1499,43 @@ void VoxelMesherBlocky::build(VoxelMesher::Output &output, const VoxelMesher::In
 	// That means we can use raw pointers to voxel data inside instead of using the higher-level getters,
 	// and then save a lot of time.
 
-	if (voxels.get_channel_compression(channel) == VoxelBuffer::COMPRESSION_UNIFORM) {
-		// All voxels have the same type.
-		// If it's all air, nothing to do. If it's all cubes, nothing to do either.
-		// TODO Handle edge case of uniform block with non-cubic voxels!
-		// If the type of voxel still produces geometry in this situation (which is an absurd use case but not an
-		// error), decompress into a backing array to still allow the use of the same algorithm.
-		return;
+	Span<const uint8_t> raw_channel;
 
-	} else if (voxels.get_channel_compression(channel) != VoxelBuffer::COMPRESSION_NONE) {
-		// No other form of compression is allowed
-		ERR_PRINT("VoxelMesherBlocky received unsupported voxel compression");
-		return;
-	}
+	if (input.padded_view != nullptr) {
+		const VoxelBufferPaddedView &padded_view = *input.padded_view;
+		ZN_ASSERT_RETURN(padded_view.get_size() == voxels.get_size());
+		ZN_ASSERT_RETURN(padded_view.get_channel_depth(channel) == voxels.get_channel_depth(channel));
+		if (padded_view.is_uniform(channel)) {
+			// Same as a uniform buffer below
+			return;
+		}
+		// Only the channel used here is gathered from the blocks, row by row, into memory reused between builds
+		const size_t size_in_bytes = Vector3iUtil::get_volume_u64(padded_view.get_size()) *
+				VoxelBuffer::get_depth_byte_count(padded_view.get_channel_depth(channel));
+		cache.padded_view_voxels.resize(size_in_bytes);
+		padded_view.copy_channel_to(channel, to_span(cache.padded_view_voxels));
+		raw_channel = to_span_const(cache.padded_view_voxels);
 
-	Span<const uint8_t> raw_channel;
-	if (!voxels.get_channel_as_bytes_read_only(channel, raw_channel)) {
-		// Case supposedly handled before...
-		ERR_PRINT("Something wrong happened");
-		return;
+	} else {
+		if (voxels.get_channel_compression(channel) == VoxelBuffer::COMPRESSION_UNIFORM) {
+			// All voxels have the same type.
+			// If it's all air, nothing to do. If it's all cubes, nothing to do either.
+			// TODO Handle edge case of uniform block with non-cubic voxels!
+			// If the type of voxel still produces geometry in this situation (which is an absurd use case but not an
+			// error), decompress into a backing array to still allow the use of the same algorithm.
+			return;
+
+		} else if (voxels.get_channel_compression(channel) != VoxelBuffer::COMPRESSION_NONE) {
+			// No other form of compression is allowed
+			ERR_PRINT("VoxelMesherBlocky received unsupported voxel compression");
+			return;
+		}
+
+		if (!voxels.get_channel_as_bytes_read_only(channel, raw_channel)) {
+			// Case supposedly handled before...
+			ERR_PRINT("Something wrong happened");
+			return;
+		}
 	}
 
 	const Vector3i block_size = voxels.get_size();
@@ -630,7 +1543,59 @@ void VoxelMesherBlocky::build(VoxelMesher::Output &output, const VoxelMesher::In
 
 	VoxelMesher::Output::CollisionSurface *collision_surface = nullptr;
 	if (input.collision_hint) {
-		collision_surface = &output.collision_surface;
+		collision_surface = &cache.collision_surface;
+		collision_surface->positions.clear();
+		collision_surface->indices.clear();
+	}
+
+	if (collision_surface != nullptr && input.collision_only_hint) {
+		// Nothing will be rendered, so only positions and indices of collision geometry are needed
+		{
+			RWLockRead lock(params.library->get_baked_data_rw_lock());
+			const blocky::BakedLibrary &library_baked_data = params.library->get_baked_data();
+
+			switch (channel_depth) {
+				case VoxelBuffer::DEPTH_8_BIT:
+					blocky::generate_collision_mesh(
+							*collision_surface,
+							raw_channel,
+							block_size,
+							library_baked_data,
+							cache.row_masks,
+							cache.greedy_faces,
+							cache.collision_merge_mask
+					);
+					break;
+
+				case VoxelBuffer::DEPTH_16_BIT:
+					blocky::generate_collision_mesh(
+							*collision_surface,
+							raw_channel.reinterpret_cast_to<const uint16_t>(),
+							block_size,
+							library_baked_data,
+							cache.row_masks,
+							cache.greedy_faces,
+							cache.collision_merge_mask
+					);
+					break;
+
+				default:
+					ERR_PRINT("Unsupported voxel depth");
+					return;
+			}
+		}
+
+		if (input.lod_index > 0) {
+			const float lod_scale = 1 << input.lod_index;
+			for (Vector3f &p : collision_surface->positions) {
+				p = p * lod_scale;
+			}
+		}
+
+		output.collision_surface.positions = collision_surface->positions;
+		output.collision_surface.indices = collision_surface->indices;
+		output.primitive_type = Mesh::PRIMITIVE_TRIANGLES;
+		return;
 	}
 
 	unsigned int material_count = 0;
@@ -648,6 +1613,63 @@ void VoxelMesherBlocky::build(VoxelMesher::Output &output, const VoxelMesher::In
 		const blocky::TintSampler tint_sampler =
 				blocky::TintSampler::create(voxels, static_cast<blocky::TintSampler::Mode>(params.tint_mode));
 
+		StdVector<uint32_t> *greedy_faces = params.greedy_meshing ? &cache.greedy_faces : nullptr;
+		if (params.greedy_meshing && !library_baked_data.has_mergeable_sides) {
+			// Otherwise it's not obvious why the option has no effect, since it's the case of the default cube setup
+			ZN_PRINT_WARNING_ONCE(
+					"VoxelMesherBlocky: greedy meshing is enabled, but no side of the library can be merged. Sides "
+					"using a tile of a texture atlas are never merged."
+			);
+		}
+
+		// Incremental builds keep the mesh of each brick of the block, so the next build only has to rebuild bricks
+		// touching edited voxels. Not done with LOD, where blocks are rarely edited one voxel at a time.
+		StdVector<MeshBrick> *bricks = nullptr;
+		Box3i dirty_box;
+		if (input.incremental_hint && input.lod_index == 0) {
+			std::shared_ptr<IncrementalCache> incremental_cache;
+			if (input.incremental_cache != nullptr && input.incremental_cache->mesher == this) {
+				incremental_cache = std::static_pointer_cast<IncrementalCache>(input.incremental_cache);
+			} else {
+				incremental_cache = make_shared_instance<IncrementalCache>();
+				incremental_cache->mesher = this;
+			}
+
+			const Parameters &cached_params = incremental_cache->parameters;
+			const bool is_cache_valid = incremental_cache->bricks.size() > 0 && //
+					incremental_cache->block_size == block_size && //
+					incremental_cache->library_bake_version == library_baked_data.bake_version && //
+					incremental_cache->collision_enabled == (collision_surface != nullptr) && //
+					cached_params.library == params.library && //
+					cached_params.bake_occlusion == params.bake_occlusion && //
+					cached_params.baked_occlusion_darkness == params.baked_occlusion_darkness && //
+					cached_params.tint_mode == params.tint_mode && //
+					cached_params.greedy_meshing == params.greedy_meshing;
+
+			if (is_cache_valid) {
+				if (!input.dirty_box.is_empty()) {
+					// Padding because voxels affect faces and ambient occlusion of their neighbors
+					const Box3i dirty_box_in_buffer(
+							input.dirty_box.position + Vector3iUtil::create(PADDING), input.dirty_box.size
+					);
+					dirty_box = dirty_box_in_buffer.padded(1);
+				}
+			} else {
+				incremental_cache->parameters = params;
+				incremental_cache->library_bake_version = library_baked_data.bake_version;
+				incremental_cache->block_size = block_size;
+				incremental_cache->collision_enabled = collision_surface != nullptr;
+				incremental_cache->bricks.clear();
+				incremental_cache->bricks.resize(Vector3iUtil::get_volume_u64(
+						math::ceildiv(block_size - Vector3iUtil::create(2 * PADDING), INCREMENTAL_BRICK_SIZE)
+				));
+				dirty_box = Box3i(Vector3i(), block_size);
+			}
+
+			bricks = &incremental_cache->bricks;
+			output.incremental_cache = incremental_cache;
+		}
+
 		switch (channel_depth) {
 			case VoxelBuffer::DEPTH_8_BIT:
 				blocky::generate_mesh(
@@ -658,7 +1680,12 @@ void VoxelMesherBlocky::build(VoxelMesher::Output &output, const VoxelMesher::In
 						library_baked_data,
 						params.bake_occlusion,
 						baked_occlusion_darkness,
-						tint_sampler
+						tint_sampler,
+						greedy_faces,
+						cache.greedy_mask,
+						cache.row_masks,
+						bricks,
+						dirty_box
 				);
 				if (input.lod_index > 0) {
 					blocky::append_skirts(
@@ -677,7 +1704,12 @@ void VoxelMesherBlocky::build(VoxelMesher::Output &output, const VoxelMesher::In
 						library_baked_data,
 						params.bake_occlusion,
 						baked_occlusion_darkness,
-						tint_sampler
+						tint_sampler,
+						greedy_faces,
+						cache.greedy_mask,
+						cache.row_masks,
+						bricks,
+						dirty_box
 				);
 				if (input.lod_index > 0) {
 					blocky::append_skirts(model_ids, block_size, arrays_per_material, library_baked_data, tint_sampler);
@@ -705,9 +1737,20 @@ void VoxelMesherBlocky::build(VoxelMesher::Output &output, const VoxelMesher::In
 		}
 	}
 
+	if (collision_surface != nullptr) {
+		output.collision_surface.positions = collision_surface->positions;
+		output.collision_surface.indices = collision_surface->indices;
+	}
+
 	// TODO Optimization: we could return a single byte array and use Mesh::add_surface down the line?
 	// That API does not seem to exist yet though.
 
+	if (params.vertex_compression) {
+		output.mesh_flags |= Mesh::ARRAY_FLAG_COMPRESS_ATTRIBUTES;
+	}
+
+	output.surfaces.reserve(material_count);
+
 	for (unsigned int material_index = 0; material_index < material_count; ++material_index) {
 		const Arrays &arrays = arrays_per_material[material_index];
 
@@ -753,8 +1796,9 @@ void VoxelMesherBlocky::build(VoxelMesher::Output &output, const VoxelMesher::In
 	}
 
 	if (params.shadow_occluders_mask != 0 && !blocky::is_empty(arrays_per_material)) {
-		// TODO Candidate for temp allocator (maybe even stack allocator in this case?)
-		blocky::OccluderArrays occluder_arrays;
+		blocky::OccluderArrays &occluder_arrays = cache.occluder_arrays;
+		occluder_arrays.vertices.clear();
+		occluder_arrays.indices.clear();
 
 		RWLockRead lock(params.library->get_baked_data_rw_lock());
 		const blocky::BakedLibrary &library_baked_data = params.library->get_baked_data();
@@ -833,6 +1877,11 @@ int VoxelMesherBlocky::get_used_channels_mask() const {
 	return mask;
 }
 
+bool VoxelMesherBlocky::supports_padded_view() const {
+	// Tint is sampled from another channel with random access, which requires voxels to be in a single buffer
+	return get_tint_mode() == TINT_NONE;
+}
+
 Ref<Material> VoxelMesherBlocky::get_material_by_index(unsigned int index) const {
 	Ref<VoxelBlockyLibraryBase> lib = get_library();
 	if (lib.is_null()) {
@@ -872,6 +1921,16 @@ void VoxelMesherBlocky::get_configuration_warnings(PackedStringArray &out_warnin
 		return;
 	}
 
+	if (is_greedy_meshing_enabled()) {
+		if (!baked_data.has_mergeable_sides) {
+			out_warnings.append(
+					String(ZN_TTR("Greedy meshing is enabled on {0}, but none of the models of its library have "
+								  "sides that can be merged. Sides using a tile of a texture atlas are never merged."))
+							.format(varray(VoxelMesherBlocky::get_class_static()))
+			);
+		}
+	}
+
 	library->get_configuration_warnings(out_warnings);
 }
 
@@ -887,6 +1946,16 @@ void VoxelMesherBlocky::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_occlusion_darkness", "value"), &VoxelMesherBlocky::set_occlusion_darkness);
 	ClassDB::bind_method(D_METHOD("get_occlusion_darkness"), &VoxelMesherBlocky::get_occlusion_darkness);
 
+	ClassDB::bind_method(
+			D_METHOD("set_greedy_meshing_enabled", "enable"), &VoxelMesherBlocky::set_greedy_meshing_enabled
+	);
+	ClassDB::bind_method(D_METHOD("is_greedy_meshing_enabled"), &VoxelMesherBlocky::is_greedy_meshing_enabled);
+
+	ClassDB::bind_method(
+			D_METHOD("set_vertex_compression_enabled", "enable"), &VoxelMesherBlocky::set_vertex_compression_enabled
+	);
+	ClassDB::bind_method(D_METHOD("is_vertex_compression_enabled"), &VoxelMesherBlocky::is_vertex_compression_enabled);
+
 	ClassDB::bind_method(
 			D_METHOD("set_shadow_occluder_side", "side", "enabled"), &VoxelMesherBlocky::set_shadow_occluder_side
 	);
@@ -921,6 +1990,16 @@ void VoxelMesherBlocky::_bind_methods() {
 			"set_tint_mode",
 			"get_tint_mode"
 	);
+	ADD_PROPERTY(
+			PropertyInfo(Variant::BOOL, "greedy_meshing_enabled"),
+			"set_greedy_meshing_enabled",
+			"is_greedy_meshing_enabled"
+	);
+	ADD_PROPERTY(
+			PropertyInfo(Variant::BOOL, "vertex_compression_enabled"),
+			"set_vertex_compression_enabled",
+			"is_vertex_compression_enabled"
+	);
 
 	ADD_GROUP("Shadow Occluders", "shadow_occluder_");
 
@@ -5,6 +5,7 @@
 #include "../../util/math/color.h"
 #include "../../util/thread/rw_lock.h"
 #include "../voxel_mesher.h"
+#include "blocky_shadow_occluders.h"
 #include "blocky_tint_sampler.h"
 #include "voxel_blocky_library_base.h"
 
@@ -12,6 +13,26 @@
 
 namespace zylann::voxel {
 
+namespace blocky {
+
+// Face of a voxel in a slice, as seen by greedy meshing. Neighbor faces can be merged when they are equal.
+struct GreedyFace {
+	Color color;
+	uint32_t voxel_id;
+	uint8_t ao;
+	bool present;
+
+	inline bool operator==(const GreedyFace &other) const {
+		return present == other.present && voxel_id == other.voxel_id && ao == other.ao && color == other.color;
+	}
+
+	inline bool operator!=(const GreedyFace &other) const {
+		return !(*this == other);
+	}
+};
+
+} // namespace blocky
+
 // Interprets voxel values as indexes to models in a VoxelBlockyLibrary, and batches them together.
 // Overlapping faces are removed from the final mesh.
 class VoxelMesherBlocky : public VoxelMesher {
@@ -19,6 +40,9 @@ class VoxelMesherBlocky : public VoxelMesher {
 
 public:
 	static const int PADDING = 1;
+	// With `Input::incremental_hint`, blocks are meshed in bricks of this size, so only bricks touching edited voxels
+	// have to be rebuilt
+	static const int INCREMENTAL_BRICK_SIZE = 8;
 
 	VoxelMesherBlocky();
 	~VoxelMesherBlocky();
@@ -32,6 +56,12 @@ public:
 	void set_occlusion_enabled(bool enable);
 	bool get_occlusion_enabled() const;
 
+	void set_greedy_meshing_enabled(bool enable);
+	bool is_greedy_meshing_enabled() const;
+
+	void set_vertex_compression_enabled(bool enable);
+	bool is_vertex_compression_enabled() const;
+
 	enum Side {
 		SIDE_NEGATIVE_X = 0,
 		SIDE_POSITIVE_X,
@@ -73,9 +103,14 @@ public:
 		return true;
 	}
 
+	bool supports_padded_view() const override;
+
 	Ref<Material> get_material_by_index(unsigned int index) const override;
 	unsigned int get_material_index_count() const override;
 
+	// Exposed for testing. Gets how many bytes are reserved by buffers that builds reuse on the calling thread.
+	static size_t get_tls_cache_capacity_in_bytes();
+
 	// Using std::vector because they make this mesher twice as fast than Godot Vectors.
 	// See why: https://github.com/godotengine/godot/issues/24731
 	struct Arrays {
@@ -96,6 +131,12 @@ public:
 		}
 	};
 
+	// Part of the mesh of a block, kept between incremental builds
+	struct MeshBrick {
+		StdVector<Arrays> arrays_per_material;
+		Output::CollisionSurface collision_surface;
+	};
+
 #ifdef TOOLS_ENABLED
 	void get_configuration_warnings(PackedStringArray &out_warnings) const override;
 #endif
@@ -114,10 +155,34 @@ private:
 		uint8_t shadow_occluders_mask = 0;
 		Ref<VoxelBlockyLibraryBase> library;
 		TintMode tint_mode = TINT_NONE;
+		bool greedy_meshing = false;
+		bool vertex_compression = false;
 	};
 
 	struct Cache {
 		StdVector<Arrays> arrays_per_material;
+		// Per voxel, faces deferred to greedy meshing
+		StdVector<uint32_t> greedy_faces;
+		StdVector<blocky::GreedyFace> greedy_mask;
+		// Per row of voxels, bitmasks used to cull faces
+		StdVector<uint64_t> row_masks;
+		// Per slice of voxels, sides merged when only collision geometry is built
+		StdVector<uint8_t> collision_merge_mask;
+		// Voxels gathered from `Input::padded_view`
+		StdVector<uint8_t> padded_view_voxels;
+		// Geometry is accumulated here, then copied to the output with its final size
+		Output::CollisionSurface collision_surface;
+		blocky::OccluderArrays occluder_arrays;
+	};
+
+	struct IncrementalCache : public VoxelMesher::IncrementalCache {
+		// Bricks have to be rebuilt entirely if any of these differ from the current build
+		Parameters parameters;
+		uint32_t library_bake_version = 0;
+		Vector3i block_size;
+		bool collision_enabled = false;
+		// Indexed as [z][y][x]
+		StdVector<MeshBrick> bricks;
 	};
 
 	// Parameters
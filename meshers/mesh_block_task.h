@@ -6,6 +6,7 @@
 #include "../engine/meshing_dependency.h"
 #include "../engine/priority_dependency.h"
 #include "../storage/voxel_buffer.h"
+#include "../storage/voxel_buffer_padded_view.h"
 #include "../util/containers/std_vector.h"
 #include "../util/godot/classes/array_mesh.h"
 #include "../util/tasks/cancellation_token.h"
@@ -62,9 +63,21 @@ public:
 	bool require_visual = true;
 	// If true, a collision mesh is required if possible
 	bool collision_hint = false;
+	// If true, the mesh is only needed for collisions, and meshers may skip everything related to rendering. Only
+	// makes sense when `require_visual` is false.
+	bool collision_only_hint = false;
 	// If true, the mesh will be used in a context with LOD, which might require a few extra things in the way it is
 	// built
 	bool lod_hint = false;
+	// Sides bordering blocks of lower level of detail. See `VoxelMesher::Input`.
+	uint8_t transition_mask = 0b111111;
+	// If true, the mesher may only rebuild parts of the mesh intersecting `dirty_box`, using `incremental_cache`.
+	// See `VoxelMesher::Input`.
+	bool incremental_hint = false;
+	std::shared_ptr<VoxelMesher::IncrementalCache> incremental_cache;
+	Box3i dirty_box;
+	// Returned in the output, so the caller can tell which request it answers
+	uint32_t meshing_version = 0;
 	// Detail textures might be enabled, but we don't always want to update them in every mesh update.
 	// So this boolean is also checked to know if they should be computed.
 	bool require_detail_texture = false;
@@ -94,6 +107,9 @@ private:
 	uint8_t _stage = 0;
 #endif
 	VoxelBuffer _voxels;
+	// Used instead of copying blocks into `_voxels`, if the mesher supports it
+	VoxelBufferPaddedView _padded_view;
+	bool _use_padded_view = false;
 	VoxelMesher::Output _surfaces_output;
 	Ref<Mesh> _mesh;
 	Ref<Mesh> _shadow_occluder_mesh;
@@ -4,6 +4,7 @@
 #include "../../util/godot/core/sort_array.h"
 #include "../../util/math/conv.h"
 #include "../../util/math/funcs.h"
+#include "../../util/math/simd.h"
 #include "../../util/profiling.h"
 #include "transvoxel_materials_mixel4.h"
 #include "transvoxel_materials_null.h"
@@ -182,6 +183,138 @@ inline float get_isolevel<float>() {
 }
 
 // This function is template so we avoid branches and checks when sampling voxels
+// Returns bits of the 64-bit word `w` of a bitset, covering indices in `[begin, end)`
+inline uint64_t get_word_range_mask(const unsigned int w, const unsigned int begin, const unsigned int end) {
+	const unsigned int word_begin = w * 64;
+	if (end <= word_begin || begin >= word_begin + 64) {
+		return 0;
+	}
+	const unsigned int b = math::max(begin, word_begin) - word_begin;
+	const unsigned int e = math::min(end, word_begin + 64) - word_begin;
+	const uint64_t below_end = e == 64 ? ~uint64_t(0) : (uint64_t(1) << e) - 1;
+	return below_end & ~((uint64_t(1) << b) - 1);
+}
+
+// Finds regular cells crossing the isolevel, in the order they have to be processed (X first, then Y, then Z), and
+// computes their case code. Most cells of a block are fully above or below the isolevel, so they are skipped here
+// without visiting them one by one.
+template <typename TSdf>
+void find_active_cells(
+		Span<const TSdf> sdf_data,
+		const Vector3i block_size_with_padding,
+		const Vector3i min_pos,
+		const Vector3i max_pos,
+		Cache &cache
+) {
+	ZN_PROFILE_SCOPE();
+
+	const Vector3i bs = block_size_with_padding;
+
+	// Get direct representation of the isolevel (not always zero since we are not using signed integers yet)
+	const TSdf isolevel = get_isolevel<TSdf>();
+
+	// Get signs of whole columns of voxels along Y, which are contiguous in memory. Bits are set where the SDF is above
+	// the isolevel.
+	// The chosen comparison here is very important. This relates to case selections where 4 samples are equal to the
+	// isolevel and 4 others are above or below:
+	// In one of these two cases, there has to be a surface to extract, otherwise no surface will be allowed to appear
+	// if it happens to line up with integer coordinates.
+	// If we used `<` instead of `>`, it would appear to work, but would break those edge cases.
+	// `>` is also what the case code needs: `sdf_as_float` negates SDF values (Transvoxel's sign convention is
+	// inverted), so `v > isolevel` is the same as `sign_f(sdf_as_float(v))`, which transition cells use. These bits are
+	// therefore directly the bits of the case code.
+	const unsigned int column_word_count = (bs.y + 63) / 64;
+	const unsigned int column_count = bs.x * bs.z;
+	StdVector<uint64_t> &sign_bits = cache.sign_bits;
+	sign_bits.resize(column_count * column_word_count);
+	for (unsigned int column_index = 0; column_index < column_count; ++column_index) {
+		simd::get_greater_bits(
+				sdf_data.data() + column_index * bs.y, bs.y, isolevel, &sign_bits[column_index * column_word_count]
+		);
+	}
+
+	// For each Y in the current deck, bits of cells crossing the isolevel, indexed by X
+	const unsigned int row_word_count = (bs.x + 63) / 64;
+	StdVector<uint64_t> &active_rows = cache.active_cell_rows;
+	active_rows.clear();
+	active_rows.resize(bs.y * row_word_count, 0);
+
+	StdVector<ActiveCell> &active_cells = cache.active_cells;
+	active_cells.clear();
+
+	for (int z = min_pos.z; z < max_pos.z; ++z) {
+		for (int x = min_pos.x; x < max_pos.x; ++x) {
+			// Columns of corners of the cells at (x, z)
+			const uint64_t *c00 = &sign_bits[(x + z * bs.x) * column_word_count];
+			const uint64_t *c10 = c00 + column_word_count;
+			const uint64_t *c01 = c00 + bs.x * column_word_count;
+			const uint64_t *c11 = c01 + column_word_count;
+
+			for (unsigned int w = 0; w < column_word_count; ++w) {
+				const uint64_t any_above = c00[w] | c10[w] | c01[w] | c11[w];
+				const uint64_t all_above = c00[w] & c10[w] & c01[w] & c11[w];
+
+				// Cells also have corners one voxel higher
+				uint64_t any_above_next = any_above >> 1;
+				uint64_t all_above_next = all_above >> 1;
+				if (w + 1 < column_word_count) {
+					any_above_next |= (c00[w + 1] | c10[w + 1] | c01[w + 1] | c11[w + 1]) << 63;
+					all_above_next |= (c00[w + 1] & c10[w + 1] & c01[w + 1] & c11[w + 1]) << 63;
+				}
+
+				// Not crossing the isolevel means all corners have the same sign
+				uint64_t active = (any_above | any_above_next) & ~(all_above & all_above_next);
+				active &= get_word_range_mask(w, min_pos.y, max_pos.y);
+
+				for (; active != 0; active &= active - 1) {
+					const unsigned int y = w * 64 + math::get_lowest_bit_index_u64(active);
+					active_rows[y * row_word_count + (x >> 6)] |= uint64_t(1) << (x & 63);
+				}
+			}
+		}
+
+		struct L {
+			static inline uint8_t get_bit(const uint64_t *column, unsigned int y) {
+				return (column[y >> 6] >> (y & 63)) & 1;
+			}
+		};
+
+		for (int y = min_pos.y; y < max_pos.y; ++y) {
+			for (unsigned int w = 0; w < row_word_count; ++w) {
+				uint64_t &row_bits = active_rows[y * row_word_count + w];
+
+				for (uint64_t active = row_bits; active != 0; active &= active - 1) {
+					const unsigned int x = w * 64 + math::get_lowest_bit_index_u64(active);
+
+					const uint64_t *c00 = &sign_bits[(x + z * bs.x) * column_word_count];
+					const uint64_t *c10 = c00 + column_word_count;
+					const uint64_t *c01 = c00 + bs.x * column_word_count;
+					const uint64_t *c11 = c01 + column_word_count;
+
+					// Concatenate the sign of cell values to obtain the case code.
+					// Index 0 is the less significant bit, and index 7 is the most significant bit.
+					uint8_t case_code = L::get_bit(c00, y);
+					case_code |= L::get_bit(c10, y) << 1;
+					case_code |= L::get_bit(c00, y + 1) << 2;
+					case_code |= L::get_bit(c10, y + 1) << 3;
+					case_code |= L::get_bit(c01, y) << 4;
+					case_code |= L::get_bit(c11, y) << 5;
+					case_code |= L::get_bit(c01, y + 1) << 6;
+					case_code |= L::get_bit(c11, y + 1) << 7;
+
+					active_cells.push_back(ActiveCell{ static_cast<uint16_t>(x),
+													   static_cast<uint16_t>(y),
+													   static_cast<uint16_t>(z),
+													   case_code });
+				}
+
+				// Clear for the next deck
+				row_bits = 0;
+			}
+		}
+	}
+}
+
 template <typename TSdf, typename TMaterialProcessor>
 void build_regular_mesh(
 		Span<const TSdf> sdf_data,
@@ -219,385 +352,342 @@ void build_regular_mesh(
 	const unsigned int n011 = n010 + n001;
 	const unsigned int n111 = n100 + n010 + n001;
 
-	// Get direct representation of the isolevel (not always zero since we are not using signed integers yet)
-	const TSdf isolevel = get_isolevel<TSdf>();
+	find_active_cells(sdf_data, block_size_with_padding, min_pos, max_pos, cache);
+
+	// Iterate cells crossing the isolevel, with padding (expected to be neighbors)
+	for (const ActiveCell &cell : cache.active_cells) {
+		const Vector3i pos(cell.x, cell.y, cell.z);
+		const unsigned int data_index = Vector3iUtil::get_zxy_index(pos, block_size_with_padding);
+		const uint8_t case_code = cell.case_code;
+
+		//    6-------7
+		//   /|      /|
+		//  / |     / |  Corners
+		// 4-------5  |
+		// |  2----|--3
+		// | /     | /   z y
+		// |/      |/    |/
+		// 0-------1     o--x
+
+		FixedArray<unsigned int, 8> corner_data_indices;
+		corner_data_indices[0] = data_index;
+		corner_data_indices[1] = data_index + n100;
+		corner_data_indices[2] = data_index + n010;
+		corner_data_indices[3] = data_index + n110;
+		corner_data_indices[4] = data_index + n001;
+		corner_data_indices[5] = data_index + n101;
+		corner_data_indices[6] = data_index + n011;
+		corner_data_indices[7] = data_index + n111;
+
+		FixedArray<float, 8> cell_samples_sdf;
+		for (unsigned int i = 0; i < corner_data_indices.size(); ++i) {
+			cell_samples_sdf[i] = sdf_as_float(sdf_data[corner_data_indices[i]]);
+		}
 
-	// Iterate all cells with padding (expected to be neighbors)
-	Vector3i pos;
-	for (pos.z = min_pos.z; pos.z < max_pos.z; ++pos.z) {
-		for (pos.y = min_pos.y; pos.y < max_pos.y; ++pos.y) {
-			// TODO Optimization: change iteration to be ZXY? (Data is laid out with Y as deepest coordinate)
-			unsigned int data_index =
-					Vector3iUtil::get_zxy_index(Vector3i(min_pos.x, pos.y, pos.z), block_size_with_padding);
+#ifdef DEBUG_ENABLED
+		{
+			// The case code from the pre-pass must match the one Transvoxel defines, otherwise winding would flip
+			uint8_t expected_case_code = 0;
+			for (unsigned int i = 0; i < cell_samples_sdf.size(); ++i) {
+				expected_case_code |= sign_f(cell_samples_sdf[i]) << i;
+			}
+			ZN_ASSERT(case_code == expected_case_code);
+		}
+#endif
 
-			for (pos.x = min_pos.x; pos.x < max_pos.x; ++pos.x, data_index += block_size_with_padding.y) {
-				{
-					// The chosen comparison here is very important. This relates to case selections where 4 samples
-					// are equal to the isolevel and 4 others are above or below:
-					// In one of these two cases, there has to be a surface to extract, otherwise no surface will be
-					// allowed to appear if it happens to line up with integer coordinates.
-					// If we used `<` instead of `>`, it would appear to work, but would break those edge cases.
-					// `>` is chosen because it must match the comparison we do with case selection (in Transvoxel
-					// it is inverted).
-					const bool s = sdf_data[data_index] > isolevel;
-
-					if ( //
-							(sdf_data[data_index + n010] > isolevel) == s &&
-							(sdf_data[data_index + n100] > isolevel) == s &&
-							(sdf_data[data_index + n110] > isolevel) == s &&
-							(sdf_data[data_index + n001] > isolevel) == s &&
-							(sdf_data[data_index + n011] > isolevel) == s &&
-							(sdf_data[data_index + n101] > isolevel) == s &&
-							(sdf_data[data_index + n111] > isolevel) == s) {
-						// Not crossing the isolevel, this cell won't produce any geometry.
-						// We must figure this out as fast as possible, because it will happen a lot.
-						continue;
-					}
-				}
+		ReuseCell &current_reuse_cell = cache.get_reuse_cell(pos);
+
+		FixedArray<Vector3i, 8> padded_corner_positions;
+		padded_corner_positions[0] = Vector3i(pos.x, pos.y, pos.z);
+		padded_corner_positions[1] = Vector3i(pos.x + 1, pos.y, pos.z);
+		padded_corner_positions[2] = Vector3i(pos.x, pos.y + 1, pos.z);
+		padded_corner_positions[3] = Vector3i(pos.x + 1, pos.y + 1, pos.z);
+		padded_corner_positions[4] = Vector3i(pos.x, pos.y, pos.z + 1);
+		padded_corner_positions[5] = Vector3i(pos.x + 1, pos.y, pos.z + 1);
+		padded_corner_positions[6] = Vector3i(pos.x, pos.y + 1, pos.z + 1);
+		padded_corner_positions[7] = Vector3i(pos.x + 1, pos.y + 1, pos.z + 1);
+
+		current_reuse_cell.packed_texture_indices = material_processor.on_cell(corner_data_indices, case_code);
+
+		FixedArray<Vector3i, 8> corner_positions;
+		for (unsigned int i = 0; i < padded_corner_positions.size(); ++i) {
+			const Vector3i p = padded_corner_positions[i];
+			// Undo padding here. From this point, corner positions are actual positions.
+			corner_positions[i] = (p - min_pos) << lod_index;
+		}
 
-				//    6-------7
-				//   /|      /|
-				//  / |     / |  Corners
-				// 4-------5  |
-				// |  2----|--3
-				// | /     | /   z y
-				// |/      |/    |/
-				// 0-------1     o--x
-
-				FixedArray<unsigned int, 8> corner_data_indices;
-				corner_data_indices[0] = data_index;
-				corner_data_indices[1] = data_index + n100;
-				corner_data_indices[2] = data_index + n010;
-				corner_data_indices[3] = data_index + n110;
-				corner_data_indices[4] = data_index + n001;
-				corner_data_indices[5] = data_index + n101;
-				corner_data_indices[6] = data_index + n011;
-				corner_data_indices[7] = data_index + n111;
-
-				FixedArray<float, 8> cell_samples_sdf;
-				for (unsigned int i = 0; i < corner_data_indices.size(); ++i) {
-					cell_samples_sdf[i] = sdf_as_float(sdf_data[corner_data_indices[i]]);
-				}
+		// For cells occurring along the minimal boundaries of a block,
+		// the preceding cells needed for vertex reuse may not exist.
+		// In these cases, we allow new vertex creation on additional edges of a cell.
+		// While iterating through the cells in a block, a 3-bit mask is maintained whose bits indicate
+		// whether corresponding bits in a direction code are valid
+		const uint8_t direction_validity_mask = (pos.x > min_pos.x ? 1 : 0) |
+				((pos.y > min_pos.y ? 1 : 0) << 1) | ((pos.z > min_pos.z ? 1 : 0) << 2);
+
+		const uint8_t regular_cell_class_index = tables::get_regular_cell_class(case_code);
+		const tables::RegularCellData &regular_cell_data = tables::get_regular_cell_data(regular_cell_class_index);
+		const uint8_t triangle_count = regular_cell_data.geometryCounts & 0x0f;
+		const uint8_t vertex_count = (regular_cell_data.geometryCounts & 0xf0) >> 4;
+
+		FixedArray<int, 12> cell_vertex_indices;
+		fill(cell_vertex_indices, -1);
+
+		// TODO When not using LOD, this is not necessary
+		const uint8_t cell_border_mask = get_border_mask(pos - min_pos, block_size - Vector3i(1, 1, 1));
+
+		// For each vertex in the case
+		for (unsigned int vertex_index = 0; vertex_index < vertex_count; ++vertex_index) {
+			// The case index maps to a list of 16-bit codes providing information about the edges on which the
+			// vertices lie. The low byte of each 16-bit code contains the corner indexes of the edge’s
+			// endpoints in one nibble each, and the high byte contains the mapping code shown in Figure 3.8(b)
+			const unsigned short rvd = tables::get_regular_vertex_data(case_code, vertex_index);
+			const uint8_t edge_code_low = rvd & 0xff;
+			const uint8_t edge_code_high = (rvd >> 8) & 0xff;
+
+			// Get corner indexes in the low nibble (always ordered so the higher comes last)
+			const uint8_t v0 = (edge_code_low >> 4) & 0xf;
+			const uint8_t v1 = edge_code_low & 0xf;
 
-				// Concatenate the sign of cell values to obtain the case code.
-				// Index 0 is the less significant bit, and index 7 is the most significant bit.
-				uint8_t case_code = sign_f(cell_samples_sdf[0]);
-				case_code |= (sign_f(cell_samples_sdf[1]) << 1);
-				case_code |= (sign_f(cell_samples_sdf[2]) << 2);
-				case_code |= (sign_f(cell_samples_sdf[3]) << 3);
-				case_code |= (sign_f(cell_samples_sdf[4]) << 4);
-				case_code |= (sign_f(cell_samples_sdf[5]) << 5);
-				case_code |= (sign_f(cell_samples_sdf[6]) << 6);
-				case_code |= (sign_f(cell_samples_sdf[7]) << 7);
-
-				// TODO Is this really needed now that we check isolevel earlier?
-				if (case_code == 0 || case_code == 255) {
-					// If the case_code is 0 or 255, there is no triangulation to do.
-					continue;
-				}
+#ifdef DEBUG_ENABLED
+			ZN_ASSERT_RETURN(v1 > v0);
+#endif
 
-				ReuseCell &current_reuse_cell = cache.get_reuse_cell(pos);
+			// Get voxel values at the corners
+			const float sample0 = cell_samples_sdf[v0]; // called d0 in the paper
+			const float sample1 = cell_samples_sdf[v1]; // called d1 in the paper
 
-#if DEBUG_ENABLED
-				ZN_ASSERT(case_code <= 255);
+#ifdef DEBUG_ENABLED
+			// TODO Zero-division is not mentionned in the paper?? (never happens tho)
+			ZN_ASSERT_RETURN(sample1 != sample0);
+			ZN_ASSERT_RETURN(sample1 != 0 || sample0 != 0);
 #endif
 
-				FixedArray<Vector3i, 8> padded_corner_positions;
-				padded_corner_positions[0] = Vector3i(pos.x, pos.y, pos.z);
-				padded_corner_positions[1] = Vector3i(pos.x + 1, pos.y, pos.z);
-				padded_corner_positions[2] = Vector3i(pos.x, pos.y + 1, pos.z);
-				padded_corner_positions[3] = Vector3i(pos.x + 1, pos.y + 1, pos.z);
-				padded_corner_positions[4] = Vector3i(pos.x, pos.y, pos.z + 1);
-				padded_corner_positions[5] = Vector3i(pos.x + 1, pos.y, pos.z + 1);
-				padded_corner_positions[6] = Vector3i(pos.x, pos.y + 1, pos.z + 1);
-				padded_corner_positions[7] = Vector3i(pos.x + 1, pos.y + 1, pos.z + 1);
-
-				current_reuse_cell.packed_texture_indices = material_processor.on_cell(corner_data_indices, case_code);
-
-				FixedArray<Vector3i, 8> corner_positions;
-				for (unsigned int i = 0; i < padded_corner_positions.size(); ++i) {
-					const Vector3i p = padded_corner_positions[i];
-					// Undo padding here. From this point, corner positions are actual positions.
-					corner_positions[i] = (p - min_pos) << lod_index;
+			// Get interpolation position
+			// We use an 8-bit fraction, allowing the new vertex to be located at one of 257 possible
+			// positions  along  the  edge  when  both  endpoints  are included.
+			// const int t = (sample1 << 8) / (sample1 - sample0);
+			const float t = math::clamp(sample1 / (sample1 - sample0), edge_clamp_margin, edge_clamp_margin_max);
+
+			const Vector3i p0 = corner_positions[v0];
+			const Vector3i p1 = corner_positions[v1];
+
+			if (t > 0.f && t < 1.f) {
+				// Vertex is between p0 and p1 (inside the edge)
+
+				// Each edge of a cell is assigned an 8-bit code, as shown in Figure 3.8(b),
+				// that provides a mapping to a preceding cell and the coincident edge on that preceding cell
+				// for which new vertex creation  was  allowed.
+				// The high nibble of this code indicates which direction to go in order to reach the correct
+				// preceding cell. The bit values 1, 2, and 4 in this nibble indicate that we must subtract one
+				// from the x, y, and/or z coordinate, respectively.
+				const uint8_t reuse_dir = (edge_code_high >> 4) & 0xf;
+				const uint8_t reuse_vertex_index = edge_code_high & 0xf;
+
+				// TODO Some re-use opportunities are missed on negative sides of the block,
+				// but I don't really know how to fix it...
+				// You can check by "shaking" every vertex randomly in a shader based on its index,
+				// you will see vertices touching the -X, -Y or -Z sides of the block aren't connected
+
+				const bool present = (reuse_dir & direction_validity_mask) == reuse_dir;
+
+				if (present) {
+					const Vector3i cache_pos = pos + dir_to_prev_vec(reuse_dir);
+					const ReuseCell &prev_cell = cache.get_reuse_cell(cache_pos);
+					if (prev_cell.packed_texture_indices == current_reuse_cell.packed_texture_indices) {
+						// Will reuse a previous vertice
+						cell_vertex_indices[vertex_index] = prev_cell.vertices[reuse_vertex_index];
+					}
 				}
 
-				// For cells occurring along the minimal boundaries of a block,
-				// the preceding cells needed for vertex reuse may not exist.
-				// In these cases, we allow new vertex creation on additional edges of a cell.
-				// While iterating through the cells in a block, a 3-bit mask is maintained whose bits indicate
-				// whether corresponding bits in a direction code are valid
-				const uint8_t direction_validity_mask = (pos.x > min_pos.x ? 1 : 0) |
-						((pos.y > min_pos.y ? 1 : 0) << 1) | ((pos.z > min_pos.z ? 1 : 0) << 2);
-
-				const uint8_t regular_cell_class_index = tables::get_regular_cell_class(case_code);
-				const tables::RegularCellData &regular_cell_data =
-						tables::get_regular_cell_data(regular_cell_class_index);
-				const uint8_t triangle_count = regular_cell_data.geometryCounts & 0x0f;
-				const uint8_t vertex_count = (regular_cell_data.geometryCounts & 0xf0) >> 4;
-
-				FixedArray<int, 12> cell_vertex_indices;
-				fill(cell_vertex_indices, -1);
-
-				// TODO When not using LOD, this is not necessary
-				const uint8_t cell_border_mask = get_border_mask(pos - min_pos, block_size - Vector3i(1, 1, 1));
-
-				// For each vertex in the case
-				for (unsigned int vertex_index = 0; vertex_index < vertex_count; ++vertex_index) {
-					// The case index maps to a list of 16-bit codes providing information about the edges on which the
-					// vertices lie. The low byte of each 16-bit code contains the corner indexes of the edge’s
-					// endpoints in one nibble each, and the high byte contains the mapping code shown in Figure 3.8(b)
-					const unsigned short rvd = tables::get_regular_vertex_data(case_code, vertex_index);
-					const uint8_t edge_code_low = rvd & 0xff;
-					const uint8_t edge_code_high = (rvd >> 8) & 0xff;
-
-					// Get corner indexes in the low nibble (always ordered so the higher comes last)
-					const uint8_t v0 = (edge_code_low >> 4) & 0xf;
-					const uint8_t v1 = edge_code_low & 0xf;
-
-#ifdef DEBUG_ENABLED
-					ZN_ASSERT_RETURN(v1 > v0);
-#endif
+				if (!present || cell_vertex_indices[vertex_index] == -1) {
+					// Create new vertex
+
+					const float t0 = t; // static_cast<float>(t) / 256.f;
+					const float t1 = 1.f - t; // static_cast<float>(0x100 - t) / 256.f;
+					// const int ti0 = t;
+					// const int ti1 = 0x100 - t;
+					// const Vector3i primary = p0 * ti0 + p1 * ti1;
+
+					const Vector3f primaryf = to_vec3f(p0) * t0 + to_vec3f(p1) * t1;
+					// TODO Binary search gives better positional results, but does not improve normals.
+					// I'm not sure how to overcome this because if we sample low-detail normals, we get a
+					// "blocky" result due to SDF clipping. If we sample high-detail gradients, we get details,
+					// but if details are bumpy, we also get noisy results.
+					const Vector3f cg0 = get_corner_gradient<TSdf>(
+							corner_data_indices[v0], sdf_data, block_size_with_padding
+					);
+					const Vector3f cg1 = get_corner_gradient<TSdf>(
+							corner_data_indices[v1], sdf_data, block_size_with_padding
+					);
+					const Vector3f normal = normalized_not_null(cg0 * t0 + cg1 * t1);
 
-					// Get voxel values at the corners
-					const float sample0 = cell_samples_sdf[v0]; // called d0 in the paper
-					const float sample1 = cell_samples_sdf[v1]; // called d1 in the paper
+					Vector3f secondary;
 
-#ifdef DEBUG_ENABLED
-					// TODO Zero-division is not mentionned in the paper?? (never happens tho)
-					ZN_ASSERT_RETURN(sample1 != sample0);
-					ZN_ASSERT_RETURN(sample1 != 0 || sample0 != 0);
-#endif
+					uint8_t vertex_border_mask = 0;
+					if (cell_border_mask > 0) {
+						secondary = get_secondary_position(primaryf, normal, lod_index, block_size);
+						vertex_border_mask =
+								(get_border_mask(p0, block_size_scaled) & get_border_mask(p1, block_size_scaled));
+					}
 
-					// Get interpolation position
-					// We use an 8-bit fraction, allowing the new vertex to be located at one of 257 possible
-					// positions  along  the  edge  when  both  endpoints  are included.
-					// const int t = (sample1 << 8) / (sample1 - sample0);
-					const float t =
-							math::clamp(sample1 / (sample1 - sample0), edge_clamp_margin, edge_clamp_margin_max);
-
-					const Vector3i p0 = corner_positions[v0];
-					const Vector3i p1 = corner_positions[v1];
-
-					if (t > 0.f && t < 1.f) {
-						// Vertex is between p0 and p1 (inside the edge)
-
-						// Each edge of a cell is assigned an 8-bit code, as shown in Figure 3.8(b),
-						// that provides a mapping to a preceding cell and the coincident edge on that preceding cell
-						// for which new vertex creation  was  allowed.
-						// The high nibble of this code indicates which direction to go in order to reach the correct
-						// preceding cell. The bit values 1, 2, and 4 in this nibble indicate that we must subtract one
-						// from the x, y, and/or z coordinate, respectively.
-						const uint8_t reuse_dir = (edge_code_high >> 4) & 0xf;
-						const uint8_t reuse_vertex_index = edge_code_high & 0xf;
-
-						// TODO Some re-use opportunities are missed on negative sides of the block,
-						// but I don't really know how to fix it...
-						// You can check by "shaking" every vertex randomly in a shader based on its index,
-						// you will see vertices touching the -X, -Y or -Z sides of the block aren't connected
-
-						const bool present = (reuse_dir & direction_validity_mask) == reuse_dir;
-
-						if (present) {
-							const Vector3i cache_pos = pos + dir_to_prev_vec(reuse_dir);
-							const ReuseCell &prev_cell = cache.get_reuse_cell(cache_pos);
-							if (prev_cell.packed_texture_indices == current_reuse_cell.packed_texture_indices) {
-								// Will reuse a previous vertice
-								cell_vertex_indices[vertex_index] = prev_cell.vertices[reuse_vertex_index];
-							}
-						}
+					cell_vertex_indices[vertex_index] = output.add_vertex(
+							primaryf, normal, cell_border_mask, vertex_border_mask, 0, secondary
+					);
 
-						if (!present || cell_vertex_indices[vertex_index] == -1) {
-							// Create new vertex
-
-							const float t0 = t; // static_cast<float>(t) / 256.f;
-							const float t1 = 1.f - t; // static_cast<float>(0x100 - t) / 256.f;
-							// const int ti0 = t;
-							// const int ti1 = 0x100 - t;
-							// const Vector3i primary = p0 * ti0 + p1 * ti1;
-
-							const Vector3f primaryf = to_vec3f(p0) * t0 + to_vec3f(p1) * t1;
-							// TODO Binary search gives better positional results, but does not improve normals.
-							// I'm not sure how to overcome this because if we sample low-detail normals, we get a
-							// "blocky" result due to SDF clipping. If we sample high-detail gradients, we get details,
-							// but if details are bumpy, we also get noisy results.
-							const Vector3f cg0 = get_corner_gradient<TSdf>(
-									corner_data_indices[v0], sdf_data, block_size_with_padding
-							);
-							const Vector3f cg1 = get_corner_gradient<TSdf>(
-									corner_data_indices[v1], sdf_data, block_size_with_padding
-							);
-							const Vector3f normal = normalized_not_null(cg0 * t0 + cg1 * t1);
-
-							Vector3f secondary;
-
-							uint8_t vertex_border_mask = 0;
-							if (cell_border_mask > 0) {
-								secondary = get_secondary_position(primaryf, normal, lod_index, block_size);
-								vertex_border_mask =
-										(get_border_mask(p0, block_size_scaled) & get_border_mask(p1, block_size_scaled)
-										);
-							}
-
-							cell_vertex_indices[vertex_index] = output.add_vertex(
-									primaryf, normal, cell_border_mask, vertex_border_mask, 0, secondary
-							);
-
-							material_processor.on_vertex(v0, v1, t1);
-
-							if (reuse_dir & 8) {
-								// Store the generated vertex so that other cells can reuse it.
-								current_reuse_cell.vertices[reuse_vertex_index] = cell_vertex_indices[vertex_index];
-							}
-						}
+					material_processor.on_vertex(v0, v1, t1);
 
-					} else if (t == 0 && v1 == 7) {
-						// t == 0: the vertex is on p1
-						// v1 == 7: p1 on the max corner of the cell
-						// This cell owns the vertex, so it should be created.
+					if (reuse_dir & 8) {
+						// Store the generated vertex so that other cells can reuse it.
+						current_reuse_cell.vertices[reuse_vertex_index] = cell_vertex_indices[vertex_index];
+					}
+				}
 
-						const Vector3i primary = p1;
-						const Vector3f primaryf = to_vec3f(primary);
-						const Vector3f cg1 =
-								get_corner_gradient<TSdf>(corner_data_indices[v1], sdf_data, block_size_with_padding);
-						const Vector3f normal = normalized_not_null(cg1);
+			} else if (t == 0 && v1 == 7) {
+				// t == 0: the vertex is on p1
+				// v1 == 7: p1 on the max corner of the cell
+				// This cell owns the vertex, so it should be created.
 
-						Vector3f secondary;
+				const Vector3i primary = p1;
+				const Vector3f primaryf = to_vec3f(primary);
+				const Vector3f cg1 =
+						get_corner_gradient<TSdf>(corner_data_indices[v1], sdf_data, block_size_with_padding);
+				const Vector3f normal = normalized_not_null(cg1);
 
-						uint8_t vertex_border_mask = 0;
-						if (cell_border_mask > 0) {
-							secondary = get_secondary_position(primaryf, normal, lod_index, block_size);
-							vertex_border_mask = get_border_mask(p1, block_size_scaled);
-						}
+				Vector3f secondary;
 
-						cell_vertex_indices[vertex_index] =
-								output.add_vertex(primaryf, normal, cell_border_mask, vertex_border_mask, 0, secondary);
+				uint8_t vertex_border_mask = 0;
+				if (cell_border_mask > 0) {
+					secondary = get_secondary_position(primaryf, normal, lod_index, block_size);
+					vertex_border_mask = get_border_mask(p1, block_size_scaled);
+				}
 
-						material_processor.on_vertex(v0, v1, 1.f);
+				cell_vertex_indices[vertex_index] =
+						output.add_vertex(primaryf, normal, cell_border_mask, vertex_border_mask, 0, secondary);
 
-						current_reuse_cell.vertices[0] = cell_vertex_indices[vertex_index];
+				material_processor.on_vertex(v0, v1, 1.f);
 
-					} else {
-						// The vertex is either on p0 or p1.
-						// The original Transvoxel tries to reuse previous vertices in these cases,
-						// however here we don't do it because of ambiguous cases that makes artifacts appear.
-						// It's not a common case so it shouldn't be too bad
-						// (unless you do a lot of grid-aligned shapes?).
+				current_reuse_cell.vertices[0] = cell_vertex_indices[vertex_index];
 
-						// What do we do if the vertex we would re-use is on a cell that had no triangulation?
-						// The previous cell might have had all corners of the same sign, except one being 0.
-						// Forcing `present=false` seems to fix cases of holes that would be caused by that.
-						// Resetting the cache before processing each deck also works, but is slightly slower.
-						// Otherwise the code would try to re-use a vertex that hasn't been written as re-usable,
-						// so it picks up some garbage from earlier decks.
+			} else {
+				// The vertex is either on p0 or p1.
+				// The original Transvoxel tries to reuse previous vertices in these cases,
+				// however here we don't do it because of ambiguous cases that makes artifacts appear.
+				// It's not a common case so it shouldn't be too bad
+				// (unless you do a lot of grid-aligned shapes?).
+
+				// What do we do if the vertex we would re-use is on a cell that had no triangulation?
+				// The previous cell might have had all corners of the same sign, except one being 0.
+				// Forcing `present=false` seems to fix cases of holes that would be caused by that.
+				// Resetting the cache before processing each deck also works, but is slightly slower.
+				// Otherwise the code would try to re-use a vertex that hasn't been written as re-usable,
+				// so it picks up some garbage from earlier decks.
 #ifdef VOXEL_TRANSVOXEL_REUSE_VERTEX_ON_COINCIDENT_CASES
-						// A 3-bit direction code leading to the proper cell can easily be obtained by
-						// inverting the 3-bit corner index (bitwise, by exclusive ORing with the number 7).
-						// The corner index depends on the value of t, t = 0 means that we're at the higher
-						// numbered endpoint.
-						const uint8_t reuse_dir = (t == 0 ? v1 ^ 7 : v0 ^ 7);
-						const bool present = (reuse_dir & direction_validity_mask) == reuse_dir;
-
-						// Note: the only difference with similar code above is that we take vertice 0 in the `else`
-						if (present) {
-							const Vector3i cache_pos = pos + dir_to_prev_vec(reuse_dir);
-							const ReuseCell &prev_cell = cache.get_reuse_cell(cache_pos);
-							cell_vertex_indices[vertex_index] = prev_cell.vertices[0];
-						}
+				// A 3-bit direction code leading to the proper cell can easily be obtained by
+				// inverting the 3-bit corner index (bitwise, by exclusive ORing with the number 7).
+				// The corner index depends on the value of t, t = 0 means that we're at the higher
+				// numbered endpoint.
+				const uint8_t reuse_dir = (t == 0 ? v1 ^ 7 : v0 ^ 7);
+				const bool present = (reuse_dir & direction_validity_mask) == reuse_dir;
+
+				// Note: the only difference with similar code above is that we take vertice 0 in the `else`
+				if (present) {
+					const Vector3i cache_pos = pos + dir_to_prev_vec(reuse_dir);
+					const ReuseCell &prev_cell = cache.get_reuse_cell(cache_pos);
+					cell_vertex_indices[vertex_index] = prev_cell.vertices[0];
+				}
 
-						if (!present || cell_vertex_indices[vertex_index] == -1)
+				if (!present || cell_vertex_indices[vertex_index] == -1)
 #endif
-						{
-							// Create new vertex
-
-							const unsigned int vi = t == 0 ? v1 : v0;
-
-							const Vector3i primary = t == 0 ? p1 : p0;
-							const Vector3f primaryf = to_vec3f(primary);
-							const Vector3f cg = get_corner_gradient<TSdf>(
-									corner_data_indices[vi], sdf_data, block_size_with_padding
-							);
-							const Vector3f normal = normalized_not_null(cg);
+				{
+					// Create new vertex
 
-							// TODO This bit of code is repeated several times, factor it?
-							Vector3f secondary;
+					const unsigned int vi = t == 0 ? v1 : v0;
 
-							uint8_t vertex_border_mask = 0;
-							if (cell_border_mask > 0) {
-								secondary = get_secondary_position(primaryf, normal, lod_index, block_size);
-								vertex_border_mask = get_border_mask(primary, block_size_scaled);
-							}
+					const Vector3i primary = t == 0 ? p1 : p0;
+					const Vector3f primaryf = to_vec3f(primary);
+					const Vector3f cg = get_corner_gradient<TSdf>(
+							corner_data_indices[vi], sdf_data, block_size_with_padding
+					);
+					const Vector3f normal = normalized_not_null(cg);
 
-							cell_vertex_indices[vertex_index] = output.add_vertex(
-									primaryf, normal, cell_border_mask, vertex_border_mask, 0, secondary
-							);
+					// TODO This bit of code is repeated several times, factor it?
+					Vector3f secondary;
 
-							material_processor.on_vertex(v0, v1, 1.f - t);
-						}
+					uint8_t vertex_border_mask = 0;
+					if (cell_border_mask > 0) {
+						secondary = get_secondary_position(primaryf, normal, lod_index, block_size);
+						vertex_border_mask = get_border_mask(primary, block_size_scaled);
 					}
 
-				} // for each cell vertex
-
-				const uint32_t effective_triangle_count = triangle_count;
-
-				for (int t = 0; t < triangle_count; ++t) {
-					const int t0 = t * 3;
-
-					const int i0 = cell_vertex_indices[regular_cell_data.get_vertex_index(t0)];
-					const int i1 = cell_vertex_indices[regular_cell_data.get_vertex_index(t0 + 1)];
-					const int i2 = cell_vertex_indices[regular_cell_data.get_vertex_index(t0 + 2)];
-
-					{
-						// Transvoxel paper:
-						// It is possible to generate triangles having zero area when one or more of the corner sample
-						// values for a cell is zero. For example, when we triangulate a cell for which one corner
-						// sample value is zero and the seven remaining corner sample values are negative, then we
-						// generate the single triangle of equivalence class #1 (see Table 3.2). However, all three
-						// vertices lie exactly at the corner having zero sample value. Such triangles are eliminated
-						// after a simple area calculation indicates that they are degenerate.
-						//
-						// Not fixing this used to work fine actually, but Jolt physics integration makes this
-						// problematic. Jolt checks for degenerate triangles, but instead of just skipping them, it
-						// throws errors. Also, the fact Godot enforces passing a de-indexed mesh through the
-						// Physics3DServer requires Jolt to re-index it. This is not only a waste of time, but also,
-						// Jolt eliminates vertices at the same location or below a hardcoded threshold in the process.
-						// This in turn causes further issues, as degenerate or microscopic triangles cause the
-						// same errors, instead of just being ignored. So a workaround is to actively remove those
-						// triangles here, at the cost of extra CPU work.
-						//
-						// Note, this workaround means there can be unused vertices in the final mesh.
-						// Another workaround could have been to alter the SDF to never have 0, but that would not
-						// cover the case of triangles that are too thin.
-						//
-						// Profiling results, in average time per chunk (16^3).
-						// With it: 75 us
-						// Without it: 65 us
-						// So fixing the 0.5% of meshes with at least 1 degenerate/superthin triangle isn't negligible
-						// unfortunately.
-						//
-						// About Jolt re-indexing meshes, see PR (abandoned?):
-						// https://github.com/godotengine/godot/pull/72868
-						//
-						// const Vector3f p0 = output.vertices[i0];
-						// const Vector3f p1 = output.vertices[i1];
-						// const Vector3f p2 = output.vertices[i2];
-						// if (math::is_triangle_degenerate_approx(p0, p1, p2, 0.000001f)) {
-						// 	--effective_triangle_count;
-						// 	continue;
-						// }
-					}
+					cell_vertex_indices[vertex_index] = output.add_vertex(
+							primaryf, normal, cell_border_mask, vertex_border_mask, 0, secondary
+					);
 
-					output.indices.push_back(i0);
-					output.indices.push_back(i1);
-					output.indices.push_back(i2);
+					material_processor.on_vertex(v0, v1, 1.f - t);
 				}
+			}
 
-				if (cell_info != nullptr) {
-					cell_info->push_back(CellInfo{ pos - min_pos, static_cast<uint8_t>(effective_triangle_count) });
-				}
+		} // for each cell vertex
+
+		const uint32_t effective_triangle_count = triangle_count;
+
+		for (int t = 0; t < triangle_count; ++t) {
+			const int t0 = t * 3;
+
+			const int i0 = cell_vertex_indices[regular_cell_data.get_vertex_index(t0)];
+			const int i1 = cell_vertex_indices[regular_cell_data.get_vertex_index(t0 + 1)];
+			const int i2 = cell_vertex_indices[regular_cell_data.get_vertex_index(t0 + 2)];
 
-			} // x
-		} // y
-	} // z
+			{
+				// Transvoxel paper:
+				// It is possible to generate triangles having zero area when one or more of the corner sample
+				// values for a cell is zero. For example, when we triangulate a cell for which one corner
+				// sample value is zero and the seven remaining corner sample values are negative, then we
+				// generate the single triangle of equivalence class #1 (see Table 3.2). However, all three
+				// vertices lie exactly at the corner having zero sample value. Such triangles are eliminated
+				// after a simple area calculation indicates that they are degenerate.
+				//
+				// Not fixing this used to work fine actually, but Jolt physics integration makes this
+				// problematic. Jolt checks for degenerate triangles, but instead of just skipping them, it
+				// throws errors. Also, the fact Godot enforces passing a de-indexed mesh through the
+				// Physics3DServer requires Jolt to re-index it. This is not only a waste of time, but also,
+				// Jolt eliminates vertices at the same location or below a hardcoded threshold in the process.
+				// This in turn causes further issues, as degenerate or microscopic triangles cause the
+				// same errors, instead of just being ignored. So a workaround is to actively remove those
+				// triangles here, at the cost of extra CPU work.
+				//
+				// Note, this workaround means there can be unused vertices in the final mesh.
+				// Another workaround could have been to alter the SDF to never have 0, but that would not
+				// cover the case of triangles that are too thin.
+				//
+				// Profiling results, in average time per chunk (16^3).
+				// With it: 75 us
+				// Without it: 65 us
+				// So fixing the 0.5% of meshes with at least 1 degenerate/superthin triangle isn't negligible
+				// unfortunately.
+				//
+				// About Jolt re-indexing meshes, see PR (abandoned?):
+				// https://github.com/godotengine/godot/pull/72868
+				//
+				// const Vector3f p0 = output.vertices[i0];
+				// const Vector3f p1 = output.vertices[i1];
+				// const Vector3f p2 = output.vertices[i2];
+				// if (math::is_triangle_degenerate_approx(p0, p1, p2, 0.000001f)) {
+				// 	--effective_triangle_count;
+				// 	continue;
+				// }
+			}
+
+			output.indices.push_back(i0);
+			output.indices.push_back(i1);
+			output.indices.push_back(i2);
+		}
+
+		if (cell_info != nullptr) {
+			cell_info->push_back(CellInfo{ pos - min_pos, static_cast<uint8_t>(effective_triangle_count) });
+		}
+
+	} // for each active cell
 }
 
 //    y            y
@@ -1166,8 +1256,9 @@ StdVector<uint8_t> &get_tls_u8_conversion_buffer() {
 
 template <typename TMaterialProcessor>
 inline void build_regular_mesh_dispatch_sd(
-		const VoxelBuffer &voxels,
-		const unsigned int sdf_channel,
+		Span<const uint8_t> sdf_data_raw,
+		const VoxelBuffer::Depth sdf_depth,
+		const Vector3i voxels_size,
 		TMaterialProcessor material_processor,
 		const uint32_t lod_index,
 		Cache &cache,
@@ -1175,18 +1266,15 @@ inline void build_regular_mesh_dispatch_sd(
 		StdVector<CellInfo> *cell_infos,
 		const float edge_clamp_margin
 ) {
-	Span<const uint8_t> sdf_data_raw;
-	ZN_ASSERT(voxels.get_channel_as_bytes_read_only(sdf_channel, sdf_data_raw) == true);
-
 	// We settle data types up-front so we can get rid of abstraction layers and conditionals,
 	// which would otherwise harm performance in tight iterations
-	switch (voxels.get_channel_depth(sdf_channel)) {
+	switch (sdf_depth) {
 		case VoxelBuffer::DEPTH_8_BIT: {
 			Span<const int8_t> sdf_data = sdf_data_raw.reinterpret_cast_to<const int8_t>();
 			build_regular_mesh<int8_t>(
 					sdf_data,
 					material_processor,
-					voxels.get_size(),
+					voxels_size,
 					lod_index,
 					cache,
 					output,
@@ -1200,7 +1288,7 @@ inline void build_regular_mesh_dispatch_sd(
 			build_regular_mesh<int16_t>(
 					sdf_data,
 					material_processor,
-					voxels.get_size(),
+					voxels_size,
 					lod_index,
 					cache,
 					output,
@@ -1217,7 +1305,7 @@ inline void build_regular_mesh_dispatch_sd(
 			build_regular_mesh<float>(
 					sdf_data,
 					material_processor,
-					voxels.get_size(),
+					voxels_size,
 					lod_index,
 					cache,
 					output,
@@ -1241,6 +1329,33 @@ inline void build_regular_mesh_dispatch_sd(
 	}
 }
 
+template <typename TMaterialProcessor>
+inline void build_regular_mesh_dispatch_sd(
+		const VoxelBuffer &voxels,
+		const unsigned int sdf_channel,
+		TMaterialProcessor material_processor,
+		const uint32_t lod_index,
+		Cache &cache,
+		MeshArrays &output,
+		StdVector<CellInfo> *cell_infos,
+		const float edge_clamp_margin
+) {
+	Span<const uint8_t> sdf_data_raw;
+	ZN_ASSERT(voxels.get_channel_as_bytes_read_only(sdf_channel, sdf_data_raw) == true);
+
+	build_regular_mesh_dispatch_sd(
+			sdf_data_raw,
+			voxels.get_channel_depth(sdf_channel),
+			voxels.get_size(),
+			material_processor,
+			lod_index,
+			cache,
+			output,
+			cell_infos,
+			edge_clamp_margin
+	);
+}
+
 DefaultTextureIndicesData build_regular_mesh(
 		const VoxelBuffer &voxels,
 		const unsigned int sdf_channel,
@@ -1366,8 +1481,9 @@ DefaultTextureIndicesData build_regular_mesh(
 
 template <typename TMaterialProcessor>
 inline void build_transition_mesh_dispatch_sd(
-		const VoxelBuffer &voxels,
-		const unsigned int sdf_channel,
+		Span<const uint8_t> sdf_data_raw,
+		const VoxelBuffer::Depth sdf_depth,
+		const Vector3i voxels_size,
 		const TMaterialProcessor material_processor,
 		const int direction,
 		const uint32_t lod_index,
@@ -1375,16 +1491,13 @@ inline void build_transition_mesh_dispatch_sd(
 		MeshArrays &output,
 		const float edge_clamp_margin
 ) {
-	Span<const uint8_t> sdf_data_raw;
-	ZN_ASSERT(voxels.get_channel_as_bytes_read_only(sdf_channel, sdf_data_raw) == true);
-
-	switch (voxels.get_channel_depth(sdf_channel)) {
+	switch (sdf_depth) {
 		case VoxelBuffer::DEPTH_8_BIT: {
 			Span<const int8_t> sdf_data = sdf_data_raw.reinterpret_cast_to<const int8_t>();
 			build_transition_mesh<int8_t>(
 					sdf_data,
 					material_processor,
-					voxels.get_size(),
+					voxels_size,
 					direction,
 					lod_index,
 					cache,
@@ -1398,7 +1511,7 @@ inline void build_transition_mesh_dispatch_sd(
 			build_transition_mesh<int16_t>(
 					sdf_data,
 					material_processor,
-					voxels.get_size(),
+					voxels_size,
 					direction,
 					lod_index,
 					cache,
@@ -1412,7 +1525,7 @@ inline void build_transition_mesh_dispatch_sd(
 			build_transition_mesh<float>(
 					sdf_data,
 					material_processor,
-					voxels.get_size(),
+					voxels_size,
 					direction,
 					lod_index,
 					cache,
@@ -1432,6 +1545,33 @@ inline void build_transition_mesh_dispatch_sd(
 	}
 }
 
+template <typename TMaterialProcessor>
+inline void build_transition_mesh_dispatch_sd(
+		const VoxelBuffer &voxels,
+		const unsigned int sdf_channel,
+		const TMaterialProcessor material_processor,
+		const int direction,
+		const uint32_t lod_index,
+		Cache &cache,
+		MeshArrays &output,
+		const float edge_clamp_margin
+) {
+	Span<const uint8_t> sdf_data_raw;
+	ZN_ASSERT(voxels.get_channel_as_bytes_read_only(sdf_channel, sdf_data_raw) == true);
+
+	build_transition_mesh_dispatch_sd(
+			sdf_data_raw,
+			voxels.get_channel_depth(sdf_channel),
+			voxels.get_size(),
+			material_processor,
+			direction,
+			lod_index,
+			cache,
+			output,
+			edge_clamp_margin
+	);
+}
+
 void build_transition_mesh(
 		const VoxelBuffer &voxels,
 		const unsigned int sdf_channel,
@@ -1552,4 +1692,62 @@ void build_transition_mesh(
 	}
 }
 
+void build_regular_mesh(
+		Span<const uint8_t> sdf_data,
+		const VoxelBuffer::Depth sdf_depth,
+		const Vector3i voxels_size,
+		const uint32_t lod_index,
+		Cache &cache,
+		MeshArrays &output,
+		StdVector<CellInfo> *cell_infos,
+		const float edge_clamp_margin
+) {
+	ZN_PROFILE_SCOPE();
+	ZN_ASSERT_RETURN(
+			sdf_data.size() == Vector3iUtil::get_volume_u64(voxels_size) * VoxelBuffer::get_depth_byte_count(sdf_depth)
+	);
+
+	output.clear();
+
+	build_regular_mesh_dispatch_sd(
+			sdf_data,
+			sdf_depth,
+			voxels_size,
+			materials::NullProcessor{},
+			lod_index,
+			cache,
+			output,
+			cell_infos,
+			edge_clamp_margin
+	);
+}
+
+void build_transition_mesh(
+		Span<const uint8_t> sdf_data,
+		const VoxelBuffer::Depth sdf_depth,
+		const Vector3i voxels_size,
+		const int direction,
+		const uint32_t lod_index,
+		Cache &cache,
+		MeshArrays &output,
+		const float edge_clamp_margin
+) {
+	ZN_PROFILE_SCOPE();
+	ZN_ASSERT_RETURN(
+			sdf_data.size() == Vector3iUtil::get_volume_u64(voxels_size) * VoxelBuffer::get_depth_byte_count(sdf_depth)
+	);
+
+	build_transition_mesh_dispatch_sd(
+			sdf_data,
+			sdf_depth,
+			voxels_size,
+			materials::NullProcessor{},
+			direction,
+			lod_index,
+			cache,
+			output,
+			edge_clamp_margin
+	);
+}
+
 } // namespace zylann::voxel::transvoxel
@@ -112,6 +112,14 @@ struct ReuseTransitionCell {
 	uint32_t packed_texture_indices = 0;
 };
 
+// Regular cell crossing the isolevel, in padded block coordinates
+struct ActiveCell {
+	uint16_t x;
+	uint16_t y;
+	uint16_t z;
+	uint8_t case_code;
+};
+
 class Cache {
 public:
 	void reset_reuse_cells(Vector3i p_block_size) {
@@ -150,6 +158,11 @@ public:
 		return _cache_2d[j][i];
 	}
 
+	// Scratch memory used to find regular cells crossing the isolevel
+	StdVector<uint64_t> sign_bits;
+	StdVector<uint64_t> active_cell_rows;
+	StdVector<ActiveCell> active_cells;
+
 private:
 	FixedArray<StdVector<ReuseCell>, 2> _cache;
 	FixedArray<StdVector<ReuseTransitionCell>, 2> _cache_2d;
@@ -194,6 +207,30 @@ void build_transition_mesh(
 		const bool textures_ignore_air_voxels
 );
 
+// Same as above without texturing, with SDF voxels given as raw data of the specified depth, in ZXY order in an area of
+// size `voxels_size`. Used when voxels are not stored in a single `VoxelBuffer`.
+void build_regular_mesh(
+		Span<const uint8_t> sdf_data,
+		const VoxelBuffer::Depth sdf_depth,
+		const Vector3i voxels_size,
+		const uint32_t lod_index,
+		Cache &cache,
+		MeshArrays &output,
+		StdVector<CellInfo> *cell_infos,
+		const float edge_clamp_margin
+);
+
+void build_transition_mesh(
+		Span<const uint8_t> sdf_data,
+		const VoxelBuffer::Depth sdf_depth,
+		const Vector3i voxels_size,
+		const int direction,
+		const uint32_t lod_index,
+		Cache &cache,
+		MeshArrays &output,
+		const float edge_clamp_margin
+);
+
 } // namespace zylann::voxel::transvoxel
 
 #endif // VOXEL_TRANSVOXEL_H
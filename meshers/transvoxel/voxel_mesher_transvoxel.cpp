@@ -3,14 +3,17 @@
 #include "../../generators/voxel_generator.h"
 #include "../../shaders/transvoxel_minimal_shader.h"
 #include "../../storage/voxel_buffer_gd.h"
+#include "../../storage/voxel_buffer_padded_view.h"
 #include "../../storage/voxel_data.h"
 #include "../../thirdparty/meshoptimizer/meshoptimizer.h"
+#include "../../util/containers/container_funcs.h"
 #include "../../util/godot/classes/array_mesh.h"
 #include "../../util/godot/classes/rendering_server.h"
 #include "../../util/godot/classes/shader.h"
 #include "../../util/godot/classes/shader_material.h"
 #include "../../util/godot/core/packed_arrays.h"
 #include "../../util/math/conv.h"
+#include "../../util/memory/memory.h"
 #include "../../util/profiling.h"
 #include "transvoxel_tables.cpp"
 #ifdef TOOLS_ENABLED
@@ -67,6 +70,11 @@ VoxelMesherTransvoxel::VoxelMesherTransvoxel() {
 
 VoxelMesherTransvoxel::~VoxelMesherTransvoxel() {}
 
+bool VoxelMesherTransvoxel::supports_padded_view() const {
+	// Texturing samples other channels with random access, which requires voxels to be in a single buffer
+	return _texture_mode == TEXTURES_NONE;
+}
+
 int VoxelMesherTransvoxel::get_used_channels_mask() const {
 	uint32_t mask = 1 << VoxelBuffer::CHANNEL_SDF;
 
@@ -222,6 +230,23 @@ void simplify(
 	);
 }
 
+// Appends a mesh that was built separately, so its indices are offset to point after existing vertices
+void append_mesh_arrays(transvoxel::MeshArrays &dst, const transvoxel::MeshArrays &src) {
+	const int32_t index_offset = dst.vertices.size();
+	const size_t index_begin = dst.indices.size();
+
+	append_array(dst.vertices, src.vertices);
+	append_array(dst.normals, src.normals);
+	append_array(dst.lod_data, src.lod_data);
+	append_array(dst.texturing_data_1f32, src.texturing_data_1f32);
+	append_array(dst.texturing_data_2f32, src.texturing_data_2f32);
+	append_array(dst.indices, src.indices);
+
+	for (size_t i = index_begin; i < dst.indices.size(); ++i) {
+		dst.indices[i] += index_offset;
+	}
+}
+
 } // namespace
 
 // TODO Maybe we could auto-detect? It could become ambiguous tho
@@ -293,56 +318,148 @@ void VoxelMesherTransvoxel::build(VoxelMesher::Output &output, const VoxelMesher
 	mesh_arrays.clear();
 
 	const VoxelBuffer &voxels = input.voxels;
-	if (voxels.is_uniform(sdf_channel)) {
+	const VoxelBufferPaddedView *padded_view = input.padded_view;
+	if (padded_view != nullptr ? padded_view->is_uniform(sdf_channel) : voxels.is_uniform(sdf_channel)) {
 		// There won't be anything to polygonize since the SDF has no variations, so it can't cross the isolevel
 		return;
 	}
 
+	// SDF gathered from the padded view. Other channels are not read from it, so texturing is not supported then.
+	static thread_local StdVector<uint8_t> tls_padded_view_sdf;
+	Span<const uint8_t> padded_view_sdf;
+	if (padded_view != nullptr) {
+		ZN_ASSERT_RETURN(padded_view->get_size() == voxels.get_size());
+		const size_t size_in_bytes = Vector3iUtil::get_volume_u64(padded_view->get_size()) *
+				VoxelBuffer::get_depth_byte_count(padded_view->get_channel_depth(sdf_channel));
+		tls_padded_view_sdf.resize(size_in_bytes);
+		padded_view->copy_channel_to(sdf_channel, to_span(tls_padded_view_sdf));
+		padded_view_sdf = to_span_const(tls_padded_view_sdf);
+	}
+
 	// const uint64_t time_before = Time::get_singleton()->get_ticks_usec();
 
+	// When the mesh is only used for collisions, texturing data and transitions are not needed
+	const bool collision_only = input.collision_hint && input.collision_only_hint;
+
+	const TexturingMode texture_mode = (collision_only || padded_view != nullptr)
+			? TEXTURES_NONE
+			: check_texturing_mode(_texture_mode, voxels);
+
+	// When transitions are built lazily, the regular mesh is kept in a cache along with transition meshes built so far,
+	// so more transitions can be added when neighbors change without building the regular mesh again.
+	std::shared_ptr<IncrementalCache> incremental_cache;
+	bool reuse_regular_mesh = false;
+	if (_transitions_enabled && //
+		_lazy_transitions_enabled && //
+		input.lod_hint && //
+		input.incremental_hint && //
+		!collision_only) {
+		if (input.incremental_cache != nullptr && input.incremental_cache->mesher == this) {
+			incremental_cache = std::static_pointer_cast<IncrementalCache>(input.incremental_cache);
+		} else {
+			incremental_cache = make_shared_instance<IncrementalCache>();
+			incremental_cache->mesher = this;
+		}
+
+		const IncrementalCache &cache = *incremental_cache;
+		reuse_regular_mesh = input.dirty_box.is_empty() && //
+				cache.regular_mesh.indices.size() > 0 && //
+				cache.voxels_size == voxels.get_size() && //
+				cache.lod_index == input.lod_index && //
+				cache.texture_mode == texture_mode && //
+				cache.edge_clamp_margin == _edge_clamp_margin && //
+				cache.textures_ignore_air_voxels == _textures_ignore_air_voxels && //
+				cache.mesh_optimization_params.enabled == _mesh_optimization_params.enabled && //
+				cache.mesh_optimization_params.error_threshold == _mesh_optimization_params.error_threshold && //
+				cache.mesh_optimization_params.target_ratio == _mesh_optimization_params.target_ratio;
+	}
+
 	transvoxel::DefaultTextureIndicesData default_texture_indices_data;
-	StdVector<transvoxel::CellInfo> *cell_infos = nullptr;
-	if (input.detail_texture_hint) {
+	transvoxel::MeshArrays *combined_mesh_arrays = &mesh_arrays;
+
+	if (reuse_regular_mesh) {
+		// Voxels didn't change since the previous build, only transition meshes may be missing.
+		// Note, cell infos are not gathered in this case.
+		ZN_PROFILE_SCOPE_NAMED("Reuse regular mesh");
 		transvoxel::get_tls_cell_infos().clear();
-		cell_infos = &transvoxel::get_tls_cell_infos();
-	}
+		mesh_arrays = incremental_cache->regular_mesh;
+		default_texture_indices_data = incremental_cache->default_texture_indices_data;
+
+	} else {
+		StdVector<transvoxel::CellInfo> *cell_infos = nullptr;
+		if (input.detail_texture_hint && !collision_only) {
+			transvoxel::get_tls_cell_infos().clear();
+			cell_infos = &transvoxel::get_tls_cell_infos();
+		}
 
-	const TexturingMode texture_mode = check_texturing_mode(_texture_mode, voxels);
+		if (padded_view != nullptr) {
+			transvoxel::build_regular_mesh(
+					padded_view_sdf,
+					padded_view->get_channel_depth(sdf_channel),
+					padded_view->get_size(),
+					input.lod_index,
+					tls_cache,
+					mesh_arrays,
+					cell_infos,
+					_edge_clamp_margin
+			);
+		} else {
+			default_texture_indices_data = transvoxel::build_regular_mesh(
+					voxels,
+					sdf_channel,
+					input.lod_index,
+					static_cast<transvoxel::TexturingMode>(texture_mode),
+					tls_cache,
+					mesh_arrays,
+					cell_infos,
+					_edge_clamp_margin,
+					_textures_ignore_air_voxels
+			);
+		}
 
-	default_texture_indices_data = transvoxel::build_regular_mesh(
-			voxels,
-			sdf_channel,
-			input.lod_index,
-			static_cast<transvoxel::TexturingMode>(texture_mode),
-			tls_cache,
-			mesh_arrays,
-			cell_infos,
-			_edge_clamp_margin,
-			_textures_ignore_air_voxels
-	);
+		if (mesh_arrays.vertices.size() == 0) {
+			// The mesh can be empty
+			return;
+		}
+		if (mesh_arrays.indices.size() == 0) {
+			// The mesh can have vertices, but still be empty, for example because triangles are all degenerate
+			return;
+		}
 
-	if (mesh_arrays.vertices.size() == 0) {
-		// The mesh can be empty
-		return;
-	}
-	if (mesh_arrays.indices.size() == 0) {
-		// The mesh can have vertices, but still be empty, for example because triangles are all degenerate
-		return;
-	}
+		if (_mesh_optimization_params.enabled) {
+			// TODO When voxel texturing is enabled, this will decrease quality a lot.
+			// There is no support yet for taking textures into account when simplifying.
+			// See https://github.com/zeux/meshoptimizer/issues/158
+			simplify(
+					mesh_arrays,
+					tls_simplified_mesh_arrays,
+					_mesh_optimization_params.target_ratio,
+					_mesh_optimization_params.error_threshold
+			);
 
-	transvoxel::MeshArrays *combined_mesh_arrays = &mesh_arrays;
-	if (_mesh_optimization_params.enabled) {
-		// TODO When voxel texturing is enabled, this will decrease quality a lot.
-		// There is no support yet for taking textures into account when simplifying.
-		// See https://github.com/zeux/meshoptimizer/issues/158
-		simplify(
-				mesh_arrays,
-				tls_simplified_mesh_arrays,
-				_mesh_optimization_params.target_ratio,
-				_mesh_optimization_params.error_threshold
-		);
+			combined_mesh_arrays = &tls_simplified_mesh_arrays;
+		}
 
-		combined_mesh_arrays = &tls_simplified_mesh_arrays;
+		if (incremental_cache != nullptr) {
+			IncrementalCache &cache = *incremental_cache;
+			cache.voxels_size = voxels.get_size();
+			cache.lod_index = input.lod_index;
+			cache.texture_mode = texture_mode;
+			cache.edge_clamp_margin = _edge_clamp_margin;
+			cache.textures_ignore_air_voxels = _textures_ignore_air_voxels;
+			cache.mesh_optimization_params = _mesh_optimization_params;
+			cache.regular_mesh = *combined_mesh_arrays;
+			cache.default_texture_indices_data = default_texture_indices_data;
+			// Previous transition meshes are outdated
+			cache.transition_mask = 0;
+		}
+	}
+
+	if (collision_only) {
+		output.collision_surface.positions = combined_mesh_arrays->vertices;
+		output.collision_surface.indices = combined_mesh_arrays->indices;
+		output.primitive_type = Mesh::PRIMITIVE_TRIANGLES;
+		return;
 	}
 
 	output.collision_surface.submesh_vertex_end = combined_mesh_arrays->vertices.size();
@@ -353,24 +470,62 @@ void VoxelMesherTransvoxel::build(VoxelMesher::Output &output, const VoxelMesher
 		// separate. This only requires a vertex shader trick to discard them when neighbors change.
 		ZN_ASSERT(combined_mesh_arrays != nullptr);
 
+		auto build_transition = [&](const int dir, transvoxel::MeshArrays &transition_output) {
+			if (padded_view != nullptr) {
+				transvoxel::build_transition_mesh(
+						padded_view_sdf,
+						padded_view->get_channel_depth(sdf_channel),
+						padded_view->get_size(),
+						dir,
+						input.lod_index,
+						tls_cache,
+						transition_output,
+						_edge_clamp_margin
+				);
+			} else {
+				transvoxel::build_transition_mesh(
+						voxels,
+						sdf_channel,
+						dir,
+						input.lod_index,
+						static_cast<transvoxel::TexturingMode>(texture_mode),
+						tls_cache,
+						transition_output,
+						default_texture_indices_data,
+						_edge_clamp_margin,
+						_textures_ignore_air_voxels
+				);
+			}
+		};
+
 		for (int dir = 0; dir < Cube::SIDE_COUNT; ++dir) {
 			ZN_PROFILE_SCOPE();
 
-			transvoxel::build_transition_mesh(
-					voxels,
-					sdf_channel,
-					dir,
-					input.lod_index,
-					static_cast<transvoxel::TexturingMode>(texture_mode),
-					tls_cache,
-					*combined_mesh_arrays,
-					default_texture_indices_data,
-					_edge_clamp_margin,
-					_textures_ignore_air_voxels
-			);
+			if (_lazy_transitions_enabled && (input.transition_mask & (1 << dir)) == 0) {
+				// The neighbor on that side has the same level of detail, or is not loaded
+				continue;
+			}
+
+			if (incremental_cache != nullptr) {
+				// Transition meshes are built separately so they can be cached
+				transvoxel::MeshArrays &transition_mesh = incremental_cache->transition_meshes[dir];
+
+				if ((incremental_cache->transition_mask & (1 << dir)) == 0) {
+					transition_mesh.clear();
+					build_transition(dir, transition_mesh);
+					incremental_cache->transition_mask |= (1 << dir);
+				}
+
+				append_mesh_arrays(*combined_mesh_arrays, transition_mesh);
+
+			} else {
+				build_transition(dir, *combined_mesh_arrays);
+			}
 		}
 	}
 
+	output.incremental_cache = incremental_cache;
+
 	Array gd_arrays;
 	fill_surface_arrays(gd_arrays, *combined_mesh_arrays);
 	output.surfaces.push_back({ gd_arrays, 0 });
@@ -395,6 +550,11 @@ void VoxelMesherTransvoxel::build(VoxelMesher::Output &output, const VoxelMesher
 			ZN_PRINT_ERROR("Unhandled texture mode");
 			break;
 	}
+
+	// Custom attributes are left as they are, only standard attributes get compressed
+	if (_vertex_compression_enabled) {
+		output.mesh_flags |= Mesh::ARRAY_FLAG_COMPRESS_ATTRIBUTES;
+	}
 }
 
 // Only exists for testing
@@ -493,6 +653,18 @@ bool VoxelMesherTransvoxel::get_transitions_enabled() const {
 	return _transitions_enabled;
 }
 
+void VoxelMesherTransvoxel::set_lazy_transitions_enabled(bool enable) {
+	_lazy_transitions_enabled = enable;
+}
+
+bool VoxelMesherTransvoxel::is_lazy_transitions_enabled() const {
+	return _lazy_transitions_enabled;
+}
+
+bool VoxelMesherTransvoxel::is_building_transitions_lazily() const {
+	return _transitions_enabled && _lazy_transitions_enabled;
+}
+
 Ref<ShaderMaterial> VoxelMesherTransvoxel::get_default_lod_material() const {
 	return g_minimal_shader_material;
 }
@@ -505,6 +677,14 @@ float VoxelMesherTransvoxel::get_edge_clamp_margin() const {
 	return _edge_clamp_margin;
 }
 
+void VoxelMesherTransvoxel::set_vertex_compression_enabled(bool enable) {
+	_vertex_compression_enabled = enable;
+}
+
+bool VoxelMesherTransvoxel::is_vertex_compression_enabled() const {
+	return _vertex_compression_enabled;
+}
+
 void VoxelMesherTransvoxel::_bind_methods() {
 	using Self = VoxelMesherTransvoxel;
 
@@ -534,9 +714,15 @@ void VoxelMesherTransvoxel::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_transitions_enabled", "enabled"), &Self::set_transitions_enabled);
 	ClassDB::bind_method(D_METHOD("get_transitions_enabled"), &Self::get_transitions_enabled);
 
+	ClassDB::bind_method(D_METHOD("set_lazy_transitions_enabled", "enabled"), &Self::set_lazy_transitions_enabled);
+	ClassDB::bind_method(D_METHOD("is_lazy_transitions_enabled"), &Self::is_lazy_transitions_enabled);
+
 	ClassDB::bind_method(D_METHOD("get_edge_clamp_margin"), &Self::get_edge_clamp_margin);
 	ClassDB::bind_method(D_METHOD("set_edge_clamp_margin", "margin"), &Self::set_edge_clamp_margin);
 
+	ClassDB::bind_method(D_METHOD("set_vertex_compression_enabled", "enabled"), &Self::set_vertex_compression_enabled);
+	ClassDB::bind_method(D_METHOD("is_vertex_compression_enabled"), &Self::is_vertex_compression_enabled);
+
 	ADD_GROUP("Materials", "");
 
 	ADD_PROPERTY(
@@ -575,8 +761,20 @@ void VoxelMesherTransvoxel::_bind_methods() {
 			PropertyInfo(Variant::BOOL, "transitions_enabled"), "set_transitions_enabled", "get_transitions_enabled"
 	);
 
+	ADD_PROPERTY(
+			PropertyInfo(Variant::BOOL, "lazy_transitions_enabled"),
+			"set_lazy_transitions_enabled",
+			"is_lazy_transitions_enabled"
+	);
+
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "edge_clamp_margin"), "set_edge_clamp_margin", "get_edge_clamp_margin");
 
+	ADD_PROPERTY(
+			PropertyInfo(Variant::BOOL, "vertex_compression_enabled"),
+			"set_vertex_compression_enabled",
+			"is_vertex_compression_enabled"
+	);
+
 	BIND_ENUM_CONSTANT(TEXTURES_NONE);
 	BIND_ENUM_CONSTANT(TEXTURES_MIXEL4_S4);
 	BIND_ENUM_CONSTANT(TEXTURES_SINGLE_S4);
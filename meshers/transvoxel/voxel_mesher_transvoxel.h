@@ -5,6 +5,8 @@
 #include "../voxel_mesher.h"
 #include "transvoxel.h"
 
+#include <atomic>
+
 ZN_GODOT_FORWARD_DECLARE(class ArrayMesh);
 ZN_GODOT_FORWARD_DECLARE(class ShaderMaterial);
 
@@ -35,6 +37,8 @@ public:
 
 	int get_used_channels_mask() const override;
 
+	bool supports_padded_view() const override;
+
 	bool is_generating_collision_surface() const override;
 
 	void set_texturing_mode(TexturingMode mode);
@@ -55,9 +59,17 @@ public:
 	void set_transitions_enabled(bool enable);
 	bool get_transitions_enabled() const;
 
+	void set_lazy_transitions_enabled(bool enable);
+	bool is_lazy_transitions_enabled() const;
+
+	bool is_building_transitions_lazily() const override;
+
 	void set_edge_clamp_margin(float margin);
 	float get_edge_clamp_margin() const;
 
+	void set_vertex_compression_enabled(bool enable);
+	bool is_vertex_compression_enabled() const;
+
 	Ref<ShaderMaterial> get_default_lod_material() const override;
 
 	// Internal
@@ -95,6 +107,26 @@ private:
 
 	MeshOptimizationParams _mesh_optimization_params;
 
+	// Kept between builds of a block when transitions are built lazily, so adding transition meshes to it doesn't
+	// require building the regular mesh again.
+	struct IncrementalCache : public VoxelMesher::IncrementalCache {
+		// The regular mesh has to be rebuilt if any of these differ from the current build
+		Vector3i voxels_size;
+		uint8_t lod_index = 0;
+		TexturingMode texture_mode = TEXTURES_NONE;
+		float edge_clamp_margin = 0.f;
+		bool textures_ignore_air_voxels = false;
+		MeshOptimizationParams mesh_optimization_params;
+
+		// Regular mesh, simplified if mesh optimization is enabled
+		transvoxel::MeshArrays regular_mesh;
+		transvoxel::DefaultTextureIndicesData default_texture_indices_data;
+		// Indices are relative to each transition mesh
+		FixedArray<transvoxel::MeshArrays, Cube::SIDE_COUNT> transition_meshes;
+		// Sides for which transition meshes were built
+		uint8_t transition_mask = 0;
+	};
+
 	// When a marching cube cell is computed, vertices may be placed anywhere on edges of the cell, including very close
 	// to corners. This can lead to very thin or small triangles, which can be a problem notably for collision. this
 	// margin is the minimum distance from corners, below which vertices will be clamped to it. Increasing this value
@@ -103,7 +135,15 @@ private:
 
 	bool _transitions_enabled = true;
 
+	// If enabled, transition meshes are only built for sides bordering a lower level of detail, and are cached so
+	// more can be added later without building the regular mesh again
+	bool _lazy_transitions_enabled = false;
+
 	bool _textures_ignore_air_voxels = false;
+
+	// Creates meshes with compressed vertex attributes. Atomic because meshing threads read it while it can be set
+	// from the main thread.
+	std::atomic_bool _vertex_compression_enabled = { false };
 };
 
 } // namespace zylann::voxel
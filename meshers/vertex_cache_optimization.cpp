@@ -0,0 +1,198 @@
+#include "vertex_cache_optimization.h"
+#include "../thirdparty/meshoptimizer/meshoptimizer.h"
+#include "../util/containers/std_vector.h"
+#include "../util/errors.h"
+#include "../util/godot/classes/mesh.h"
+#include "../util/godot/core/packed_arrays.h"
+#include "../util/io/log.h"
+#include "../util/profiling.h"
+
+namespace zylann::voxel {
+
+namespace {
+
+template <typename TPackedArray>
+int get_packed_array_size(const Variant &v) {
+	const TPackedArray a = v;
+	return a.size();
+}
+
+// Returns the number of elements in a vertex attribute array, or -1 if its type is not supported
+int get_vertex_array_size(const Variant &v) {
+	switch (v.get_type()) {
+		case Variant::PACKED_VECTOR3_ARRAY:
+			return get_packed_array_size<PackedVector3Array>(v);
+		case Variant::PACKED_VECTOR2_ARRAY:
+			return get_packed_array_size<PackedVector2Array>(v);
+		case Variant::PACKED_FLOAT32_ARRAY:
+			return get_packed_array_size<PackedFloat32Array>(v);
+		case Variant::PACKED_COLOR_ARRAY:
+			return get_packed_array_size<PackedColorArray>(v);
+		case Variant::PACKED_INT32_ARRAY:
+			return get_packed_array_size<PackedInt32Array>(v);
+		case Variant::PACKED_BYTE_ARRAY:
+			return get_packed_array_size<PackedByteArray>(v);
+		default:
+			return -1;
+	}
+}
+
+template <typename TPackedArray>
+void remap_vertex_array(
+		Array &surface,
+		const unsigned int array_index,
+		const unsigned int src_vertex_count,
+		const unsigned int dst_vertex_count,
+		const StdVector<unsigned int> &remap
+) {
+	const TPackedArray src = surface[array_index];
+	// Some attributes have multiple elements per vertex (tangents, custom channels...)
+	const unsigned int components = src.size() / src_vertex_count;
+	const size_t vertex_size = sizeof(*src.ptr()) * components;
+
+	TPackedArray dst;
+	dst.resize(dst_vertex_count * components);
+	zylannmeshopt::meshopt_remapVertexBuffer(dst.ptrw(), src.ptr(), src_vertex_count, vertex_size, remap.data());
+
+	surface[array_index] = dst;
+}
+
+void remap_vertex_array(
+		Array &surface,
+		const unsigned int array_index,
+		const unsigned int src_vertex_count,
+		const unsigned int dst_vertex_count,
+		const StdVector<unsigned int> &remap
+) {
+	switch (surface[array_index].get_type()) {
+		case Variant::PACKED_VECTOR3_ARRAY:
+			remap_vertex_array<PackedVector3Array>(surface, array_index, src_vertex_count, dst_vertex_count, remap);
+			break;
+		case Variant::PACKED_VECTOR2_ARRAY:
+			remap_vertex_array<PackedVector2Array>(surface, array_index, src_vertex_count, dst_vertex_count, remap);
+			break;
+		case Variant::PACKED_FLOAT32_ARRAY:
+			remap_vertex_array<PackedFloat32Array>(surface, array_index, src_vertex_count, dst_vertex_count, remap);
+			break;
+		case Variant::PACKED_COLOR_ARRAY:
+			remap_vertex_array<PackedColorArray>(surface, array_index, src_vertex_count, dst_vertex_count, remap);
+			break;
+		case Variant::PACKED_INT32_ARRAY:
+			remap_vertex_array<PackedInt32Array>(surface, array_index, src_vertex_count, dst_vertex_count, remap);
+			break;
+		case Variant::PACKED_BYTE_ARRAY:
+			remap_vertex_array<PackedByteArray>(surface, array_index, src_vertex_count, dst_vertex_count, remap);
+			break;
+		default:
+			ZN_PRINT_ERROR("Unexpected vertex array type");
+			break;
+	}
+}
+
+bool can_remap_vertex_arrays(const Array &surface, const unsigned int vertex_count) {
+	for (int array_index = 0; array_index < Mesh::ARRAY_MAX; ++array_index) {
+		if (array_index == Mesh::ARRAY_INDEX) {
+			continue;
+		}
+		const Variant &v = surface[array_index];
+		if (v.get_type() == Variant::NIL) {
+			continue;
+		}
+		const int size = get_vertex_array_size(v);
+		if (size < 0 || (size % vertex_count) != 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+} // namespace
+
+void optimize_surface_for_vertex_cache(Array &surface, int32_t submesh_vertex_end, int32_t submesh_index_end) {
+	ZN_PROFILE_SCOPE();
+	ZN_ASSERT_RETURN(surface.size() == Mesh::ARRAY_MAX);
+
+	PackedInt32Array indices = surface[Mesh::ARRAY_INDEX];
+	const PackedVector3Array positions = surface[Mesh::ARRAY_VERTEX];
+
+	const unsigned int index_count = indices.size();
+	const unsigned int vertex_count = positions.size();
+
+	if (index_count == 0 || vertex_count == 0) {
+		return;
+	}
+
+	const bool has_submesh = submesh_index_end >= 0 && submesh_vertex_end >= 0;
+	if (has_submesh) {
+		ZN_ASSERT_RETURN(
+				static_cast<unsigned int>(submesh_index_end) <= index_count //
+				&& static_cast<unsigned int>(submesh_vertex_end) <= vertex_count //
+		);
+	}
+
+	// Release the reference held by the surface, so indices can be modified without being copied
+	surface[Mesh::ARRAY_INDEX] = Variant();
+	// Indices are never negative, so they can be processed as unsigned
+	unsigned int *indices_w = reinterpret_cast<unsigned int *>(indices.ptrw());
+
+	{
+		ZN_PROFILE_SCOPE_NAMED("meshopt_optimizeVertexCache");
+
+		if (has_submesh) {
+			// Triangles are only reordered within each range
+			zylannmeshopt::meshopt_optimizeVertexCache(indices_w, indices_w, submesh_index_end, vertex_count);
+			zylannmeshopt::meshopt_optimizeVertexCache(
+					indices_w + submesh_index_end,
+					indices_w + submesh_index_end,
+					index_count - submesh_index_end,
+					vertex_count
+			);
+		} else {
+			zylannmeshopt::meshopt_optimizeVertexCache(indices_w, indices_w, index_count, vertex_count);
+		}
+	}
+
+	static thread_local StdVector<unsigned int> tls_remap;
+	StdVector<unsigned int> &remap = tls_remap;
+	unsigned int unique_vertex_count = 0;
+	bool remap_vertices = false;
+
+	// Attributes we don't know how to reorder prevent from reordering vertices
+	if (can_remap_vertex_arrays(surface, vertex_count)) {
+		ZN_PROFILE_SCOPE_NAMED("meshopt_optimizeVertexFetchRemap");
+
+		remap.resize(vertex_count);
+		// Vertices not used by any triangle are dropped
+		unique_vertex_count =
+				zylannmeshopt::meshopt_optimizeVertexFetchRemap(remap.data(), indices_w, index_count, vertex_count);
+
+		remap_vertices = true;
+
+		if (has_submesh) {
+			// Vertices of the sub-mesh must remain the first ones
+			for (int32_t i = 0; i < submesh_vertex_end; ++i) {
+				if (remap[i] >= static_cast<unsigned int>(submesh_vertex_end)) {
+					remap_vertices = false;
+					break;
+				}
+			}
+		}
+	}
+
+	if (remap_vertices) {
+		ZN_PROFILE_SCOPE_NAMED("Remap vertices");
+
+		zylannmeshopt::meshopt_remapIndexBuffer(indices_w, indices_w, index_count, remap.data());
+
+		for (int array_index = 0; array_index < Mesh::ARRAY_MAX; ++array_index) {
+			if (array_index == Mesh::ARRAY_INDEX || surface[array_index].get_type() == Variant::NIL) {
+				continue;
+			}
+			remap_vertex_array(surface, array_index, vertex_count, unique_vertex_count, remap);
+		}
+	}
+
+	surface[Mesh::ARRAY_INDEX] = indices;
+}
+
+} // namespace zylann::voxel
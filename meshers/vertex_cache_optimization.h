@@ -0,0 +1,18 @@
+#ifndef VOXEL_VERTEX_CACHE_OPTIMIZATION_H
+#define VOXEL_VERTEX_CACHE_OPTIMIZATION_H
+
+#include "../util/godot/core/array.h"
+#include <cstdint>
+
+namespace zylann::voxel {
+
+// Reorders triangles of an indexed surface so the GPU can reuse more transformed vertices from its post-transform
+// cache, then reorders vertices in the order triangles use them, so they are fetched from memory more linearly.
+// The resulting mesh looks the same.
+// If `submesh_index_end` and `submesh_vertex_end` are not -1, triangles and vertices before them are kept before them,
+// so sub-meshes picked from these ranges (such as collision surfaces) remain valid.
+void optimize_surface_for_vertex_cache(Array &surface, int32_t submesh_vertex_end, int32_t submesh_index_end);
+
+} // namespace zylann::voxel
+
+#endif // VOXEL_VERTEX_CACHE_OPTIMIZATION_H
@@ -156,6 +156,14 @@ void VoxelMesher::set_padding(int minimum, int maximum) {
 	_maximum_padding = maximum;
 }
 
+void VoxelMesher::set_vertex_cache_optimization_enabled(bool enabled) {
+	_vertex_cache_optimization_enabled = enabled;
+}
+
+bool VoxelMesher::is_vertex_cache_optimization_enabled() const {
+	return _vertex_cache_optimization_enabled;
+}
+
 Ref<Material> VoxelMesher::get_material_by_index(unsigned int i) const {
 	// May be implemented in some meshers
 	return Ref<Material>();
@@ -178,6 +186,67 @@ bool VoxelMesher::is_mesh_empty(const StdVector<Output::Surface> &surfaces) {
 	return true;
 }
 
+namespace {
+
+void pack_surface(VoxelMesher::Output::Surface &surface, Mesh::PrimitiveType primitive, uint32_t flags) {
+#if defined(ZN_GODOT)
+	if (!is_surface_triangulated(surface.arrays)) {
+		return;
+	}
+	RenderingServer::SurfaceData packed_data;
+	const Error err = RenderingServer::get_singleton()->mesh_create_surface_data_from_arrays(
+			&packed_data, RenderingServer::PrimitiveType(primitive), surface.arrays, Array(), Dictionary(), flags
+	);
+	ERR_FAIL_COND(err != OK);
+	surface.packed_data = std::move(packed_data);
+#endif
+}
+
+} // namespace
+
+void VoxelMesher::pack_surfaces(Output &output) {
+	ZN_PROFILE_SCOPE();
+	for (Output::Surface &surface : output.surfaces) {
+		pack_surface(surface, output.primitive_type, output.mesh_flags);
+	}
+	for (StdVector<Output::Surface> &surfaces : output.transition_surfaces) {
+		for (Output::Surface &surface : surfaces) {
+			pack_surface(surface, output.primitive_type, output.mesh_flags);
+		}
+	}
+}
+
+void VoxelMesher::add_surface_to_mesh(
+		ArrayMesh &mesh,
+		const Output::Surface &surface,
+		Mesh::PrimitiveType primitive,
+		uint32_t flags
+) {
+#if defined(ZN_GODOT)
+	const RenderingServer::SurfaceData &sd = surface.packed_data;
+	if (sd.vertex_count > 0) {
+		// Same as what `add_surface_from_arrays` does after packing
+		mesh.add_surface(
+				sd.format,
+				Mesh::PrimitiveType(sd.primitive),
+				sd.vertex_data,
+				sd.attribute_data,
+				sd.skin_data,
+				sd.vertex_count,
+				sd.index_data,
+				sd.index_count,
+				sd.aabb,
+				sd.blend_shape_data,
+				sd.bone_aabbs,
+				sd.lods,
+				sd.uv_scale
+		);
+		return;
+	}
+#endif
+	mesh.add_surface_from_arrays(primitive, surface.arrays, Array(), Dictionary(), flags);
+}
+
 Ref<ShaderMaterial> VoxelMesher::get_default_lod_material() const {
 	return Ref<ShaderMaterial>();
 }
@@ -202,6 +271,20 @@ void VoxelMesher::_bind_methods() {
 	);
 	ClassDB::bind_method(D_METHOD("get_minimum_padding"), &VoxelMesher::get_minimum_padding);
 	ClassDB::bind_method(D_METHOD("get_maximum_padding"), &VoxelMesher::get_maximum_padding);
+
+	ClassDB::bind_method(
+			D_METHOD("set_vertex_cache_optimization_enabled", "enabled"),
+			&VoxelMesher::set_vertex_cache_optimization_enabled
+	);
+	ClassDB::bind_method(
+			D_METHOD("is_vertex_cache_optimization_enabled"), &VoxelMesher::is_vertex_cache_optimization_enabled
+	);
+
+	ADD_PROPERTY(
+			PropertyInfo(Variant::BOOL, "vertex_cache_optimization_enabled"),
+			"set_vertex_cache_optimization_enabled",
+			"is_vertex_cache_optimization_enabled"
+	);
 }
 
 } // namespace zylann::voxel
@@ -7,8 +7,13 @@
 #include "../util/containers/std_vector.h"
 #include "../util/godot/classes/image.h"
 #include "../util/godot/classes/mesh.h"
+#include "../util/godot/classes/rendering_server.h"
 #include "../util/macros.h"
+#include "../util/math/box3i.h"
 
+#include <memory>
+
+ZN_GODOT_FORWARD_DECLARE(class ArrayMesh)
 ZN_GODOT_FORWARD_DECLARE(class ShaderMaterial)
 
 namespace zylann::voxel {
@@ -18,6 +23,7 @@ class VoxelBuffer;
 }
 
 class VoxelBuffer;
+class VoxelBufferPaddedView;
 class VoxelGenerator;
 class VoxelData;
 
@@ -25,6 +31,15 @@ class VoxelData;
 class VoxelMesher : public Resource {
 	GDCLASS(VoxelMesher, Resource)
 public:
+	// Results of a previous build of a block, which some meshers can keep in order to only rebuild the parts of it that
+	// changed. Its contents depend on the mesher.
+	struct IncrementalCache {
+		// Mesher that created the cache. Other meshers must not use it.
+		const VoxelMesher *mesher = nullptr;
+
+		virtual ~IncrementalCache() {}
+	};
+
 	struct Input {
 		// Voxels to be used as the primary source of data.
 		const VoxelBuffer &voxels;
@@ -45,12 +60,33 @@ public:
 		// If true, the mesher can collect some extra information which can be useful to speed up detail texture
 		// baking. Depends on the mesher.
 		bool detail_texture_hint = false;
+		// If true, the mesher is told the same block will likely be meshed again after small edits. Meshers supporting
+		// it will return an `incremental_cache` in the output, to be passed back in the next build of that block.
+		bool incremental_hint = false;
+		// Cache returned by the previous build of the same block. Can be null. Only used with `incremental_hint`.
+		std::shared_ptr<IncrementalCache> incremental_cache;
+		// Area of voxels that changed since `incremental_cache` was returned, relative to `origin_in_voxels`. Voxels
+		// outside of it are expected to be the same as in the previous build.
+		Box3i dirty_box;
+		// If true along with `collision_hint`, the mesh will not be rendered. Meshers supporting it may only fill
+		// `collision_surface` with positions and indices, possibly with a simpler topology, and return no surfaces.
+		bool collision_only_hint = false;
+		// Sides of the block bordering blocks of lower level of detail, as a bitmask indexed by `Cube::Side`. Meshers
+		// building transition meshes lazily only build them for these sides.
+		uint8_t transition_mask = 0b111111;
+		// If not null, voxels have to be read from this view instead of `voxels`, which then only provides the size
+		// and format of the area, without data. Only given to meshers returning true from `supports_padded_view`.
+		const VoxelBufferPaddedView *padded_view = nullptr;
 	};
 
 	struct Output {
 		struct Surface {
 			Array arrays;
 			uint16_t material_index = 0;
+#if defined(ZN_GODOT)
+			// Contents of `arrays` packed in the format of mesh resources, if `pack_surfaces` was called.
+			RenderingServer::SurfaceData packed_data;
+#endif
 		};
 		StdVector<Surface> surfaces;
 		FixedArray<StdVector<Surface>, Cube::SIDE_COUNT> transition_surfaces;
@@ -74,10 +110,28 @@ public:
 		// May be used to store extra information needed in shader to render the mesh properly
 		// (currently used only by the cubes mesher when baking colors)
 		Ref<Image> atlas_image;
+
+		// Only returned by meshers supporting incremental builds, if `Input::incremental_hint` was true
+		std::shared_ptr<IncrementalCache> incremental_cache;
 	};
 
 	static bool is_mesh_empty(const StdVector<Output::Surface> &surfaces);
 
+	// Packs vertex attributes of the render surfaces of `output` in the format of mesh resources, following
+	// `Output::mesh_flags`. With `ARRAY_FLAG_COMPRESS_ATTRIBUTES`, positions become 16-bit values relative to the bounds
+	// of the surface, normals and tangents are octahedral-encoded and UVs become 16-bit values. Meant to be called in
+	// meshing threads, so building mesh resources afterward, possibly on the main thread, doesn't pack them again.
+	// Does nothing with GDExtension, which has no API to create meshes from packed data.
+	static void pack_surfaces(Output &output);
+
+	// Adds a surface to a mesh resource, using its packed data if `pack_surfaces` was called on it.
+	static void add_surface_to_mesh(
+			ArrayMesh &mesh,
+			const Output::Surface &surface,
+			Mesh::PrimitiveType primitive,
+			uint32_t flags
+	);
+
 	// This can be called from multiple threads at once. Make sure member vars are protected or thread-local.
 	virtual void build(Output &output, const Input &voxels);
 
@@ -94,12 +148,23 @@ public:
 	// If this is not respected, the mesher might produce seams at the edges, or an error
 	unsigned int get_maximum_padding() const;
 
+	// If enabled, triangles and vertices of meshes built by terrains are reordered after meshing, so they render faster
+	// on the GPU. This costs a bit more time in meshing threads.
+	void set_vertex_cache_optimization_enabled(bool enabled);
+	bool is_vertex_cache_optimization_enabled() const;
+
 	// Gets which channels this mesher is able to use in its current configuration.
 	// This is returned as a bitmask where channel index corresponds to bit position.
 	virtual int get_used_channels_mask() const {
 		return 0;
 	}
 
+	// Returns true if the mesher can read voxels from `Input::padded_view` in its current configuration. Terrains then
+	// don't need to copy voxels of a block and its neighbors into a single buffer before meshing it.
+	virtual bool supports_padded_view() const {
+		return false;
+	}
+
 	// Returns true if this mesher supports generating voxel data at multiple levels of detail.
 	virtual bool supports_lod() const {
 		return true;
@@ -124,6 +189,12 @@ public:
 		return false;
 	}
 
+	// Returns `true` if transition meshes are only built for sides found in `Input::transition_mask`. Terrains using
+	// such meshers have to remesh blocks when transitions become needed on other sides.
+	virtual bool is_building_transitions_lazily() const {
+		return false;
+	}
+
 	// Gets a special default material to be used to render meshes produced with this mesher, when variable level of
 	// detail is used. If null, standard materials or default Godot shaders can be used. This is mostly to provide a
 	// default shader that looks ok. Users are still expected to tweak them if need be.
@@ -140,6 +211,8 @@ private:
 	// Set in constructor and never changed after.
 	unsigned int _minimum_padding = 0;
 	unsigned int _maximum_padding = 0;
+
+	bool _vertex_cache_optimization_enabled = false;
 };
 
 } // namespace zylann::voxel
@@ -0,0 +1,237 @@
+#include "voxel_buffer_padded_view.h"
+#include "../util/io/log.h"
+#include "../util/math/funcs.h"
+#include "../util/profiling.h"
+#include <cstring>
+
+namespace zylann::voxel {
+
+namespace {
+
+template <typename T>
+inline void fill_values(uint8_t *dst, unsigned int count, uint64_t value) {
+	T *dst_values = reinterpret_cast<T *>(dst);
+	const T v = static_cast<T>(value);
+	for (unsigned int i = 0; i < count; ++i) {
+		dst_values[i] = v;
+	}
+}
+
+void fill_values(uint8_t *dst, unsigned int count, uint64_t value, VoxelBuffer::Depth depth) {
+	switch (depth) {
+		case VoxelBuffer::DEPTH_8_BIT:
+			memset(dst, static_cast<uint8_t>(value), count);
+			break;
+		case VoxelBuffer::DEPTH_16_BIT:
+			fill_values<uint16_t>(dst, count, value);
+			break;
+		case VoxelBuffer::DEPTH_32_BIT:
+			fill_values<uint32_t>(dst, count, value);
+			break;
+		case VoxelBuffer::DEPTH_64_BIT:
+			fill_values<uint64_t>(dst, count, value);
+			break;
+		default:
+			ZN_PRINT_ERROR("Invalid depth");
+			break;
+	}
+}
+
+} // namespace
+
+bool VoxelBufferPaddedView::create(
+		Span<const std::shared_ptr<VoxelBuffer>> blocks,
+		unsigned int block_size,
+		unsigned int min_padding,
+		unsigned int max_padding
+) {
+	_blocks = Span<const std::shared_ptr<VoxelBuffer>>();
+	_segment_count = 0;
+	_size = 0;
+
+	unsigned int grid_size;
+	switch (blocks.size()) {
+		case 3 * 3 * 3:
+			grid_size = 3;
+			break;
+		case 4 * 4 * 4:
+			grid_size = 4;
+			break;
+		default:
+			ZN_PRINT_ERROR("Unsupported block count");
+			return false;
+	}
+
+	if (block_size == 0 || min_padding > block_size || max_padding > block_size) {
+		return false;
+	}
+
+	for (const std::shared_ptr<VoxelBuffer> &block : blocks) {
+		if (block == nullptr || block->get_size() != Vector3iUtil::create(block_size)) {
+			return false;
+		}
+	}
+
+	_blocks = blocks;
+	_block_size = block_size;
+	_grid_size = grid_size;
+	_offset = block_size - min_padding;
+	_size = (grid_size - 2) * block_size + min_padding + max_padding;
+
+	// Split the area where it crosses block boundaries
+	unsigned int begin = 0;
+	while (begin < _size) {
+		const unsigned int coord = _offset + begin;
+		AxisSegment &segment = _segments[_segment_count];
+		segment.block_coord = coord / block_size;
+		segment.local_begin = coord % block_size;
+		segment.begin = begin;
+		segment.end = math::min(begin + block_size - segment.local_begin, _size);
+		begin = segment.end;
+		++_segment_count;
+	}
+
+	return true;
+}
+
+VoxelBuffer::Depth VoxelBufferPaddedView::get_channel_depth(unsigned int channel_index) const {
+	ZN_ASSERT_RETURN_V(_blocks.size() > 0, VoxelBuffer::DEPTH_8_BIT);
+	return _blocks[0]->get_channel_depth(channel_index);
+}
+
+bool VoxelBufferPaddedView::is_uniform(unsigned int channel_index) const {
+	ZN_ASSERT_RETURN_V(_blocks.size() > 0, false);
+
+	const unsigned int bc0 = _segments[0].block_coord;
+	const uint64_t value = get_block(bc0, bc0, bc0).get_voxel(0, 0, 0, channel_index);
+
+	for (unsigned int zi = 0; zi < _segment_count; ++zi) {
+		for (unsigned int xi = 0; xi < _segment_count; ++xi) {
+			for (unsigned int yi = 0; yi < _segment_count; ++yi) {
+				const VoxelBuffer &block = get_block(
+						_segments[xi].block_coord, _segments[yi].block_coord, _segments[zi].block_coord
+				);
+				if (block.get_channel_compression(channel_index) != VoxelBuffer::COMPRESSION_UNIFORM ||
+					block.get_voxel(0, 0, 0, channel_index) != value) {
+					return false;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+uint64_t VoxelBufferPaddedView::get_voxel(Vector3i pos, unsigned int channel_index) const {
+	ZN_ASSERT_RETURN_V(_blocks.size() > 0, 0);
+	ZN_ASSERT_RETURN_V(Box3i(Vector3i(), get_size()).contains(pos), 0);
+
+	const Vector3i coord = pos + Vector3iUtil::create(_offset);
+	const int block_size = _block_size;
+	const Vector3i block_coord = coord / block_size;
+	const Vector3i local_pos = coord - block_coord * block_size;
+
+	return get_block(block_coord.x, block_coord.y, block_coord.z).get_voxel(local_pos, channel_index);
+}
+
+unsigned int VoxelBufferPaddedView::get_row(
+		int x,
+		int z,
+		unsigned int channel_index,
+		RowSegments &out_segments
+) const {
+	ZN_ASSERT_RETURN_V(_blocks.size() > 0, 0);
+#ifdef DEBUG_ENABLED
+	ZN_ASSERT_RETURN_V(x >= 0 && z >= 0 && x < int(_size) && z < int(_size), 0);
+#endif
+
+	const unsigned int coord_x = _offset + x;
+	const unsigned int coord_z = _offset + z;
+	const unsigned int block_x = coord_x / _block_size;
+	const unsigned int block_z = coord_z / _block_size;
+	const unsigned int local_x = coord_x - block_x * _block_size;
+	const unsigned int local_z = coord_z - block_z * _block_size;
+
+	const unsigned int depth_bytes = VoxelBuffer::get_depth_byte_count(get_channel_depth(channel_index));
+
+	for (unsigned int i = 0; i < _segment_count; ++i) {
+		const AxisSegment &axis_segment = _segments[i];
+		const VoxelBuffer &block = get_block(block_x, axis_segment.block_coord, block_z);
+
+		RowSegment &row_segment = out_segments[i];
+		row_segment.begin = axis_segment.begin;
+		row_segment.end = axis_segment.end;
+
+		if (block.get_channel_compression(channel_index) == VoxelBuffer::COMPRESSION_UNIFORM) {
+			row_segment.data = nullptr;
+			row_segment.uniform_value = block.get_voxel(0, 0, 0, channel_index);
+
+		} else {
+			Span<const uint8_t> block_data;
+			ZN_ASSERT_RETURN_V(block.get_channel_as_bytes_read_only(channel_index, block_data), 0);
+			const size_t local_index = block.get_index(local_x, axis_segment.local_begin, local_z);
+			row_segment.data = block_data.data() + local_index * depth_bytes;
+			row_segment.uniform_value = 0;
+		}
+	}
+
+	return _segment_count;
+}
+
+void VoxelBufferPaddedView::copy_channel_to(unsigned int channel_index, Span<uint8_t> dst) const {
+	ZN_PROFILE_SCOPE();
+	ZN_ASSERT_RETURN(_blocks.size() > 0);
+
+	const VoxelBuffer::Depth depth = get_channel_depth(channel_index);
+	const unsigned int depth_bytes = VoxelBuffer::get_depth_byte_count(depth);
+	const size_t row_size_in_bytes = _size * depth_bytes;
+	ZN_ASSERT_RETURN(dst.size() >= row_size_in_bytes * _size * _size);
+
+	RowSegments segments;
+	uint8_t *row_data = dst.data();
+
+	// ZXY order, so rows are written one after the other
+	for (unsigned int z = 0; z < _size; ++z) {
+		for (unsigned int x = 0; x < _size; ++x) {
+			const unsigned int segment_count = get_row(x, z, channel_index, segments);
+
+			for (unsigned int i = 0; i < segment_count; ++i) {
+				const RowSegment &segment = segments[i];
+				uint8_t *segment_data = row_data + segment.begin * depth_bytes;
+				const unsigned int count = segment.end - segment.begin;
+
+				if (segment.data != nullptr) {
+					memcpy(segment_data, segment.data, count * depth_bytes);
+				} else {
+					fill_values(segment_data, count, segment.uniform_value, depth);
+				}
+			}
+
+			row_data += row_size_in_bytes;
+		}
+	}
+}
+
+void VoxelBufferPaddedView::copy_to(VoxelBuffer &dst, uint32_t channels_mask) const {
+	ZN_PROFILE_SCOPE();
+	ZN_ASSERT_RETURN(_blocks.size() > 0);
+	ZN_ASSERT_RETURN(dst.get_size() == get_size());
+
+	const SmallVector<uint8_t, VoxelBuffer::MAX_CHANNELS> channels = VoxelBuffer::mask_to_channels_list(channels_mask);
+
+	for (const uint8_t channel_index : channels) {
+		ZN_ASSERT_CONTINUE(dst.get_channel_depth(channel_index) == get_channel_depth(channel_index));
+
+		if (is_uniform(channel_index)) {
+			dst.fill(get_voxel(Vector3i(), channel_index), channel_index);
+			continue;
+		}
+
+		dst.decompress_channel(channel_index);
+		Span<uint8_t> dst_data;
+		ZN_ASSERT_CONTINUE(dst.get_channel_as_bytes(channel_index, dst_data));
+		copy_channel_to(channel_index, dst_data);
+	}
+}
+
+} // namespace zylann::voxel
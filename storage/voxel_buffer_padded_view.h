@@ -0,0 +1,92 @@
+#ifndef VOXEL_BUFFER_PADDED_VIEW_H
+#define VOXEL_BUFFER_PADDED_VIEW_H
+
+#include "../util/containers/fixed_array.h"
+#include "../util/containers/span.h"
+#include "voxel_buffer.h"
+#include <memory>
+
+namespace zylann::voxel {
+
+// Read-only view of a cubic area of voxels spanning a grid of blocks, such as a block to mesh and the padding taken
+// from its neighbors. Voxels are read from the blocks directly instead of being copied into a single buffer first, so
+// blocks must stay alive and must not be modified while the view is used.
+class VoxelBufferPaddedView {
+public:
+	// Part of a row of voxels along the Y axis, coming from a single block
+	struct RowSegment {
+		// Voxels of the segment in the block. Null if the channel is uniform in that block.
+		const uint8_t *data;
+		// Value of all voxels of the segment if `data` is null
+		uint64_t uniform_value;
+		// Range covered by the segment in the row
+		uint32_t begin;
+		uint32_t end;
+	};
+
+	// Padding can't be larger than a block, so a row overlaps at most the two middle blocks of a 4x4x4 grid and one
+	// block on each side
+	static const unsigned int MAX_ROW_SEGMENTS = 4;
+
+	typedef FixedArray<RowSegment, MAX_ROW_SEGMENTS> RowSegments;
+
+	// `blocks` is a grid of 3x3x3 or 4x4x4 blocks in ZXY order, like those given to `MeshBlockTask`. The area covers
+	// the blocks in the middle of the grid, extended by `min_padding` voxels towards negative axes and `max_padding`
+	// voxels towards positive axes. The span is referenced, not copied.
+	// Returns false if the view can't be used, for example if a block is missing.
+	bool create(
+			Span<const std::shared_ptr<VoxelBuffer>> blocks,
+			unsigned int block_size,
+			unsigned int min_padding,
+			unsigned int max_padding
+	);
+
+	inline Vector3i get_size() const {
+		return Vector3iUtil::create(_size);
+	}
+
+	VoxelBuffer::Depth get_channel_depth(unsigned int channel_index) const;
+
+	// Returns true if the channel has the same uniform value in all blocks overlapping the area
+	bool is_uniform(unsigned int channel_index) const;
+
+	uint64_t get_voxel(Vector3i pos, unsigned int channel_index) const;
+
+	// Gets the row of voxels along the Y axis at the given X and Z coordinates of the area, as segments coming from
+	// different blocks. Returns how many segments were written.
+	unsigned int get_row(int x, int z, unsigned int channel_index, RowSegments &out_segments) const;
+
+	// Copies a channel into a contiguous array, with the same layout as a `VoxelBuffer` the size of the area.
+	// `dst` must be large enough to contain every voxel of the area at the depth of the channel.
+	void copy_channel_to(unsigned int channel_index, Span<uint8_t> dst) const;
+
+	// Copies channels into a buffer having the size of the area and the same format as the blocks. Used when voxels
+	// have to be in a single buffer.
+	void copy_to(VoxelBuffer &dst, uint32_t channels_mask) const;
+
+private:
+	// Part of the area overlapping a single block along one axis. The area is cubic so it is the same on all axes.
+	struct AxisSegment {
+		uint32_t block_coord;
+		uint32_t local_begin;
+		uint32_t begin;
+		uint32_t end;
+	};
+
+	inline const VoxelBuffer &get_block(unsigned int bx, unsigned int by, unsigned int bz) const {
+		return *_blocks[by + _grid_size * (bx + _grid_size * bz)];
+	}
+
+	Span<const std::shared_ptr<VoxelBuffer>> _blocks;
+	FixedArray<AxisSegment, MAX_ROW_SEGMENTS> _segments;
+	unsigned int _segment_count = 0;
+	unsigned int _block_size = 0;
+	unsigned int _grid_size = 0;
+	// Position of the area along each axis, relative to the first block of the grid
+	unsigned int _offset = 0;
+	unsigned int _size = 0;
+};
+
+} // namespace zylann::voxel
+
+#endif // VOXEL_BUFFER_PADDED_VIEW_H
@@ -81,27 +81,75 @@ bool compress_lz4(MemoryWriter &f, Span<const uint8_t> src, StdVector<uint8_t> &
 	return true;
 }
 
-bool compress(Span<const uint8_t> src, StdVector<uint8_t> &dst, Compression comp) {
+size_t get_max_compressed_size(size_t src_size, Compression comp) {
+	switch (comp) {
+		case COMPRESSION_NONE:
+			return sizeof(uint8_t) + src_size;
+
+		case COMPRESSION_LZ4_BE:
+		case COMPRESSION_LZ4:
+			ZN_ASSERT_RETURN_V(src_size <= LZ4_MAX_INPUT_SIZE, 0);
+			return sizeof(uint8_t) + sizeof(uint32_t) + LZ4_compressBound(src_size);
+
+		default:
+			ZN_PRINT_ERROR("Invalid compression header");
+			return 0;
+	}
+}
+
+bool compress(Span<const uint8_t> src, Span<uint8_t> dst, Compression comp, size_t &out_size) {
 	ZN_PROFILE_SCOPE();
 
+	ZN_ASSERT_RETURN_V(dst.size() >= get_max_compressed_size(src.size(), comp), false);
+
 	switch (comp) {
 		case COMPRESSION_NONE: {
-			dst.resize(src.size() + 1);
 			dst[0] = comp;
 			memcpy(dst.data() + 1, src.data(), src.size());
+			out_size = src.size() + 1;
 		} break;
 
-		case COMPRESSION_LZ4_BE: {
-			ZN_PRINT_ERROR("Using deprecated LZ4_BE compression!");
-			dst.clear();
-			MemoryWriter f(dst, ENDIANNESS_LITTLE_ENDIAN);
+		case COMPRESSION_LZ4: {
+			ZN_ASSERT_RETURN_V(src.size() <= LZ4_MAX_INPUT_SIZE, false);
+
+			ByteSpanWithPosition bs(dst, 0);
+			MemoryWriterExistingBuffer f(bs, ENDIANNESS_LITTLE_ENDIAN);
 			f.store_8(comp);
-			compress_lz4(f, src, dst);
+			f.store_32(src.size());
+
+			const uint32_t header_size = sizeof(uint8_t) + sizeof(uint32_t);
+
+			const int compressed_size = LZ4_compress_default(
+					(const char *)src.data(), (char *)dst.data() + header_size, src.size(), dst.size() - header_size);
+
+			ZN_ASSERT_RETURN_V(compressed_size > 0, false);
+
+			out_size = header_size + compressed_size;
 		} break;
 
+		default:
+			// Deprecated formats are only supported when writing to a vector
+			ZN_PRINT_ERROR("Unsupported compression format");
+			return false;
+	}
+
+	return true;
+}
+
+bool compress(Span<const uint8_t> src, StdVector<uint8_t> &dst, Compression comp) {
+	ZN_PROFILE_SCOPE();
+
+	switch (comp) {
+		case COMPRESSION_NONE:
 		case COMPRESSION_LZ4: {
-			// Write header
-			// Must clear first because MemoryWriter writes from the end
+			dst.resize(get_max_compressed_size(src.size(), comp));
+			size_t compressed_size = 0;
+			ZN_ASSERT_RETURN_V(compress(src, to_span(dst), comp, compressed_size), false);
+			dst.resize(compressed_size);
+		} break;
+
+		case COMPRESSION_LZ4_BE: {
+			ZN_PRINT_ERROR("Using deprecated LZ4_BE compression!");
 			dst.clear();
 			MemoryWriter f(dst, ENDIANNESS_LITTLE_ENDIAN);
 			f.store_8(comp);
@@ -29,6 +29,11 @@ enum Compression {
 bool compress(Span<const uint8_t> src, StdVector<uint8_t> &dst, Compression comp);
 bool decompress(Span<const uint8_t> src, StdVector<uint8_t> &dst);
 
+// Gets the size of the memory to provide to compress `src_size` bytes in the worst case
+size_t get_max_compressed_size(size_t src_size, Compression comp);
+// Compresses into memory owned by the caller, which must be at least `get_max_compressed_size` bytes.
+bool compress(Span<const uint8_t> src, Span<uint8_t> dst, Compression comp, size_t &out_size);
+
 } // namespace zylann::voxel::CompressedData
 
 #endif // VOXEL_COMPRESSED_DATA_H
@@ -5,13 +5,22 @@
 #include "../storage/voxel_data.h"
 #include "../util/dstack.h"
 #include "../util/io/log.h"
+#include "../util/math/conv.h"
 #include "../util/profiling.h"
+#include "prefetch_block_data_task.h"
 
 namespace zylann::voxel {
 
 namespace {
 std::atomic_int g_debug_load_block_tasks_count = { 0 };
-}
+
+// How far ahead in time we try to anticipate viewer motion
+const float PREFETCH_LOOKAHEAD_SECONDS = 2.f;
+// Viewers slower than this (in world units per second) are not worth prefetching for
+const float PREFETCH_MIN_SPEED = 4.f;
+// Limits how many blocks can be prefetched from a single load request
+const int PREFETCH_MAX_DEPTH = 4;
+} // namespace
 
 LoadBlockDataTask::LoadBlockDataTask(
 		VolumeID p_volume_id,
@@ -54,6 +63,11 @@ int LoadBlockDataTask::debug_get_running_count() {
 	return g_debug_load_block_tasks_count;
 }
 
+void LoadBlockDataTask::enable_prefetch(const Basis &volume_basis) {
+	_world_to_volume_basis = volume_basis.inverse();
+	_prefetch_enabled = true;
+}
+
 void LoadBlockDataTask::run(zylann::ThreadedTaskContext &ctx) {
 	ZN_DSTACK();
 	ZN_PROFILE_SCOPE();
@@ -76,6 +90,10 @@ void LoadBlockDataTask::run(zylann::ThreadedTaskContext &ctx) {
 	VoxelStream::VoxelQueryData voxel_query_data{ *_voxels, _position, _lod_index, VoxelStream::RESULT_ERROR };
 	stream->load_voxel_block(voxel_query_data);
 
+	if (_prefetch_enabled && stream->supports_prefetch()) {
+		schedule_prefetch();
+	}
+
 	if (voxel_query_data.result == VoxelStream::RESULT_ERROR) {
 		ERR_PRINT("Error loading voxel block");
 
@@ -137,6 +155,78 @@ void LoadBlockDataTask::run(zylann::ThreadedTaskContext &ctx) {
 	_has_run = true;
 }
 
+// Blocks are requested when they enter the load area of a viewer. If the viewer moves fast, it can outrun loading.
+// When this block is in front of a moving viewer, it likely is on the leading edge of that area, so blocks further
+// along the viewer's motion will be requested next. We schedule reading them ahead of time at low priority.
+void LoadBlockDataTask::schedule_prefetch() {
+	ZN_PROFILE_SCOPE();
+
+	const PriorityDependency::ViewersData *viewers_data = _priority_dependency.shared.get();
+	if (viewers_data == nullptr) {
+		return;
+	}
+	const unsigned int viewer_count = math::min(
+			static_cast<unsigned int>(viewers_data->viewers_count),
+			static_cast<unsigned int>(viewers_data->viewer_velocities.size())
+	);
+
+	const Vector3f block_position = _priority_dependency.world_position;
+
+	int closest_viewer_index = -1;
+	float closest_distance_sq = 0.f;
+	for (unsigned int i = 0; i < viewer_count; ++i) {
+		const float d = math::distance_squared(viewers_data->viewers[i], block_position);
+		if (closest_viewer_index == -1 || d < closest_distance_sq) {
+			closest_distance_sq = d;
+			closest_viewer_index = i;
+		}
+	}
+	if (closest_viewer_index == -1) {
+		return;
+	}
+
+	const Vector3f velocity = viewers_data->viewer_velocities[closest_viewer_index];
+	if (math::length_squared(velocity) < math::squared(PREFETCH_MIN_SPEED)) {
+		return;
+	}
+	const Vector3f viewer_to_block = block_position - viewers_data->viewers[closest_viewer_index];
+	if (math::dot(viewer_to_block, velocity) <= 0.f) {
+		// The viewer is moving away from this block
+		return;
+	}
+
+	// In voxels per second
+	const Vector3 local_velocity = _world_to_volume_basis.xform(to_vec3(velocity));
+	const real_t local_speed = local_velocity.length();
+	const real_t block_size_in_voxels = _block_size << _lod_index;
+	const int depth = math::min(
+			static_cast<int>(Math::ceil(local_speed * PREFETCH_LOOKAHEAD_SECONDS / block_size_in_voxels)),
+			PREFETCH_MAX_DEPTH
+	);
+	if (depth <= 0) {
+		return;
+	}
+	const Vector3 direction = local_velocity / local_speed;
+
+	StdVector<Vector3i> positions;
+	Vector3i prev_position = _position;
+	for (int i = 1; i <= depth; ++i) {
+		const Vector3i pos = _position + math::round_to_int(direction * i);
+		// Slow components can round to the same block several times
+		if (pos != prev_position) {
+			positions.push_back(pos);
+			prev_position = pos;
+		}
+	}
+	if (positions.size() == 0) {
+		return;
+	}
+
+	PrefetchBlockDataTask *task =
+			ZN_NEW(PrefetchBlockDataTask(std::move(positions), _lod_index, _stream_dependency, _cancellation_token));
+	VoxelEngine::get_singleton().push_async_io_task(task);
+}
+
 TaskPriority LoadBlockDataTask::get_priority() {
 	float closest_viewer_distance_sq;
 	const TaskPriority p =
@@ -4,6 +4,7 @@
 #include "../engine/ids.h"
 #include "../engine/priority_dependency.h"
 #include "../engine/streaming_dependency.h"
+#include "../util/godot/core/basis.h"
 #include "../util/memory/memory.h"
 #include "../util/tasks/threaded_task.h"
 
@@ -29,6 +30,10 @@ public:
 
 	~LoadBlockDataTask();
 
+	// If the stream supports it, blocks further along the path of a viewer moving towards this block will be read
+	// ahead of time, so they are ready sooner when the viewer gets there.
+	void enable_prefetch(const Basis &volume_basis);
+
 	const char *get_debug_name() const override {
 		return "LoadBlockData";
 	}
@@ -41,6 +46,8 @@ public:
 	static int debug_get_running_count();
 
 private:
+	void schedule_prefetch();
+
 	PriorityDependency _priority_dependency;
 	std::shared_ptr<VoxelBuffer> _voxels;
 #ifdef VOXEL_ENABLE_INSTANCER
@@ -59,9 +66,12 @@ private:
 	bool _max_lod_hint = false;
 	bool _generate_cache_data = true;
 	bool _requested_generator_task = false;
+	bool _prefetch_enabled = false;
 #ifdef VOXEL_ENABLE_GPU
 	bool _generator_use_gpu = false;
 #endif
+	// Converts world-space directions into volume-space. Only used for prefetching.
+	Basis _world_to_volume_basis;
 	std::shared_ptr<StreamingDependency> _stream_dependency;
 	std::shared_ptr<VoxelData> _voxel_data;
 	TaskCancellationToken _cancellation_token;
@@ -0,0 +1,46 @@
+#include "prefetch_block_data_task.h"
+#include "../util/profiling.h"
+
+namespace zylann::voxel {
+
+PrefetchBlockDataTask::PrefetchBlockDataTask(
+		StdVector<Vector3i> &&p_block_positions,
+		uint8_t p_lod,
+		std::shared_ptr<StreamingDependency> p_stream_dependency,
+		TaskCancellationToken p_cancellation_token
+) :
+		_block_positions(std::move(p_block_positions)),
+		_lod_index(p_lod),
+		_stream_dependency(p_stream_dependency),
+		_cancellation_token(p_cancellation_token) {}
+
+void PrefetchBlockDataTask::run(ThreadedTaskContext &ctx) {
+	ZN_PROFILE_SCOPE();
+
+	ZN_ASSERT_RETURN(_stream_dependency != nullptr);
+	Ref<VoxelStream> stream = _stream_dependency->stream;
+	ZN_ASSERT_RETURN(stream.is_valid());
+
+	stream->prefetch_voxel_blocks(to_span_const(_block_positions), _lod_index);
+}
+
+TaskPriority PrefetchBlockDataTask::get_priority() {
+	TaskPriority p;
+	// Closer LODs first, like load requests
+	p.band1 = constants::MAX_LOD - _lod_index;
+	p.band2 = constants::TASK_PRIORITY_PREFETCH_BAND2;
+	p.band3 = constants::TASK_PRIORITY_BAND3_DEFAULT;
+	return p;
+}
+
+bool PrefetchBlockDataTask::is_cancelled() {
+	if (!_stream_dependency->valid) {
+		return true;
+	}
+	if (_cancellation_token.is_valid()) {
+		return _cancellation_token.is_cancelled();
+	}
+	return false;
+}
+
+} // namespace zylann::voxel
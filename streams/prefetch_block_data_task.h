@@ -0,0 +1,39 @@
+#ifndef PREFETCH_BLOCK_DATA_TASK_H
+#define PREFETCH_BLOCK_DATA_TASK_H
+
+#include "../engine/streaming_dependency.h"
+#include "../util/containers/std_vector.h"
+#include "../util/tasks/cancellation_token.h"
+#include "../util/tasks/threaded_task.h"
+
+namespace zylann::voxel {
+
+// Reads blocks ahead of time into the stream's cache, because they are likely to be requested soon.
+// It doesn't produce any result by itself: the actual load request that comes later will be faster.
+class PrefetchBlockDataTask : public IThreadedTask {
+public:
+	PrefetchBlockDataTask(
+			StdVector<Vector3i> &&p_block_positions,
+			uint8_t p_lod,
+			std::shared_ptr<StreamingDependency> p_stream_dependency,
+			TaskCancellationToken p_cancellation_token
+	);
+
+	const char *get_debug_name() const override {
+		return "PrefetchBlockData";
+	}
+
+	void run(ThreadedTaskContext &ctx) override;
+	TaskPriority get_priority() override;
+	bool is_cancelled() override;
+
+private:
+	StdVector<Vector3i> _block_positions;
+	uint8_t _lod_index;
+	std::shared_ptr<StreamingDependency> _stream_dependency;
+	TaskCancellationToken _cancellation_token;
+};
+
+} // namespace zylann::voxel
+
+#endif // PREFETCH_BLOCK_DATA_TASK_H
@@ -1,5 +1,6 @@
 #include "connection.h"
 #include "../../thirdparty/sqlite/sqlite3.h"
+#include "../../util/hash_funcs.h"
 #include "../../util/profiling.h"
 #include "../../util/string/format.h"
 
@@ -146,6 +147,26 @@ inline bool read_block_location(
 	return true;
 }
 
+inline bool decode_payload_reference(Span<const uint8_t> data, int64_t &out_id) {
+	if (data.size() != Connection::PAYLOAD_REFERENCE_SIZE || data[0] != Connection::PAYLOAD_REFERENCE_MARKER) {
+		return false;
+	}
+	int64_t id = 0;
+	for (unsigned int i = 0; i < sizeof(int64_t); ++i) {
+		id |= static_cast<int64_t>(data[1 + i]) << (i * 8);
+	}
+	out_id = id;
+	return true;
+}
+
+inline void encode_payload_reference(int64_t id, Span<uint8_t> dst) {
+	ZN_ASSERT(dst.size() == Connection::PAYLOAD_REFERENCE_SIZE);
+	dst[0] = Connection::PAYLOAD_REFERENCE_MARKER;
+	for (unsigned int i = 0; i < sizeof(int64_t); ++i) {
+		dst[1 + i] = (id >> (i * 8)) & 0xff;
+	}
+}
+
 struct TransactionScope {
 	Connection &db;
 	TransactionScope(Connection &p_db) : db(p_db) {
@@ -165,6 +186,17 @@ static bool prepare(sqlite3 *db, sqlite3_stmt **s, const char *sql) {
 	return true;
 }
 
+StdString make_multi_row_insert_sql(unsigned int row_count) {
+	StdString sql = "INSERT OR REPLACE INTO blocks VALUES ";
+	for (unsigned int i = 0; i < row_count; ++i) {
+		if (i > 0) {
+			sql += ",";
+		}
+		sql += "(?,?,?)";
+	}
+	return sql;
+}
+
 static void finalize(sqlite3_stmt *&s) {
 	if (s != nullptr) {
 		sqlite3_finalize(s);
@@ -180,7 +212,11 @@ Connection::~Connection() {
 	close();
 }
 
-bool Connection::open(const char *fpath, const BlockLocation::CoordinateFormat preferred_coordinate_format) {
+bool Connection::open(
+		const char *fpath,
+		const BlockLocation::CoordinateFormat preferred_coordinate_format,
+		const Options &options
+) {
 	ZN_PROFILE_SCOPE();
 	close();
 
@@ -191,6 +227,12 @@ bool Connection::open(const char *fpath, const BlockLocation::CoordinateFormat p
 		return false;
 	}
 
+	// Must be done before tables get created, because the page size can't change afterwards
+	if (!apply_options(options)) {
+		close();
+		return false;
+	}
+
 	// Note, SQLite uses UTF-8 encoding by default. We rely on that.
 	// https://www.sqlite.org/c3ref/open.html
 
@@ -238,6 +280,12 @@ bool Connection::open(const char *fpath, const BlockLocation::CoordinateFormat p
 		return false;
 	}
 
+	// New databases get the latest version. Older ones only get the payloads table when migrated.
+	if (version >= VERSION_V2 && !create_payload_tables()) {
+		close();
+		return false;
+	}
+
 	// Prepare statements
 	if (!prepare(
 				db,
@@ -261,9 +309,18 @@ bool Connection::open(const char *fpath, const BlockLocation::CoordinateFormat p
 	if (!prepare(db, &_get_instance_block_statement, "SELECT instances FROM blocks WHERE loc=:loc")) {
 		return false;
 	}
+	if (!prepare(db, &_save_blocks_batch_statement, make_multi_row_insert_sql(SAVE_BATCH_SIZE).c_str())) {
+		return false;
+	}
+	if (!prepare(db, &_save_blocks_single_statement, make_multi_row_insert_sql(1).c_str())) {
+		return false;
+	}
 	if (!prepare(db, &_begin_statement, "BEGIN")) {
 		return false;
 	}
+	if (!prepare(db, &_begin_immediate_statement, "BEGIN IMMEDIATE")) {
+		return false;
+	}
 	if (!prepare(db, &_end_statement, "END")) {
 		return false;
 	}
@@ -275,7 +332,7 @@ bool Connection::open(const char *fpath, const BlockLocation::CoordinateFormat p
 		if (!prepare(db, &_save_meta_statement, "INSERT INTO meta VALUES (:version, :block_size_po2)")) {
 			return false;
 		}
-	} else if (version == VERSION_LATEST) {
+	} else if (version == VERSION_V1 || version == VERSION_V2) {
 		if (!prepare(
 					db, &_save_meta_statement, "INSERT INTO meta VALUES (:version, :block_size_po2, :coordinate_format)"
 			)) {
@@ -303,6 +360,12 @@ bool Connection::open(const char *fpath, const BlockLocation::CoordinateFormat p
 	if (!prepare(db, &_load_all_block_keys_statement, "SELECT loc FROM blocks")) {
 		return false;
 	}
+	if (!prepare(db, &_data_version_statement, "PRAGMA data_version")) {
+		return false;
+	}
+	if (version >= VERSION_V2 && !prepare_payload_statements()) {
+		return false;
+	}
 
 	// Is the database setup?
 	Meta meta = load_meta();
@@ -342,7 +405,24 @@ bool Connection::open(const char *fpath, const BlockLocation::CoordinateFormat p
 	}
 
 	_meta = meta;
+	_options = options;
 	_opened_path = fpath;
+
+	if (options.deduplication_enabled && !has_payload_table()) {
+		migrate_to_latest_version();
+		if (!has_payload_table()) {
+			ZN_PRINT_ERROR(format("Could not migrate database at path \"{}\" to use deduplication", fpath));
+			close();
+			return false;
+		}
+	}
+
+	_data_version = -1;
+	if (!refresh_payload_state()) {
+		close();
+		return false;
+	}
+
 	return true;
 }
 
@@ -351,18 +431,28 @@ void Connection::close() {
 		return;
 	}
 	finalize(_begin_statement);
+	finalize(_begin_immediate_statement);
 	finalize(_end_statement);
 	finalize(_load_version_statement);
+	finalize(_data_version_statement);
 	finalize(_update_voxel_block_statement);
 	finalize(_get_voxel_block_statement);
 	finalize(_update_instance_block_statement);
 	finalize(_get_instance_block_statement);
+	finalize(_save_blocks_batch_statement);
+	finalize(_save_blocks_single_statement);
 	finalize(_load_meta_statement);
 	finalize(_save_meta_statement);
 	finalize(_load_channels_statement);
 	finalize(_save_channel_statement);
 	finalize(_load_all_blocks_statement);
 	finalize(_load_all_block_keys_statement);
+	finalize(_find_payloads_statement);
+	finalize(_insert_payload_statement);
+	finalize(_add_payload_references_statement);
+	finalize(_delete_unused_payload_statement);
+	finalize(_get_payload_statement);
+	finalize(_has_payloads_statement);
 	sqlite3_close(_db);
 	_db = nullptr;
 	_opened_path.clear();
@@ -389,6 +479,25 @@ bool Connection::begin_transaction() {
 	return true;
 }
 
+bool Connection::begin_write_transaction() {
+	int rc = sqlite3_reset(_begin_immediate_statement);
+	if (rc != SQLITE_OK) {
+		ERR_PRINT(sqlite3_errmsg(_db));
+		return false;
+	}
+	rc = sqlite3_step(_begin_immediate_statement);
+	if (rc != SQLITE_DONE) {
+		ERR_PRINT(sqlite3_errmsg(_db));
+		return false;
+	}
+	// The write lock is held, so the state can't change until the transaction ends
+	if (!refresh_payload_state()) {
+		end_transaction();
+		return false;
+	}
+	return true;
+}
+
 bool Connection::end_transaction() {
 	int rc = sqlite3_reset(_end_statement);
 	if (rc != SQLITE_OK) {
@@ -421,6 +530,19 @@ bool Connection::save_block(const BlockLocation loc, const Span<const uint8_t> b
 			CRASH_NOW();
 	}
 
+	Span<const uint8_t> stored_data = block_data;
+	FixedArray<uint8_t, PAYLOAD_REFERENCE_SIZE> reference_buffer;
+	if (type == VOXELS) {
+		bool deduplication_active;
+		if (!is_deduplication_active(deduplication_active)) {
+			return false;
+		}
+		if (deduplication_active &&
+			!deduplicate_voxel_data(loc, block_data, to_span(reference_buffer), stored_data)) {
+			return false;
+		}
+	}
+
 	int rc = sqlite3_reset(update_block_statement);
 	if (rc != SQLITE_OK) {
 		ERR_PRINT(sqlite3_errmsg(db));
@@ -432,11 +554,11 @@ bool Connection::save_block(const BlockLocation loc, const Span<const uint8_t> b
 		return false;
 	}
 
-	if (block_data.size() == 0) {
+	if (stored_data.size() == 0) {
 		rc = sqlite3_bind_null(update_block_statement, 2);
 	} else {
 		// We use SQLITE_TRANSIENT so SQLite will make its own copy of the data
-		rc = sqlite3_bind_blob(update_block_statement, 2, block_data.data(), block_data.size(), SQLITE_TRANSIENT);
+		rc = sqlite3_bind_blob(update_block_statement, 2, stored_data.data(), stored_data.size(), SQLITE_TRANSIENT);
 	}
 	if (rc != SQLITE_OK) {
 		ERR_PRINT(sqlite3_errmsg(db));
@@ -456,10 +578,124 @@ bool Connection::save_block(const BlockLocation loc, const Span<const uint8_t> b
 	return true;
 }
 
+bool Connection::save_blocks(Span<const BlockRow> rows) {
+	ZN_PROFILE_SCOPE();
+
+	bool deduplication_active;
+	if (!is_deduplication_active(deduplication_active)) {
+		return false;
+	}
+
+	StdVector<BlockRow> deduplicated_rows;
+	StdVector<uint8_t> references;
+	if (deduplication_active) {
+		// Sized up-front, rows will point to it
+		references.resize(rows.size() * PAYLOAD_REFERENCE_SIZE);
+		deduplicated_rows.reserve(rows.size());
+		for (unsigned int row_index = 0; row_index < rows.size(); ++row_index) {
+			BlockRow row = rows[row_index];
+			const Span<uint8_t> reference_buffer =
+					to_span(references).sub(row_index * PAYLOAD_REFERENCE_SIZE, PAYLOAD_REFERENCE_SIZE);
+			if (!deduplicate_voxel_data(row.location, row.voxel_data, reference_buffer, row.voxel_data)) {
+				return false;
+			}
+			deduplicated_rows.push_back(row);
+		}
+		rows = to_span_const(deduplicated_rows);
+	}
+
+	unsigned int i = 0;
+	for (; i + SAVE_BATCH_SIZE <= rows.size(); i += SAVE_BATCH_SIZE) {
+		if (!save_blocks_batch(_save_blocks_batch_statement, rows.sub(i, SAVE_BATCH_SIZE))) {
+			return false;
+		}
+	}
+	for (; i < rows.size(); ++i) {
+		if (!save_blocks_batch(_save_blocks_single_statement, rows.sub(i, 1))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// The statement must have been prepared for exactly the number of rows given.
+bool Connection::save_blocks_batch(sqlite3_stmt *statement, Span<const BlockRow> rows) {
+	sqlite3 *db = _db;
+
+	int rc = sqlite3_reset(statement);
+	if (rc != SQLITE_OK) {
+		ERR_PRINT(sqlite3_errmsg(db));
+		return false;
+	}
+
+	// Coordinates may be bound as static memory, so they must remain valid until the statement is executed
+	FixedArray<BindBlockCoordinates, SAVE_BATCH_SIZE> block_coordinates_bindings;
+	ZN_ASSERT_RETURN_V(rows.size() <= block_coordinates_bindings.size(), false);
+
+	for (unsigned int row_index = 0; row_index < rows.size(); ++row_index) {
+		const BlockRow &row = rows[row_index];
+		const int param_index = row_index * 3 + 1;
+
+		if (!block_coordinates_bindings[row_index].bind(
+					db, statement, param_index, _meta.coordinate_format, row.location
+			)) {
+			return false;
+		}
+
+		const Span<const uint8_t> blobs[2] = { row.voxel_data, row.instances_data };
+		for (unsigned int blob_index = 0; blob_index < 2; ++blob_index) {
+			const Span<const uint8_t> blob = blobs[blob_index];
+			if (blob.size() == 0) {
+				rc = sqlite3_bind_null(statement, param_index + 1 + blob_index);
+			} else {
+				// We use SQLITE_TRANSIENT so SQLite will make its own copy of the data
+				rc = sqlite3_bind_blob(
+						statement, param_index + 1 + blob_index, blob.data(), blob.size(), SQLITE_TRANSIENT
+				);
+			}
+			if (rc != SQLITE_OK) {
+				ERR_PRINT(sqlite3_errmsg(db));
+				return false;
+			}
+		}
+	}
+
+	rc = sqlite3_step(statement);
+	if (rc != SQLITE_DONE) {
+		ERR_PRINT(sqlite3_errmsg(db));
+		return false;
+	}
+
+	return true;
+}
+
 VoxelStream::ResultCode Connection::load_block(
 		const BlockLocation loc,
 		StdVector<uint8_t> &out_block_data,
 		const BlockType type
+) {
+	const VoxelStream::ResultCode result = load_block_raw(loc, out_block_data, type);
+
+	int64_t payload_id;
+	if (result == VoxelStream::RESULT_BLOCK_FOUND && type == VOXELS &&
+		decode_payload_reference(to_span_const(out_block_data), payload_id)) {
+		// Another connection may have migrated the database since this one was opened
+		if (!has_payload_table() && !refresh_payload_state()) {
+			return VoxelStream::RESULT_ERROR;
+		}
+		if (!load_payload(payload_id, out_block_data)) {
+			return VoxelStream::RESULT_ERROR;
+		}
+	}
+
+	return result;
+}
+
+// Gets data as stored in the blocks table, without resolving references
+VoxelStream::ResultCode Connection::load_block_raw(
+		const BlockLocation loc,
+		StdVector<uint8_t> &out_block_data,
+		const BlockType type
 ) {
 	sqlite3 *db = _db;
 
@@ -559,12 +795,21 @@ bool Connection::load_all_blocks(
 			const void *instances_blob = sqlite3_column_blob(load_all_blocks_statement, 2);
 			const size_t instances_blob_size = sqlite3_column_bytes(load_all_blocks_statement, 2);
 
+			Span<const uint8_t> voxel_data(reinterpret_cast<const uint8_t *>(voxels_blob), voxels_blob_size);
+
+			int64_t payload_id;
+			if (decode_payload_reference(voxel_data, payload_id)) {
+				ZN_ASSERT_CONTINUE(has_payload_table() || refresh_payload_state());
+				ZN_ASSERT_CONTINUE(load_payload(payload_id, _temp_block_data));
+				voxel_data = to_span_const(_temp_block_data);
+			}
+
 			// Using a function pointer because returning a big list of a copy of all the blobs can
 			// waste a lot of temporary memory
 			process_block_func(
 					callback_data,
 					loc,
-					Span<const uint8_t>(reinterpret_cast<const uint8_t *>(voxels_blob), voxels_blob_size),
+					voxel_data,
 					Span<const uint8_t>(reinterpret_cast<const uint8_t *>(instances_blob), instances_blob_size)
 			);
 
@@ -680,7 +925,7 @@ Connection::Meta Connection::load_meta() {
 
 		if (meta.version == VERSION_V0) {
 			meta.coordinate_format = BlockLocation::FORMAT_INT64_X16_Y16_Z16_L16;
-		} else if (meta.version == VERSION_LATEST) {
+		} else if (meta.version == VERSION_V1 || meta.version == VERSION_V2) {
 			meta.coordinate_format =
 					static_cast<BlockLocation::CoordinateFormat>(sqlite3_column_int(load_meta_statement, 2));
 		} else {
@@ -764,7 +1009,7 @@ void Connection::save_meta(Meta meta) {
 		ERR_PRINT(sqlite3_errmsg(db));
 		return;
 	}
-	if (meta.version == VERSION_LATEST) {
+	if (meta.version >= VERSION_V1) {
 		rc = sqlite3_bind_int(save_meta_statement, 3, meta.coordinate_format);
 		if (rc != SQLITE_OK) {
 			ZN_PRINT_ERROR(sqlite3_errmsg(db));
@@ -865,11 +1110,415 @@ bool Connection::migrate_from_v0_to_v1() {
 	return true;
 }
 
+bool Connection::migrate_from_v1_to_v2() {
+	if (_meta.version == VERSION_V2) {
+		ZN_PRINT_WARNING("Version already matching");
+		return true;
+	}
+	ZN_ASSERT_RETURN_V(_meta.version == VERSION_V1, false);
+
+	{
+		TransactionScope scope(*this);
+
+		if (!create_payload_tables()) {
+			return false;
+		}
+
+		char *error_message = nullptr;
+		const StdString sql = format("UPDATE meta SET version = {}", VERSION_V2);
+		const int rc = sqlite3_exec(_db, sql.c_str(), nullptr, nullptr, &error_message);
+		if (rc != SQLITE_OK) {
+			ZN_PRINT_ERROR(format("Failed to update version: {}", error_message));
+			sqlite3_free(error_message);
+			return false;
+		}
+	}
+
+	if (!prepare_payload_statements()) {
+		return false;
+	}
+	_meta.version = VERSION_V2;
+	return true;
+}
+
+bool Connection::create_payload_tables() {
+	const char *tables[2] = {
+		// Voxel data shared by multiple blocks, when deduplication is used
+		"CREATE TABLE IF NOT EXISTS payloads (id INTEGER PRIMARY KEY, hash INTEGER, refcount INTEGER, data BLOB)",
+		"CREATE INDEX IF NOT EXISTS payloads_hash ON payloads (hash)"
+	};
+	for (size_t i = 0; i < 2; ++i) {
+		char *error_message = nullptr;
+		const int rc = sqlite3_exec(_db, tables[i], nullptr, nullptr, &error_message);
+		if (rc != SQLITE_OK) {
+			ZN_PRINT_ERROR(format("Failed to create table: {}", error_message));
+			sqlite3_free(error_message);
+			return false;
+		}
+	}
+	return true;
+}
+
+bool Connection::prepare_payload_statements() {
+	sqlite3 *db = _db;
+	if (!prepare(db, &_find_payloads_statement, "SELECT id, data FROM payloads WHERE hash=:hash")) {
+		return false;
+	}
+	if (!prepare(
+				db, &_insert_payload_statement, "INSERT INTO payloads (hash, refcount, data) VALUES (:hash, 1, :data)"
+		)) {
+		return false;
+	}
+	if (!prepare(
+				db, &_add_payload_references_statement, "UPDATE payloads SET refcount=refcount+:delta WHERE id=:id"
+		)) {
+		return false;
+	}
+	if (!prepare(db, &_delete_unused_payload_statement, "DELETE FROM payloads WHERE id=:id AND refcount<=0")) {
+		return false;
+	}
+	if (!prepare(db, &_get_payload_statement, "SELECT data FROM payloads WHERE id=:id")) {
+		return false;
+	}
+	if (!prepare(db, &_has_payloads_statement, "SELECT EXISTS (SELECT 1 FROM payloads)")) {
+		return false;
+	}
+	return true;
+}
+
+// Existing payloads must keep their reference count up to date even if deduplication is off. Other connections to the
+// same database may have added some since the last save, or migrated it to a version having payloads.
+// `data_version` only changes when other connections commit, so most of the time this doesn't query tables.
+bool Connection::refresh_payload_state() {
+	sqlite3 *db = _db;
+
+	int rc = sqlite3_reset(_data_version_statement);
+	if (rc != SQLITE_OK) {
+		ERR_PRINT(sqlite3_errmsg(db));
+		return false;
+	}
+	rc = sqlite3_step(_data_version_statement);
+	if (rc != SQLITE_ROW) {
+		ERR_PRINT(sqlite3_errmsg(db));
+		return false;
+	}
+	const int64_t data_version = sqlite3_column_int64(_data_version_statement, 0);
+	sqlite3_reset(_data_version_statement);
+
+	if (data_version == _data_version) {
+		return true;
+	}
+	_data_version = data_version;
+
+	if (!has_payload_table()) {
+		const int version = load_version();
+		if (version == -1) {
+			return false;
+		}
+		if (version < VERSION_V2) {
+			_has_payloads = false;
+			return true;
+		}
+		// Another connection migrated the database
+		if (!prepare_payload_statements()) {
+			return false;
+		}
+		_meta.version = version;
+	}
+
+	rc = sqlite3_reset(_has_payloads_statement);
+	if (rc != SQLITE_OK) {
+		ERR_PRINT(sqlite3_errmsg(db));
+		return false;
+	}
+	rc = sqlite3_step(_has_payloads_statement);
+	if (rc != SQLITE_ROW) {
+		ERR_PRINT(sqlite3_errmsg(db));
+		return false;
+	}
+	_has_payloads = sqlite3_column_int(_has_payloads_statement, 0) != 0;
+	sqlite3_reset(_has_payloads_statement);
+	return true;
+}
+
+bool Connection::is_deduplication_active(bool &out_active) {
+	// Within a write transaction, the state was refreshed when it began. Otherwise each save commits on its own.
+	if (sqlite3_get_autocommit(_db) != 0 && !refresh_payload_state()) {
+		return false;
+	}
+	out_active = _options.deduplication_enabled || _has_payloads;
+	return true;
+}
+
+bool Connection::get_pragma(const char *name, StdString &out_value) {
+	sqlite3_stmt *statement = nullptr;
+	if (!prepare(_db, &statement, format("PRAGMA {}", name).c_str())) {
+		return false;
+	}
+	const int rc = sqlite3_step(statement);
+	const bool success = rc == SQLITE_ROW;
+	if (success) {
+		const unsigned char *text = sqlite3_column_text(statement, 0);
+		out_value = text != nullptr ? reinterpret_cast<const char *>(text) : "";
+	} else {
+		ERR_PRINT(sqlite3_errmsg(_db));
+	}
+	finalize(statement);
+	return success;
+}
+
+int64_t Connection::get_payload_count() {
+	if (!has_payload_table()) {
+		return 0;
+	}
+	sqlite3_stmt *statement = nullptr;
+	if (!prepare(_db, &statement, "SELECT COUNT(*) FROM payloads")) {
+		return -1;
+	}
+	int64_t count = -1;
+	const int rc = sqlite3_step(statement);
+	if (rc == SQLITE_ROW) {
+		count = sqlite3_column_int64(statement, 0);
+	} else {
+		ERR_PRINT(sqlite3_errmsg(_db));
+	}
+	finalize(statement);
+	return count;
+}
+
+bool Connection::deduplicate_voxel_data(
+		const BlockLocation loc,
+		Span<const uint8_t> data,
+		Span<uint8_t> reference_buffer,
+		Span<const uint8_t> &out_data
+) {
+	ZN_PROFILE_SCOPE();
+
+	out_data = data;
+
+	// Acquire before releasing, so a payload isn't deleted and inserted again if the block saves the same data
+	if (_options.deduplication_enabled && data.size() >= DEDUPLICATION_MIN_SIZE) {
+		int64_t payload_id;
+		if (!acquire_payload(data, payload_id)) {
+			return false;
+		}
+		encode_payload_reference(payload_id, reference_buffer);
+		out_data = reference_buffer;
+	}
+
+	// The block may be referencing a payload already, which it won't use anymore
+	return release_voxel_payload(loc);
+}
+
+bool Connection::release_voxel_payload(const BlockLocation loc) {
+	const VoxelStream::ResultCode result = load_block_raw(loc, _temp_block_data, VOXELS);
+	if (result == VoxelStream::RESULT_ERROR) {
+		return false;
+	}
+	int64_t payload_id;
+	if (result == VoxelStream::RESULT_BLOCK_FOUND &&
+		decode_payload_reference(to_span_const(_temp_block_data), payload_id)) {
+		return add_payload_references(payload_id, -1);
+	}
+	return true;
+}
+
+// Finds a payload with identical data and adds a reference to it, or creates a new one
+bool Connection::acquire_payload(Span<const uint8_t> data, int64_t &out_id) {
+	sqlite3 *db = _db;
+	// SQLite integers are signed, the hash is stored as-is
+	const int64_t hash = static_cast<int64_t>(hash_xxh64(data.data(), data.size()));
+
+	int rc = sqlite3_reset(_find_payloads_statement);
+	if (rc != SQLITE_OK) {
+		ERR_PRINT(sqlite3_errmsg(db));
+		return false;
+	}
+	rc = sqlite3_bind_int64(_find_payloads_statement, 1, hash);
+	if (rc != SQLITE_OK) {
+		ERR_PRINT(sqlite3_errmsg(db));
+		return false;
+	}
+
+	// Different data can have the same hash, so contents must be compared too
+	int64_t found_id = -1;
+	while (true) {
+		rc = sqlite3_step(_find_payloads_statement);
+		if (rc == SQLITE_ROW) {
+			const void *blob = sqlite3_column_blob(_find_payloads_statement, 1);
+			const size_t blob_size = sqlite3_column_bytes(_find_payloads_statement, 1);
+			if (blob_size == data.size() && memcmp(blob, data.data(), blob_size) == 0) {
+				found_id = sqlite3_column_int64(_find_payloads_statement, 0);
+				break;
+			}
+			continue;
+		}
+		if (rc != SQLITE_DONE) {
+			ERR_PRINT(sqlite3_errmsg(db));
+			return false;
+		}
+		break;
+	}
+	// Don't leave the query running if we stopped early
+	sqlite3_reset(_find_payloads_statement);
+
+	if (found_id != -1) {
+		out_id = found_id;
+		return add_payload_references(found_id, 1);
+	}
+
+	rc = sqlite3_reset(_insert_payload_statement);
+	if (rc != SQLITE_OK) {
+		ERR_PRINT(sqlite3_errmsg(db));
+		return false;
+	}
+	rc = sqlite3_bind_int64(_insert_payload_statement, 1, hash);
+	if (rc != SQLITE_OK) {
+		ERR_PRINT(sqlite3_errmsg(db));
+		return false;
+	}
+	rc = sqlite3_bind_blob(_insert_payload_statement, 2, data.data(), data.size(), SQLITE_TRANSIENT);
+	if (rc != SQLITE_OK) {
+		ERR_PRINT(sqlite3_errmsg(db));
+		return false;
+	}
+	rc = sqlite3_step(_insert_payload_statement);
+	if (rc != SQLITE_DONE) {
+		ERR_PRINT(sqlite3_errmsg(db));
+		return false;
+	}
+
+	out_id = sqlite3_last_insert_rowid(db);
+	_has_payloads = true;
+	return true;
+}
+
+// Changes the reference count of a payload, and deletes it if it is no longer referenced
+bool Connection::add_payload_references(int64_t id, int delta) {
+	sqlite3 *db = _db;
+
+	int rc = sqlite3_reset(_add_payload_references_statement);
+	if (rc != SQLITE_OK) {
+		ERR_PRINT(sqlite3_errmsg(db));
+		return false;
+	}
+	rc = sqlite3_bind_int(_add_payload_references_statement, 1, delta);
+	if (rc != SQLITE_OK) {
+		ERR_PRINT(sqlite3_errmsg(db));
+		return false;
+	}
+	rc = sqlite3_bind_int64(_add_payload_references_statement, 2, id);
+	if (rc != SQLITE_OK) {
+		ERR_PRINT(sqlite3_errmsg(db));
+		return false;
+	}
+	rc = sqlite3_step(_add_payload_references_statement);
+	if (rc != SQLITE_DONE) {
+		ERR_PRINT(sqlite3_errmsg(db));
+		return false;
+	}
+
+	if (delta < 0) {
+		rc = sqlite3_reset(_delete_unused_payload_statement);
+		if (rc != SQLITE_OK) {
+			ERR_PRINT(sqlite3_errmsg(db));
+			return false;
+		}
+		rc = sqlite3_bind_int64(_delete_unused_payload_statement, 1, id);
+		if (rc != SQLITE_OK) {
+			ERR_PRINT(sqlite3_errmsg(db));
+			return false;
+		}
+		rc = sqlite3_step(_delete_unused_payload_statement);
+		if (rc != SQLITE_DONE) {
+			ERR_PRINT(sqlite3_errmsg(db));
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool Connection::load_payload(int64_t id, StdVector<uint8_t> &out_data) {
+	ZN_ASSERT_RETURN_V_MSG(has_payload_table(), false, "Found a payload reference, but the database has no payloads");
+	sqlite3 *db = _db;
+
+	int rc = sqlite3_reset(_get_payload_statement);
+	if (rc != SQLITE_OK) {
+		ERR_PRINT(sqlite3_errmsg(db));
+		return false;
+	}
+	rc = sqlite3_bind_int64(_get_payload_statement, 1, id);
+	if (rc != SQLITE_OK) {
+		ERR_PRINT(sqlite3_errmsg(db));
+		return false;
+	}
+
+	rc = sqlite3_step(_get_payload_statement);
+	if (rc == SQLITE_DONE) {
+		ZN_PRINT_ERROR(format("Block references payload {} which doesn't exist", id));
+		return false;
+	}
+	if (rc != SQLITE_ROW) {
+		ERR_PRINT(sqlite3_errmsg(db));
+		return false;
+	}
+
+	const void *blob = sqlite3_column_blob(_get_payload_statement, 0);
+	const size_t blob_size = sqlite3_column_bytes(_get_payload_statement, 0);
+	out_data.resize(blob_size);
+	memcpy(out_data.data(), blob, blob_size);
+
+	sqlite3_reset(_get_payload_statement);
+	return true;
+}
+
+bool Connection::apply_options(const Options &options) {
+	ZN_ASSERT_RETURN_V(options.synchronous >= 0 && options.synchronous < SYNCHRONOUS_MODE_COUNT, false);
+
+	StdVector<StdString> pragmas;
+	pragmas.push_back(format("PRAGMA page_size = {}", options.page_size));
+	// The journal mode persists in the file, so it is only changed when asked to. Otherwise opening a WAL database
+	// with default options would convert it back.
+	if (options.wal_enabled) {
+		pragmas.push_back("PRAGMA journal_mode = WAL");
+	} else if (options.disable_wal) {
+		StdString journal_mode;
+		if (get_pragma("journal_mode", journal_mode) && journal_mode == "wal") {
+			pragmas.push_back("PRAGMA journal_mode = DELETE");
+		}
+	}
+	pragmas.push_back(format("PRAGMA synchronous = {}", static_cast<int>(options.synchronous)));
+	pragmas.push_back(format("PRAGMA mmap_size = {}", options.mmap_size));
+
+	for (const StdString &pragma : pragmas) {
+		char *error_message = nullptr;
+		const int rc = sqlite3_exec(_db, pragma.c_str(), nullptr, nullptr, &error_message);
+		if (rc != SQLITE_OK) {
+			// Not fatal, the database remains usable with different settings. For example, the journal mode can't
+			// be changed while other connections are open.
+			ZN_PRINT_WARNING(format("Failed to execute \"{}\": {}", pragma, error_message));
+			sqlite3_free(error_message);
+		}
+	}
+
+	// Multiple connections to the same database may be used at the same time (for example, one reader per thread).
+	// Instead of failing immediately when the database is locked by another connection, wait a bit. Saves are made in
+	// single transactions of batched rows, which take well below a second for a typical cache flush. Waiting longer
+	// would rather stall a thread when another process holds the database.
+	sqlite3_busy_timeout(_db, BUSY_TIMEOUT_MS);
+
+	return true;
+}
+
 bool Connection::migrate_to_next_version() {
 	switch (_meta.version) {
 		case VERSION_V0:
 			return migrate_from_v0_to_v1();
 
+		case VERSION_V1:
+			return migrate_from_v1_to_v2();
+
 		case VERSION_LATEST:
 			ZN_PRINT_WARNING("Version is already latest");
 			break;
@@ -16,7 +16,10 @@ class Connection {
 public:
 	static constexpr int VERSION_V0 = 0;
 	static constexpr int VERSION_V1 = 1;
-	static constexpr int VERSION_LATEST = VERSION_V1;
+	// Added the `payloads` table, used for deduplication. Databases are only migrated to it when deduplication is
+	// enabled, so older versions of the module keep being able to open those that don't use it.
+	static constexpr int VERSION_V2 = 2;
+	static constexpr int VERSION_LATEST = VERSION_V2;
 
 	struct Meta {
 		int version = -1;
@@ -38,10 +41,72 @@ public:
 		INSTANCES
 	};
 
+	// Values match SQLite's `synchronous` pragma
+	enum SynchronousMode { //
+		SYNCHRONOUS_OFF = 0,
+		SYNCHRONOUS_NORMAL = 1,
+		SYNCHRONOUS_FULL = 2,
+		SYNCHRONOUS_MODE_COUNT
+	};
+
+	// Settings applied when opening the connection. Pragma defaults are those of SQLite.
+	struct Options {
+		// Write-ahead logging. Readers don't block the writer and vice versa, and commits are cheaper.
+		// Persists in the database file.
+		bool wal_enabled = false;
+		// If `wal_enabled` is false, a database using WAL is only turned back to the default journal mode if this is
+		// true. Otherwise its journal mode is left as is.
+		bool disable_wal = false;
+		SynchronousMode synchronous = SYNCHRONOUS_FULL;
+		// Maximum number of bytes of the database file accessed with memory-mapped I/O. 0 disables it.
+		int64_t mmap_size = 0;
+		// Only has effect when creating a new database.
+		int page_size = 4096;
+		// Saved voxel data identical to existing data is stored only once, and referenced by blocks.
+		// References are always resolved when loading, regardless of this setting.
+		bool deduplication_enabled = false;
+
+		inline bool operator==(const Options &other) const {
+			return wal_enabled == other.wal_enabled && disable_wal == other.disable_wal &&
+					synchronous == other.synchronous && mmap_size == other.mmap_size && page_size == other.page_size &&
+					deduplication_enabled == other.deduplication_enabled;
+		}
+
+		inline bool operator!=(const Options &other) const {
+			return !(*this == other);
+		}
+	};
+
+	// A row of the blocks table, where both voxels and instances are known.
+	// Empty data will be stored as null.
+	struct BlockRow {
+		BlockLocation location;
+		Span<const uint8_t> voxel_data;
+		Span<const uint8_t> instances_data;
+	};
+
+	// How many rows are inserted at once with `save_blocks`
+	static constexpr unsigned int SAVE_BATCH_SIZE = 32;
+
+	// How long to wait for another connection to release the database before a query fails with SQLITE_BUSY
+	static constexpr int BUSY_TIMEOUT_MS = 1000;
+
+	// With deduplication, voxel data of a block can be a reference to a row of the `payloads` table, where identical
+	// data is stored once with a reference count. References are this marker followed by the 64-bit ID of the
+	// payload. The marker can't be confused with the first byte of compressed data.
+	static constexpr uint8_t PAYLOAD_REFERENCE_MARKER = 0xff;
+	static constexpr unsigned int PAYLOAD_REFERENCE_SIZE = sizeof(uint8_t) + sizeof(int64_t);
+	// Smaller data is always stored in blocks directly, a reference would not save enough space
+	static constexpr unsigned int DEDUPLICATION_MIN_SIZE = 64;
+
 	Connection();
 	~Connection();
 
-	bool open(const char *fpath, const BlockLocation::CoordinateFormat preferred_coordinate_format);
+	bool open(
+			const char *fpath,
+			const BlockLocation::CoordinateFormat preferred_coordinate_format,
+			const Options &options = Options()
+	);
 	void close();
 
 	bool is_open() const {
@@ -58,10 +123,17 @@ public:
 	}
 
 	bool begin_transaction();
+	// Starts a transaction holding the write lock right away, so what it reads can't be changed by other connections
+	// until it ends. Saves should use this. Also refreshes what the connection knows about payloads, if other
+	// connections changed the database since.
+	bool begin_write_transaction();
 	bool end_transaction();
 
 	bool save_block(const BlockLocation loc, const Span<const uint8_t> block_data, const BlockType type);
 
+	// Saves or replaces whole rows, using multi-row inserts. Cheaper than calling `save_block` for each row and type.
+	bool save_blocks(Span<const BlockRow> rows);
+
 	VoxelStream::ResultCode load_block(
 			const BlockLocation loc,
 			StdVector<uint8_t> &out_block_data,
@@ -87,31 +159,92 @@ public:
 		return _meta;
 	}
 
+	// Options the connection was opened with
+	const Options &get_options() const {
+		return _options;
+	}
+
 	void migrate_to_latest_version();
 
+	// Gets how many distinct voxel payloads are shared by blocks. Returns -1 on error.
+	int64_t get_payload_count();
+
+	// Gets the current value of a pragma as text. Returns false on error.
+	bool get_pragma(const char *name, StdString &out_value);
+
 private:
 	int load_version();
 	Meta load_meta();
 	void save_meta(Meta meta);
 	bool migrate_to_next_version();
 	bool migrate_from_v0_to_v1();
+	bool migrate_from_v1_to_v2();
+	bool create_payload_tables();
+	bool prepare_payload_statements();
+	bool refresh_payload_state();
+	bool apply_options(const Options &options);
+	bool save_blocks_batch(sqlite3_stmt *statement, Span<const BlockRow> rows);
+
+	VoxelStream::ResultCode load_block_raw(
+			const BlockLocation loc,
+			StdVector<uint8_t> &out_block_data,
+			const BlockType type
+	);
+
+	// Tells if voxel data must go through payloads. Must be called within the transaction of the save.
+	bool is_deduplication_active(bool &out_active);
+	bool has_payload_table() const {
+		return _meta.version >= VERSION_V2;
+	}
+
+	// Gets voxel data to store in a block, which may be replaced with a reference to a shared payload.
+	// `reference_buffer` must have `PAYLOAD_REFERENCE_SIZE` bytes and remain valid until the data is stored.
+	bool deduplicate_voxel_data(
+			const BlockLocation loc,
+			Span<const uint8_t> data,
+			Span<uint8_t> reference_buffer,
+			Span<const uint8_t> &out_data
+	);
+	bool release_voxel_payload(const BlockLocation loc);
+	bool acquire_payload(Span<const uint8_t> data, int64_t &out_id);
+	bool add_payload_references(int64_t id, int delta);
+	bool load_payload(int64_t id, StdVector<uint8_t> &out_data);
 
 	StdString _opened_path;
 	Meta _meta;
+	Options _options;
+	StdVector<uint8_t> _temp_block_data;
+	// Whether the database may contain payloads. Other connections can add some, so this is refreshed when the
+	// database's `data_version` changes. Removing the last payload leaves it true, which is only slower.
+	bool _has_payloads = false;
+	int64_t _data_version = -1;
 	sqlite3 *_db = nullptr;
 	sqlite3_stmt *_load_version_statement = nullptr;
+	sqlite3_stmt *_data_version_statement = nullptr;
 	sqlite3_stmt *_begin_statement = nullptr;
+	sqlite3_stmt *_begin_immediate_statement = nullptr;
 	sqlite3_stmt *_end_statement = nullptr;
 	sqlite3_stmt *_update_voxel_block_statement = nullptr;
 	sqlite3_stmt *_get_voxel_block_statement = nullptr;
 	sqlite3_stmt *_update_instance_block_statement = nullptr;
 	sqlite3_stmt *_get_instance_block_statement = nullptr;
+	// Inserts `SAVE_BATCH_SIZE` rows
+	sqlite3_stmt *_save_blocks_batch_statement = nullptr;
+	// Inserts one row, for the remainder of batches
+	sqlite3_stmt *_save_blocks_single_statement = nullptr;
 	sqlite3_stmt *_load_meta_statement = nullptr;
 	sqlite3_stmt *_save_meta_statement = nullptr;
 	sqlite3_stmt *_load_channels_statement = nullptr;
 	sqlite3_stmt *_save_channel_statement = nullptr;
 	sqlite3_stmt *_load_all_blocks_statement = nullptr;
 	sqlite3_stmt *_load_all_block_keys_statement = nullptr;
+	// Only prepared when the database has the payloads table
+	sqlite3_stmt *_find_payloads_statement = nullptr;
+	sqlite3_stmt *_insert_payload_statement = nullptr;
+	sqlite3_stmt *_add_payload_references_statement = nullptr;
+	sqlite3_stmt *_delete_unused_payload_statement = nullptr;
+	sqlite3_stmt *_get_payload_statement = nullptr;
+	sqlite3_stmt *_has_payloads_statement = nullptr;
 };
 
 } // namespace zylann::voxel::sqlite
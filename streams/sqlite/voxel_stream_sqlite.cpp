@@ -1,6 +1,7 @@
 #include "voxel_stream_sqlite.h"
 #include "../../util/godot/classes/project_settings.h"
 #include "../../util/godot/core/string.h"
+#include "../../util/math/funcs.h"
 #include "../../util/profiling.h"
 #include "../../util/string/format.h"
 #include "../../util/string/std_string.h"
@@ -56,10 +57,7 @@ VoxelStreamSQLite::~VoxelStreamSQLite() {
 		flush_cache();
 		ZN_PRINT_VERBOSE("~VoxelStreamSQLite flushy done");
 	}
-	for (auto it = _connection_pool.begin(); it != _connection_pool.end(); ++it) {
-		delete *it;
-	}
-	_connection_pool.clear();
+	clear_connections_no_lock();
 	ZN_PRINT_VERBOSE("~VoxelStreamSQLite done");
 }
 
@@ -75,15 +73,16 @@ void VoxelStreamSQLite::set_database_path(String path) {
 		// Note, the path could be invalid,
 		// Since Godot helpfully sets the property for every character typed in the inspector.
 		// So there can be lots of errors in the editor if you type it.
-		if (con.open(_globalized_connection_path.data(), to_internal_coordinate_format(_preferred_coordinate_format))) {
+		if (con.open(
+					_globalized_connection_path.data(),
+					to_internal_coordinate_format(_preferred_coordinate_format),
+					_connection_options
+			)) {
 			flush_cache_to_connection(&con);
 		}
 	}
-	for (auto it = _connection_pool.begin(); it != _connection_pool.end(); ++it) {
-		delete *it;
-	}
+	clear_connections_no_lock();
 	_block_keys_cache.clear();
-	_connection_pool.clear();
 
 	_user_specified_connection_path = path;
 	// To support Godot shortcuts like `user://` and `res://` (though the latter won't work on exported builds)
@@ -122,7 +121,7 @@ void VoxelStreamSQLite::load_voxel_blocks(Span<VoxelStream::VoxelQueryData> p_bl
 
 	// Getting connection first to allow the key cache to load if enabled.
 	// This should be quick after the first call because the connection is cached.
-	const ConnectionResult con_res = get_connection();
+	const ConnectionResult con_res = get_reader_connection();
 
 	switch (con_res.code) {
 		case ConnectionResult::SUCCESS:
@@ -137,7 +136,7 @@ void VoxelStreamSQLite::load_voxel_blocks(Span<VoxelStream::VoxelQueryData> p_bl
 
 	sqlite::Connection *con = con_res.connection;
 
-	const ScopeRecycle con_scope(this, con);
+	const ScopeRecycle con_scope(this, con, true);
 
 	// Check the cache first
 	StdVector<unsigned int> blocks_to_load;
@@ -229,6 +228,76 @@ void VoxelStreamSQLite::save_voxel_blocks(Span<VoxelStream::VoxelQueryData> p_bl
 	}
 }
 
+bool VoxelStreamSQLite::supports_prefetch() const {
+	return _cache.get_prefetch_capacity() > 0;
+}
+
+void VoxelStreamSQLite::prefetch_voxel_blocks(Span<const Vector3i> block_positions, uint8_t lod_index) {
+	ZN_PROFILE_SCOPE();
+
+	if (_cache.get_prefetch_capacity() == 0) {
+		return;
+	}
+
+	const ConnectionResult con_res = get_reader_connection();
+	if (con_res.code != ConnectionResult::SUCCESS) {
+		return;
+	}
+
+	sqlite::Connection *con = con_res.connection;
+	const ScopeRecycle con_scope(this, con, true);
+
+	const BlockLocation::CoordinateFormat coordinate_format = con->get_meta().coordinate_format;
+	const Box3i coordinate_range = BlockLocation::get_coordinate_range(coordinate_format);
+	if (lod_index >= BlockLocation::get_lod_count(coordinate_format)) {
+		return;
+	}
+
+	// Obtained before reading, so we don't end up caching data older than what might get saved in the meantime
+	const uint32_t ticket = _cache.get_prefetch_ticket(lod_index);
+
+	StdVector<uint8_t> &temp_block_data = get_tls_temp_block_data();
+
+	// TODO We should handle busy return codes
+	ERR_FAIL_COND(con->begin_transaction() == false);
+
+	for (const Vector3i pos : block_positions) {
+		// Predicted positions can go out of range at the edges of the world, that's not an error
+		if (!coordinate_range.contains(pos)) {
+			continue;
+		}
+		if (_block_keys_cache_enabled && !_block_keys_cache.contains(pos, lod_index)) {
+			continue;
+		}
+		if (_cache.has_voxel_block(pos, lod_index)) {
+			continue;
+		}
+
+		BlockLocation loc;
+		loc.position = pos;
+		loc.lod = lod_index;
+
+		const ResultCode res = con->load_block(loc, temp_block_data, sqlite::Connection::VOXELS);
+
+		if (res == RESULT_BLOCK_FOUND) {
+			VoxelBuffer voxels(VoxelBuffer::ALLOCATOR_POOL);
+			if (BlockSerializer::decompress_and_deserialize(to_span_const(temp_block_data), voxels)) {
+				_cache.prefetch_voxel_block(pos, lod_index, voxels, ticket);
+			}
+		}
+	}
+
+	ERR_FAIL_COND(con->end_transaction() == false);
+}
+
+void VoxelStreamSQLite::set_prefetch_capacity(int capacity) {
+	_cache.set_prefetch_capacity(math::max(capacity, 0));
+}
+
+int VoxelStreamSQLite::get_prefetch_capacity() const {
+	return _cache.get_prefetch_capacity();
+}
+
 #ifdef VOXEL_ENABLE_INSTANCER
 
 bool VoxelStreamSQLite::supports_instance_blocks() const {
@@ -259,7 +328,7 @@ void VoxelStreamSQLite::load_instance_blocks(Span<VoxelStream::InstancesQueryDat
 		return;
 	}
 
-	ConnectionResult con_res = get_connection();
+	ConnectionResult con_res = get_reader_connection();
 	switch (con_res.code) {
 		case ConnectionResult::SUCCESS:
 			break;
@@ -272,7 +341,7 @@ void VoxelStreamSQLite::load_instance_blocks(Span<VoxelStream::InstancesQueryDat
 	}
 
 	sqlite::Connection *con = con_res.connection;
-	const ScopeRecycle con_scope(this, con);
+	const ScopeRecycle con_scope(this, con, true);
 
 	// TODO We should handle busy return codes
 	ERR_FAIL_COND(con->begin_transaction() == false);
@@ -428,6 +497,24 @@ void VoxelStreamSQLite::load_all_blocks(FullLoadingResult &result) {
 	ERR_FAIL_COND(request_result == false);
 }
 
+void VoxelStreamSQLite::load_all_block_keys(StdVector<BlockKey> &out_keys) {
+	ZN_PROFILE_SCOPE();
+
+	const ConnectionResult con_res = get_connection();
+	if (con_res.code != ConnectionResult::SUCCESS) {
+		return;
+	}
+	sqlite::Connection *con = con_res.connection;
+
+	const ScopeRecycle con_scope(this, con);
+
+	const bool request_result = con->load_all_block_keys(&out_keys, [](void *ctx, BlockLocation loc) {
+		StdVector<BlockKey> *keys = static_cast<StdVector<BlockKey> *>(ctx);
+		keys->push_back(BlockKey{ loc.position, loc.lod });
+	});
+	ERR_FAIL_COND(request_result == false);
+}
+
 Array VoxelStreamSQLite::get_all_blocks() {
 	FullLoadingResult result;
 	load_all_blocks(result);
@@ -477,7 +564,8 @@ void VoxelStreamSQLite::flush_cache_to_connection(sqlite::Connection *p_connecti
 	ZN_PRINT_VERBOSE(format("VoxelStreamSQLite: Flushing cache ({} elements)", _cache.get_indicative_block_count()));
 
 	ERR_FAIL_COND(p_connection == nullptr);
-	ERR_FAIL_COND(p_connection->begin_transaction() == false);
+	// Deduplication checks what the database contains before writing
+	ERR_FAIL_COND(p_connection->begin_write_transaction() == false);
 
 #ifdef VOXEL_ENABLE_INSTANCER
 	StdVector<uint8_t> &temp_data = get_tls_temp_block_data();
@@ -488,12 +576,47 @@ void VoxelStreamSQLite::flush_cache_to_connection(sqlite::Connection *p_connecti
 	const Box3i coordinate_range = BlockLocation::get_coordinate_range(coordinate_format);
 	const unsigned int lod_count = BlockLocation::get_lod_count(coordinate_format);
 
+	// Rows where both voxels and instances are known are inserted in batches, which is much faster than one query per
+	// row and per column. Their serialized data is accumulated in a single buffer until the batch is full.
+	struct PendingRow {
+		BlockLocation location;
+		size_t voxels_offset;
+		size_t voxels_size;
+		size_t instances_offset;
+		size_t instances_size;
+	};
+	StdVector<PendingRow> pending_rows;
+	pending_rows.reserve(sqlite::Connection::SAVE_BATCH_SIZE);
+	StdVector<uint8_t> pending_data;
+	StdVector<sqlite::Connection::BlockRow> batch_rows;
+	batch_rows.reserve(sqlite::Connection::SAVE_BATCH_SIZE);
+
+	auto submit_pending_rows = [p_connection, &pending_rows, &pending_data, &batch_rows]() {
+		if (pending_rows.size() == 0) {
+			return;
+		}
+		batch_rows.clear();
+		const Span<const uint8_t> data = to_span_const(pending_data);
+		for (const PendingRow &row : pending_rows) {
+			batch_rows.push_back(sqlite::Connection::BlockRow{
+					row.location,
+					data.sub(row.voxels_offset, row.voxels_size),
+					data.sub(row.instances_offset, row.instances_size) });
+		}
+		p_connection->save_blocks(to_span_const(batch_rows));
+		pending_rows.clear();
+		pending_data.clear();
+	};
+
 	// TODO Needs better error rollback handling
 	_cache.flush([p_connection,
 #ifdef VOXEL_ENABLE_INSTANCER
 				  &temp_data,
 #endif
 				  &temp_compressed_data,
+				  &pending_rows,
+				  &pending_data,
+				  &submit_pending_rows,
 				  coordinate_range,
 				  lod_count](VoxelStreamCache::Block &block) {
 		ZN_ASSERT_RETURN(validate_range(block.position, block.lod, coordinate_range, lod_count));
@@ -502,18 +625,7 @@ void VoxelStreamSQLite::flush_cache_to_connection(sqlite::Connection *p_connecti
 		loc.position = block.position;
 		loc.lod = block.lod;
 
-		// Save voxels
-		if (block.has_voxels) {
-			if (block.voxels_deleted) {
-				p_connection->save_block(loc, Span<const uint8_t>(), sqlite::Connection::VOXELS);
-			} else {
-				BlockSerializer::SerializeResult res = BlockSerializer::serialize_and_compress(block.voxels);
-				ERR_FAIL_COND(!res.success);
-				p_connection->save_block(loc, to_span(res.data), sqlite::Connection::VOXELS);
-			}
-		}
-
-		// Save instances
+		// Serialize instances
 		temp_compressed_data.clear();
 #ifdef VOXEL_ENABLE_INSTANCER
 		if (block.instances != nullptr) {
@@ -526,17 +638,47 @@ void VoxelStreamSQLite::flush_cache_to_connection(sqlite::Connection *p_connecti
 			));
 		}
 #endif
-		p_connection->save_block(loc, to_span(temp_compressed_data), sqlite::Connection::INSTANCES);
 
-		// TODO Optimization: add a version of the query that can update both at once
+		if (!block.has_voxels) {
+			// Voxels must be left untouched, so we can't replace the whole row
+			p_connection->save_block(loc, to_span(temp_compressed_data), sqlite::Connection::INSTANCES);
+			return;
+		}
+
+		PendingRow row;
+		row.location = loc;
+
+		row.voxels_offset = pending_data.size();
+		if (block.voxels_deleted) {
+			row.voxels_size = 0;
+		} else {
+			ERR_FAIL_COND(!BlockSerializer::serialize_and_compress_append(block.voxels, pending_data));
+			row.voxels_size = pending_data.size() - row.voxels_offset;
+		}
+
+		row.instances_offset = pending_data.size();
+		row.instances_size = temp_compressed_data.size();
+		pending_data.insert(pending_data.end(), temp_compressed_data.begin(), temp_compressed_data.end());
+
+		pending_rows.push_back(row);
+
+		if (pending_rows.size() >= sqlite::Connection::SAVE_BATCH_SIZE) {
+			submit_pending_rows();
+		}
 	});
 
-	ERR_FAIL_COND(p_connection->end_transaction() == false);
+	submit_pending_rows();
+
+	const bool committed = p_connection->end_transaction();
+	// Only now reading blocks from the database gives what was flushed
+	_cache.end_flush();
+	ERR_FAIL_COND(!committed);
 }
 
 VoxelStreamSQLite::ConnectionResult VoxelStreamSQLite::get_connection() {
 	StdString fpath;
 	CoordinateFormat preferred_coordinate_format;
+	sqlite::Connection::Options options;
 	{
 		MutexLock mlock(_connection_mutex);
 
@@ -552,33 +694,26 @@ VoxelStreamSQLite::ConnectionResult VoxelStreamSQLite::get_connection() {
 		// First connection we get since we set the database path
 		fpath = _globalized_connection_path;
 		preferred_coordinate_format = _preferred_coordinate_format;
+		options = _connection_options;
 	}
 
 	if (fpath.empty()) {
 		ZN_PRINT_WARNING_ONCE("The database path hasn't been set.")
 		return { nullptr, ConnectionResult::NOT_CONFIGURED };
 	}
-	sqlite::Connection *con = new sqlite::Connection();
-	if (!con->open(fpath.data(), to_internal_coordinate_format(preferred_coordinate_format))) {
-		delete con;
+	sqlite::Connection *con = open_connection(fpath, preferred_coordinate_format, options);
+	if (con == nullptr) {
 		return { nullptr, ConnectionResult::ERROR };
 	}
-	if (_block_keys_cache_enabled) {
-		RWLockWrite wlock(_block_keys_cache.rw_lock);
-		con->load_all_block_keys(&_block_keys_cache, [](void *ctx, BlockLocation loc) {
-			BlockKeysCache *cache = static_cast<BlockKeysCache *>(ctx);
-			cache->add_no_lock(loc.position, loc.lod);
-		});
-	}
 	return { con, ConnectionResult::SUCCESS };
 }
 
 void VoxelStreamSQLite::recycle_connection(sqlite::Connection *con) {
 	const char *con_path = con->get_opened_file_path();
-	// Put back in the pool if the connection path didn't change
+	// Put back in the pool if the connection path and settings didn't change
 	{
 		MutexLock mlock(_connection_mutex);
-		if (_globalized_connection_path == con_path) {
+		if (_globalized_connection_path == con_path && _connection_options == con->get_options()) {
 			_connection_pool.push_back(con);
 			return;
 		}
@@ -586,6 +721,89 @@ void VoxelStreamSQLite::recycle_connection(sqlite::Connection *con) {
 	delete con;
 }
 
+VoxelStreamSQLite::ConnectionResult VoxelStreamSQLite::get_reader_connection() {
+	const Thread::ID thread_id = Thread::get_caller_id();
+
+	StdString fpath;
+	CoordinateFormat preferred_coordinate_format;
+	sqlite::Connection::Options options;
+	{
+		MutexLock mlock(_connection_mutex);
+
+		if (_globalized_connection_path.empty()) {
+			ZN_PRINT_WARNING_ONCE("The database path hasn't been set.")
+			return { nullptr, ConnectionResult::NOT_CONFIGURED };
+		}
+		auto it = _reader_connections.find(thread_id);
+		if (it != _reader_connections.end()) {
+			// Taken out while in use, so it can't be deleted by another thread in the meantime
+			sqlite::Connection *existing_connection = it->second;
+			_reader_connections.erase(it);
+			return { existing_connection, ConnectionResult::SUCCESS };
+		}
+		fpath = _globalized_connection_path;
+		preferred_coordinate_format = _preferred_coordinate_format;
+		options = _connection_options;
+	}
+
+	sqlite::Connection *con = open_connection(fpath, preferred_coordinate_format, options);
+	if (con == nullptr) {
+		return { nullptr, ConnectionResult::ERROR };
+	}
+	return { con, ConnectionResult::SUCCESS };
+}
+
+void VoxelStreamSQLite::recycle_reader_connection(sqlite::Connection *con) {
+	const char *con_path = con->get_opened_file_path();
+	{
+		MutexLock mlock(_connection_mutex);
+		if (_globalized_connection_path == con_path && _connection_options == con->get_options()) {
+			const Thread::ID thread_id = Thread::get_caller_id();
+			auto insert_result = _reader_connections.insert(std::make_pair(thread_id, con));
+			if (insert_result.second) {
+				return;
+			}
+		}
+	}
+	delete con;
+}
+
+sqlite::Connection *VoxelStreamSQLite::open_connection(
+		const StdString &fpath,
+		CoordinateFormat preferred_coordinate_format,
+		const sqlite::Connection::Options &options
+) {
+	sqlite::Connection *con = new sqlite::Connection();
+	if (!con->open(fpath.data(), to_internal_coordinate_format(preferred_coordinate_format), options)) {
+		delete con;
+		return nullptr;
+	}
+	if (_block_keys_cache_enabled) {
+		RWLockWrite wlock(_block_keys_cache.rw_lock);
+		if (!_block_keys_cache.loaded) {
+			con->load_all_block_keys(&_block_keys_cache, [](void *ctx, BlockLocation loc) {
+				BlockKeysCache *cache = static_cast<BlockKeysCache *>(ctx);
+				cache->add_no_lock(loc.position, loc.lod);
+			});
+			_block_keys_cache.loaded = true;
+		}
+	}
+	return con;
+}
+
+// Deletes idle connections. Connections currently in use will be deleted when recycled, if they no longer match the
+// current configuration.
+void VoxelStreamSQLite::clear_connections_no_lock() {
+	for (auto it = _connection_pool.begin(); it != _connection_pool.end(); ++it) {
+		delete *it;
+	}
+	_connection_pool.clear();
+	for (auto it = _reader_connections.begin(); it != _reader_connections.end(); ++it) {
+		delete it->second;
+	}
+	_reader_connections.clear();
+}
+
 void VoxelStreamSQLite::set_key_cache_enabled(bool enable) {
 	_block_keys_cache_enabled = enable;
 }
@@ -629,6 +847,91 @@ VoxelStreamSQLite::CoordinateFormat VoxelStreamSQLite::get_current_coordinate_fo
 	return to_exposed_coordinate_format(con->get_meta().coordinate_format);
 }
 
+bool VoxelStreamSQLite::get_connection_pragma(const char *name, StdString &out_value) {
+	const ConnectionResult con_res = get_connection();
+	sqlite::Connection *con = con_res.connection;
+	if (con == nullptr) {
+		return false;
+	}
+	const ScopeRecycle con_scope(this, con);
+	return con->get_pragma(name, out_value);
+}
+
+void VoxelStreamSQLite::set_wal_enabled(bool enabled) {
+	MutexLock mlock(_connection_mutex);
+	if (_connection_options.wal_enabled != enabled) {
+		_connection_options.wal_enabled = enabled;
+		// The journal mode persists in databases, so it's only turned off if WAL was enabled before
+		_connection_options.disable_wal = !enabled;
+		clear_connections_no_lock();
+	}
+}
+
+bool VoxelStreamSQLite::is_wal_enabled() const {
+	MutexLock mlock(_connection_mutex);
+	return _connection_options.wal_enabled;
+}
+
+void VoxelStreamSQLite::set_synchronous_mode(SynchronousMode mode) {
+	ZN_ASSERT_RETURN(mode >= 0 && mode < SYNCHRONOUS_MODE_COUNT);
+	MutexLock mlock(_connection_mutex);
+	const sqlite::Connection::SynchronousMode internal_mode = static_cast<sqlite::Connection::SynchronousMode>(mode);
+	if (_connection_options.synchronous != internal_mode) {
+		_connection_options.synchronous = internal_mode;
+		clear_connections_no_lock();
+	}
+}
+
+VoxelStreamSQLite::SynchronousMode VoxelStreamSQLite::get_synchronous_mode() const {
+	MutexLock mlock(_connection_mutex);
+	return static_cast<SynchronousMode>(_connection_options.synchronous);
+}
+
+void VoxelStreamSQLite::set_mmap_size(int64_t size_bytes) {
+	size_bytes = math::max(size_bytes, int64_t(0));
+	MutexLock mlock(_connection_mutex);
+	if (_connection_options.mmap_size != size_bytes) {
+		_connection_options.mmap_size = size_bytes;
+		clear_connections_no_lock();
+	}
+}
+
+int64_t VoxelStreamSQLite::get_mmap_size() const {
+	MutexLock mlock(_connection_mutex);
+	return _connection_options.mmap_size;
+}
+
+void VoxelStreamSQLite::set_page_size(int page_size) {
+	// SQLite requires a power of two between 512 and 65536
+	ZN_ASSERT_RETURN_MSG(
+			page_size >= 512 && page_size <= 65536 && math::is_power_of_two(page_size),
+			"Page size must be a power of two between 512 and 65536"
+	);
+	MutexLock mlock(_connection_mutex);
+	if (_connection_options.page_size != page_size) {
+		_connection_options.page_size = page_size;
+		clear_connections_no_lock();
+	}
+}
+
+int VoxelStreamSQLite::get_page_size() const {
+	MutexLock mlock(_connection_mutex);
+	return _connection_options.page_size;
+}
+
+void VoxelStreamSQLite::set_deduplication_enabled(bool enabled) {
+	MutexLock mlock(_connection_mutex);
+	if (_connection_options.deduplication_enabled != enabled) {
+		_connection_options.deduplication_enabled = enabled;
+		clear_connections_no_lock();
+	}
+}
+
+bool VoxelStreamSQLite::is_deduplication_enabled() const {
+	MutexLock mlock(_connection_mutex);
+	return _connection_options.deduplication_enabled;
+}
+
 bool VoxelStreamSQLite::copy_blocks_to_other_sqlite_stream(Ref<VoxelStreamSQLite> dst_stream) {
 	// This function may be used as a generic way to migrate an old save to a new one, when the format of the old one
 	// needs to change. If it's just a version change, it might be possible to do it in-place, however changes like
@@ -691,6 +994,26 @@ void VoxelStreamSQLite::_bind_methods() {
 			D_METHOD("get_preferred_coordinate_format"), &VoxelStreamSQLite::get_preferred_coordinate_format
 	);
 
+	ClassDB::bind_method(D_METHOD("set_prefetch_capacity", "capacity"), &VoxelStreamSQLite::set_prefetch_capacity);
+	ClassDB::bind_method(D_METHOD("get_prefetch_capacity"), &VoxelStreamSQLite::get_prefetch_capacity);
+
+	ClassDB::bind_method(D_METHOD("set_wal_enabled", "enabled"), &VoxelStreamSQLite::set_wal_enabled);
+	ClassDB::bind_method(D_METHOD("is_wal_enabled"), &VoxelStreamSQLite::is_wal_enabled);
+
+	ClassDB::bind_method(D_METHOD("set_synchronous_mode", "mode"), &VoxelStreamSQLite::set_synchronous_mode);
+	ClassDB::bind_method(D_METHOD("get_synchronous_mode"), &VoxelStreamSQLite::get_synchronous_mode);
+
+	ClassDB::bind_method(D_METHOD("set_mmap_size", "size_bytes"), &VoxelStreamSQLite::set_mmap_size);
+	ClassDB::bind_method(D_METHOD("get_mmap_size"), &VoxelStreamSQLite::get_mmap_size);
+
+	ClassDB::bind_method(D_METHOD("set_page_size", "page_size"), &VoxelStreamSQLite::set_page_size);
+	ClassDB::bind_method(D_METHOD("get_page_size"), &VoxelStreamSQLite::get_page_size);
+
+	ClassDB::bind_method(
+			D_METHOD("set_deduplication_enabled", "enabled"), &VoxelStreamSQLite::set_deduplication_enabled
+	);
+	ClassDB::bind_method(D_METHOD("is_deduplication_enabled"), &VoxelStreamSQLite::is_deduplication_enabled);
+
 	ClassDB::bind_method(D_METHOD("get_all_blocks"), &VoxelStreamSQLite::get_all_blocks);
 
 	BIND_ENUM_CONSTANT(COORDINATE_FORMAT_INT64_X16_Y16_Z16_L16);
@@ -699,6 +1022,11 @@ void VoxelStreamSQLite::_bind_methods() {
 	BIND_ENUM_CONSTANT(COORDINATE_FORMAT_BLOB80_X25_Y25_Z25_L5);
 	BIND_ENUM_CONSTANT(COORDINATE_FORMAT_COUNT);
 
+	BIND_ENUM_CONSTANT(SYNCHRONOUS_OFF);
+	BIND_ENUM_CONSTANT(SYNCHRONOUS_NORMAL);
+	BIND_ENUM_CONSTANT(SYNCHRONOUS_FULL);
+	BIND_ENUM_CONSTANT(SYNCHRONOUS_MODE_COUNT);
+
 	ADD_PROPERTY(
 			PropertyInfo(Variant::STRING, "database_path", PROPERTY_HINT_FILE), "set_database_path", "get_database_path"
 	);
@@ -713,6 +1041,43 @@ void VoxelStreamSQLite::_bind_methods() {
 			"set_preferred_coordinate_format",
 			"get_preferred_coordinate_format"
 	);
+
+	ADD_PROPERTY(
+			PropertyInfo(Variant::INT, "prefetch_capacity", PROPERTY_HINT_RANGE, "0,1024,1,or_greater"),
+			"set_prefetch_capacity",
+			"get_prefetch_capacity"
+	);
+
+	ADD_GROUP("Connection", "");
+
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "wal_enabled"), "set_wal_enabled", "is_wal_enabled");
+
+	ADD_PROPERTY(
+			PropertyInfo(Variant::INT, "synchronous_mode", PROPERTY_HINT_ENUM, "Off,Normal,Full"),
+			"set_synchronous_mode",
+			"get_synchronous_mode"
+	);
+
+	ADD_PROPERTY(
+			PropertyInfo(Variant::INT, "mmap_size", PROPERTY_HINT_RANGE, "0,1073741824,1,or_greater,suffix:bytes"),
+			"set_mmap_size",
+			"get_mmap_size"
+	);
+
+	ADD_PROPERTY(
+			PropertyInfo(
+					Variant::INT,
+					"page_size",
+					PROPERTY_HINT_ENUM,
+					"512:512,1024:1024,2048:2048,4096:4096,8192:8192,16384:16384,32768:32768,65536:65536"
+			),
+			"set_page_size",
+			"get_page_size"
+	);
+
+	ADD_PROPERTY(
+			PropertyInfo(Variant::BOOL, "deduplication_enabled"), "set_deduplication_enabled", "is_deduplication_enabled"
+	);
 }
 
 } // namespace zylann::voxel
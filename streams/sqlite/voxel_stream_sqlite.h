@@ -1,17 +1,16 @@
 #ifndef VOXEL_STREAM_SQLITE_H
 #define VOXEL_STREAM_SQLITE_H
 
+#include "../../util/containers/std_unordered_map.h"
 #include "../../util/containers/std_unordered_set.h"
 #include "../../util/containers/std_vector.h"
 #include "../../util/string/std_string.h"
 #include "../../util/thread/mutex.h"
+#include "../../util/thread/thread.h"
 #include "../voxel_block_serializer.h"
 #include "../voxel_stream.h"
 #include "../voxel_stream_cache.h"
-
-namespace zylann::voxel::sqlite {
-class Connection;
-}
+#include "connection.h"
 
 namespace zylann::voxel {
 
@@ -37,6 +36,13 @@ public:
 	void load_voxel_blocks(Span<VoxelStream::VoxelQueryData> p_blocks) override;
 	void save_voxel_blocks(Span<VoxelStream::VoxelQueryData> p_blocks) override;
 
+	bool supports_prefetch() const override;
+	void prefetch_voxel_blocks(Span<const Vector3i> block_positions, uint8_t lod_index) override;
+
+	// How many blocks per LOD can be read ahead of time, when terrains anticipate viewer motion. 0 disables it.
+	void set_prefetch_capacity(int capacity);
+	int get_prefetch_capacity() const;
+
 #ifdef VOXEL_ENABLE_INSTANCER
 	bool supports_instance_blocks() const override;
 	void load_instance_blocks(Span<VoxelStream::InstancesQueryData> out_blocks) override;
@@ -47,6 +53,7 @@ public:
 		return true;
 	}
 	void load_all_blocks(FullLoadingResult &result) override;
+	void load_all_block_keys(StdVector<BlockKey> &out_keys) override;
 
 	int get_used_channels_mask() const override;
 
@@ -75,11 +82,45 @@ public:
 
 	bool copy_blocks_to_other_sqlite_stream(Ref<VoxelStreamSQLite> dst_stream);
 
+	// Connection settings. Changing them closes idle connections, so the next queries will use new settings.
+
+	// Enables write-ahead logging, so reading and writing don't block each other, and saves are cheaper.
+	// This setting persists in the database file.
+	void set_wal_enabled(bool enabled);
+	bool is_wal_enabled() const;
+
+	enum SynchronousMode {
+		SYNCHRONOUS_OFF = sqlite::Connection::SYNCHRONOUS_OFF,
+		SYNCHRONOUS_NORMAL = sqlite::Connection::SYNCHRONOUS_NORMAL,
+		SYNCHRONOUS_FULL = sqlite::Connection::SYNCHRONOUS_FULL,
+		SYNCHRONOUS_MODE_COUNT
+	};
+
+	void set_synchronous_mode(SynchronousMode mode);
+	SynchronousMode get_synchronous_mode() const;
+
+	void set_mmap_size(int64_t size_bytes);
+	int64_t get_mmap_size() const;
+
+	// Only has effect when a new database is created.
+	void set_page_size(int page_size);
+	int get_page_size() const;
+
+	// Saved voxel data identical to existing data is stored only once. Saving becomes more expensive, but databases
+	// where lots of blocks are the same get smaller.
+	void set_deduplication_enabled(bool enabled);
+	bool is_deduplication_enabled() const;
+
+	// Exposed for testing. Reads a pragma from one of the connections the stream uses.
+	bool get_connection_pragma(const char *name, StdString &out_value);
+
 private:
 	void rebuild_key_cache();
 
 	struct BlockKeysCache {
 		FixedArray<StdUnorderedSet<Vector3i>, constants::MAX_LOD> lods;
+		// Keys only need to be loaded from the database once, the cache is kept up to date afterwards
+		bool loaded = false;
 		RWLock rw_lock;
 
 		inline bool contains(Vector3i bpos, unsigned int lod_index) const {
@@ -102,6 +143,7 @@ private:
 			for (unsigned int i = 0; i < lods.size(); ++i) {
 				lods[i].clear();
 			}
+			loaded = false;
 		}
 
 		// inline size_t get_memory_usage() const {
@@ -138,12 +180,25 @@ private:
 	ConnectionResult get_connection();
 	void recycle_connection(sqlite::Connection *con);
 
+	// Reading threads get their own connection, which is kept for them between queries. It avoids contention on the
+	// shared pool, and with WAL enabled, reads can run concurrently with saves.
+	ConnectionResult get_reader_connection();
+	void recycle_reader_connection(sqlite::Connection *con);
+
+	sqlite::Connection *open_connection(
+			const StdString &fpath,
+			CoordinateFormat preferred_coordinate_format,
+			const sqlite::Connection::Options &options
+	);
+	void clear_connections_no_lock();
+
 	struct ScopeRecycle {
 		VoxelStreamSQLite *stream;
 		sqlite::Connection *connection;
+		bool reader;
 
-		ScopeRecycle(VoxelStreamSQLite *p_stream, sqlite::Connection *p_connection) :
-				stream(p_stream), connection(p_connection) {
+		ScopeRecycle(VoxelStreamSQLite *p_stream, sqlite::Connection *p_connection, bool p_reader = false) :
+				stream(p_stream), connection(p_connection), reader(p_reader) {
 #ifdef DEV_ENABLED
 			ZN_ASSERT(stream != nullptr);
 			ZN_ASSERT(connection != nullptr);
@@ -151,7 +206,11 @@ private:
 		}
 
 		~ScopeRecycle() {
-			stream->recycle_connection(connection);
+			if (reader) {
+				stream->recycle_reader_connection(connection);
+			} else {
+				stream->recycle_connection(connection);
+			}
 		}
 	};
 
@@ -164,7 +223,9 @@ private:
 	String _user_specified_connection_path;
 	StdString _globalized_connection_path;
 	StdVector<sqlite::Connection *> _connection_pool;
-	Mutex _connection_mutex;
+	StdUnorderedMap<Thread::ID, sqlite::Connection *> _reader_connections;
+	sqlite::Connection::Options _connection_options;
+	mutable Mutex _connection_mutex;
 	// This cache stores blocks in memory, and gets flushed to the database when big enough.
 	// This is because save queries are more expensive.
 	// It also speeds up queries of blocks that were recently saved.
@@ -185,5 +246,6 @@ private:
 } // namespace zylann::voxel
 
 VARIANT_ENUM_CAST(zylann::voxel::VoxelStreamSQLite::CoordinateFormat);
+VARIANT_ENUM_CAST(zylann::voxel::VoxelStreamSQLite::SynchronousMode);
 
 #endif // VOXEL_STREAM_SQLITE_H
@@ -0,0 +1,927 @@
+#include "voxel_archive.h"
+#include "../engine/voxel_engine.h"
+#include "../storage/voxel_buffer.h"
+#include "../util/containers/fixed_array.h"
+#include "../util/godot/classes/directory.h"
+#include "../util/godot/classes/file_access.h"
+#include "../util/io/serialization.h"
+#include "../util/math/funcs.h"
+#include "../util/profiling.h"
+#include "../util/string/format.h"
+#include "../util/tasks/threaded_task.h"
+#include "../util/thread/mutex.h"
+#include "../util/thread/semaphore.h"
+#include "compressed_data.h"
+#include "instance_data.h"
+#include "voxel_block_serializer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace zylann::voxel::VoxelArchive {
+
+namespace {
+
+const char *FORMAT_MAGIC = "VXAR";
+const unsigned int FORMAT_MAGIC_SIZE = 4;
+const unsigned int HEADER_SIZE = FORMAT_MAGIC_SIZE + 2 * sizeof(uint8_t);
+const unsigned int TRAILER_SIZE = sizeof(uint64_t) + FORMAT_MAGIC_SIZE;
+
+enum Column {
+	// Location and format of each block
+	COLUMN_BLOCKS = 0,
+	// Data of non-uniform channels, one column per channel
+	COLUMN_CHANNELS_BEGIN,
+	COLUMN_METADATA = COLUMN_CHANNELS_BEGIN + VoxelBuffer::MAX_CHANNELS,
+	COLUMN_INSTANCES,
+	COLUMN_COUNT
+};
+
+enum BlockFlags {
+	BLOCK_HAS_VOXELS = 1,
+	BLOCK_HAS_INSTANCES = 2
+};
+
+const unsigned int INDEX_ENTRY_SIZE = sizeof(uint64_t) + sizeof(uint32_t) + COLUMN_COUNT * sizeof(uint32_t);
+
+const CompressedData::Compression COLUMN_COMPRESSION = CompressedData::COMPRESSION_LZ4;
+
+typedef VoxelStream::FullLoadingResult::Block Block;
+
+inline uint64_t spread_bits_morton_21(uint32_t v) {
+	uint64_t x = v & 0x1fffff;
+	x = (x | (x << 32)) & 0x1f00000000ffff;
+	x = (x | (x << 16)) & 0x1f0000ff0000ff;
+	x = (x | (x << 8)) & 0x100f00f00f00f00f;
+	x = (x | (x << 4)) & 0x10c30c30c30c30c3;
+	x = (x | (x << 2)) & 0x1249249249249249;
+	return x;
+}
+
+// Interleaves the 21 lowest bits of each coordinate, offset so that positions around the origin remain contiguous
+inline uint64_t get_morton_code(Vector3i p) {
+	const uint32_t offset = 1 << 20;
+	return spread_bits_morton_21(p.x + offset) | (spread_bits_morton_21(p.y + offset) << 1) |
+			(spread_bits_morton_21(p.z + offset) << 2);
+}
+
+// Works with blocks and block keys
+struct BlockOrder {
+	template <typename T>
+	inline bool operator()(const T &a, const T &b) const {
+		if (a.lod != b.lod) {
+			return a.lod < b.lod;
+		}
+		const uint64_t ma = get_morton_code(a.position);
+		const uint64_t mb = get_morton_code(b.position);
+		if (ma != mb) {
+			return ma < mb;
+		}
+		// Coordinates beyond what Morton codes cover may collide, still keep the order strict
+		if (a.position.z != b.position.z) {
+			return a.position.z < b.position.z;
+		}
+		if (a.position.y != b.position.y) {
+			return a.position.y < b.position.y;
+		}
+		return a.position.x < b.position.x;
+	}
+};
+
+struct ChunkInfo {
+	uint64_t offset = 0;
+	uint32_t block_count = 0;
+	FixedArray<uint32_t, COLUMN_COUNT> column_sizes;
+
+	uint64_t get_size() const {
+		uint64_t size = 0;
+		for (const uint32_t column_size : column_sizes) {
+			size += column_size;
+		}
+		return size;
+	}
+};
+
+// Runs jobs over the engine's thread pool, while the calling thread consumes their results in order. The calling
+// thread also runs jobs instead of just waiting, so this completes even if the pool is busy with other tasks.
+class OrderedJobs {
+public:
+	typedef void (*JobFunc)(void *context, unsigned int index);
+
+	static void run(
+			unsigned int count,
+			void *context,
+			JobFunc job_func,
+			void *consumer_context,
+			void (*consume_func)(void *consumer_context, unsigned int index)
+	) {
+		ZN_PROFILE_SCOPE();
+
+		if (count == 0) {
+			return;
+		}
+
+		std::shared_ptr<Shared> shared = make_shared_instance<Shared>();
+		shared->context = context;
+		shared->job_func = job_func;
+		shared->done.resize(count, 0);
+
+		VoxelEngine &engine = VoxelEngine::get_singleton();
+		// The calling thread takes jobs as well
+		const unsigned int task_count = math::min(count - 1, engine.get_thread_count());
+		for (unsigned int i = 0; i < task_count; ++i) {
+			engine.push_async_task(ZN_NEW(Task(shared)));
+		}
+
+		for (unsigned int index = 0; index < count; ++index) {
+			while (!shared->is_done(index)) {
+				unsigned int job_index;
+				if (shared->try_take(job_index)) {
+					shared->run(job_index);
+				} else {
+					// Remaining jobs are running in other threads
+					shared->semaphore.wait();
+				}
+			}
+			consume_func(consumer_context, index);
+		}
+		// Tasks may still exist in the pool, but they can no longer access `context` since all jobs are done
+	}
+
+private:
+	struct Shared {
+		void *context = nullptr;
+		JobFunc job_func = nullptr;
+		Mutex mutex;
+		unsigned int next_index = 0;
+		StdVector<uint8_t> done;
+		Semaphore semaphore;
+
+		bool try_take(unsigned int &out_index) {
+			MutexLock mlock(mutex);
+			if (next_index >= done.size()) {
+				return false;
+			}
+			out_index = next_index;
+			++next_index;
+			return true;
+		}
+
+		void run(unsigned int index) {
+			job_func(context, index);
+			{
+				MutexLock mlock(mutex);
+				done[index] = 1;
+			}
+			semaphore.post();
+		}
+
+		bool is_done(unsigned int index) {
+			MutexLock mlock(mutex);
+			return done[index] != 0;
+		}
+	};
+
+	class Task : public IThreadedTask {
+	public:
+		Task(std::shared_ptr<Shared> shared) : _shared(shared) {}
+
+		void run(ThreadedTaskContext &ctx) override {
+			ZN_PROFILE_SCOPE();
+			unsigned int index;
+			while (_shared->try_take(index)) {
+				_shared->run(index);
+			}
+		}
+
+		const char *get_debug_name() const override {
+			return "VoxelArchiveJobs";
+		}
+
+	private:
+		std::shared_ptr<Shared> _shared;
+	};
+};
+
+// Temporary buffers holding uncompressed columns, re-used to reduce allocations
+FixedArray<StdVector<uint8_t>, COLUMN_COUNT> &get_tls_columns() {
+	thread_local FixedArray<StdVector<uint8_t>, COLUMN_COUNT> tls_columns;
+	return tls_columns;
+}
+
+void append(StdVector<uint8_t> &dst, Span<const uint8_t> src) {
+	const size_t pos = dst.size();
+	dst.resize(pos + src.size());
+	src.copy_to(Span<uint8_t>(dst.data() + pos, src.size()));
+}
+
+bool encode_voxels(const VoxelBuffer &voxels, MemoryWriter &bw, FixedArray<StdVector<uint8_t>, COLUMN_COUNT> &columns) {
+	const Vector3i size = voxels.get_size();
+	ZN_ASSERT_RETURN_V(size.x <= std::numeric_limits<uint16_t>::max(), false);
+	ZN_ASSERT_RETURN_V(size.y <= std::numeric_limits<uint16_t>::max(), false);
+	ZN_ASSERT_RETURN_V(size.z <= std::numeric_limits<uint16_t>::max(), false);
+	bw.store_16(size.x);
+	bw.store_16(size.y);
+	bw.store_16(size.z);
+
+	for (unsigned int channel_index = 0; channel_index < VoxelBuffer::MAX_CHANNELS; ++channel_index) {
+		const VoxelBuffer::Compression compression = voxels.get_channel_compression(channel_index);
+		const VoxelBuffer::Depth depth = voxels.get_channel_depth(channel_index);
+		// Same format byte as serialized blocks
+		bw.store_8(static_cast<uint8_t>(compression) | (static_cast<uint8_t>(depth) << 4));
+
+		switch (compression) {
+			case VoxelBuffer::COMPRESSION_NONE: {
+				Span<const uint8_t> data;
+				ZN_ASSERT_RETURN_V(voxels.get_channel_as_bytes_read_only(channel_index, data), false);
+				append(columns[COLUMN_CHANNELS_BEGIN + channel_index], data);
+			} break;
+
+			case VoxelBuffer::COMPRESSION_UNIFORM:
+				bw.store_64(voxels.get_voxel(Vector3i(), channel_index));
+				break;
+
+			default:
+				ZN_PRINT_ERROR("Unhandled compression mode");
+				return false;
+		}
+	}
+
+	const size_t metadata_size = BlockSerializer::get_metadata_size_in_bytes(voxels);
+	ZN_ASSERT_RETURN_V(metadata_size <= std::numeric_limits<uint32_t>::max(), false);
+	bw.store_32(metadata_size);
+	if (metadata_size > 0) {
+		StdVector<uint8_t> &metadata_column = columns[COLUMN_METADATA];
+		const size_t pos = metadata_column.size();
+		metadata_column.resize(pos + metadata_size);
+		BlockSerializer::serialize_metadata(Span<uint8_t>(metadata_column.data() + pos, metadata_size), voxels);
+	}
+
+	return true;
+}
+
+bool encode_chunk(Span<const Block> blocks, StdVector<uint8_t> &dst, ChunkInfo &info) {
+	ZN_PROFILE_SCOPE();
+
+	FixedArray<StdVector<uint8_t>, COLUMN_COUNT> &columns = get_tls_columns();
+	for (StdVector<uint8_t> &column : columns) {
+		column.clear();
+	}
+
+	MemoryWriter bw(columns[COLUMN_BLOCKS], ENDIANNESS_LITTLE_ENDIAN);
+
+	for (const Block &block : blocks) {
+		ZN_ASSERT_RETURN_V(block.lod < constants::MAX_LOD, false);
+		bw.store_8(block.lod);
+		bw.store_32(block.position.x);
+		bw.store_32(block.position.y);
+		bw.store_32(block.position.z);
+
+		uint8_t flags = 0;
+		if (block.voxels != nullptr) {
+			flags |= BLOCK_HAS_VOXELS;
+		}
+#ifdef VOXEL_ENABLE_INSTANCER
+		if (block.instances_data != nullptr) {
+			flags |= BLOCK_HAS_INSTANCES;
+		}
+#endif
+		bw.store_8(flags);
+
+		if (block.voxels != nullptr) {
+			ZN_ASSERT_RETURN_V(encode_voxels(*block.voxels, bw, columns), false);
+		}
+
+#ifdef VOXEL_ENABLE_INSTANCER
+		if (block.instances_data != nullptr) {
+			StdVector<uint8_t> &instances_column = columns[COLUMN_INSTANCES];
+			const size_t pos = instances_column.size();
+			ZN_ASSERT_RETURN_V(serialize_instance_block_data(*block.instances_data, instances_column), false);
+			bw.store_32(instances_column.size() - pos);
+		}
+#endif
+	}
+
+	dst.clear();
+	info.block_count = blocks.size();
+
+	for (unsigned int column_index = 0; column_index < COLUMN_COUNT; ++column_index) {
+		const StdVector<uint8_t> &column = columns[column_index];
+		if (column.size() == 0) {
+			info.column_sizes[column_index] = 0;
+			continue;
+		}
+		const size_t pos = dst.size();
+		dst.resize(pos + CompressedData::get_max_compressed_size(column.size(), COLUMN_COMPRESSION));
+		size_t compressed_size = 0;
+		ZN_ASSERT_RETURN_V(
+				CompressedData::compress(
+						to_span(column), to_span(dst).sub(pos), COLUMN_COMPRESSION, compressed_size
+				),
+				false
+		);
+		ZN_ASSERT_RETURN_V(compressed_size <= std::numeric_limits<uint32_t>::max(), false);
+		dst.resize(pos + compressed_size);
+		info.column_sizes[column_index] = compressed_size;
+	}
+
+	return true;
+}
+
+// Reads sequentially from columns, checking bounds
+struct ColumnReader {
+	Span<const uint8_t> data;
+	size_t pos = 0;
+
+	bool read(size_t size, Span<const uint8_t> &out_data) {
+		if (pos + size > data.size()) {
+			return false;
+		}
+		out_data = data.sub(pos, size);
+		pos += size;
+		return true;
+	}
+};
+
+bool decode_voxels(
+		MemoryReader &br,
+		FixedArray<ColumnReader, COLUMN_COUNT> &column_readers,
+		VoxelBuffer &voxels
+) {
+	ZN_ASSERT_RETURN_V(br.pos + 3 * sizeof(uint16_t) <= br.data.size(), false);
+	Vector3i size;
+	size.x = br.get_16();
+	size.y = br.get_16();
+	size.z = br.get_16();
+	voxels.create(size);
+
+	for (unsigned int channel_index = 0; channel_index < VoxelBuffer::MAX_CHANNELS; ++channel_index) {
+		ZN_ASSERT_RETURN_V(br.pos < br.data.size(), false);
+		const uint8_t fmt = br.get_8();
+		const uint8_t compression_value = fmt & 0xf;
+		const uint8_t depth_value = (fmt >> 4) & 0xf;
+		ZN_ASSERT_RETURN_V(compression_value < VoxelBuffer::COMPRESSION_COUNT, false);
+		ZN_ASSERT_RETURN_V(depth_value < VoxelBuffer::DEPTH_COUNT, false);
+		const VoxelBuffer::Depth depth = static_cast<VoxelBuffer::Depth>(depth_value);
+
+		voxels.set_channel_depth(channel_index, depth);
+
+		switch (static_cast<VoxelBuffer::Compression>(compression_value)) {
+			case VoxelBuffer::COMPRESSION_NONE: {
+				Span<const uint8_t> data;
+				ZN_ASSERT_RETURN_V(
+						column_readers[COLUMN_CHANNELS_BEGIN + channel_index].read(
+								VoxelBuffer::get_size_in_bytes_for_volume(size, depth), data
+						),
+						false
+				);
+				voxels.set_channel_from_bytes(channel_index, data);
+			} break;
+
+			case VoxelBuffer::COMPRESSION_UNIFORM:
+				ZN_ASSERT_RETURN_V(br.pos + sizeof(uint64_t) <= br.data.size(), false);
+				voxels.clear_channel(channel_index, br.get_64());
+				break;
+
+			default:
+				ZN_PRINT_ERROR("Unhandled compression mode");
+				return false;
+		}
+	}
+
+	ZN_ASSERT_RETURN_V(br.pos + sizeof(uint32_t) <= br.data.size(), false);
+	const uint32_t metadata_size = br.get_32();
+	if (metadata_size > 0) {
+		Span<const uint8_t> data;
+		ZN_ASSERT_RETURN_V(column_readers[COLUMN_METADATA].read(metadata_size, data), false);
+		ZN_ASSERT_RETURN_V(BlockSerializer::deserialize_metadata(data, voxels), false);
+	}
+
+	return true;
+}
+
+bool decode_chunk(Span<const uint8_t> src, const ChunkInfo &info, StdVector<Block> &out_blocks) {
+	ZN_PROFILE_SCOPE();
+
+	FixedArray<StdVector<uint8_t>, COLUMN_COUNT> &columns = get_tls_columns();
+	FixedArray<ColumnReader, COLUMN_COUNT> column_readers;
+
+	size_t pos = 0;
+	for (unsigned int column_index = 0; column_index < COLUMN_COUNT; ++column_index) {
+		const uint32_t column_size = info.column_sizes[column_index];
+		StdVector<uint8_t> &column = columns[column_index];
+		if (column_size == 0) {
+			column.clear();
+		} else {
+			ZN_ASSERT_RETURN_V(pos + column_size <= src.size(), false);
+			ZN_ASSERT_RETURN_V(CompressedData::decompress(src.sub(pos, column_size), column), false);
+			pos += column_size;
+		}
+		column_readers[column_index].data = to_span(column);
+	}
+
+	MemoryReader br(to_span(columns[COLUMN_BLOCKS]), ENDIANNESS_LITTLE_ENDIAN);
+
+	out_blocks.clear();
+	out_blocks.resize(info.block_count);
+
+	for (Block &block : out_blocks) {
+		ZN_ASSERT_RETURN_V(br.pos + sizeof(uint8_t) + 3 * sizeof(uint32_t) + sizeof(uint8_t) <= br.data.size(), false);
+		block.lod = br.get_8();
+		ZN_ASSERT_RETURN_V(block.lod < constants::MAX_LOD, false);
+		block.position.x = static_cast<int32_t>(br.get_32());
+		block.position.y = static_cast<int32_t>(br.get_32());
+		block.position.z = static_cast<int32_t>(br.get_32());
+		const uint8_t flags = br.get_8();
+
+		if ((flags & BLOCK_HAS_VOXELS) != 0) {
+			block.voxels = make_shared_instance<VoxelBuffer>(VoxelBuffer::ALLOCATOR_POOL);
+			ZN_ASSERT_RETURN_V_MSG(
+					decode_voxels(br, column_readers, *block.voxels),
+					false,
+					format("Failed to decode voxels of block {} lod {}", block.position, block.lod)
+			);
+		}
+
+		if ((flags & BLOCK_HAS_INSTANCES) != 0) {
+			ZN_ASSERT_RETURN_V(br.pos + sizeof(uint32_t) <= br.data.size(), false);
+			const uint32_t instances_size = br.get_32();
+			Span<const uint8_t> data;
+			ZN_ASSERT_RETURN_V(column_readers[COLUMN_INSTANCES].read(instances_size, data), false);
+#ifdef VOXEL_ENABLE_INSTANCER
+			block.instances_data = make_unique_instance<InstanceBlockData>();
+			ZN_ASSERT_RETURN_V(deserialize_instance_block_data(*block.instances_data, data), false);
+#endif
+		}
+	}
+
+	return true;
+}
+
+bool read_header(FileAccess &f, uint8_t &out_block_size_po2) {
+	FixedArray<uint8_t, HEADER_SIZE> header;
+	ZN_ASSERT_RETURN_V(zylann::godot::get_buffer(f, to_span(header)) == header.size(), false);
+	ZN_ASSERT_RETURN_V_MSG(memcmp(header.data(), FORMAT_MAGIC, FORMAT_MAGIC_SIZE) == 0, false, "Not a voxel archive");
+	const uint8_t version = header[FORMAT_MAGIC_SIZE];
+	ZN_ASSERT_RETURN_V_MSG(
+			version == FORMAT_VERSION, false, format("Unsupported voxel archive version {}", static_cast<int>(version))
+	);
+	out_block_size_po2 = header[FORMAT_MAGIC_SIZE + 1];
+	return true;
+}
+
+bool read_index(FileAccess &f, StdVector<ChunkInfo> &out_chunks) {
+	const uint64_t file_size = f.get_length();
+	ZN_ASSERT_RETURN_V(file_size >= HEADER_SIZE + sizeof(uint32_t) + TRAILER_SIZE, false);
+
+	FixedArray<uint8_t, TRAILER_SIZE> trailer;
+	f.seek(file_size - TRAILER_SIZE);
+	ZN_ASSERT_RETURN_V(zylann::godot::get_buffer(f, to_span(trailer)) == trailer.size(), false);
+	ZN_ASSERT_RETURN_V_MSG(
+			memcmp(trailer.data() + sizeof(uint64_t), FORMAT_MAGIC, FORMAT_MAGIC_SIZE) == 0,
+			false,
+			"Voxel archive is truncated"
+	);
+	MemoryReader tr(to_span(trailer), ENDIANNESS_LITTLE_ENDIAN);
+	const uint64_t index_offset = tr.get_64();
+	ZN_ASSERT_RETURN_V(index_offset >= HEADER_SIZE && index_offset <= file_size - TRAILER_SIZE, false);
+
+	StdVector<uint8_t> index_data;
+	index_data.resize(file_size - TRAILER_SIZE - index_offset);
+	f.seek(index_offset);
+	ZN_ASSERT_RETURN_V(zylann::godot::get_buffer(f, to_span(index_data)) == index_data.size(), false);
+
+	MemoryReader ir(to_span(index_data), ENDIANNESS_LITTLE_ENDIAN);
+	ZN_ASSERT_RETURN_V(index_data.size() >= sizeof(uint32_t), false);
+	const uint32_t chunk_count = ir.get_32();
+	ZN_ASSERT_RETURN_V(index_data.size() == sizeof(uint32_t) + chunk_count * INDEX_ENTRY_SIZE, false);
+
+	out_chunks.resize(chunk_count);
+	// Chunks must follow each other, they are read in contiguous batches
+	uint64_t previous_chunk_end = HEADER_SIZE;
+	for (ChunkInfo &chunk : out_chunks) {
+		chunk.offset = ir.get_64();
+		chunk.block_count = ir.get_32();
+		for (uint32_t &column_size : chunk.column_sizes) {
+			column_size = ir.get_32();
+		}
+		ZN_ASSERT_RETURN_V(chunk.offset >= previous_chunk_end, false);
+		ZN_ASSERT_RETURN_V(chunk.offset + chunk.get_size() <= index_offset, false);
+		ZN_ASSERT_RETURN_V(chunk.block_count <= CHUNK_BLOCK_COUNT, false);
+		previous_chunk_end = chunk.offset + chunk.get_size();
+	}
+
+	return true;
+}
+
+// Chunks are processed in batches, so memory usage remains bounded with large volumes
+unsigned int get_batch_chunk_count() {
+	return 2 * (VoxelEngine::get_singleton().get_thread_count() + 1);
+}
+
+// Writes an archive into a temporary file, which replaces the destination only once complete. This way, a failed or
+// interrupted save doesn't leave a truncated archive behind, nor destroys a previous one.
+class ArchiveWriter {
+public:
+	~ArchiveWriter() {
+		if (_file.is_valid()) {
+			// Not finished
+			_file.unref();
+			zylann::godot::remove_file(_temp_fpath);
+		}
+	}
+
+	bool open(const String &fpath, uint8_t block_size_po2) {
+		_fpath = fpath;
+		_temp_fpath = fpath + ".tmp";
+
+		Error file_error;
+		_file = zylann::godot::open_file(_temp_fpath, FileAccess::WRITE, file_error);
+		ZN_ASSERT_RETURN_V_MSG(
+				_file.is_valid(),
+				false,
+				format("Could not open file {}, error {}", GodotStringWrapper(_temp_fpath), file_error)
+		);
+
+		StdVector<uint8_t> header;
+		MemoryWriter hw(header, ENDIANNESS_LITTLE_ENDIAN);
+		hw.store_buffer(Span<const uint8_t>(reinterpret_cast<const uint8_t *>(FORMAT_MAGIC), FORMAT_MAGIC_SIZE));
+		hw.store_8(FORMAT_VERSION);
+		hw.store_8(block_size_po2);
+		zylann::godot::store_buffer(**_file, to_span(header));
+
+		return true;
+	}
+
+	// Blocks must be sorted with `BlockOrder`, and come after those of previous calls.
+	bool write_blocks(Span<const Block> blocks) {
+		ZN_PROFILE_SCOPE();
+		ZN_ASSERT_RETURN_V(_file.is_valid(), false);
+
+		const unsigned int chunk_count = (blocks.size() + CHUNK_BLOCK_COUNT - 1) / CHUNK_BLOCK_COUNT;
+		const unsigned int first_chunk_index = _chunks.size();
+		_chunks.resize(first_chunk_index + chunk_count);
+
+		struct Context {
+			Span<const Block> blocks;
+			StdVector<StdVector<uint8_t>> chunk_data;
+			Span<ChunkInfo> chunks;
+			StdVector<uint8_t> chunk_success;
+			FileAccess *file;
+			bool success = true;
+
+			static void encode(void *context, unsigned int chunk_index) {
+				Context &ctx = *static_cast<Context *>(context);
+				const unsigned int begin = chunk_index * CHUNK_BLOCK_COUNT;
+				const unsigned int count =
+						math::min(CHUNK_BLOCK_COUNT, static_cast<unsigned int>(ctx.blocks.size()) - begin);
+				ctx.chunk_success[chunk_index] = encode_chunk(
+						ctx.blocks.sub(begin, count), ctx.chunk_data[chunk_index], ctx.chunks[chunk_index]
+				);
+			}
+
+			static void write(void *context, unsigned int chunk_index) {
+				Context &ctx = *static_cast<Context *>(context);
+				StdVector<uint8_t> &data = ctx.chunk_data[chunk_index];
+				if (ctx.chunk_success[chunk_index] == 0) {
+					ctx.success = false;
+				} else if (ctx.success) {
+					ctx.chunks[chunk_index].offset = ctx.file->get_position();
+					zylann::godot::store_buffer(*ctx.file, to_span(data));
+				}
+				// Free memory as we go
+				data = StdVector<uint8_t>();
+			}
+		};
+
+		Context ctx;
+		ctx.blocks = blocks;
+		ctx.chunk_data.resize(chunk_count);
+		ctx.chunks = to_span(_chunks).sub(first_chunk_index, chunk_count);
+		ctx.chunk_success.resize(chunk_count, 0);
+		ctx.file = _file.ptr();
+
+		OrderedJobs::run(chunk_count, &ctx, Context::encode, &ctx, Context::write);
+
+		ZN_ASSERT_RETURN_V_MSG(
+				ctx.success, false, format("Failed to encode voxel archive {}", GodotStringWrapper(_fpath))
+		);
+		return true;
+	}
+
+	// Writes the index, and moves the archive to its destination.
+	bool finish() {
+		ZN_PROFILE_SCOPE();
+		ZN_ASSERT_RETURN_V(_file.is_valid(), false);
+
+		const uint64_t index_offset = _file->get_position();
+
+		StdVector<uint8_t> index_data;
+		MemoryWriter iw(index_data, ENDIANNESS_LITTLE_ENDIAN);
+		iw.store_32(_chunks.size());
+		for (const ChunkInfo &chunk : _chunks) {
+			iw.store_64(chunk.offset);
+			iw.store_32(chunk.block_count);
+			for (const uint32_t column_size : chunk.column_sizes) {
+				iw.store_32(column_size);
+			}
+		}
+		iw.store_64(index_offset);
+		iw.store_buffer(Span<const uint8_t>(reinterpret_cast<const uint8_t *>(FORMAT_MAGIC), FORMAT_MAGIC_SIZE));
+		zylann::godot::store_buffer(**_file, to_span(index_data));
+
+		ZN_ASSERT_RETURN_V_MSG(
+				_file->get_error() == OK,
+				false,
+				format("Error while writing voxel archive {}: {}", GodotStringWrapper(_temp_fpath), _file->get_error())
+		);
+
+		// Close the file before moving it
+		_file.unref();
+
+		const Error rename_error = zylann::godot::rename_file(_temp_fpath, _fpath);
+		if (rename_error != OK) {
+			zylann::godot::remove_file(_temp_fpath);
+			ZN_PRINT_ERROR(format(
+					"Could not move {} to {}, error {}",
+					GodotStringWrapper(_temp_fpath),
+					GodotStringWrapper(_fpath),
+					rename_error
+			));
+			return false;
+		}
+
+		return true;
+	}
+
+private:
+	String _fpath;
+	String _temp_fpath;
+	Ref<FileAccess> _file;
+	StdVector<ChunkInfo> _chunks;
+};
+
+} // namespace
+
+bool save_blocks(const String &fpath, Span<Block> blocks, uint8_t block_size_po2) {
+	ZN_PROFILE_SCOPE();
+
+	{
+		ZN_PROFILE_SCOPE_NAMED("Sort");
+		std::sort(blocks.data(), blocks.data() + blocks.size(), BlockOrder());
+	}
+
+	ArchiveWriter writer;
+	ZN_ASSERT_RETURN_V(writer.open(fpath, block_size_po2), false);
+	ZN_ASSERT_RETURN_V(writer.write_blocks(blocks), false);
+	return writer.finish();
+}
+
+bool load_blocks(
+		const String &fpath,
+		void *callback_data,
+		bool (*process_blocks_func)(void *callback_data, Span<Block> blocks),
+		uint8_t &out_block_size_po2
+) {
+	ZN_PROFILE_SCOPE();
+
+	Error file_error;
+	Ref<FileAccess> f = zylann::godot::open_file(fpath, FileAccess::READ, file_error);
+	ZN_ASSERT_RETURN_V_MSG(
+			f.is_valid(), false, format("Could not open file {}, error {}", GodotStringWrapper(fpath), file_error)
+	);
+
+	ZN_ASSERT_RETURN_V(read_header(**f, out_block_size_po2), false);
+
+	StdVector<ChunkInfo> chunks;
+	ZN_ASSERT_RETURN_V_MSG(
+			read_index(**f, chunks), false, format("Invalid voxel archive index in {}", GodotStringWrapper(fpath))
+	);
+
+	struct Context {
+		Span<const ChunkInfo> chunks;
+		// Compressed data of the chunks in the current batch, as read from the file
+		StdVector<uint8_t> data;
+		uint64_t data_offset = 0;
+		StdVector<StdVector<Block>> blocks;
+		StdVector<uint8_t> chunk_success;
+		void *callback_data;
+		bool (*process_blocks_func)(void *callback_data, Span<Block> blocks);
+		bool success = true;
+
+		static void decode(void *context, unsigned int batch_chunk_index) {
+			Context &ctx = *static_cast<Context *>(context);
+			const ChunkInfo &chunk = ctx.chunks[batch_chunk_index];
+			const Span<const uint8_t> src =
+					to_span_const(ctx.data).sub(chunk.offset - ctx.data_offset, chunk.get_size());
+			ctx.chunk_success[batch_chunk_index] = decode_chunk(src, chunk, ctx.blocks[batch_chunk_index]);
+		}
+
+		static void process(void *context, unsigned int batch_chunk_index) {
+			Context &ctx = *static_cast<Context *>(context);
+			StdVector<Block> &blocks = ctx.blocks[batch_chunk_index];
+			if (ctx.chunk_success[batch_chunk_index] == 0) {
+				ctx.success = false;
+			} else if (ctx.success) {
+				ctx.success = ctx.process_blocks_func(ctx.callback_data, to_span(blocks));
+			}
+			blocks.clear();
+		}
+	};
+
+	Context ctx;
+	ctx.callback_data = callback_data;
+	ctx.process_blocks_func = process_blocks_func;
+
+	// Chunks are read in batches so memory usage remains bounded with large archives. The calling thread reads the
+	// next batch from the file while no decoding is running, so I/O remains sequential.
+	const unsigned int batch_size = get_batch_chunk_count();
+
+	for (unsigned int batch_begin = 0; batch_begin < chunks.size() && ctx.success; batch_begin += batch_size) {
+		const unsigned int batch_count = math::min(batch_size, static_cast<unsigned int>(chunks.size()) - batch_begin);
+		ctx.chunks = to_span_const(chunks).sub(batch_begin, batch_count);
+
+		const ChunkInfo &last_chunk = ctx.chunks[batch_count - 1];
+		ctx.data_offset = ctx.chunks[0].offset;
+		ctx.data.resize(last_chunk.offset + last_chunk.get_size() - ctx.data_offset);
+		{
+			ZN_PROFILE_SCOPE_NAMED("Read");
+			f->seek(ctx.data_offset);
+			ZN_ASSERT_RETURN_V(zylann::godot::get_buffer(**f, to_span(ctx.data)) == ctx.data.size(), false);
+		}
+
+		ctx.blocks.resize(batch_count);
+		ctx.chunk_success.clear();
+		ctx.chunk_success.resize(batch_count, 0);
+
+		OrderedJobs::run(batch_count, &ctx, Context::decode, &ctx, Context::process);
+	}
+
+	ZN_ASSERT_RETURN_V_MSG(ctx.success, false, format("Failed to load voxel archive {}", GodotStringWrapper(fpath)));
+	return true;
+}
+
+bool export_stream(VoxelStream &stream, const String &fpath) {
+	ZN_PROFILE_SCOPE();
+	ZN_ASSERT_RETURN_V_MSG(
+			stream.supports_loading_all_blocks(), false, "The stream does not support loading all blocks"
+	);
+
+	// Blocks only present in the stream's cache must be listed too
+	stream.flush();
+
+	StdVector<VoxelStream::BlockKey> keys;
+	stream.load_all_block_keys(keys);
+	{
+		ZN_PROFILE_SCOPE_NAMED("Sort");
+		std::sort(keys.begin(), keys.end(), BlockOrder());
+	}
+
+	ArchiveWriter writer;
+	ZN_ASSERT_RETURN_V(writer.open(fpath, stream.get_block_size_po2()), false);
+
+	// Blocks are loaded a few chunks at a time rather than all at once, so memory usage remains bounded
+	const unsigned int batch_size = CHUNK_BLOCK_COUNT * get_batch_chunk_count();
+
+	StdVector<Block> blocks;
+	StdVector<VoxelStream::VoxelQueryData> voxel_queries;
+#ifdef VOXEL_ENABLE_INSTANCER
+	StdVector<VoxelStream::InstancesQueryData> instance_queries;
+#endif
+
+	for (unsigned int batch_begin = 0; batch_begin < keys.size(); batch_begin += batch_size) {
+		const unsigned int batch_count = math::min(batch_size, static_cast<unsigned int>(keys.size()) - batch_begin);
+
+		blocks.clear();
+		blocks.resize(batch_count);
+		voxel_queries.clear();
+		for (unsigned int i = 0; i < batch_count; ++i) {
+			const VoxelStream::BlockKey &key = keys[batch_begin + i];
+			Block &block = blocks[i];
+			block.position = key.position;
+			block.lod = key.lod;
+			block.voxels = make_shared_instance<VoxelBuffer>(VoxelBuffer::ALLOCATOR_POOL);
+			voxel_queries.push_back(VoxelStream::VoxelQueryData{
+					*block.voxels, //
+					key.position,
+					key.lod,
+					VoxelStream::RESULT_ERROR //
+			});
+		}
+		{
+			ZN_PROFILE_SCOPE_NAMED("Load voxels");
+			stream.load_voxel_blocks(to_span(voxel_queries));
+		}
+		for (unsigned int i = 0; i < batch_count; ++i) {
+			const VoxelStream::ResultCode result = voxel_queries[i].result;
+			ZN_ASSERT_RETURN_V_MSG(
+					result != VoxelStream::RESULT_ERROR,
+					false,
+					format("Failed to load block {} lod {}", blocks[i].position, blocks[i].lod)
+			);
+			if (result == VoxelStream::RESULT_BLOCK_NOT_FOUND) {
+				// The block only has instances
+				blocks[i].voxels.reset();
+			}
+		}
+
+#ifdef VOXEL_ENABLE_INSTANCER
+		if (stream.supports_instance_blocks()) {
+			instance_queries.clear();
+			for (const Block &block : blocks) {
+				instance_queries.push_back(VoxelStream::InstancesQueryData{
+						nullptr, //
+						block.position,
+						static_cast<uint8_t>(block.lod),
+						VoxelStream::RESULT_ERROR //
+				});
+			}
+			{
+				ZN_PROFILE_SCOPE_NAMED("Load instances");
+				stream.load_instance_blocks(to_span(instance_queries));
+			}
+			for (unsigned int i = 0; i < batch_count; ++i) {
+				blocks[i].instances_data = std::move(instance_queries[i].data);
+			}
+		}
+#endif
+
+		ZN_ASSERT_RETURN_V(writer.write_blocks(to_span_const(blocks)), false);
+	}
+
+	return writer.finish();
+}
+
+bool import_stream(const String &fpath, VoxelStream &stream) {
+	ZN_PROFILE_SCOPE();
+
+	struct Context {
+		VoxelStream &stream;
+		const uint8_t &block_size_po2;
+		StdVector<VoxelStream::VoxelQueryData> voxel_queries;
+#ifdef VOXEL_ENABLE_INSTANCER
+		StdVector<VoxelStream::InstancesQueryData> instance_queries;
+#endif
+
+		static bool save(void *callback_data, Span<Block> blocks) {
+			Context &ctx = *static_cast<Context *>(callback_data);
+
+			ZN_ASSERT_RETURN_V_MSG(
+					ctx.block_size_po2 == ctx.stream.get_block_size_po2(),
+					false,
+					format("Block size of the archive ({}) doesn't match the stream ({})",
+						   1 << ctx.block_size_po2,
+						   1 << ctx.stream.get_block_size_po2())
+			);
+
+			ctx.voxel_queries.clear();
+#ifdef VOXEL_ENABLE_INSTANCER
+			ctx.instance_queries.clear();
+#endif
+
+			for (Block &block : blocks) {
+				if (block.voxels != nullptr) {
+					ctx.voxel_queries.push_back(VoxelStream::VoxelQueryData{
+							*block.voxels, //
+							block.position,
+							static_cast<uint8_t>(block.lod),
+							VoxelStream::RESULT_ERROR //
+					});
+				}
+#ifdef VOXEL_ENABLE_INSTANCER
+				if (block.instances_data != nullptr) {
+					ctx.instance_queries.push_back(VoxelStream::InstancesQueryData{
+							std::move(block.instances_data), //
+							block.position,
+							static_cast<uint8_t>(block.lod),
+							VoxelStream::RESULT_ERROR //
+					});
+				}
+#endif
+			}
+
+			if (ctx.voxel_queries.size() > 0) {
+				ctx.stream.save_voxel_blocks(to_span(ctx.voxel_queries));
+			}
+#ifdef VOXEL_ENABLE_INSTANCER
+			if (ctx.instance_queries.size() > 0) {
+				ZN_ASSERT_RETURN_V_MSG(
+						ctx.stream.supports_instance_blocks(), false, "The stream does not support instance blocks"
+				);
+				ctx.stream.save_instance_blocks(to_span(ctx.instance_queries));
+			}
+#endif
+			return true;
+		}
+	};
+
+	uint8_t block_size_po2 = 0;
+	Context ctx{ stream, block_size_po2 };
+	const bool success = load_blocks(fpath, &ctx, Context::save, block_size_po2);
+
+	stream.flush();
+	return success;
+}
+
+} // namespace zylann::voxel::VoxelArchive
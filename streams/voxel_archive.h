@@ -0,0 +1,59 @@
+#ifndef VOXEL_ARCHIVE_H
+#define VOXEL_ARCHIVE_H
+
+#include "../util/containers/span.h"
+#include "../util/godot/core/string.h"
+#include "voxel_stream.h"
+
+#include <cstdint>
+
+namespace zylann::voxel {
+
+// Single-file archive of all the blocks of a volume, intended for backups and transfers of whole saves.
+//
+// Blocks are written sequentially, sorted by LOD and then in Morton order, so spatially close blocks end up close in
+// the file. They are grouped in chunks, and each chunk is stored as columns: one with the location and format of each
+// block, one per voxel channel with the data of all its blocks concatenated, one for metadata and one for instances.
+// Columns are compressed separately, since data of the same channel compresses much better together. Chunks are
+// compressed and decompressed in parallel on the engine's thread pool, while the calling thread does file I/O.
+// An index of chunks is written at the end of the file.
+//
+// Layout:
+// - Header: magic, version, block size as a power of two
+// - Chunks, each being a sequence of compressed columns
+// - Index: for each chunk, its offset, block count and the size of each of its columns
+// - Trailer: offset of the index, magic
+//
+// Numbers are little-endian.
+namespace VoxelArchive {
+
+static const uint8_t FORMAT_VERSION = 0;
+// How many blocks are grouped into each chunk. Chunks are the unit of parallel work.
+static const unsigned int CHUNK_BLOCK_COUNT = 64;
+
+// Writes blocks to a new archive at the given path. Blocks get sorted in place. The archive is written to a temporary
+// file first, which replaces the one at `fpath` only if writing succeeded.
+bool save_blocks(const String &fpath, Span<VoxelStream::FullLoadingResult::Block> blocks, uint8_t block_size_po2);
+
+// Reads all blocks from an archive. Blocks are decoded one batch at a time, which is passed to
+// `process_blocks_func` on the calling thread in the order they were saved. Blocks may be moved out of the batch.
+// Loading stops with failure if `process_blocks_func` returns false.
+// `out_block_size_po2` is set before the first call to `process_blocks_func`.
+bool load_blocks(
+		const String &fpath,
+		void *callback_data,
+		bool (*process_blocks_func)(void *callback_data, Span<VoxelStream::FullLoadingResult::Block> blocks),
+		uint8_t &out_block_size_po2
+);
+
+// Writes all blocks of a stream to a new archive. The stream must support loading all blocks. Blocks are loaded from the
+// stream one batch at a time, so the whole volume doesn't have to fit in memory.
+bool export_stream(VoxelStream &stream, const String &fpath);
+
+// Saves all blocks of an archive into a stream. The archive must have the same block size as the stream.
+bool import_stream(const String &fpath, VoxelStream &stream);
+
+} // namespace VoxelArchive
+} // namespace zylann::voxel
+
+#endif // VOXEL_ARCHIVE_H
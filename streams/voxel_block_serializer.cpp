@@ -25,11 +25,6 @@ const unsigned int BLOCK_METADATA_HEADER_SIZE = sizeof(uint32_t);
 
 // Temporary data buffers, re-used to reduce allocations
 
-StdVector<uint8_t> &get_tls_metadata_tmp() {
-	thread_local StdVector<uint8_t> tls_metadata_tmp;
-	return tls_metadata_tmp;
-}
-
 StdVector<uint8_t> &get_tls_data() {
 	thread_local StdVector<uint8_t> tls_data;
 	return tls_data;
@@ -286,38 +281,29 @@ size_t get_size_in_bytes(const VoxelBuffer &buffer, size_t &metadata_size) {
 	return size + metadata_size_with_header + BLOCK_TRAILING_MAGIC_SIZE;
 }
 
-SerializeResult serialize(const VoxelBuffer &voxel_buffer) {
-	ZN_PROFILE_SCOPE();
+size_t get_serialized_size(const VoxelBuffer &voxel_buffer) {
+	size_t metadata_size = 0;
+	return get_size_in_bytes(voxel_buffer, metadata_size);
+}
 
-	StdVector<uint8_t> &dst_data = get_tls_data();
-	StdVector<uint8_t> &metadata_tmp = get_tls_metadata_tmp();
-	dst_data.clear();
-	metadata_tmp.clear();
+namespace {
 
+// Writes into memory that must have exactly the size returned by `get_size_in_bytes`
+bool serialize_into(const VoxelBuffer &voxel_buffer, Span<uint8_t> dst, size_t expected_metadata_size) {
 	// Cannot serialize an empty block
-	ERR_FAIL_COND_V(Vector3iUtil::get_volume_u64(voxel_buffer.get_size()) == 0, SerializeResult(dst_data, false));
+	ERR_FAIL_COND_V(Vector3iUtil::get_volume_u64(voxel_buffer.get_size()) == 0, false);
 
-	size_t expected_metadata_size = 0;
-	const size_t expected_data_size = get_size_in_bytes(voxel_buffer, expected_metadata_size);
-	dst_data.reserve(expected_data_size);
+	ERR_FAIL_COND_V(voxel_buffer.get_size().x > std::numeric_limits<uint16_t>().max(), false);
+	ERR_FAIL_COND_V(voxel_buffer.get_size().y > std::numeric_limits<uint16_t>().max(), false);
+	ERR_FAIL_COND_V(voxel_buffer.get_size().z > std::numeric_limits<uint16_t>().max(), false);
 
-	MemoryWriter f(dst_data, ENDIANNESS_LITTLE_ENDIAN);
+	ByteSpanWithPosition bs(dst, 0);
+	MemoryWriterExistingBuffer f(bs, ENDIANNESS_LITTLE_ENDIAN);
 
 	f.store_8(BLOCK_FORMAT_VERSION);
 
-	ERR_FAIL_COND_V(
-			voxel_buffer.get_size().x > std::numeric_limits<uint16_t>().max(), SerializeResult(dst_data, false)
-	);
 	f.store_16(voxel_buffer.get_size().x);
-
-	ERR_FAIL_COND_V(
-			voxel_buffer.get_size().y > std::numeric_limits<uint16_t>().max(), SerializeResult(dst_data, false)
-	);
 	f.store_16(voxel_buffer.get_size().y);
-
-	ERR_FAIL_COND_V(
-			voxel_buffer.get_size().z > std::numeric_limits<uint16_t>().max(), SerializeResult(dst_data, false)
-	);
 	f.store_16(voxel_buffer.get_size().z);
 
 	for (unsigned int channel_index = 0; channel_index < VoxelBuffer::MAX_CHANNELS; ++channel_index) {
@@ -331,10 +317,7 @@ SerializeResult serialize(const VoxelBuffer &voxel_buffer) {
 		switch (compression) {
 			case VoxelBuffer::COMPRESSION_NONE: {
 				Span<const uint8_t> data;
-				ERR_FAIL_COND_V(
-						!voxel_buffer.get_channel_as_bytes_read_only(channel_index, data),
-						SerializeResult(dst_data, false)
-				);
+				ERR_FAIL_COND_V(!voxel_buffer.get_channel_as_bytes_read_only(channel_index, data), false);
 				f.store_buffer(data);
 			} break;
 
@@ -367,18 +350,51 @@ SerializeResult serialize(const VoxelBuffer &voxel_buffer) {
 	// we just discard all metadata as if it was empty.
 	if (expected_metadata_size > 0) {
 		f.store_32(expected_metadata_size);
-		metadata_tmp.resize(expected_metadata_size);
-		// This function brings me joy. </irony>
-		serialize_metadata(to_span(metadata_tmp), voxel_buffer);
-		f.store_buffer(to_span(metadata_tmp));
+		// Written in place
+		serialize_metadata(dst.sub(bs.pos, expected_metadata_size), voxel_buffer);
+		bs.pos += expected_metadata_size;
 	}
 
 	f.store_32(BLOCK_TRAILING_MAGIC);
 
 	// Check out of bounds writing
-	CRASH_COND(dst_data.size() != expected_data_size);
+	CRASH_COND(bs.pos != dst.size());
+
+	return true;
+}
+
+} // namespace
+
+bool serialize(const VoxelBuffer &voxel_buffer, Span<uint8_t> dst) {
+	ZN_PROFILE_SCOPE();
+	size_t expected_metadata_size = 0;
+	const size_t expected_data_size = get_size_in_bytes(voxel_buffer, expected_metadata_size);
+	ZN_ASSERT_RETURN_V_MSG(
+			dst.size() == expected_data_size,
+			false,
+			format("Destination size {} doesn't match serialized size {}", dst.size(), expected_data_size)
+	);
+	return serialize_into(voxel_buffer, dst, expected_metadata_size);
+}
 
-	return SerializeResult(dst_data, true);
+bool serialize_append(const VoxelBuffer &voxel_buffer, StdVector<uint8_t> &dst) {
+	ZN_PROFILE_SCOPE();
+	size_t expected_metadata_size = 0;
+	const size_t expected_data_size = get_size_in_bytes(voxel_buffer, expected_metadata_size);
+	const size_t prev_size = dst.size();
+	dst.resize(prev_size + expected_data_size);
+	if (!serialize_into(voxel_buffer, to_span(dst).sub(prev_size), expected_metadata_size)) {
+		dst.resize(prev_size);
+		return false;
+	}
+	return true;
+}
+
+SerializeResult serialize(const VoxelBuffer &voxel_buffer) {
+	StdVector<uint8_t> &dst_data = get_tls_data();
+	dst_data.clear();
+	const bool success = serialize_append(voxel_buffer, dst_data);
+	return SerializeResult(dst_data, success);
 }
 
 namespace legacy {
@@ -579,8 +595,6 @@ bool deserialize(Span<const uint8_t> p_data, VoxelBuffer &out_voxel_buffer) {
 	ZN_DSTACK();
 	ZN_PROFILE_SCOPE();
 
-	StdVector<uint8_t> &metadata_tmp = get_tls_metadata_tmp();
-
 	ERR_FAIL_COND_V(p_data.size() < sizeof(uint32_t), false);
 	const uint32_t magic = *reinterpret_cast<const uint32_t *>(&p_data[p_data.size() - sizeof(uint32_t)]);
 #if DEV_ENABLED
@@ -614,8 +628,17 @@ bool deserialize(Span<const uint8_t> p_data, VoxelBuffer &out_voxel_buffer) {
 	const unsigned int size_x = f.get_16();
 	const unsigned int size_y = f.get_16();
 	const unsigned int size_z = f.get_16();
-
-	out_voxel_buffer.create(Vector3i(size_x, size_y, size_z));
+	const Vector3i size(size_x, size_y, size_z);
+
+	// If the destination already has the right size, channels that are allocated with the same depth are overwritten
+	// in place, instead of being freed and allocated again. Every channel gets written below, so no reset is needed.
+	const bool reuse_channels = out_voxel_buffer.get_size() == size;
+	if (reuse_channels) {
+		out_voxel_buffer.clear_voxel_metadata();
+		out_voxel_buffer.get_block_metadata().clear();
+	} else {
+		out_voxel_buffer.create(size);
+	}
 
 	for (unsigned int channel_index = 0; channel_index < VoxelBuffer::MAX_CHANNELS; ++channel_index) {
 		const uint8_t fmt = f.get_8();
@@ -634,20 +657,22 @@ bool deserialize(Span<const uint8_t> p_data, VoxelBuffer &out_voxel_buffer) {
 		VoxelBuffer::Compression compression = (VoxelBuffer::Compression)compression_value;
 		VoxelBuffer::Depth depth = (VoxelBuffer::Depth)depth_value;
 
+		if (reuse_channels && out_voxel_buffer.get_channel_depth(channel_index) != depth) {
+			// Don't convert data we are going to overwrite anyways
+			out_voxel_buffer.clear_channel(channel_index, 0);
+		}
 		out_voxel_buffer.set_channel_depth(channel_index, depth);
 
 		switch (compression) {
 			case VoxelBuffer::COMPRESSION_NONE: {
-				out_voxel_buffer.decompress_channel(channel_index);
-
-				Span<uint8_t> buffer;
-				CRASH_COND(!out_voxel_buffer.get_channel_as_bytes(channel_index, buffer));
-
-				const size_t read_len = f.get_buffer(buffer);
-				if (read_len != buffer.size()) {
+				// Copied straight from the source, without initializing the channel first
+				const size_t channel_size = VoxelBuffer::get_size_in_bytes_for_volume(size, depth);
+				if (f.pos + channel_size > p_data.size()) {
 					ERR_PRINT("Unexpected end of file");
 					return false;
 				}
+				out_voxel_buffer.set_channel_from_bytes(channel_index, p_data.sub(f.pos, channel_size));
+				f.pos += channel_size;
 
 			} break;
 
@@ -684,9 +709,9 @@ bool deserialize(Span<const uint8_t> p_data, VoxelBuffer &out_voxel_buffer) {
 	if (p_data.size() - f.get_position() > BLOCK_TRAILING_MAGIC_SIZE) {
 		const size_t metadata_size = f.get_32();
 		ERR_FAIL_COND_V(f.get_position() + metadata_size > p_data.size(), false);
-		metadata_tmp.resize(metadata_size);
-		f.get_buffer(to_span(metadata_tmp));
-		deserialize_metadata(to_span(metadata_tmp), out_voxel_buffer);
+		// Parsed in place
+		deserialize_metadata(p_data.sub(f.pos, metadata_size), out_voxel_buffer);
+		f.pos += metadata_size;
 	}
 
 	// Failure at this indicates file corruption
@@ -697,20 +722,33 @@ bool deserialize(Span<const uint8_t> p_data, VoxelBuffer &out_voxel_buffer) {
 }
 
 SerializeResult serialize_and_compress(const VoxelBuffer &voxel_buffer) {
-	ZN_PROFILE_SCOPE();
-
 	StdVector<uint8_t> &compressed_data = get_tls_compressed_data();
+	compressed_data.clear();
+	const bool success = serialize_and_compress_append(voxel_buffer, compressed_data);
+	return SerializeResult(compressed_data, success);
+}
 
-	SerializeResult res = serialize(voxel_buffer);
-	ERR_FAIL_COND_V(!res.success, SerializeResult(compressed_data, false));
-	const StdVector<uint8_t> &data = res.data;
+bool serialize_and_compress_append(const VoxelBuffer &voxel_buffer, StdVector<uint8_t> &dst) {
+	ZN_PROFILE_SCOPE();
 
-	res.success = CompressedData::compress(
-			Span<const uint8_t>(data.data(), 0, data.size()), compressed_data, CompressedData::COMPRESSION_LZ4
-	);
-	ERR_FAIL_COND_V(!res.success, SerializeResult(compressed_data, false));
+	SerializeResult res = serialize(voxel_buffer);
+	ERR_FAIL_COND_V(!res.success, false);
+	const Span<const uint8_t> data = to_span(res.data);
+
+	// Compress directly at the end of the destination
+	const size_t prev_size = dst.size();
+	dst.resize(prev_size + CompressedData::get_max_compressed_size(data.size(), CompressedData::COMPRESSION_LZ4));
+	size_t compressed_size = 0;
+	if (!CompressedData::compress(
+				data, to_span(dst).sub(prev_size), CompressedData::COMPRESSION_LZ4, compressed_size
+		)) {
+		dst.resize(prev_size);
+		ERR_PRINT("Failed to compress block");
+		return false;
+	}
+	dst.resize(prev_size + compressed_size);
 
-	return SerializeResult(compressed_data, true);
+	return true;
 }
 
 bool decompress_and_deserialize(Span<const uint8_t> p_data, VoxelBuffer &out_voxel_buffer) {
@@ -34,10 +34,27 @@ struct SerializeResult {
 SerializeResult serialize(const VoxelBuffer &voxel_buffer);
 bool deserialize(Span<const uint8_t> p_data, VoxelBuffer &out_voxel_buffer);
 
+// Gets how many bytes `serialize` will produce for the given buffer
+size_t get_serialized_size(const VoxelBuffer &voxel_buffer);
+// Serializes directly into memory owned by the caller, which must have the size given by `get_serialized_size`.
+bool serialize(const VoxelBuffer &voxel_buffer, Span<uint8_t> dst);
+// Serializes at the end of the given vector, growing it as needed.
+bool serialize_append(const VoxelBuffer &voxel_buffer, StdVector<uint8_t> &dst);
+
 SerializeResult serialize_and_compress(const VoxelBuffer &voxel_buffer);
+// Serializes and compresses at the end of the given vector, growing it as needed. Useful to batch multiple blocks
+// into one buffer without an extra copy.
+bool serialize_and_compress_append(const VoxelBuffer &voxel_buffer, StdVector<uint8_t> &dst);
 bool decompress_and_deserialize(Span<const uint8_t> p_data, VoxelBuffer &out_voxel_buffer);
 bool decompress_and_deserialize(FileAccess &f, unsigned int size_to_read, VoxelBuffer &out_voxel_buffer);
 
+// Metadata of a buffer in the same format as in serialized blocks, for formats storing it separately.
+// Returns 0 if the buffer has no metadata, in which case nothing has to be stored.
+size_t get_metadata_size_in_bytes(const VoxelBuffer &buffer);
+// Writes into memory that must have exactly the size returned by `get_metadata_size_in_bytes`
+void serialize_metadata(Span<uint8_t> p_dst, const VoxelBuffer &buffer);
+bool deserialize_metadata(Span<const uint8_t> p_src, VoxelBuffer &buffer);
+
 // Temporary thread-local buffers for internal use
 StdVector<uint8_t> &get_tls_data();
 StdVector<uint8_t> &get_tls_compressed_data();
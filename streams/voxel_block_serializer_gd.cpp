@@ -1,6 +1,7 @@
 #include "voxel_block_serializer_gd.h"
 #include "../util/godot/classes/stream_peer.h"
 #include "../util/godot/core/packed_arrays.h"
+#include "compressed_data.h"
 #include "voxel_block_serializer.h"
 
 using namespace zylann::godot;
@@ -56,16 +57,30 @@ void VoxelBlockSerializer::deserialize_from_stream_peer(
 PackedByteArray VoxelBlockSerializer::serialize_to_byte_array(Ref<VoxelBuffer> voxel_buffer, bool compress) {
 	ERR_FAIL_COND_V(voxel_buffer.is_null(), PackedByteArray());
 
+	// Data is written directly into the returned array
 	PackedByteArray bytes;
 	if (compress) {
-		BlockSerializer::SerializeResult res = BlockSerializer::serialize_and_compress(voxel_buffer->get_buffer());
+		BlockSerializer::SerializeResult res = BlockSerializer::serialize(voxel_buffer->get_buffer());
 		ERR_FAIL_COND_V(!res.success, PackedByteArray());
-		copy_to(bytes, to_span(res.data));
+		bytes.resize(CompressedData::get_max_compressed_size(res.data.size(), CompressedData::COMPRESSION_LZ4));
+		size_t compressed_size = 0;
+		ERR_FAIL_COND_V(
+				!CompressedData::compress(
+						to_span(res.data),
+						Span<uint8_t>(bytes.ptrw(), bytes.size()),
+						CompressedData::COMPRESSION_LZ4,
+						compressed_size
+				),
+				PackedByteArray()
+		);
+		bytes.resize(compressed_size);
 
 	} else {
-		BlockSerializer::SerializeResult res = BlockSerializer::serialize(voxel_buffer->get_buffer());
-		ERR_FAIL_COND_V(!res.success, PackedByteArray());
-		copy_to(bytes, to_span(res.data));
+		const VoxelBuffer &buffer = voxel_buffer->get_buffer();
+		bytes.resize(BlockSerializer::get_serialized_size(buffer));
+		ERR_FAIL_COND_V(
+				!BlockSerializer::serialize(buffer, Span<uint8_t>(bytes.ptrw(), bytes.size())), PackedByteArray()
+		);
 	}
 	return bytes;
 }
@@ -2,6 +2,7 @@
 #include "../storage/voxel_buffer_gd.h"
 #include "../util/godot/core/string.h"
 #include "../util/string/format.h"
+#include "voxel_archive.h"
 
 namespace zylann::voxel {
 
@@ -55,6 +56,14 @@ void VoxelStream::load_all_blocks(FullLoadingResult &result) {
 	ZN_PRINT_ERROR(format("{} does not support `load_all_blocks`", get_class()));
 }
 
+void VoxelStream::load_all_block_keys(StdVector<BlockKey> &out_keys) {
+	FullLoadingResult result;
+	load_all_blocks(result);
+	for (const FullLoadingResult::Block &block : result.blocks) {
+		out_keys.push_back(BlockKey{ block.position, static_cast<uint8_t>(block.lod) });
+	}
+}
+
 int VoxelStream::get_used_channels_mask() const {
 	return 0;
 }
@@ -119,6 +128,14 @@ Vector3 VoxelStream::_b_get_block_size() const {
 	return Vector3iUtil::create(1 << get_block_size_po2());
 }
 
+bool VoxelStream::_b_export_to_archive(String fpath) {
+	return VoxelArchive::export_stream(*this, fpath);
+}
+
+bool VoxelStream::_b_import_from_archive(String fpath) {
+	return VoxelArchive::import_stream(fpath, *this);
+}
+
 void VoxelStream::_bind_methods() {
 	ClassDB::bind_method(
 			D_METHOD("load_voxel_block", "out_buffer", "block_position", "lod_index"), &VoxelStream::_b_load_voxel_block
@@ -135,6 +152,9 @@ void VoxelStream::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("flush"), &VoxelStream::flush);
 
+	ClassDB::bind_method(D_METHOD("export_to_archive", "path"), &VoxelStream::_b_export_to_archive);
+	ClassDB::bind_method(D_METHOD("import_from_archive", "path"), &VoxelStream::_b_import_from_archive);
+
 	ADD_PROPERTY(
 			PropertyInfo(Variant::BOOL, "save_generator_output"),
 			"set_save_generator_output",
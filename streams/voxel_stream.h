@@ -85,6 +85,15 @@ public:
 	// This function is recommended if you save to files, because you can batch their access.
 	virtual void save_voxel_blocks(Span<VoxelQueryData> p_blocks);
 
+	// Tells if the stream can read blocks ahead of time, before they are actually requested.
+	virtual bool supports_prefetch() const {
+		return false;
+	}
+
+	// Hints that the given blocks are likely to be requested soon, so the stream may read them into a bounded cache.
+	// This is speculative: it doesn't return anything, and the blocks may never actually be requested.
+	virtual void prefetch_voxel_blocks(Span<const Vector3i> block_positions, uint8_t lod_index) {}
+
 #ifdef VOXEL_ENABLE_INSTANCER
 	// TODO Merge support functions into a single getter with Feature bitmask
 	virtual bool supports_instance_blocks() const;
@@ -112,6 +121,15 @@ public:
 
 	virtual void load_all_blocks(FullLoadingResult &result);
 
+	struct BlockKey {
+		Vector3i position;
+		uint8_t lod;
+	};
+
+	// Gets the location of every block the stream contains, without loading their data. Only available if
+	// `supports_loading_all_blocks` returns true. The default implementation uses `load_all_blocks`.
+	virtual void load_all_block_keys(StdVector<BlockKey> &out_keys);
+
 	// Tells which channels can be found in this stream.
 	// The simplest implementation is to return them all.
 	// One reason to specify which channels are available is to help the editor detect configuration issues,
@@ -149,6 +167,8 @@ private:
 	void _b_save_voxel_block(Ref<godot::VoxelBuffer> buffer, Vector3i block_position, int lod_index);
 	int _b_get_used_channels_mask() const;
 	Vector3 _b_get_block_size() const;
+	bool _b_export_to_archive(String fpath);
+	bool _b_import_from_archive(String fpath);
 
 	struct Parameters {
 		bool save_generator_output = false;
@@ -3,30 +3,44 @@
 namespace zylann::voxel {
 
 bool VoxelStreamCache::load_voxel_block(Vector3i position, uint8_t lod_index, VoxelBuffer &out_voxels) {
-	const Lod &lod = _cache[lod_index];
+	Lod &lod = _cache[lod_index];
 
-	RWLockRead rlock(lod.rw_lock);
+	{
+		RWLockRead rlock(lod.rw_lock);
 
-	auto it = lod.blocks.find(position);
+		auto it = lod.blocks.find(position);
 
-	if (it == lod.blocks.end()) {
-		// Not in cache, will have to query
-		return false;
+		if (it != lod.blocks.end()) {
+			const Block &block = it->second;
+			if (block.has_voxels) {
+				// In cache, serve it
 
-	} else {
-		const Block &block = it->second;
-		if (!block.has_voxels) {
+				// Copying is required since the cache has ownership on its data,
+				// and the requests wants us to populate the buffer it provides
+				block.voxels.copy_to(out_voxels, true);
+
+				return true;
+			}
 			// Has a block in cache but there is no voxel data
+		}
+
+		if (lod.prefetched_blocks.find(position) == lod.prefetched_blocks.end()) {
+			// Not in cache, will have to query
 			return false;
 		}
-		// In cache, serve it
+	}
 
-		// Copying is required since the cache has ownership on its data,
-		// and the requests wants us to populate the buffer it provides
-		block.voxels.copy_to(out_voxels, true);
+	// The block was prefetched. It is now actually requested, so we can give it away instead of copying it.
+	RWLockWrite wlock(lod.rw_lock);
 
-		return true;
+	auto it = lod.prefetched_blocks.find(position);
+	if (it == lod.prefetched_blocks.end()) {
+		// Another thread took it in the meantime
+		return false;
 	}
+	it->second.voxels.move_to(out_voxels);
+	lod.prefetched_blocks.erase(it);
+	return true;
 }
 
 void VoxelStreamCache::save_voxel_block(Vector3i position, uint8_t lod_index, VoxelBuffer &voxels) {
@@ -38,6 +52,10 @@ void VoxelStreamCache::save_voxel_block(Vector3i position, uint8_t lod_index, Vo
 			!Vector3iUtil::is_empty_size(voxels.get_size()), "Saving voxel buffer with empty size is not expected. Bug?"
 	);
 
+	// Prefetched data is now older than what we are saving
+	lod.prefetched_blocks.erase(position);
+	++lod.save_generation;
+
 	if (it == lod.blocks.end()) {
 		// Not cached yet, create an entry
 		Block b;
@@ -119,4 +137,98 @@ unsigned int VoxelStreamCache::get_indicative_block_count() const {
 	return _count;
 }
 
+void VoxelStreamCache::set_prefetch_capacity(unsigned int capacity) {
+	_prefetch_capacity = capacity;
+
+	if (capacity == 0) {
+		for (unsigned int lod_index = 0; lod_index < _cache.size(); ++lod_index) {
+			Lod &lod = _cache[lod_index];
+			RWLockWrite wlock(lod.rw_lock);
+			lod.prefetched_blocks.clear();
+			lod.prefetch_order = StdQueue<PrefetchOrderItem>();
+		}
+	}
+}
+
+unsigned int VoxelStreamCache::get_prefetch_capacity() const {
+	return _prefetch_capacity;
+}
+
+bool VoxelStreamCache::has_voxel_block(Vector3i position, uint8_t lod_index) const {
+	const Lod &lod = _cache[lod_index];
+	RWLockRead rlock(lod.rw_lock);
+
+	auto it = lod.blocks.find(position);
+	if (it != lod.blocks.end() && it->second.has_voxels) {
+		return true;
+	}
+	return lod.prefetched_blocks.find(position) != lod.prefetched_blocks.end();
+}
+
+uint32_t VoxelStreamCache::get_prefetch_ticket(uint8_t lod_index) const {
+	const Lod &lod = _cache[lod_index];
+	RWLockRead rlock(lod.rw_lock);
+	return lod.save_generation;
+}
+
+void VoxelStreamCache::prefetch_voxel_block(
+		Vector3i position,
+		uint8_t lod_index,
+		VoxelBuffer &voxels,
+		uint32_t ticket
+) {
+	const unsigned int capacity = _prefetch_capacity;
+	if (capacity == 0) {
+		return;
+	}
+
+	Lod &lod = _cache[lod_index];
+	RWLockWrite wlock(lod.rw_lock);
+
+	if (lod.save_generation != ticket) {
+		// Blocks were saved while this one was being read, it might be outdated
+		return;
+	}
+	auto it = lod.blocks.find(position);
+	if (it != lod.blocks.end() && it->second.has_voxels) {
+		// Saved data takes precedence
+		return;
+	}
+	const uint32_t id = lod.next_prefetch_id++;
+	auto insert_result = lod.prefetched_blocks.insert(
+			std::make_pair(position, PrefetchedBlock{ VoxelBuffer(VoxelBuffer::ALLOCATOR_POOL), id })
+	);
+	if (!insert_result.second) {
+		// Already prefetched
+		return;
+	}
+	voxels.move_to(insert_result.first->second.voxels);
+	lod.prefetch_order.push(PrefetchOrderItem{ position, id });
+
+	// Drop oldest blocks. The queue may contain items that were already consumed or overwritten, so it is also bounded
+	// to not grow indefinitely.
+	while (lod.prefetched_blocks.size() > capacity || lod.prefetch_order.size() > 2 * capacity) {
+		const PrefetchOrderItem item = lod.prefetch_order.front();
+		lod.prefetch_order.pop();
+		auto prefetched_it = lod.prefetched_blocks.find(item.position);
+		// The position may have been prefetched again since, in which case that newer block must stay
+		if (prefetched_it != lod.prefetched_blocks.end() && prefetched_it->second.id == item.id) {
+			lod.prefetched_blocks.erase(prefetched_it);
+		}
+	}
+}
+
+void VoxelStreamCache::end_flush() {
+	for (unsigned int lod_index = 0; lod_index < _cache.size(); ++lod_index) {
+		Lod &lod = _cache[lod_index];
+		RWLockWrite wlock(lod.rw_lock);
+		// Prefetches that started before the commit may have read data older than what got flushed
+		for (const Vector3i &position : lod.flushed_positions) {
+			lod.prefetched_blocks.erase(position);
+		}
+		lod.flushed_positions.clear();
+		++lod.save_generation;
+	}
+}
+
 } // namespace zylann::voxel
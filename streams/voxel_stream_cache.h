@@ -2,7 +2,9 @@
 #define VOXEL_STREAM_CACHE_H
 
 #include "../storage/voxel_buffer.h"
+#include "../util/containers/std_queue.h"
 #include "../util/containers/std_unordered_map.h"
+#include "../util/containers/std_vector.h"
 #include "../util/memory/memory.h"
 #include "../util/thread/rw_lock.h"
 
@@ -34,7 +36,8 @@ public:
 		Block() : voxels(VoxelBuffer::ALLOCATOR_POOL) {}
 	};
 
-	// Copies cached block into provided buffer
+	// Copies cached block into provided buffer.
+	// If the block was prefetched, it is moved into the provided buffer and no longer cached.
 	bool load_voxel_block(Vector3i position, uint8_t lod_index, VoxelBuffer &out_voxels);
 
 	// Stores provided block into the cache. The cache will take ownership of the provided data.
@@ -50,6 +53,25 @@ public:
 
 	unsigned int get_indicative_block_count() const;
 
+	// Prefetched blocks are read ahead of time from storage, because they are likely to be requested soon.
+	// They are kept apart from saved blocks: they are never flushed, and the oldest ones get dropped when there are
+	// more than the capacity. Capacity is per LOD. 0 disables prefetching.
+	void set_prefetch_capacity(unsigned int capacity);
+	unsigned int get_prefetch_capacity() const;
+
+	// Tells if a block is either saved or prefetched in the cache, so there is no need to prefetch it.
+	bool has_voxel_block(Vector3i position, uint8_t lod_index) const;
+
+	// Must be obtained before reading a block from storage in order to prefetch it.
+	// If any block of the same LOD gets saved or committed in between, the prefetched block will be discarded, since it
+	// could be older than what got saved.
+	uint32_t get_prefetch_ticket(uint8_t lod_index) const;
+
+	// Stores a block that was read ahead of time. The cache will take ownership of the provided data.
+	void prefetch_voxel_block(Vector3i position, uint8_t lod_index, VoxelBuffer &voxels, uint32_t ticket);
+
+	// Passes all cached blocks to the provided function and removes them from the cache.
+	// `end_flush` must be called once the data is actually committed to storage.
 	template <typename F>
 	void flush(F save_func) {
 		_count = 0;
@@ -59,20 +81,47 @@ public:
 			for (auto it = lod.blocks.begin(); it != lod.blocks.end(); ++it) {
 				Block &block = it->second;
 				save_func(block);
+				if (block.has_voxels) {
+					lod.flushed_positions.push_back(block.position);
+				}
 			}
 			lod.blocks.clear();
 		}
 	}
 
+	// Until storage has committed flushed blocks, prefetching could still read their previous version from it. Such
+	// reads get invalidated here.
+	void end_flush();
+
 private:
+	struct PrefetchedBlock {
+		VoxelBuffer voxels;
+		// Identifies this particular prefetch, since the same position can be prefetched again after being consumed
+		uint32_t id;
+	};
+
+	struct PrefetchOrderItem {
+		Vector3i position;
+		uint32_t id;
+	};
+
 	struct Lod {
 		// Not using pointers for values, since unordered_map does not invalidate pointers to values
 		StdUnorderedMap<Vector3i, Block> blocks;
+		StdUnorderedMap<Vector3i, PrefetchedBlock> prefetched_blocks;
+		// Blocks in the order they were prefetched. May contain items that are no longer prefetched.
+		StdQueue<PrefetchOrderItem> prefetch_order;
+		uint32_t next_prefetch_id = 0;
+		// Incremented every time blocks are saved in this LOD, or committed to storage after a flush
+		uint32_t save_generation = 0;
+		// Positions of blocks with voxels that were flushed but not committed yet
+		StdVector<Vector3i> flushed_positions;
 		RWLock rw_lock;
 	};
 
 	FixedArray<Lod, constants::MAX_LOD> _cache;
 	unsigned int _count = 0;
+	unsigned int _prefetch_capacity = 0;
 };
 
 } // namespace zylann::voxel
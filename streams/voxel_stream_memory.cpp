@@ -137,6 +137,26 @@ void VoxelStreamMemory::load_all_blocks(FullLoadingResult &result) {
 	}
 }
 
+void VoxelStreamMemory::load_all_block_keys(StdVector<BlockKey> &out_keys) {
+	for (unsigned int lod_index = 0; lod_index < _lods.size(); ++lod_index) {
+		const Lod &lod = _lods[lod_index];
+		MutexLock mlock(lod.mutex);
+
+		for (auto it = lod.voxel_blocks.begin(); it != lod.voxel_blocks.end(); ++it) {
+			out_keys.push_back(BlockKey{ it->first, static_cast<uint8_t>(lod_index) });
+		}
+
+#ifdef VOXEL_ENABLE_INSTANCER
+		for (auto it = lod.instance_blocks.begin(); it != lod.instance_blocks.end(); ++it) {
+			// Blocks having both voxels and instances were already listed
+			if (lod.voxel_blocks.find(it->first) == lod.voxel_blocks.end()) {
+				out_keys.push_back(BlockKey{ it->first, static_cast<uint8_t>(lod_index) });
+			}
+		}
+#endif
+	}
+}
+
 int VoxelStreamMemory::get_used_channels_mask() const {
 	return VoxelBuffer::ALL_CHANNELS_MASK;
 }
@@ -32,6 +32,7 @@ public:
 
 	bool supports_loading_all_blocks() const override;
 	void load_all_blocks(FullLoadingResult &result) override;
+	void load_all_block_keys(StdVector<BlockKey> &out_keys) override;
 
 	int get_used_channels_mask() const override;
 
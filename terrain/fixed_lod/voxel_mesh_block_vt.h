@@ -31,6 +31,16 @@ public:
 	// collision, it may be a better idea to use `is_area_editable` and not use mesh blocks
 	bool is_loaded = false;
 
+	// Set once voxels of the block get edited, since it is then likely to be edited again. Meshers supporting it will
+	// only rebuild parts of the mesh touching edited voxels.
+	bool incremental_meshing = false;
+	// Voxels that changed since the last meshing task of this block was scheduled
+	Box3i dirty_box_in_voxels;
+	// Returned by the last meshing task, to be passed to the next one
+	std::shared_ptr<VoxelMesher::IncrementalCache> incremental_meshing_cache;
+	// Incremented each time a meshing task is scheduled, so caches returned by outdated tasks can be ignored
+	uint32_t meshing_version = 0;
+
 	VoxelMeshBlockVT(const Vector3i bpos, unsigned int size) : VoxelMeshBlock(bpos) {
 		_position_in_voxels = bpos * size;
 	}
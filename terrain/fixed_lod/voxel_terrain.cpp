@@ -662,6 +662,9 @@ void VoxelTerrain::stop_updater() {
 
 void VoxelTerrain::remesh_all_blocks() {
 	_mesh_map.for_each_block([this](VoxelMeshBlockVT &block) { //
+		// Results of previous meshing can't be re-used
+		block.incremental_meshing_cache.reset();
+		++block.meshing_version;
 		try_schedule_mesh_update(block);
 	});
 }
@@ -767,7 +770,7 @@ void VoxelTerrain::post_edit_voxel(Vector3i pos) {
 	post_edit_area(Box3i(pos, Vector3i(1, 1, 1)), true);
 }
 
-void VoxelTerrain::try_schedule_mesh_update_from_data(const Box3i &box_in_voxels) {
+void VoxelTerrain::try_schedule_mesh_update_from_data(const Box3i &box_in_voxels, bool edited) {
 	ZN_PROFILE_SCOPE();
 	if (_mesher.is_null()) {
 		// No mesher, can't do updates
@@ -775,11 +778,17 @@ void VoxelTerrain::try_schedule_mesh_update_from_data(const Box3i &box_in_voxels
 	}
 	// We pad by 1 because neighbor blocks might be affected visually (for example, baked ambient occlusion)
 	const Box3i mesh_box = box_in_voxels.padded(1).downscaled(get_mesh_block_size());
-	mesh_box.for_each_cell([this](Vector3i pos) {
+	mesh_box.for_each_cell([this, &box_in_voxels, edited](Vector3i pos) {
 		VoxelMeshBlockVT *block = _mesh_map.get_block(pos);
 		// There isn't necessarily a mesh block, if the edit happens in a boundary,
 		// or if it is done next to a viewer that doesn't need meshes
 		if (block != nullptr) {
+			if (block->dirty_box_in_voxels.is_empty()) {
+				block->dirty_box_in_voxels = box_in_voxels;
+			} else {
+				block->dirty_box_in_voxels.merge_with(box_in_voxels);
+			}
+			block->incremental_meshing |= edited;
 			try_schedule_mesh_update(*block);
 		}
 	});
@@ -803,7 +812,7 @@ void VoxelTerrain::post_edit_area(Box3i box_in_voxels, bool update_mesh) {
 	}
 
 	if (update_mesh) {
-		try_schedule_mesh_update_from_data(box_in_voxels);
+		try_schedule_mesh_update_from_data(box_in_voxels, true);
 
 #ifdef VOXEL_ENABLE_INSTANCER
 		if (_instancer != nullptr) {
@@ -975,6 +984,10 @@ void request_block_load(
 				TaskCancellationToken()
 		));
 
+		if (stream_dependency->stream->supports_prefetch()) {
+			task->enable_prefetch(volume_transform.basis);
+		}
+
 		scheduler.push_io_task(task);
 
 	} else {
@@ -1741,7 +1754,7 @@ void VoxelTerrain::apply_data_block_response(VoxelEngine::BlockDataOutput &ob) {
 	// TODO Optimize: initial loading can hang for a while here.
 	// Because lots of blocks are loaded at once, which leads to many block queries.
 	try_schedule_mesh_update_from_data(
-			Box3i(_data->block_to_voxel(block_pos), Vector3iUtil::create(get_data_block_size()))
+			Box3i(_data->block_to_voxel(block_pos), Vector3iUtil::create(get_data_block_size())), false
 	);
 
 	// We might have requested some blocks again (if we got a dropped one while we still need them)
@@ -1803,7 +1816,7 @@ bool VoxelTerrain::try_set_block_data(Vector3i position, std::shared_ptr<VoxelBu
 
 	// The block itself might not be suitable for meshing yet, but blocks surrounding it might be now
 	try_schedule_mesh_update_from_data(
-			Box3i(_data->block_to_voxel(position), Vector3iUtil::create(get_data_block_size()))
+			Box3i(_data->block_to_voxel(position), Vector3iUtil::create(get_data_block_size())), false
 	);
 
 	return true;
@@ -1861,8 +1874,22 @@ void VoxelTerrain::process_meshing() {
 		task->meshing_dependency = _meshing_dependency;
 		task->require_visual = mesh_block->mesh_viewers.get() > 0;
 		task->collision_hint = _generate_collisions && mesh_block->collision_viewers.get() > 0;
+		// Render surfaces are not used at all when no viewer requires visuals, like on a dedicated server
+		task->collision_only_hint = !task->require_visual;
 		task->data = _data;
 
+		if (mesh_block->incremental_meshing) {
+			task->incremental_hint = true;
+			task->incremental_cache = std::move(mesh_block->incremental_meshing_cache);
+			const Vector3i origin_in_voxels = mesh_block_pos * get_mesh_block_size();
+			task->dirty_box = Box3i(
+					mesh_block->dirty_box_in_voxels.position - origin_in_voxels, mesh_block->dirty_box_in_voxels.size
+			);
+		}
+		mesh_block->dirty_box_in_voxels = Box3i();
+		++mesh_block->meshing_version;
+		task->meshing_version = mesh_block->meshing_version;
+
 		// This iteration order is specifically chosen to match VoxelEngine and threaded access
 		_data->get_blocks_with_voxel_data(data_box, 0, to_span(task->blocks));
 		task->blocks_count = Vector3iUtil::get_volume_u64(data_box.size);
@@ -1933,6 +1960,11 @@ void VoxelTerrain::apply_mesh_update(const VoxelEngine::BlockMeshOutput &ob) {
 		return;
 	}
 
+	if (ob.meshing_version == block->meshing_version) {
+		// No other meshing task was scheduled for this block since, so it can be used for the next one
+		block->incremental_meshing_cache = ob.surfaces.incremental_cache;
+	}
+
 	Ref<ArrayMesh> mesh;
 	Ref<Mesh> shadow_occluder_mesh;
 	StdVector<uint16_t> material_indices;
@@ -236,7 +236,7 @@ private:
 	void unload_mesh_block(Vector3i bpos);
 	// void make_data_block_dirty(Vector3i bpos);
 	void try_schedule_mesh_update(VoxelMeshBlockVT &block);
-	void try_schedule_mesh_update_from_data(const Box3i &box_in_voxels);
+	void try_schedule_mesh_update_from_data(const Box3i &box_in_voxels, bool edited);
 
 	void save_all_modified_blocks(bool with_copy, std::shared_ptr<AsyncDependencyTracker> tracker);
 	void get_viewer_pos_and_direction(Vector3 &out_pos, Vector3 &out_direction) const;
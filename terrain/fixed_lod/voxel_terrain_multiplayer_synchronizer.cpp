@@ -1,6 +1,7 @@
 #include "voxel_terrain_multiplayer_synchronizer.h"
 #include "../../constants/voxel_string_names.h"
 #include "../../storage/voxel_buffer.h"
+#include "../../streams/compressed_data.h"
 #include "../../streams/voxel_block_serializer.h"
 #include "../../util/containers/container_funcs.h"
 #include "../../util/godot/classes/multiplayer_api.h"
@@ -52,21 +53,32 @@ void VoxelTerrainMultiplayerSynchronizer::send_block(
 ) {
 	ZN_PROFILE_SCOPE();
 
-	BlockSerializer::SerializeResult result = BlockSerializer::serialize_and_compress(data_block.get_voxels_const());
+	BlockSerializer::SerializeResult result = BlockSerializer::serialize(data_block.get_voxels_const());
 	ZN_ASSERT_RETURN(result.success);
 
+	// Compressed data is written directly into the message after the header
+	const size_t header_size = 4 * sizeof(int16_t);
 	PackedByteArray message_data;
-	message_data.resize(4 * sizeof(int16_t) + result.data.size());
+	message_data.resize(
+			header_size + CompressedData::get_max_compressed_size(result.data.size(), CompressedData::COMPRESSION_LZ4)
+	);
+	const Span<uint8_t> message_span(message_data.ptrw(), message_data.size());
+
+	size_t compressed_size = 0;
+	ZN_ASSERT_RETURN(CompressedData::compress(
+			to_span(result.data), message_span.sub(header_size), CompressedData::COMPRESSION_LZ4, compressed_size
+	));
+	ZN_ASSERT_RETURN(compressed_size <= 65535);
 
-	ByteSpanWithPosition mw_span(Span<uint8_t>(message_data.ptrw(), message_data.size()), 0);
+	ByteSpanWithPosition mw_span(message_span, 0);
 	MemoryWriterExistingBuffer mw(mw_span, ENDIANNESS_LITTLE_ENDIAN);
 
 	mw.store_16(bpos.x);
 	mw.store_16(bpos.y);
 	mw.store_16(bpos.z);
-	ZN_ASSERT_RETURN(result.data.size() <= 65535);
-	mw.store_16(result.data.size());
-	mw.store_buffer(to_span(result.data));
+	mw.store_16(compressed_size);
+
+	message_data.resize(header_size + compressed_size);
 
 	// print_line(String("Server: send block {0}").format(varray(bpos)));
 
@@ -94,20 +106,31 @@ void VoxelTerrainMultiplayerSynchronizer::send_area(Box3i voxel_box) {
 	voxels.create(voxel_box.size);
 	_terrain->get_storage().copy(voxel_box.position, voxels, 0xff);
 
-	BlockSerializer::SerializeResult result = BlockSerializer::serialize_and_compress(voxels);
+	BlockSerializer::SerializeResult result = BlockSerializer::serialize(voxels);
 	ZN_ASSERT_RETURN(result.success);
 
+	// Compressed data is written directly into the message after the header
+	const size_t header_size = 4 * sizeof(int32_t);
 	PackedByteArray pba;
-	pba.resize(4 * sizeof(int32_t) + result.data.size());
+	pba.resize(
+			header_size + CompressedData::get_max_compressed_size(result.data.size(), CompressedData::COMPRESSION_LZ4)
+	);
+	const Span<uint8_t> pba_span(pba.ptrw(), pba.size());
+
+	size_t compressed_size = 0;
+	ZN_ASSERT_RETURN(CompressedData::compress(
+			to_span(result.data), pba_span.sub(header_size), CompressedData::COMPRESSION_LZ4, compressed_size
+	));
 
-	ByteSpanWithPosition mw_span(Span<uint8_t>(pba.ptrw(), pba.size()), 0);
+	ByteSpanWithPosition mw_span(pba_span, 0);
 	MemoryWriterExistingBuffer mw(mw_span, ENDIANNESS_LITTLE_ENDIAN);
 
 	mw.store_32(voxel_box.position.x);
 	mw.store_32(voxel_box.position.y);
 	mw.store_32(voxel_box.position.z);
-	mw.store_32(result.data.size());
-	mw.store_buffer(to_span(result.data));
+	mw.store_32(compressed_size);
+
+	pba.resize(header_size + compressed_size);
 	for (const ViewerID viewer_id : viewers) {
 		const int peer_id = VoxelEngine::get_singleton().get_viewer_network_peer_id(viewer_id);
 		// TODO Don't bother copying and serializing if no networked viewers are around?
@@ -1585,7 +1585,7 @@ void VoxelLodTerrain::apply_main_thread_update_tasks() {
 				// material settings. This causes a bit of overdraw, but LOD fading does anyways.
 				if (_lod_fade_duration > 0.f && shader_material.is_valid() &&
 					activated_visual_blocks.find(block) == activated_visual_blocks.end() &&
-					tu.transition_mask != block->get_transition_mask()) {
+					(tu.transition_mask & block->get_meshed_transition_mask()) != block->get_transition_mask()) {
 					//
 					const Vector3 block_center = volume_transform.xform(
 							to_vec3(block->position * mesh_block_size + Vector3iUtil::create(mesh_block_size / 2))
@@ -1875,6 +1875,17 @@ void VoxelLodTerrain::apply_mesh_update(VoxelEngine::BlockMeshOutput &ob) {
 
 		transition_mask = mesh_block_state.transition_mask;
 
+		if (ob.surfaces.incremental_cache != nullptr) {
+			// Kept for the next meshing task of this block, which may only need to add transition meshes
+			MutexLock mlock(lod.meshing_caches_mutex);
+			// Tasks can complete in a different order than they were sent
+			if (mesh_block_state.meshing_cache == nullptr || //
+				ob.meshing_version > mesh_block_state.meshing_cache_version) {
+				mesh_block_state.meshing_cache = std::move(ob.surfaces.incremental_cache);
+				mesh_block_state.meshing_cache_version = ob.meshing_version;
+			}
+		}
+
 		// The update task could be running at the same time, so we need to do this atomically.
 		// The state can become "up to date" only if no other unsent update was pending.
 		VoxelLodTerrainUpdateData::MeshState expected = VoxelLodTerrainUpdateData::MESH_UPDATE_SENT;
@@ -2074,6 +2085,9 @@ void VoxelLodTerrain::apply_mesh_update(VoxelEngine::BlockMeshOutput &ob) {
 #endif
 		);
 
+		// Transition sides missing from the previous mesh get enabled now that a mesh having them arrived
+		block->set_meshed_transition_mask(ob.transition_mask);
+
 		if (assign_material_after_mesh) {
 			// Do this after assigning the mesh when not using a ShaderMaterial.
 			// This is because we don't create a per-chunk material in this case, and so chunks don't hold it, so
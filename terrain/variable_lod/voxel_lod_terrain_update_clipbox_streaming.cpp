@@ -731,6 +731,8 @@ inline void schedule_mesh_load(
 ) {
 	// ZN_PROFILE_SCOPE();
 
+	mesh_block.transition_update_only = false;
+
 	if (mesh_block.update_list_index != -1) {
 		// Update settings before the task is scheduled
 		VoxelLodTerrainUpdateData::MeshToUpdate &u = update_list[mesh_block.update_list_index];
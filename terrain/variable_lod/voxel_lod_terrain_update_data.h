@@ -3,6 +3,7 @@
 
 #include "../../constants/voxel_constants.h"
 #include "../../generators/voxel_generator.h"
+#include "../../meshers/voxel_mesher.h"
 #include "../../streams/voxel_stream.h"
 #include "../../util/containers/fixed_array.h"
 #include "../../util/containers/std_map.h"
@@ -129,6 +130,18 @@ struct VoxelLodTerrainUpdateData {
 		bool visual_active;
 		bool collision_active;
 
+		// Used when the mesher builds transitions lazily.
+		// Transition mask sent with the last meshing task of this block.
+		uint8_t meshed_transition_mask;
+		// True if the pending mesh update was only scheduled to add missing transition meshes, voxels didn't change.
+		bool transition_update_only;
+		// Incremented each time a meshing task is sent for this block.
+		uint32_t meshing_version;
+		// Returned by the last completed meshing task, to be passed to the next one. Written by the main thread, so it
+		// must be accessed with `Lod::meshing_caches_mutex` locked.
+		std::shared_ptr<VoxelMesher::IncrementalCache> meshing_cache;
+		uint32_t meshing_cache_version;
+
 		// Tells whether the first meshing was done since this block was added.
 		// Written by the main thread only, when it receives mesh updates or when it unloads resources.
 		// Read by threaded update to decide when to subdivide LODs.
@@ -145,6 +158,10 @@ struct VoxelLodTerrainUpdateData {
 				transition_mask(0),
 				visual_active(false),
 				collision_active(false),
+				meshed_transition_mask(0),
+				transition_update_only(false),
+				meshing_version(0),
+				meshing_cache_version(0),
 				visual_loaded(false),
 				collision_loaded(false) {}
 	};
@@ -204,6 +221,8 @@ struct VoxelLodTerrainUpdateData {
 
 		// Positions of mesh blocks that will be scheduled for update next time the update task runs.
 		StdVector<MeshToUpdate> mesh_blocks_pending_update;
+		// Protects `MeshBlockState::meshing_cache`
+		BinaryMutex meshing_caches_mutex;
 		Vector3i last_viewer_mesh_block_pos;
 		int last_view_distance_mesh_blocks = 0;
 
@@ -167,6 +167,10 @@ void request_block_load(
 				cancellation_token
 		));
 
+		if (stream_dependency->stream->supports_prefetch()) {
+			task->enable_prefetch(volume_transform.basis);
+		}
+
 		task_scheduler.push_io_task(task);
 
 	} else if (settings.cache_generated_blocks) {
@@ -308,6 +312,7 @@ void send_mesh_requests(
 	const int mesh_block_size = 1 << settings.mesh_block_size_po2;
 	const int render_to_data_factor = mesh_block_size / data_block_size;
 	const unsigned int lod_count = data.get_lod_count();
+	const bool lazy_transitions = meshing_dependency->mesher->is_building_transitions_lazily();
 
 	for (unsigned int lod_index = 0; lod_index < lod_count; ++lod_index) {
 		ZN_PROFILE_SCOPE();
@@ -349,9 +354,35 @@ void send_mesh_requests(
 			task->block_generation_use_gpu = settings.generator_use_gpu;
 			task->cancellation_token = mesh_to_update.cancellation_token;
 
+			bool transition_update_only = false;
+			if (lazy_transitions) {
+				task->transition_mask = mesh_block.transition_mask;
+				mesh_block.meshed_transition_mask = mesh_block.transition_mask;
+
+				// Always ask for a cache, so the next update of transitions can reuse the regular mesh
+				task->incremental_hint = true;
+				{
+					MutexLock mlock(lod.meshing_caches_mutex);
+					// The cache can only be reused if it comes from the last task sent for this block
+					if (mesh_block.transition_update_only && //
+						mesh_block.meshing_cache_version == mesh_block.meshing_version) {
+						task->incremental_cache = std::move(mesh_block.meshing_cache);
+						transition_update_only = true;
+					}
+					mesh_block.meshing_cache.reset();
+				}
+				if (!transition_update_only) {
+					// Everything has to be rebuilt
+					task->dirty_box = Box3i(Vector3i(), Vector3iUtil::create(mesh_block_size));
+				}
+			}
+			mesh_block.transition_update_only = false;
+			++mesh_block.meshing_version;
+			task->meshing_version = mesh_block.meshing_version;
+
 #ifdef VOXEL_ENABLE_SMOOTH_MESHING
-			// Don't update a detail texture if one update is already processing
-			if (settings.detail_texture_settings.enabled &&
+			// Don't update a detail texture if one update is already processing, or if voxels didn't change
+			if (settings.detail_texture_settings.enabled && !transition_update_only &&
 				lod_index >= settings.detail_texture_settings.begin_lod_index &&
 				mesh_block.detail_texture_state != VoxelLodTerrainUpdateData::DETAIL_TEXTURE_PENDING) {
 				mesh_block.detail_texture_state = VoxelLodTerrainUpdateData::DETAIL_TEXTURE_PENDING;
@@ -392,6 +423,45 @@ void send_mesh_requests(
 	}
 }
 
+// When the mesher builds transitions lazily, blocks needing transitions on sides their mesh doesn't have must be
+// remeshed. Transitions no longer needed don't require remeshing, since they get hidden by the shader.
+void schedule_missing_transition_updates(VoxelLodTerrainUpdateData::State &state, const unsigned int lod_count) {
+	ZN_PROFILE_SCOPE();
+
+	for (unsigned int lod_index = 0; lod_index < lod_count; ++lod_index) {
+		VoxelLodTerrainUpdateData::Lod &lod = state.lods[lod_index];
+
+		if (lod.mesh_blocks_to_update_transitions.size() == 0) {
+			continue;
+		}
+
+		RWLockRead rlock(lod.mesh_map_state.map_lock);
+
+		for (const VoxelLodTerrainUpdateData::TransitionUpdate &tu : lod.mesh_blocks_to_update_transitions) {
+			auto mesh_block_it = lod.mesh_map_state.map.find(tu.block_position);
+			if (mesh_block_it == lod.mesh_map_state.map.end()) {
+				continue;
+			}
+			VoxelLodTerrainUpdateData::MeshBlockState &mesh_block = mesh_block_it->second;
+
+			if ((tu.transition_mask & ~mesh_block.meshed_transition_mask) == 0) {
+				continue;
+			}
+
+			const bool up_to_date = mesh_block.state == VoxelLodTerrainUpdateData::MESH_UP_TO_DATE;
+
+			VoxelLodTerrainUpdateTask::schedule_mesh_update(
+					mesh_block, tu.block_position, lod.mesh_blocks_pending_update, mesh_block.mesh_viewers.get() > 0
+			);
+
+			if (up_to_date) {
+				// Voxels didn't change since the last mesh was built
+				mesh_block.transition_update_only = true;
+			}
+		}
+	}
+}
+
 // Generates all non-present blocks in preparation for an edit.
 // This function schedules one parallel task for every block.
 // The returned tracker may be polled to detect when it is complete.
@@ -1022,6 +1092,10 @@ void VoxelLodTerrainUpdateTask::run(ThreadedTaskContext &ctx) {
 	// TODO When no mesher is assigned, mesh requests are still accumulated but not being sent. A better way to support
 	// this is by allowing voxels-only/mesh-less viewers, similar to VoxelTerrain
 	if (_meshing_dependency->mesher.is_valid()) {
+		if (_meshing_dependency->mesher->is_building_transitions_lazily()) {
+			schedule_missing_transition_updates(state, lod_count);
+		}
+
 		send_mesh_requests(
 				_volume_id,
 				state,
@@ -71,6 +71,8 @@ public:
 			StdVector<VoxelLodTerrainUpdateData::MeshToUpdate> &blocks_pending_update,
 			const bool require_visual
 	) {
+		// Anything may have changed, so the mesh will have to be rebuilt entirely
+		block.transition_update_only = false;
 		if (block.state != VoxelLodTerrainUpdateData::MESH_UPDATE_NOT_SENT) {
 			if (block.visual_active || block.collision_active) {
 				// Schedule an update
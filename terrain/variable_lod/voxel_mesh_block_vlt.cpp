@@ -148,6 +148,8 @@ void VoxelMeshBlockVLT::drop_visuals() {
 	fading_progress = 0.f;
 	visual_active = false;
 	_transition_mask = 0;
+	_requested_transition_mask = 0;
+	_meshed_transition_mask = 0;
 }
 
 void VoxelMeshBlockVLT::set_gi_mode(GeometryInstance3D::GIMode mode) {
@@ -304,6 +306,17 @@ void VoxelMeshBlockVLT::set_material_override_internal(Ref<Material> material) {
 
 void VoxelMeshBlockVLT::set_transition_mask(uint8_t m) {
 	CRASH_COND(m >= (1 << Cube::SIDE_COUNT));
+	_requested_transition_mask = m;
+	apply_transition_mask(m & _meshed_transition_mask);
+}
+
+void VoxelMeshBlockVLT::set_meshed_transition_mask(uint8_t m) {
+	CRASH_COND(m >= (1 << Cube::SIDE_COUNT));
+	_meshed_transition_mask = m;
+	apply_transition_mask(_requested_transition_mask & m);
+}
+
+void VoxelMeshBlockVLT::apply_transition_mask(uint8_t m) {
 	const uint8_t diff = _transition_mask ^ m;
 	if (diff == 0) {
 		return;
@@ -479,9 +492,7 @@ Ref<ArrayMesh> build_mesh(
 			mesh.instantiate();
 		}
 
-		// TODO Use `add_surface`, it's about 20% faster after measuring in Tracy (though we may see if Godot 4 expects
-		// the same)
-		mesh->add_surface_from_arrays(primitive, arrays, Array(), Dictionary(), flags);
+		VoxelMesher::add_surface_to_mesh(**mesh, surface, primitive, flags);
 		mesh->surface_set_material(surface_index, material);
 		// No multi-material supported yet
 		++surface_index;
@@ -71,11 +71,20 @@ public:
 	);
 	void drop_visuals();
 
+	// Sets transition sides the block should display. Only sides the current mesh was built with are applied, the
+	// others get applied once a mesh having them is set with `set_meshed_transition_mask`.
 	void set_transition_mask(uint8_t m);
 	inline uint8_t get_transition_mask() const {
 		return _transition_mask;
 	}
 
+	// Sets transition sides the current mesh was built with. Meshers building transitions lazily can produce meshes
+	// lacking some sides. Enabling a side in the shader without its transition mesh would leave a crack.
+	void set_meshed_transition_mask(uint8_t m);
+	inline uint8_t get_meshed_transition_mask() const {
+		return _meshed_transition_mask;
+	}
+
 	void set_gi_mode(GeometryInstance3D::GIMode mode);
 	void set_shadow_casting(RenderingServer::ShadowCastingSetting mode);
 	void set_render_layers_mask(int mask);
@@ -122,6 +131,7 @@ public:
 
 private:
 	void set_material_override_internal(Ref<Material> material);
+	void apply_transition_mask(uint8_t m);
 	void _set_visible(bool visible);
 
 	inline bool _is_transition_visible(unsigned int side) const {
@@ -132,7 +142,12 @@ private:
 
 	FixedArray<zylann::godot::DirectMeshInstance, Cube::SIDE_COUNT> _transition_mesh_instances;
 
+	// Transition sides currently enabled
 	uint8_t _transition_mask = 0;
+	// Transition sides requested by the terrain
+	uint8_t _requested_transition_mask = 0;
+	// Transition sides the current mesh has
+	uint8_t _meshed_transition_mask = 0;
 
 	// See VoxelMesherBlocky.
 	// This unfortunately has to be a whole separate mesh instance because Godot doesn't support setting
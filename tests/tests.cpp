@@ -21,13 +21,16 @@
 #include "voxel/test_raycast.h"
 #include "voxel/test_region_file.h"
 #include "voxel/test_storage_funcs.h"
+#include "voxel/test_voxel_archive.h"
 #include "voxel/test_voxel_buffer.h"
 #include "voxel/test_voxel_data_map.h"
 #include "voxel/test_voxel_graph.h"
 #include "voxel/test_voxel_instancer.h"
+#include "voxel/test_voxel_mesher_blocky.h"
 #include "voxel/test_voxel_mesher_cubes.h"
 
 #ifdef VOXEL_ENABLE_SMOOTH_MESHING
+#include "voxel/test_voxel_mesher_transvoxel.h"
 #ifdef VOXEL_ENABLE_GPU
 #include "voxel/test_detail_rendering_gpu.h"
 #endif
@@ -59,6 +62,8 @@ void run_voxel_tests(const testing::TestOptions &options) {
 	using namespace zylann::tests;
 
 	VOXEL_TEST(test_wrap);
+	VOXEL_TEST(test_deterministic_funcs);
+	VOXEL_TEST(test_simd_greater_bits);
 	VOXEL_TEST(test_int32_to_string_base10);
 	VOXEL_TEST(test_string_base10_to_int32);
 	VOXEL_TEST(test_voxel_buffer_metadata);
@@ -120,9 +125,11 @@ void run_voxel_tests(const testing::TestOptions &options) {
 	VOXEL_TEST(test_get_curve_monotonic_sections);
 	VOXEL_TEST(test_voxel_buffer_create);
 	VOXEL_TEST(test_block_serializer);
+	VOXEL_TEST(test_block_serializer_caller_buffers);
 	VOXEL_TEST(test_block_serializer_stream_peer);
 	VOXEL_TEST(test_region_file);
 	VOXEL_TEST(test_voxel_stream_region_files);
+	VOXEL_TEST(test_voxel_archive);
 #ifdef VOXEL_ENABLE_FAST_NOISE_2
 	VOXEL_TEST(test_fast_noise_2_basic);
 	VOXEL_TEST(test_fast_noise_2_empty_encoded_node_tree);
@@ -131,6 +138,22 @@ void run_voxel_tests(const testing::TestOptions &options) {
 	VOXEL_TEST(test_flat_map);
 	VOXEL_TEST(test_expression_parser);
 	VOXEL_TEST(test_voxel_mesher_cubes);
+	VOXEL_TEST(test_voxel_mesher_blocky_greedy);
+	VOXEL_TEST(test_voxel_mesher_blocky_culling);
+	VOXEL_TEST(test_voxel_mesher_blocky_incremental);
+	VOXEL_TEST(test_voxel_mesher_blocky_collision_only);
+	VOXEL_TEST(test_voxel_mesher_blocky_vertex_cache_optimization);
+	VOXEL_TEST(test_voxel_mesher_blocky_vertex_compression);
+	VOXEL_TEST(test_voxel_mesher_blocky_buffer_reuse);
+	VOXEL_TEST(test_voxel_mesher_blocky_padded_view);
+#ifdef VOXEL_ENABLE_SMOOTH_MESHING
+	VOXEL_TEST(test_voxel_mesher_transvoxel_lazy_transitions);
+	VOXEL_TEST(test_voxel_mesher_transvoxel_delayed_transition_mesh);
+	VOXEL_TEST(test_voxel_mesher_transvoxel_case_codes);
+	VOXEL_TEST(test_voxel_mesher_transvoxel_vertex_cache_optimization);
+	VOXEL_TEST(test_voxel_mesher_transvoxel_vertex_compression);
+	VOXEL_TEST(test_voxel_mesher_transvoxel_padded_view);
+#endif
 	VOXEL_TEST(test_threaded_task_runner_misc);
 	VOXEL_TEST(test_threaded_task_runner_debug_names);
 	VOXEL_TEST(test_task_priority_values);
@@ -154,14 +177,34 @@ void run_voxel_tests(const testing::TestOptions &options) {
 	VOXEL_TEST(test_voxel_stream_sqlite_key_blob80_encoding);
 	VOXEL_TEST(test_voxel_stream_sqlite_basic);
 	VOXEL_TEST(test_voxel_stream_sqlite_coordinate_format);
+	VOXEL_TEST(test_voxel_stream_sqlite_prefetch);
+	VOXEL_TEST(test_voxel_stream_cache_prefetch);
+	VOXEL_TEST(test_voxel_stream_sqlite_deduplication);
+	VOXEL_TEST(test_voxel_stream_sqlite_deduplication_across_connections);
+	VOXEL_TEST(test_voxel_stream_sqlite_deduplication_migration);
+	VOXEL_TEST(test_voxel_stream_sqlite_options);
+	VOXEL_TEST(test_voxel_stream_sqlite_batch_save_load);
 #endif
 	VOXEL_TEST(test_sdf_hemisphere);
 	VOXEL_TEST(test_fnl_range);
+	VOXEL_TEST(test_fnl_series);
 	VOXEL_TEST(test_voxel_buffer_set_channel_bytes);
 	VOXEL_TEST(test_raycast_sdf);
 	VOXEL_TEST(test_raycast_blocky);
 	VOXEL_TEST(test_raycast_blocky_no_cache_graph);
 	VOXEL_TEST(test_voxel_graph_constant_reduction);
+	VOXEL_TEST(test_voxel_graph_simd_kernels);
+	VOXEL_TEST(test_voxel_graph_elementwise_fusion);
+	VOXEL_TEST(test_voxel_graph_cpp_generation);
+	VOXEL_TEST(test_voxel_graph_cpp_generation_matches_runtime);
+	VOXEL_TEST(test_voxel_graph_range_analysis_cache);
+	VOXEL_TEST(test_voxel_graph_range_analysis_cache_across_lods);
+	VOXEL_TEST(test_voxel_graph_adaptive_subdivision);
+	VOXEL_TEST(test_voxel_graph_adaptive_subdivision_textures);
+	VOXEL_TEST(test_voxel_graph_slice_evaluation);
+	VOXEL_TEST(test_voxel_graph_generate_points);
+	VOXEL_TEST(test_voxel_graph_state_arena);
+	VOXEL_TEST(test_voxel_graph_deterministic);
 
 	print_line("------------ Voxel tests end -------------");
 }
@@ -1,6 +1,11 @@
 #include "test_math_funcs.h"
+#include "../../util/hash_funcs.h"
+#include "../../util/math/deterministic_funcs.h"
 #include "../../util/math/funcs.h"
+#include "../../util/math/simd.h"
 #include "../../util/testing/test_macros.h"
+#include <cmath>
+#include <cstring>
 
 namespace zylann::tests {
 
@@ -30,4 +35,89 @@ void test_wrap() {
 	}
 }
 
+namespace {
+
+inline uint32_t get_float_bits(float f) {
+	uint32_t bits;
+	memcpy(&bits, &f, sizeof(float));
+	return bits;
+}
+
+} // namespace
+
+void test_deterministic_funcs() {
+	// Accuracy
+	for (int i = -20000; i < 20000; ++i) {
+		const float x = static_cast<float>(i) * 0.01f;
+		const double expected = std::sin(static_cast<double>(x));
+		ZN_TEST_ASSERT(std::abs(math::deterministic_sin(x) - expected) < 1e-6);
+	}
+	for (int i = 1; i < 1000; ++i) {
+		for (int k = -20; k <= 20; ++k) {
+			const float x = static_cast<float>(i) * 0.1f;
+			const float p = static_cast<float>(k) * 0.15f;
+			const double expected = std::pow(static_cast<double>(x), static_cast<double>(p));
+			ZN_TEST_ASSERT(std::abs(math::deterministic_pow(x, p) - expected) <= 1e-5 * expected);
+		}
+	}
+
+	// Special cases
+	ZN_TEST_ASSERT(math::deterministic_sin(0.f) == 0.f);
+	ZN_TEST_ASSERT(std::isnan(math::deterministic_sin(INFINITY)));
+	ZN_TEST_ASSERT(math::deterministic_pow(-2.f, 3.f) == -8.f);
+	ZN_TEST_ASSERT(math::deterministic_pow(-2.f, 2.f) == 4.f);
+	ZN_TEST_ASSERT(std::isnan(math::deterministic_pow(-2.f, 0.5f)));
+	ZN_TEST_ASSERT(math::deterministic_pow(0.f, 2.f) == 0.f);
+	ZN_TEST_ASSERT(math::deterministic_pow(0.f, -1.f) == INFINITY);
+	ZN_TEST_ASSERT(math::deterministic_pow(123.f, 0.f) == 1.f);
+	ZN_TEST_ASSERT(math::deterministic_pow(2.f, 128.f) == INFINITY);
+
+	// Results must be the same on every platform. These hashes were obtained once, if they change, generated terrains
+	// relying on these functions will no longer match.
+	uint32_t sin_hash = 5381;
+	for (int i = -5000; i < 5000; ++i) {
+		sin_hash = hash_djb2_one_32(get_float_bits(math::deterministic_sin(static_cast<float>(i) * 0.0137f)), sin_hash);
+	}
+	ZN_TEST_ASSERT(sin_hash == 0xcf211899);
+
+	uint32_t pow_hash = 5381;
+	for (int i = 0; i < 200; ++i) {
+		for (int k = 0; k < 25; ++k) {
+			const float x = 0.01f + static_cast<float>(i) * 0.37f;
+			const float p = -3.f + static_cast<float>(k) * 0.25f;
+			pow_hash = hash_djb2_one_32(get_float_bits(math::deterministic_pow(x, p)), pow_hash);
+		}
+	}
+	ZN_TEST_ASSERT(pow_hash == 0x53909a66);
+}
+
+template <typename T>
+void test_simd_greater_bits_t() {
+	// Long enough to span several words and leave a partial register at the end
+	const unsigned int count = 150;
+	T values[count];
+	for (unsigned int i = 0; i < count; ++i) {
+		// Includes values equal to the threshold, which must not be counted
+		values[i] = static_cast<T>(static_cast<int>((i * 7) % 5) - 2);
+	}
+
+	for (unsigned int sub_count = 0; sub_count <= count; sub_count += 13) {
+		uint64_t bits[3];
+		simd::get_greater_bits(values, sub_count, static_cast<T>(0), bits);
+
+		// Only words covering `sub_count` are written
+		for (unsigned int i = 0; i < ((sub_count + 63) / 64) * 64; ++i) {
+			const bool expected = i < sub_count && values[i] > 0;
+			const bool actual = ((bits[i >> 6] >> (i & 63)) & 1) != 0;
+			ZN_TEST_ASSERT(expected == actual);
+		}
+	}
+}
+
+void test_simd_greater_bits() {
+	test_simd_greater_bits_t<int8_t>();
+	test_simd_greater_bits_t<int16_t>();
+	test_simd_greater_bits_t<float>();
+}
+
 } // namespace zylann::tests
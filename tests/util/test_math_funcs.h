@@ -4,6 +4,8 @@
 namespace zylann::tests {
 
 void test_wrap();
+void test_deterministic_funcs();
+void test_simd_greater_bits();
 
 } // namespace zylann::tests
 
@@ -1,4 +1,7 @@
 #include "test_noise.h"
+#include "../../util/containers/std_vector.h"
+#include "../../util/math/funcs.h"
+#include "../../util/math/simd.h"
 #include "../../util/noise/fast_noise_lite/fast_noise_lite.h"
 #include "../../util/noise/fast_noise_lite/fast_noise_lite_range.h"
 #include "../../util/testing/test_macros.h"
@@ -48,4 +51,63 @@ void test_fnl_range() {
 	ZN_TEST_ASSERT(analytic_range.contains(empiric_range));
 }
 
+void test_fnl_series() {
+	struct Config {
+		ZN_FastNoiseLite::NoiseType noise_type;
+		ZN_FastNoiseLite::FractalType fractal_type;
+	};
+	const Config configs[] = {
+		{ ZN_FastNoiseLite::TYPE_OPEN_SIMPLEX_2, ZN_FastNoiseLite::FRACTAL_NONE },
+		{ ZN_FastNoiseLite::TYPE_OPEN_SIMPLEX_2, ZN_FastNoiseLite::FRACTAL_FBM },
+		{ ZN_FastNoiseLite::TYPE_PERLIN, ZN_FastNoiseLite::FRACTAL_RIDGED },
+		{ ZN_FastNoiseLite::TYPE_CELLULAR, ZN_FastNoiseLite::FRACTAL_PING_PONG },
+		// Not vectorized, uses the fallback
+		{ ZN_FastNoiseLite::TYPE_VALUE, ZN_FastNoiseLite::FRACTAL_FBM },
+	};
+
+	// Not a multiple of the SIMD width, so the remainder is tested too
+	const unsigned int count = 103;
+	StdVector<float> x;
+	StdVector<float> y;
+	StdVector<float> z;
+	for (unsigned int i = 0; i < count; ++i) {
+		x.push_back(-50.f + 1.37f * i);
+		y.push_back(20.f - 0.71f * i);
+		z.push_back(3.f + 0.53f * i);
+	}
+
+	StdVector<float> results;
+	results.resize(count);
+
+	// Series must give the same results as single queries. Only ARMv7 differs slightly, because it has no vector
+	// division and uses an approximate reciprocal instead.
+#if defined(ZN_SIMD_NEON) && !(defined(__aarch64__) || defined(_M_ARM64))
+	const float tolerance = 0.00001f;
+#else
+	const float tolerance = 0.f;
+#endif
+
+	for (const Config &config : configs) {
+		Ref<ZN_FastNoiseLite> noise;
+		noise.instantiate();
+		noise->set_noise_type(config.noise_type);
+		noise->set_fractal_type(config.fractal_type);
+		noise->set_fractal_octaves(3);
+		noise->set_period(32);
+		noise->set_seed(131);
+
+		noise->get_noise_2d_series(to_span(x), to_span(y), to_span(results));
+		for (unsigned int i = 0; i < count; ++i) {
+			const float expected = noise->get_noise_2d(x[i], y[i]);
+			ZN_TEST_ASSERT(Math::abs(results[i] - expected) <= tolerance);
+		}
+
+		noise->get_noise_3d_series(to_span(x), to_span(y), to_span(z), to_span(results));
+		for (unsigned int i = 0; i < count; ++i) {
+			const float expected = noise->get_noise_3d(x[i], y[i], z[i]);
+			ZN_TEST_ASSERT(Math::abs(results[i] - expected) <= tolerance);
+		}
+	}
+}
+
 } // namespace zylann::tests
@@ -4,6 +4,7 @@
 namespace zylann::tests {
 
 void test_fnl_range();
+void test_fnl_series();
 
 } // namespace zylann::tests
 
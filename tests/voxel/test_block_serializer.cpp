@@ -49,6 +49,62 @@ void test_block_serializer() {
 	}
 }
 
+void test_block_serializer_caller_buffers() {
+	const Vector3i block_size(8, 9, 10);
+	VoxelBuffer voxel_buffer1(VoxelBuffer::ALLOCATOR_DEFAULT);
+	voxel_buffer1.create(block_size);
+	voxel_buffer1.fill_area(42, Vector3i(1, 2, 3), Vector3i(5, 5, 5), 0);
+	voxel_buffer1.fill_area(44, Vector3i(1, 2, 3), Vector3i(5, 5, 5), 1);
+
+	VoxelBuffer voxel_buffer2(VoxelBuffer::ALLOCATOR_DEFAULT);
+	voxel_buffer2.create(block_size);
+	voxel_buffer2.fill_area(43, Vector3i(2, 3, 4), Vector3i(6, 6, 6), 0);
+
+	{
+		// Serialize into memory provided by the caller
+		const size_t size = BlockSerializer::get_serialized_size(voxel_buffer1);
+		ZN_TEST_ASSERT(size > 0);
+		StdVector<uint8_t> data;
+		data.resize(size);
+		ZN_TEST_ASSERT(BlockSerializer::serialize(voxel_buffer1, to_span(data)));
+
+		// Same result as the thread-local version
+		BlockSerializer::SerializeResult result = BlockSerializer::serialize(voxel_buffer1);
+		ZN_TEST_ASSERT(result.success);
+		ZN_TEST_ASSERT(result.data == data);
+
+		VoxelBuffer deserialized_voxel_buffer(VoxelBuffer::ALLOCATOR_DEFAULT);
+		ZN_TEST_ASSERT(BlockSerializer::deserialize(to_span_const(data), deserialized_voxel_buffer));
+		ZN_TEST_ASSERT(voxel_buffer1.equals(deserialized_voxel_buffer));
+	}
+	{
+		// Append multiple compressed blocks into the same buffer, after some existing data
+		StdVector<uint8_t> data;
+		data.push_back(255);
+		ZN_TEST_ASSERT(BlockSerializer::serialize_and_compress_append(voxel_buffer1, data));
+		const size_t end1 = data.size();
+		ZN_TEST_ASSERT(BlockSerializer::serialize_and_compress_append(voxel_buffer2, data));
+		ZN_TEST_ASSERT(data[0] == 255);
+
+		const Span<const uint8_t> data_span = to_span_const(data);
+
+		VoxelBuffer deserialized_voxel_buffer(VoxelBuffer::ALLOCATOR_DEFAULT);
+		ZN_TEST_ASSERT(
+				BlockSerializer::decompress_and_deserialize(data_span.sub(1, end1 - 1), deserialized_voxel_buffer)
+		);
+		ZN_TEST_ASSERT(voxel_buffer1.equals(deserialized_voxel_buffer));
+
+		// Deserializing again into the same buffer re-uses its channels. Contents must not leak from the previous
+		// block, including metadata and channels that were allocated before but are uniform in the new data.
+		VoxelMetadata *meta = deserialized_voxel_buffer.get_or_create_voxel_metadata(Vector3i(1, 1, 1));
+		ZN_TEST_ASSERT(meta != nullptr);
+		meta->set_u64(12);
+		ZN_TEST_ASSERT(BlockSerializer::decompress_and_deserialize(data_span.sub(end1), deserialized_voxel_buffer));
+		ZN_TEST_ASSERT(voxel_buffer2.equals(deserialized_voxel_buffer));
+		ZN_TEST_ASSERT(deserialized_voxel_buffer.get_voxel_metadata(Vector3i(1, 1, 1)) == nullptr);
+	}
+}
+
 void test_block_serializer_stream_peer() {
 	// Create an example buffer
 	const Vector3i block_size(8, 9, 10);
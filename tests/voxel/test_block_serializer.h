@@ -4,6 +4,7 @@
 namespace zylann::voxel::tests {
 
 void test_block_serializer();
+void test_block_serializer_caller_buffers();
 void test_block_serializer_stream_peer();
 
 } // namespace zylann::voxel::tests
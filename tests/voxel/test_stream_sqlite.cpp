@@ -1,8 +1,14 @@
 #include "test_stream_sqlite.h"
 #include "../../streams/sqlite/block_location.h"
+#include "../../streams/sqlite/connection.h"
 #include "../../streams/sqlite/voxel_stream_sqlite.h"
+#include "../../streams/voxel_stream_cache.h"
+#include "../../thirdparty/sqlite/sqlite3.h"
 #include "../../util/containers/container_funcs.h"
+#include "../../util/godot/classes/project_settings.h"
 #include "../../util/godot/core/random_pcg.h"
+#include "../../util/godot/core/string.h"
+#include "../../util/math/box3i.h"
 #include "../../util/math/conv.h"
 #include "../../util/math/vector3i.h"
 #include "../../util/profiling.h"
@@ -282,4 +288,545 @@ void test_voxel_stream_sqlite_key_blob80_encoding() {
 	test_voxel_stream_sqlite_key_blob80_encoding(Vector3i(max_pos.x, min_pos.y, max_pos.z), max_lod_index);
 }
 
+void test_voxel_stream_sqlite_prefetch() {
+	zylann::testing::TestDirectory test_dir;
+	ZN_TEST_ASSERT(test_dir.is_valid());
+
+	const String database_path = test_dir.get_path().path_join("database.sqlite");
+
+	VoxelBuffer vb1(VoxelBuffer::ALLOCATOR_DEFAULT);
+	vb1.create(Vector3i(16, 16, 16));
+	vb1.fill_area(1, Vector3i(5, 5, 5), Vector3i(10, 11, 12), 0);
+	const Vector3i vb1_pos(1, 2, -3);
+
+	VoxelBuffer vb2(VoxelBuffer::ALLOCATOR_DEFAULT);
+	vb2.create(Vector3i(16, 16, 16));
+	vb2.fill_area(2, Vector3i(1, 2, 3), Vector3i(4, 5, 6), 0);
+	const Vector3i vb2_pos(2, 2, -3);
+
+	{
+		Ref<VoxelStreamSQLite> stream;
+		stream.instantiate();
+		stream->set_database_path(database_path);
+		VoxelBuffer vb1_copy(VoxelBuffer::ALLOCATOR_DEFAULT);
+		vb1.copy_to(vb1_copy, true);
+		VoxelStreamSQLite::VoxelQueryData q1{ vb1_copy, vb1_pos, 0, VoxelStream::RESULT_ERROR };
+		stream->save_voxel_block(q1);
+		VoxelBuffer vb2_copy(VoxelBuffer::ALLOCATOR_DEFAULT);
+		vb2.copy_to(vb2_copy, true);
+		VoxelStreamSQLite::VoxelQueryData q2{ vb2_copy, vb2_pos, 0, VoxelStream::RESULT_ERROR };
+		stream->save_voxel_block(q2);
+		stream->flush();
+	}
+	{
+		Ref<VoxelStreamSQLite> stream;
+		stream.instantiate();
+		stream->set_database_path(database_path);
+		ZN_TEST_ASSERT(stream->supports_prefetch() == false);
+		stream->set_prefetch_capacity(16);
+		ZN_TEST_ASSERT(stream->supports_prefetch());
+
+		// Includes a block that doesn't exist, which should be ignored
+		const Vector3i positions[] = { vb1_pos, vb2_pos, Vector3i(10, 10, 10) };
+		stream->prefetch_voxel_blocks(Span<const Vector3i>(positions, 3), 0);
+
+		// Saving over a prefetched block must take precedence
+		VoxelBuffer vb2_modified(VoxelBuffer::ALLOCATOR_DEFAULT);
+		vb2.copy_to(vb2_modified, true);
+		vb2_modified.set_voxel(3, Vector3i(0, 0, 0), 0);
+		VoxelBuffer vb2_modified_copy(VoxelBuffer::ALLOCATOR_DEFAULT);
+		vb2_modified.copy_to(vb2_modified_copy, true);
+		{
+			VoxelStreamSQLite::VoxelQueryData q{ vb2_modified_copy, vb2_pos, 0, VoxelStream::RESULT_ERROR };
+			stream->save_voxel_block(q);
+		}
+
+		{
+			VoxelBuffer loaded(VoxelBuffer::ALLOCATOR_DEFAULT);
+			VoxelStreamSQLite::VoxelQueryData q{ loaded, vb1_pos, 0, VoxelStream::RESULT_ERROR };
+			stream->load_voxel_block(q);
+			ZN_TEST_ASSERT(q.result == VoxelStream::RESULT_BLOCK_FOUND);
+			ZN_TEST_ASSERT(loaded.equals(vb1));
+		}
+		{
+			// The prefetched block was handed over, loading again must still work
+			VoxelBuffer loaded(VoxelBuffer::ALLOCATOR_DEFAULT);
+			VoxelStreamSQLite::VoxelQueryData q{ loaded, vb1_pos, 0, VoxelStream::RESULT_ERROR };
+			stream->load_voxel_block(q);
+			ZN_TEST_ASSERT(q.result == VoxelStream::RESULT_BLOCK_FOUND);
+			ZN_TEST_ASSERT(loaded.equals(vb1));
+		}
+		{
+			VoxelBuffer loaded(VoxelBuffer::ALLOCATOR_DEFAULT);
+			VoxelStreamSQLite::VoxelQueryData q{ loaded, vb2_pos, 0, VoxelStream::RESULT_ERROR };
+			stream->load_voxel_block(q);
+			ZN_TEST_ASSERT(q.result == VoxelStream::RESULT_BLOCK_FOUND);
+			ZN_TEST_ASSERT(loaded.equals(vb2_modified));
+		}
+		stream->flush();
+	}
+}
+
+void test_voxel_stream_cache_prefetch() {
+	VoxelStreamCache cache;
+	cache.set_prefetch_capacity(2);
+
+	auto prefetch = [&cache](Vector3i position) {
+		VoxelBuffer vb(VoxelBuffer::ALLOCATOR_DEFAULT);
+		vb.create(Vector3i(4, 4, 4));
+		cache.prefetch_voxel_block(position, 0, vb, cache.get_prefetch_ticket(0));
+	};
+
+	const Vector3i pos_a(1, 0, 0);
+	const Vector3i pos_b(2, 0, 0);
+	const Vector3i pos_c(3, 0, 0);
+
+	{
+		prefetch(pos_a);
+		VoxelBuffer loaded(VoxelBuffer::ALLOCATOR_DEFAULT);
+		ZN_TEST_ASSERT(cache.load_voxel_block(pos_a, 0, loaded));
+		ZN_TEST_ASSERT(cache.has_voxel_block(pos_a, 0) == false);
+	}
+	{
+		// The first prefetch of A is still in the order queue, it must not evict the second one
+		prefetch(pos_b);
+		prefetch(pos_a);
+		prefetch(pos_c);
+		ZN_TEST_ASSERT(cache.has_voxel_block(pos_a, 0));
+		ZN_TEST_ASSERT(cache.has_voxel_block(pos_b, 0) == false);
+		ZN_TEST_ASSERT(cache.has_voxel_block(pos_c, 0));
+	}
+	{
+		VoxelBuffer vb(VoxelBuffer::ALLOCATOR_DEFAULT);
+		vb.create(Vector3i(4, 4, 4));
+		cache.save_voxel_block(pos_b, 0, vb);
+
+		// Simulates a prefetch reading storage while the flush is not committed yet
+		const uint32_t ticket = cache.get_prefetch_ticket(0);
+		cache.flush([](VoxelStreamCache::Block &) {});
+		VoxelBuffer old_vb(VoxelBuffer::ALLOCATOR_DEFAULT);
+		old_vb.create(Vector3i(4, 4, 4));
+		cache.prefetch_voxel_block(pos_b, 0, old_vb, ticket);
+		cache.end_flush();
+		ZN_TEST_ASSERT(cache.has_voxel_block(pos_b, 0) == false);
+
+		// Reads that started before the commit are outdated
+		VoxelBuffer late_vb(VoxelBuffer::ALLOCATOR_DEFAULT);
+		late_vb.create(Vector3i(4, 4, 4));
+		cache.prefetch_voxel_block(pos_b, 0, late_vb, ticket);
+		ZN_TEST_ASSERT(cache.has_voxel_block(pos_b, 0) == false);
+	}
+}
+
+void test_voxel_stream_sqlite_deduplication() {
+	zylann::testing::TestDirectory test_dir;
+	ZN_TEST_ASSERT(test_dir.is_valid());
+
+	const String database_path = test_dir.get_path().path_join("database.sqlite");
+
+	RandomPCG rng;
+	rng.seed(131183);
+
+	// Random data, so it doesn't compress to something too small to be worth sharing
+	struct L {
+		static void make_block(VoxelBuffer &vb, RandomPCG &rng) {
+			vb.create(Vector3iUtil::create(1 << constants::DEFAULT_BLOCK_SIZE_PO2));
+			Vector3i rpos;
+			for (rpos.z = 0; rpos.z < vb.get_size().z; ++rpos.z) {
+				for (rpos.x = 0; rpos.x < vb.get_size().x; ++rpos.x) {
+					for (rpos.y = 0; rpos.y < 4; ++rpos.y) {
+						vb.set_voxel(rng.rand() % 256, rpos, 0);
+					}
+				}
+			}
+		}
+
+		static void save(VoxelStreamSQLite &stream, const VoxelBuffer &vb, Vector3i bpos) {
+			VoxelBuffer vb_copy(VoxelBuffer::ALLOCATOR_DEFAULT);
+			vb.copy_to(vb_copy, true);
+			VoxelStreamSQLite::VoxelQueryData q{ vb_copy, bpos, 0, VoxelStream::RESULT_ERROR };
+			stream.save_voxel_block(q);
+		}
+
+		static void check(VoxelStreamSQLite &stream, const VoxelBuffer &expected, Vector3i bpos) {
+			VoxelBuffer loaded(VoxelBuffer::ALLOCATOR_DEFAULT);
+			VoxelStreamSQLite::VoxelQueryData q{ loaded, bpos, 0, VoxelStream::RESULT_ERROR };
+			stream.load_voxel_block(q);
+			ZN_TEST_ASSERT(q.result == VoxelStream::RESULT_BLOCK_FOUND);
+			ZN_TEST_ASSERT(loaded.equals(expected));
+		}
+
+		static int64_t get_payload_count(const String &path) {
+			sqlite::Connection con;
+			ZN_ASSERT_RETURN_V(
+					con.open(
+							zylann::godot::to_std_string(ProjectSettings::get_singleton()->globalize_path(path)).c_str(),
+							sqlite::BlockLocation::FORMAT_STRING_CSD
+					),
+					-1
+			);
+			return con.get_payload_count();
+		}
+	};
+
+	VoxelBuffer shared_vb(VoxelBuffer::ALLOCATOR_DEFAULT);
+	L::make_block(shared_vb, rng);
+	VoxelBuffer unique_vb1(VoxelBuffer::ALLOCATOR_DEFAULT);
+	L::make_block(unique_vb1, rng);
+	VoxelBuffer unique_vb2(VoxelBuffer::ALLOCATOR_DEFAULT);
+	L::make_block(unique_vb2, rng);
+
+	const unsigned int shared_count = 20;
+	const Vector3i unique_pos1(-1, 0, 0);
+	const Vector3i unique_pos2(-2, 0, 0);
+
+	{
+		Ref<VoxelStreamSQLite> stream;
+		stream.instantiate();
+		stream->set_deduplication_enabled(true);
+		stream->set_database_path(database_path);
+
+		for (unsigned int i = 0; i < shared_count; ++i) {
+			L::save(**stream, shared_vb, Vector3i(i, 0, 0));
+		}
+		L::save(**stream, unique_vb1, unique_pos1);
+		L::save(**stream, unique_vb2, unique_pos2);
+		stream->flush();
+	}
+
+	// Shared blocks must be stored once
+	ZN_TEST_ASSERT(L::get_payload_count(database_path) == 3);
+
+	{
+		// References are resolved even when deduplication is off
+		Ref<VoxelStreamSQLite> stream;
+		stream.instantiate();
+		stream->set_database_path(database_path);
+
+		for (unsigned int i = 0; i < shared_count; ++i) {
+			L::check(**stream, shared_vb, Vector3i(i, 0, 0));
+		}
+		L::check(**stream, unique_vb1, unique_pos1);
+		L::check(**stream, unique_vb2, unique_pos2);
+
+		// Overwriting a block must release what it referenced, even with deduplication off
+		L::save(**stream, shared_vb, unique_pos1);
+		stream->flush();
+	}
+
+	ZN_TEST_ASSERT(L::get_payload_count(database_path) == 2);
+
+	{
+		Ref<VoxelStreamSQLite> stream;
+		stream.instantiate();
+		stream->set_deduplication_enabled(true);
+		stream->set_database_path(database_path);
+
+		L::check(**stream, shared_vb, unique_pos1);
+
+		// Saving the same data again must not duplicate it
+		L::save(**stream, unique_vb2, unique_pos2);
+		stream->flush();
+		ZN_TEST_ASSERT(L::get_payload_count(database_path) == 2);
+
+		// Once nothing references shared data anymore, it gets removed
+		for (unsigned int i = 0; i < shared_count; ++i) {
+			L::save(**stream, unique_vb1, Vector3i(i, 0, 0));
+		}
+		stream->flush();
+		L::check(**stream, shared_vb, unique_pos1);
+		L::check(**stream, unique_vb1, Vector3i(0, 0, 0));
+	}
+
+	// The first shared payload is gone (`unique_pos1` stores that data inline because it was saved with deduplication
+	// off). Remaining payloads are `unique_vb2`, and `unique_vb1` now shared by the other blocks.
+	ZN_TEST_ASSERT(L::get_payload_count(database_path) == 2);
+}
+
+void test_voxel_stream_sqlite_deduplication_across_connections() {
+	zylann::testing::TestDirectory test_dir;
+	ZN_TEST_ASSERT(test_dir.is_valid());
+
+	const StdString database_path = zylann::godot::to_std_string(
+			ProjectSettings::get_singleton()->globalize_path(test_dir.get_path().path_join("database.sqlite"))
+	);
+
+	sqlite::Connection::Options deduplication_options;
+	deduplication_options.deduplication_enabled = true;
+
+	// Opened while the database has no payloads, with deduplication off
+	sqlite::Connection con_a;
+	ZN_TEST_ASSERT(con_a.open(database_path.c_str(), sqlite::BlockLocation::FORMAT_STRING_CSD));
+
+	sqlite::Connection con_b;
+	ZN_TEST_ASSERT(
+			con_b.open(database_path.c_str(), sqlite::BlockLocation::FORMAT_STRING_CSD, deduplication_options)
+	);
+
+	StdVector<uint8_t> shared_data;
+	shared_data.resize(4 * sqlite::Connection::DEDUPLICATION_MIN_SIZE);
+	for (unsigned int i = 0; i < shared_data.size(); ++i) {
+		shared_data[i] = i % 200;
+	}
+	const sqlite::BlockLocation loc0{ Vector3i(0, 0, 0), 0 };
+	const sqlite::BlockLocation loc1{ Vector3i(1, 0, 0), 0 };
+
+	ZN_TEST_ASSERT(con_b.begin_write_transaction());
+	ZN_TEST_ASSERT(con_b.save_block(loc0, to_span_const(shared_data), sqlite::Connection::VOXELS));
+	ZN_TEST_ASSERT(con_b.save_block(loc1, to_span_const(shared_data), sqlite::Connection::VOXELS));
+	ZN_TEST_ASSERT(con_b.end_transaction());
+	ZN_TEST_ASSERT(con_b.get_payload_count() == 1);
+
+	// The first connection must release references of blocks it overwrites, even though there were no payloads when it
+	// was opened
+	const uint8_t small_data_array[] = { 1, 2, 3, 4 };
+	const Span<const uint8_t> small_data(small_data_array, 4);
+	ZN_TEST_ASSERT(con_a.begin_write_transaction());
+	ZN_TEST_ASSERT(con_a.save_block(loc0, small_data, sqlite::Connection::VOXELS));
+	ZN_TEST_ASSERT(con_a.end_transaction());
+	ZN_TEST_ASSERT(con_a.get_payload_count() == 1);
+
+	ZN_TEST_ASSERT(con_a.begin_write_transaction());
+	ZN_TEST_ASSERT(con_a.save_block(loc1, small_data, sqlite::Connection::VOXELS));
+	ZN_TEST_ASSERT(con_a.end_transaction());
+	ZN_TEST_ASSERT(con_a.get_payload_count() == 0);
+}
+
+void test_voxel_stream_sqlite_deduplication_migration() {
+	zylann::testing::TestDirectory test_dir;
+	ZN_TEST_ASSERT(test_dir.is_valid());
+
+	const StdString database_path = zylann::godot::to_std_string(
+			ProjectSettings::get_singleton()->globalize_path(test_dir.get_path().path_join("database.sqlite"))
+	);
+
+	// Database as created by versions of the module before deduplication
+	{
+		sqlite3 *db = nullptr;
+		ZN_TEST_ASSERT(
+				sqlite3_open_v2(database_path.c_str(), &db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr) ==
+				SQLITE_OK
+		);
+		const StdString sql = format(
+				"CREATE TABLE meta (version INTEGER, block_size_po2 INTEGER, coordinate_format INTEGER);"
+				"CREATE TABLE blocks (loc TEXT PRIMARY KEY, vb BLOB, instances BLOB);"
+				"CREATE TABLE channels (idx INTEGER PRIMARY KEY, depth INTEGER);"
+				"INSERT INTO meta VALUES ({}, {}, {});",
+				sqlite::Connection::VERSION_V1,
+				constants::DEFAULT_BLOCK_SIZE_PO2,
+				static_cast<int>(sqlite::BlockLocation::FORMAT_STRING_CSD)
+		);
+		const int rc = sqlite3_exec(db, sql.c_str(), nullptr, nullptr, nullptr);
+		sqlite3_close(db);
+		ZN_TEST_ASSERT(rc == SQLITE_OK);
+	}
+
+	StdVector<uint8_t> shared_data;
+	shared_data.resize(4 * sqlite::Connection::DEDUPLICATION_MIN_SIZE);
+	for (unsigned int i = 0; i < shared_data.size(); ++i) {
+		shared_data[i] = i % 200;
+	}
+	const uint8_t small_data_array[] = { 1, 2, 3, 4 };
+	const Span<const uint8_t> small_data(small_data_array, 4);
+	const sqlite::BlockLocation loc0{ Vector3i(0, 0, 0), 0 };
+	const sqlite::BlockLocation loc1{ Vector3i(1, 0, 0), 0 };
+	const sqlite::BlockLocation loc2{ Vector3i(2, 0, 0), 0 };
+	StdVector<uint8_t> loaded_data;
+
+	// Without deduplication, the version is kept, so older versions of the module can still open the database
+	sqlite::Connection con_a;
+	ZN_TEST_ASSERT(con_a.open(database_path.c_str(), sqlite::BlockLocation::FORMAT_STRING_CSD));
+	ZN_TEST_ASSERT(con_a.get_meta().version == sqlite::Connection::VERSION_V1);
+	ZN_TEST_ASSERT(con_a.save_block(loc0, to_span_const(shared_data), sqlite::Connection::VOXELS));
+	ZN_TEST_ASSERT(con_a.get_payload_count() == 0);
+
+	// Deduplication upgrades it
+	sqlite::Connection::Options deduplication_options;
+	deduplication_options.deduplication_enabled = true;
+	sqlite::Connection con_b;
+	ZN_TEST_ASSERT(
+			con_b.open(database_path.c_str(), sqlite::BlockLocation::FORMAT_STRING_CSD, deduplication_options)
+	);
+	ZN_TEST_ASSERT(con_b.get_meta().version == sqlite::Connection::VERSION_V2);
+
+	ZN_TEST_ASSERT(con_b.begin_write_transaction());
+	ZN_TEST_ASSERT(con_b.save_block(loc1, to_span_const(shared_data), sqlite::Connection::VOXELS));
+	ZN_TEST_ASSERT(con_b.save_block(loc2, to_span_const(shared_data), sqlite::Connection::VOXELS));
+	ZN_TEST_ASSERT(con_b.end_transaction());
+	ZN_TEST_ASSERT(con_b.get_payload_count() == 1);
+
+	// Data saved before the upgrade is still readable
+	ZN_TEST_ASSERT(con_b.load_block(loc0, loaded_data, sqlite::Connection::VOXELS) == VoxelStream::RESULT_BLOCK_FOUND);
+	ZN_TEST_ASSERT(loaded_data == shared_data);
+
+	// The connection opened before the upgrade must notice it, resolve references, and release those of blocks it
+	// overwrites
+	ZN_TEST_ASSERT(con_a.begin_write_transaction());
+	ZN_TEST_ASSERT(con_a.save_block(loc1, small_data, sqlite::Connection::VOXELS));
+	ZN_TEST_ASSERT(con_a.end_transaction());
+	ZN_TEST_ASSERT(con_a.get_meta().version == sqlite::Connection::VERSION_V2);
+	ZN_TEST_ASSERT(con_a.get_payload_count() == 1);
+
+	ZN_TEST_ASSERT(con_a.load_block(loc2, loaded_data, sqlite::Connection::VOXELS) == VoxelStream::RESULT_BLOCK_FOUND);
+	ZN_TEST_ASSERT(loaded_data == shared_data);
+
+	ZN_TEST_ASSERT(con_a.begin_write_transaction());
+	ZN_TEST_ASSERT(con_a.save_block(loc2, small_data, sqlite::Connection::VOXELS));
+	ZN_TEST_ASSERT(con_a.end_transaction());
+	ZN_TEST_ASSERT(con_a.get_payload_count() == 0);
+
+	con_a.close();
+	con_b.close();
+
+	// Once upgraded, the version stays even without deduplication
+	sqlite::Connection con_c;
+	ZN_TEST_ASSERT(con_c.open(database_path.c_str(), sqlite::BlockLocation::FORMAT_STRING_CSD));
+	ZN_TEST_ASSERT(con_c.get_meta().version == sqlite::Connection::VERSION_V2);
+}
+
+void test_voxel_stream_sqlite_options() {
+	zylann::testing::TestDirectory test_dir;
+	ZN_TEST_ASSERT(test_dir.is_valid());
+
+	const StdString database_path = zylann::godot::to_std_string(
+			ProjectSettings::get_singleton()->globalize_path(test_dir.get_path().path_join("database.sqlite"))
+	);
+
+	struct L {
+		static StdString get_pragma(sqlite::Connection &con, const char *name) {
+			StdString value;
+			ZN_TEST_ASSERT(con.get_pragma(name, value));
+			return value;
+		}
+	};
+
+	{
+		sqlite::Connection::Options options;
+		options.wal_enabled = true;
+		options.synchronous = sqlite::Connection::SYNCHRONOUS_NORMAL;
+		options.mmap_size = 16 * 1024 * 1024;
+		options.page_size = 8192;
+
+		sqlite::Connection con;
+		ZN_TEST_ASSERT(con.open(database_path.c_str(), sqlite::BlockLocation::FORMAT_STRING_CSD, options));
+		ZN_TEST_ASSERT(L::get_pragma(con, "journal_mode") == "wal");
+		ZN_TEST_ASSERT(L::get_pragma(con, "synchronous") == "1");
+		ZN_TEST_ASSERT(L::get_pragma(con, "mmap_size") == "16777216");
+		// The database is new, so the page size applies
+		ZN_TEST_ASSERT(L::get_pragma(con, "page_size") == "8192");
+	}
+	{
+		// Default options must not convert an existing WAL database
+		sqlite::Connection con;
+		ZN_TEST_ASSERT(con.open(database_path.c_str(), sqlite::BlockLocation::FORMAT_STRING_CSD));
+		ZN_TEST_ASSERT(L::get_pragma(con, "journal_mode") == "wal");
+		ZN_TEST_ASSERT(L::get_pragma(con, "synchronous") == "2");
+		ZN_TEST_ASSERT(L::get_pragma(con, "mmap_size") == "0");
+		// Can't change once the database exists
+		ZN_TEST_ASSERT(L::get_pragma(con, "page_size") == "8192");
+	}
+	{
+		sqlite::Connection::Options options;
+		options.disable_wal = true;
+
+		sqlite::Connection con;
+		ZN_TEST_ASSERT(con.open(database_path.c_str(), sqlite::BlockLocation::FORMAT_STRING_CSD, options));
+		ZN_TEST_ASSERT(L::get_pragma(con, "journal_mode") == "delete");
+	}
+}
+
+namespace {
+void test_voxel_stream_sqlite_batch_save_load(
+		bool wal_enabled,
+		VoxelStreamSQLite::SynchronousMode synchronous_mode,
+		int64_t mmap_size
+) {
+	zylann::testing::TestDirectory test_dir;
+	ZN_TEST_ASSERT(test_dir.is_valid());
+
+	const String database_path = test_dir.get_path().path_join("database.sqlite");
+
+	const int grid_size = 10;
+	const Box3i block_box(Vector3i(-grid_size / 2, -2, -grid_size / 2), Vector3i(grid_size, 4, grid_size));
+
+	struct L {
+		static void make_block(VoxelBuffer &vb, unsigned int block_index) {
+			vb.create(Vector3iUtil::create(1 << constants::DEFAULT_BLOCK_SIZE_PO2));
+			vb.fill(block_index % 256, 0);
+			vb.set_voxel((block_index * 7 + 1) % 256, Vector3i(block_index % 16, (block_index / 16) % 16, 3), 0);
+		}
+
+		static void check_pragmas(
+				VoxelStreamSQLite &stream,
+				bool wal_enabled,
+				VoxelStreamSQLite::SynchronousMode synchronous_mode,
+				int64_t mmap_size
+		) {
+			StdString value;
+			ZN_TEST_ASSERT(stream.get_connection_pragma("journal_mode", value));
+			ZN_TEST_ASSERT(value == (wal_enabled ? "wal" : "delete"));
+			ZN_TEST_ASSERT(stream.get_connection_pragma("synchronous", value));
+			ZN_TEST_ASSERT(value == format("{}", static_cast<int>(synchronous_mode)));
+			ZN_TEST_ASSERT(stream.get_connection_pragma("mmap_size", value));
+			ZN_TEST_ASSERT(value == format("{}", mmap_size));
+		}
+	};
+
+	// Save a lot of blocks at once, which will be flushed in a single transaction
+	{
+		Ref<VoxelStreamSQLite> stream;
+		stream.instantiate();
+		stream->set_wal_enabled(wal_enabled);
+		stream->set_synchronous_mode(synchronous_mode);
+		stream->set_mmap_size(mmap_size);
+		stream->set_database_path(database_path);
+
+		unsigned int block_index = 0;
+		block_box.for_each_cell_zxy([&stream, &block_index](Vector3i bpos) {
+			VoxelBuffer vb(VoxelBuffer::ALLOCATOR_DEFAULT);
+			L::make_block(vb, block_index);
+			VoxelStreamSQLite::VoxelQueryData q{ vb, bpos, 0, VoxelStreamSQLite::RESULT_ERROR };
+			stream->save_voxel_block(q);
+			++block_index;
+		});
+
+		stream->flush();
+
+		L::check_pragmas(**stream, wal_enabled, synchronous_mode, mmap_size);
+	}
+
+	// Reopen with the same settings and read them back
+	{
+		Ref<VoxelStreamSQLite> stream;
+		stream.instantiate();
+		stream->set_wal_enabled(wal_enabled);
+		stream->set_synchronous_mode(synchronous_mode);
+		stream->set_mmap_size(mmap_size);
+		stream->set_database_path(database_path);
+
+		VoxelBuffer vb(VoxelBuffer::ALLOCATOR_DEFAULT);
+		VoxelBuffer expected_vb(VoxelBuffer::ALLOCATOR_DEFAULT);
+		unsigned int block_index = 0;
+		block_box.for_each_cell_zxy([&stream, &vb, &expected_vb, &block_index](Vector3i bpos) {
+			VoxelStreamSQLite::VoxelQueryData q{ vb, bpos, 0, VoxelStreamSQLite::RESULT_ERROR };
+			stream->load_voxel_block(q);
+			ZN_TEST_ASSERT(q.result == VoxelStreamSQLite::RESULT_BLOCK_FOUND);
+			L::make_block(expected_vb, block_index);
+			ZN_TEST_ASSERT(vb.equals(expected_vb));
+			++block_index;
+		});
+
+		L::check_pragmas(**stream, wal_enabled, synchronous_mode, mmap_size);
+	}
+}
+} // namespace
+
+void test_voxel_stream_sqlite_batch_save_load() {
+	// Default settings, matching SQLite's defaults
+	test_voxel_stream_sqlite_batch_save_load(false, VoxelStreamSQLite::SYNCHRONOUS_FULL, 0);
+	// Settings recommended for games, where losing the last saves on power loss is acceptable
+	test_voxel_stream_sqlite_batch_save_load(true, VoxelStreamSQLite::SYNCHRONOUS_NORMAL, 0);
+	test_voxel_stream_sqlite_batch_save_load(true, VoxelStreamSQLite::SYNCHRONOUS_NORMAL, 64 * 1024 * 1024);
+}
+
 } // namespace zylann::voxel::tests
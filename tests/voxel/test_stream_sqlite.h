@@ -7,6 +7,13 @@ void test_voxel_stream_sqlite_basic();
 void test_voxel_stream_sqlite_coordinate_format();
 void test_voxel_stream_sqlite_key_string_csd_encoding();
 void test_voxel_stream_sqlite_key_blob80_encoding();
+void test_voxel_stream_sqlite_prefetch();
+void test_voxel_stream_cache_prefetch();
+void test_voxel_stream_sqlite_deduplication();
+void test_voxel_stream_sqlite_deduplication_across_connections();
+void test_voxel_stream_sqlite_deduplication_migration();
+void test_voxel_stream_sqlite_options();
+void test_voxel_stream_sqlite_batch_save_load();
 
 } // namespace zylann::voxel::tests
 
@@ -1,5 +1,9 @@
 #include "test_util.h"
 #include "../../storage/voxel_buffer.h"
+#include "../../util/godot/classes/mesh.h"
+#include "../../util/godot/core/packed_arrays.h"
+#include "../../util/memory/memory.h"
+#include <algorithm>
 
 namespace zylann::voxel::tests {
 
@@ -46,4 +50,89 @@ bool sd_equals_approx(const VoxelBuffer &vb1, const VoxelBuffer &vb2) {
 	return true;
 }
 
+unsigned int get_fifo_vertex_cache_miss_count(Span<const int32_t> indices, unsigned int cache_size) {
+	StdVector<int32_t> cache;
+	cache.resize(cache_size, -1);
+	unsigned int next_entry = 0;
+	unsigned int miss_count = 0;
+	for (const int32_t index : indices) {
+		if (std::find(cache.begin(), cache.end(), index) != cache.end()) {
+			continue;
+		}
+		cache[next_entry] = index;
+		next_entry = (next_entry + 1) % cache_size;
+		++miss_count;
+	}
+	return miss_count;
+}
+
+StdVector<TrianglePositions> get_sorted_triangles(Span<const Vector3> positions, Span<const int32_t> indices) {
+	StdVector<TrianglePositions> triangles;
+	triangles.reserve(indices.size() / 3);
+	for (unsigned int i = 0; i + 2 < indices.size(); i += 3) {
+		TrianglePositions t{ positions[indices[i]], positions[indices[i + 1]], positions[indices[i + 2]] };
+		// Rotate so the smallest vertex comes first, which keeps the winding
+		if (t.b < t.a && t.b < t.c) {
+			t = TrianglePositions{ t.b, t.c, t.a };
+		} else if (t.c < t.a && t.c < t.b) {
+			t = TrianglePositions{ t.c, t.a, t.b };
+		}
+		triangles.push_back(t);
+	}
+	std::sort(triangles.begin(), triangles.end());
+	return triangles;
+}
+
+StdVector<std::shared_ptr<VoxelBuffer>> split_into_blocks(const VoxelBuffer &src, unsigned int block_size) {
+	const Vector3i grid_size = src.get_size() / static_cast<int>(block_size);
+	ZN_ASSERT(grid_size * static_cast<int>(block_size) == src.get_size());
+
+	StdVector<std::shared_ptr<VoxelBuffer>> blocks;
+	Vector3i bpos;
+	for (bpos.z = 0; bpos.z < grid_size.z; ++bpos.z) {
+		for (bpos.x = 0; bpos.x < grid_size.x; ++bpos.x) {
+			for (bpos.y = 0; bpos.y < grid_size.y; ++bpos.y) {
+				std::shared_ptr<VoxelBuffer> block = make_shared_instance<VoxelBuffer>(VoxelBuffer::ALLOCATOR_DEFAULT);
+				block->copy_format(src);
+				block->create(Vector3iUtil::create(block_size));
+				const Vector3i src_min = bpos * static_cast<int>(block_size);
+				const Vector3i src_max = src_min + Vector3iUtil::create(block_size);
+				for (unsigned int channel_index = 0; channel_index < VoxelBuffer::MAX_CHANNELS; ++channel_index) {
+					block->copy_channel_from(src, src_min, src_max, Vector3i(), channel_index);
+				}
+				block->compress_uniform_channels();
+				blocks.push_back(block);
+			}
+		}
+	}
+	return blocks;
+}
+
+bool mesher_outputs_equal(const VoxelMesher::Output &a, const VoxelMesher::Output &b) {
+	if (a.surfaces.size() != b.surfaces.size()) {
+		return false;
+	}
+	for (unsigned int i = 0; i < a.surfaces.size(); ++i) {
+		const VoxelMesher::Output::Surface &sa = a.surfaces[i];
+		const VoxelMesher::Output::Surface &sb = b.surfaces[i];
+		if (sa.material_index != sb.material_index || sa.arrays.size() != sb.arrays.size()) {
+			return false;
+		}
+		if (sa.arrays.size() == 0) {
+			continue;
+		}
+		const PackedVector3Array positions_a = sa.arrays[Mesh::ARRAY_VERTEX];
+		const PackedVector3Array positions_b = sb.arrays[Mesh::ARRAY_VERTEX];
+		const PackedVector3Array normals_a = sa.arrays[Mesh::ARRAY_NORMAL];
+		const PackedVector3Array normals_b = sb.arrays[Mesh::ARRAY_NORMAL];
+		const PackedInt32Array indices_a = sa.arrays[Mesh::ARRAY_INDEX];
+		const PackedInt32Array indices_b = sb.arrays[Mesh::ARRAY_INDEX];
+		if (positions_a != positions_b || normals_a != normals_b || indices_a != indices_b) {
+			return false;
+		}
+	}
+	return a.collision_surface.positions == b.collision_surface.positions &&
+			a.collision_surface.indices == b.collision_surface.indices;
+}
+
 } // namespace zylann::voxel::tests
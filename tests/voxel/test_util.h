@@ -1,6 +1,13 @@
 #ifndef VOXEL_TEST_UTIL_H
 #define VOXEL_TEST_UTIL_H
 
+#include "../../meshers/voxel_mesher.h"
+#include "../../util/containers/span.h"
+#include "../../util/containers/std_vector.h"
+#include "../../util/godot/core/vector3.h"
+#include <cstdint>
+#include <memory>
+
 namespace zylann::voxel {
 
 class VoxelBuffer;
@@ -9,6 +16,41 @@ namespace tests {
 
 bool sd_equals_approx(const VoxelBuffer &vb1, const VoxelBuffer &vb2);
 
+// Simulates a FIFO post-transform vertex cache, and returns how many vertices had to be transformed. Divided by the
+// number of triangles, this is the average cache miss ratio (ACMR).
+unsigned int get_fifo_vertex_cache_miss_count(Span<const int32_t> indices, unsigned int cache_size);
+
+struct TrianglePositions {
+	Vector3 a;
+	Vector3 b;
+	Vector3 c;
+
+	bool operator==(const TrianglePositions &other) const {
+		return a == other.a && b == other.b && c == other.c;
+	}
+
+	bool operator<(const TrianglePositions &other) const {
+		if (a != other.a) {
+			return a < other.a;
+		}
+		if (b != other.b) {
+			return b < other.b;
+		}
+		return c < other.c;
+	}
+};
+
+// Gets triangles as positions, in an order that doesn't depend on the order of triangles and vertices, so meshes
+// can be compared after they were reordered. Winding is preserved.
+StdVector<TrianglePositions> get_sorted_triangles(Span<const Vector3> positions, Span<const int32_t> indices);
+
+// Splits a buffer into a grid of blocks in ZXY order, like those given to meshing tasks. The size of the buffer must be
+// a multiple of `block_size`. Channels having the same value in a whole block are left uniform in that block.
+StdVector<std::shared_ptr<VoxelBuffer>> split_into_blocks(const VoxelBuffer &src, unsigned int block_size);
+
+// Returns true if both outputs have the same surfaces, with vertices and indices in the same order.
+bool mesher_outputs_equal(const VoxelMesher::Output &a, const VoxelMesher::Output &b);
+
 } // namespace tests
 } // namespace zylann::voxel
 
@@ -0,0 +1,151 @@
+#include "test_voxel_archive.h"
+#include "../../storage/voxel_buffer.h"
+#include "../../streams/instance_data.h"
+#include "../../streams/voxel_archive.h"
+#include "../../streams/voxel_stream_memory.h"
+#include "../../util/godot/classes/file_access.h"
+#include "../../util/godot/core/random_pcg.h"
+#include "../../util/testing/test_directory.h"
+#include "../../util/testing/test_macros.h"
+
+namespace zylann::voxel::tests {
+
+void test_voxel_archive() {
+	zylann::testing::TestDirectory test_dir;
+	ZN_TEST_ASSERT(test_dir.is_valid());
+	const String archive_path = test_dir.get_path().path_join("test.vxa");
+
+	Ref<VoxelStreamMemory> src_stream;
+	src_stream.instantiate();
+
+	const int block_size = 1 << src_stream->get_block_size_po2();
+
+	RandomPCG rng;
+	rng.seed(131183);
+
+	struct SavedBlock {
+		Vector3i position;
+		uint8_t lod_index;
+	};
+	StdVector<SavedBlock> saved_blocks;
+
+	// Enough blocks to fill multiple chunks, at various LODs and on both sides of the origin
+	VoxelBuffer voxels(VoxelBuffer::ALLOCATOR_DEFAULT);
+	for (int i = 0; i < 300; ++i) {
+		const Vector3i bpos(
+				static_cast<int>(rng.rand() % 20) - 10, //
+				static_cast<int>(rng.rand() % 20) - 10, //
+				static_cast<int>(rng.rand() % 20) - 10 //
+		);
+		const uint8_t lod_index = rng.rand() % 3;
+
+		voxels.create(Vector3iUtil::create(block_size));
+		voxels.set_channel_depth(VoxelBuffer::CHANNEL_SDF, VoxelBuffer::DEPTH_16_BIT);
+
+		if (i % 4 == 0) {
+			// Uniform
+			voxels.clear_channel(VoxelBuffer::CHANNEL_TYPE, rng.rand() % 256);
+		} else {
+			for (int z = 0; z < block_size; ++z) {
+				for (int x = 0; x < block_size; ++x) {
+					for (int y = 0; y < block_size; ++y) {
+						voxels.set_voxel(rng.rand() % 4, x, y, z, VoxelBuffer::CHANNEL_TYPE);
+						voxels.set_voxel(rng.rand() % 65536, x, y, z, VoxelBuffer::CHANNEL_SDF);
+					}
+				}
+			}
+		}
+		if (i % 7 == 0) {
+			voxels.get_or_create_voxel_metadata(Vector3i(1, 2, 3))->set_u64(i);
+		}
+
+		VoxelStream::VoxelQueryData q{ voxels, bpos, lod_index, VoxelStream::RESULT_ERROR };
+		src_stream->save_voxel_block(q);
+		saved_blocks.push_back(SavedBlock{ bpos, lod_index });
+	}
+
+#ifdef VOXEL_ENABLE_INSTANCER
+	{
+		UniquePtr<InstanceBlockData> instances = make_unique_instance<InstanceBlockData>();
+		instances->position_range = block_size;
+		InstanceBlockData::LayerData layer;
+		layer.id = 1;
+		layer.scale_min = 1.f;
+		layer.scale_max = 1.f;
+		layer.instances.resize(3);
+		instances->layers.push_back(layer);
+
+		VoxelStream::InstancesQueryData q{ std::move(instances), Vector3i(100, 0, 0), 0, VoxelStream::RESULT_ERROR };
+		src_stream->save_instance_blocks(Span<VoxelStream::InstancesQueryData>(&q, 1));
+	}
+#endif
+
+	ZN_TEST_ASSERT(VoxelArchive::export_stream(**src_stream, archive_path));
+	// The archive is written to a temporary file first
+	ZN_TEST_ASSERT(FileAccess::exists(archive_path));
+	ZN_TEST_ASSERT(!FileAccess::exists(archive_path + ".tmp"));
+
+	Ref<VoxelStreamMemory> dst_stream;
+	dst_stream.instantiate();
+	ZN_TEST_ASSERT(VoxelArchive::import_stream(archive_path, **dst_stream));
+
+	VoxelBuffer expected_voxels(VoxelBuffer::ALLOCATOR_DEFAULT);
+	VoxelBuffer loaded_voxels(VoxelBuffer::ALLOCATOR_DEFAULT);
+
+	for (const SavedBlock &block : saved_blocks) {
+		VoxelStream::VoxelQueryData expected_q{ expected_voxels, block.position, block.lod_index,
+												VoxelStream::RESULT_ERROR };
+		src_stream->load_voxel_block(expected_q);
+		ZN_TEST_ASSERT(expected_q.result == VoxelStream::RESULT_BLOCK_FOUND);
+
+		VoxelStream::VoxelQueryData loaded_q{ loaded_voxels, block.position, block.lod_index,
+											  VoxelStream::RESULT_ERROR };
+		dst_stream->load_voxel_block(loaded_q);
+		ZN_TEST_ASSERT(loaded_q.result == VoxelStream::RESULT_BLOCK_FOUND);
+
+		ZN_TEST_ASSERT(expected_voxels.equals(loaded_voxels));
+	}
+
+	VoxelStream::FullLoadingResult src_result;
+	src_stream->load_all_blocks(src_result);
+	{
+		// Export lists blocks without loading them all at once
+		StdVector<VoxelStream::BlockKey> src_keys;
+		src_stream->load_all_block_keys(src_keys);
+		ZN_TEST_ASSERT(src_keys.size() == src_result.blocks.size());
+	}
+	{
+		VoxelStream::FullLoadingResult dst_result;
+		dst_stream->load_all_blocks(dst_result);
+		ZN_TEST_ASSERT(src_result.blocks.size() == dst_result.blocks.size());
+	}
+
+#ifdef VOXEL_ENABLE_INSTANCER
+	{
+		VoxelStream::InstancesQueryData q{ nullptr, Vector3i(100, 0, 0), 0, VoxelStream::RESULT_ERROR };
+		dst_stream->load_instance_blocks(Span<VoxelStream::InstancesQueryData>(&q, 1));
+		ZN_TEST_ASSERT(q.data != nullptr);
+		ZN_TEST_ASSERT(q.data->layers.size() == 1);
+		ZN_TEST_ASSERT(q.data->layers[0].id == 1);
+		ZN_TEST_ASSERT(q.data->layers[0].instances.size() == 3);
+	}
+#endif
+
+	// Read the archive directly
+	{
+		uint8_t block_size_po2 = 0;
+		struct L {
+			static bool process(void *callback_data, Span<VoxelStream::FullLoadingResult::Block> blocks) {
+				unsigned int &count = *static_cast<unsigned int *>(callback_data);
+				count += blocks.size();
+				return true;
+			}
+		};
+		unsigned int count = 0;
+		ZN_TEST_ASSERT(VoxelArchive::load_blocks(archive_path, &count, L::process, block_size_po2));
+		ZN_TEST_ASSERT(block_size_po2 == src_stream->get_block_size_po2());
+		ZN_TEST_ASSERT(count == src_result.blocks.size());
+	}
+}
+
+} // namespace zylann::voxel::tests
@@ -0,0 +1,10 @@
+#ifndef VOXEL_TEST_VOXEL_ARCHIVE_H
+#define VOXEL_TEST_VOXEL_ARCHIVE_H
+
+namespace zylann::voxel::tests {
+
+void test_voxel_archive();
+
+} // namespace zylann::voxel::tests
+
+#endif // VOXEL_TEST_VOXEL_ARCHIVE_H
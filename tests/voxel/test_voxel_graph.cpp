@@ -4,22 +4,35 @@
 #include "../../generators/graph/image_utility.h"
 #include "../../generators/graph/node_type_db.h"
 #include "../../generators/graph/voxel_generator_graph.h"
+#include "../../generators/graph/voxel_graph_cpp_generator.h"
 #include "../../storage/mixel4.h"
 #include "../../storage/voxel_buffer.h"
 #include "../../util/containers/container_funcs.h"
 #include "../../util/containers/std_vector.h"
 #include "../../util/godot/classes/fast_noise_lite.h"
+#include "../../util/godot/classes/file_access.h"
 #include "../../util/godot/classes/image.h"
+#include "../../util/godot/classes/project_settings.h"
 #include "../../util/godot/core/random_pcg.h"
+#include "../../util/hash_funcs.h"
 #include "../../util/math/conv.h"
 #include "../../util/math/sdf.h"
 #include "../../util/noise/fast_noise_lite/fast_noise_lite.h"
 #include "../../util/string/format.h"
 #include "../../util/string/std_string.h"
+#include "../../util/testing/test_directory.h"
 #include "../../util/testing/test_macros.h"
 #include "test_util.h"
+#include <cstdlib>
+#include <cstring>
 #include <sstream>
 
+#if defined(__unix__) || defined(__APPLE__)
+// Used to load C++ code generated from graphs, after compiling it with the compiler installed on the system
+#include <dlfcn.h>
+#define VOXEL_TESTS_CAN_LOAD_GENERATED_CPP
+#endif
+
 #ifdef VOXEL_ENABLE_FAST_NOISE_2
 #include "../../util/noise/fast_noise_2.h"
 #endif
@@ -2440,4 +2453,1091 @@ void test_voxel_graph_constant_reduction() {
 	ZN_TEST_ASSERT(graph->equals(**expected_graph));
 }
 
+void test_voxel_graph_simd_kernels() {
+	// X, Y, Z --- Sphere --- SmoothUnion --- Divide --- OutSDF
+	//                       /               /
+	// X, Y, Z --- Box ------               Y
+
+	static const float RADIUS = 5.f;
+	static const float BOX_SIZE = 4.f;
+	static const float SMOOTHNESS = 2.f;
+
+	Ref<VoxelGeneratorGraph> generator;
+	generator.instantiate();
+	{
+		VoxelGraphFunction &g = **generator->get_main_function();
+
+		const uint32_t n_in_x = g.create_node(VoxelGraphFunction::NODE_INPUT_X);
+		const uint32_t n_in_y = g.create_node(VoxelGraphFunction::NODE_INPUT_Y);
+		const uint32_t n_in_z = g.create_node(VoxelGraphFunction::NODE_INPUT_Z);
+		const uint32_t n_sphere = g.create_node(VoxelGraphFunction::NODE_SDF_SPHERE);
+		const uint32_t n_box = g.create_node(VoxelGraphFunction::NODE_SDF_BOX);
+		const uint32_t n_union = g.create_node(VoxelGraphFunction::NODE_SDF_SMOOTH_UNION);
+		const uint32_t n_divide = g.create_node(VoxelGraphFunction::NODE_DIVIDE);
+		const uint32_t n_out_sdf = g.create_node(VoxelGraphFunction::NODE_OUTPUT_SDF);
+
+		g.set_node_default_input(n_sphere, 3, RADIUS);
+		g.set_node_param(n_box, 0, BOX_SIZE);
+		g.set_node_param(n_box, 1, BOX_SIZE);
+		g.set_node_param(n_box, 2, BOX_SIZE);
+		g.set_node_param(n_union, 0, SMOOTHNESS);
+
+		g.add_connection(n_in_x, 0, n_sphere, 0);
+		g.add_connection(n_in_y, 0, n_sphere, 1);
+		g.add_connection(n_in_z, 0, n_sphere, 2);
+		g.add_connection(n_in_x, 0, n_box, 0);
+		g.add_connection(n_in_y, 0, n_box, 1);
+		g.add_connection(n_in_z, 0, n_box, 2);
+		g.add_connection(n_sphere, 0, n_union, 0);
+		g.add_connection(n_box, 0, n_union, 1);
+		g.add_connection(n_union, 0, n_divide, 0);
+		g.add_connection(n_in_y, 0, n_divide, 1);
+		g.add_connection(n_divide, 0, n_out_sdf, 0);
+	}
+	const CompilationResult result = generator->compile(false);
+	ZN_TEST_ASSERT_MSG(result.success, result.message);
+
+	// Not a multiple of the SIMD width, so both vectorized and remaining scalar iterations run
+	static const unsigned int COUNT = 23;
+	StdVector<float> xs;
+	StdVector<float> ys;
+	StdVector<float> zs;
+	for (unsigned int i = 0; i < COUNT; ++i) {
+		xs.push_back(static_cast<float>(i) - 10.f);
+		ys.push_back(static_cast<float>(i % 5) - 2.f);
+		zs.push_back(static_cast<float>(i) * 0.5f);
+	}
+	StdVector<float> sdf;
+	sdf.resize(COUNT);
+
+	generator->generate_series(
+			to_span(xs),
+			to_span(ys),
+			to_span(zs),
+			VoxelBuffer::CHANNEL_SDF,
+			to_span(sdf),
+			Vector3f(-10.f, -2.f, 0.f),
+			Vector3f(12.f, 2.f, 11.f)
+	);
+
+	for (unsigned int i = 0; i < COUNT; ++i) {
+		const Vector3f pos(xs[i], ys[i], zs[i]);
+		const float sphere = math::length(pos) - RADIUS;
+		const float box = math::sdf_box(pos, Vector3f(BOX_SIZE));
+		const float expected = pos.y == 0.f ? 0.f : math::sdf_smooth_union(sphere, box, SMOOTHNESS) / pos.y;
+		ZN_TEST_ASSERT(Math::abs(sdf[i] - expected) < 0.0001f);
+	}
+}
+
+void load_graph_with_elementwise_chain(VoxelGraphFunction &g) {
+	// Long chain of elementwise nodes, which can re-use each other's buffer data and run fused over tiles.
+	//
+	// X, Y, Z --- Sphere --- Abs --- Multiply --- Add --- Clamp --- Mix --- Remap --- Min --- OutSDF
+	//                                /            /                /  |               /
+	//                               Y            Z    X, Y, Z --- Box |              Y
+	//                                                                 |
+	//                                              X, Y, Z --- Normalize (nx)
+
+	const uint32_t n_in_x = g.create_node(VoxelGraphFunction::NODE_INPUT_X);
+	const uint32_t n_in_y = g.create_node(VoxelGraphFunction::NODE_INPUT_Y);
+	const uint32_t n_in_z = g.create_node(VoxelGraphFunction::NODE_INPUT_Z);
+	const uint32_t n_normalize = g.create_node(VoxelGraphFunction::NODE_NORMALIZE_3D);
+	const uint32_t n_sphere = g.create_node(VoxelGraphFunction::NODE_SDF_SPHERE);
+	const uint32_t n_abs = g.create_node(VoxelGraphFunction::NODE_ABS);
+	const uint32_t n_mul = g.create_node(VoxelGraphFunction::NODE_MULTIPLY);
+	const uint32_t n_add = g.create_node(VoxelGraphFunction::NODE_ADD);
+	const uint32_t n_clamp = g.create_node(VoxelGraphFunction::NODE_CLAMP);
+	const uint32_t n_box = g.create_node(VoxelGraphFunction::NODE_SDF_BOX);
+	const uint32_t n_mix = g.create_node(VoxelGraphFunction::NODE_MIX);
+	const uint32_t n_remap = g.create_node(VoxelGraphFunction::NODE_REMAP);
+	const uint32_t n_min = g.create_node(VoxelGraphFunction::NODE_MIN);
+	const uint32_t n_out_sdf = g.create_node(VoxelGraphFunction::NODE_OUTPUT_SDF);
+
+	g.set_node_default_input(n_sphere, 3, 10.f);
+	g.set_node_default_input(n_clamp, 1, -20.f);
+	g.set_node_default_input(n_clamp, 2, 20.f);
+	g.set_node_param(n_box, 0, 6.f);
+	g.set_node_param(n_box, 1, 3.f);
+	g.set_node_param(n_box, 2, 8.f);
+	g.set_node_param(n_remap, 0, -1.f);
+	g.set_node_param(n_remap, 1, 1.f);
+	g.set_node_param(n_remap, 2, -2.f);
+	g.set_node_param(n_remap, 3, 3.f);
+
+	g.add_connection(n_in_x, 0, n_normalize, 0);
+	g.add_connection(n_in_y, 0, n_normalize, 1);
+	g.add_connection(n_in_z, 0, n_normalize, 2);
+	g.add_connection(n_in_x, 0, n_sphere, 0);
+	g.add_connection(n_in_y, 0, n_sphere, 1);
+	g.add_connection(n_in_z, 0, n_sphere, 2);
+	g.add_connection(n_sphere, 0, n_abs, 0);
+	g.add_connection(n_abs, 0, n_mul, 0);
+	g.add_connection(n_in_y, 0, n_mul, 1);
+	g.add_connection(n_mul, 0, n_add, 0);
+	g.add_connection(n_in_z, 0, n_add, 1);
+	g.add_connection(n_add, 0, n_clamp, 0);
+	g.add_connection(n_in_x, 0, n_box, 0);
+	g.add_connection(n_in_y, 0, n_box, 1);
+	g.add_connection(n_in_z, 0, n_box, 2);
+	g.add_connection(n_clamp, 0, n_mix, 0);
+	g.add_connection(n_box, 0, n_mix, 1);
+	g.add_connection(n_normalize, 0, n_mix, 2);
+	g.add_connection(n_mix, 0, n_remap, 0);
+	g.add_connection(n_remap, 0, n_min, 0);
+	g.add_connection(n_in_y, 0, n_min, 1);
+	g.add_connection(n_min, 0, n_out_sdf, 0);
+}
+
+void test_voxel_graph_elementwise_fusion() {
+	Ref<VoxelGeneratorGraph> generator_debug;
+	generator_debug.instantiate();
+	load_graph_with_elementwise_chain(**generator_debug->get_main_function());
+	{
+		// Debug compilation gives unique data to every buffer
+		const CompilationResult result = generator_debug->compile(true);
+		ZN_TEST_ASSERT_MSG(result.success, result.message);
+	}
+
+	Ref<VoxelGeneratorGraph> generator;
+	generator.instantiate();
+	load_graph_with_elementwise_chain(**generator->get_main_function());
+	{
+		const CompilationResult result = generator->compile(false);
+		ZN_TEST_ASSERT_MSG(result.success, result.message);
+	}
+
+	// Blocks are larger than fusion tiles, so this also covers tiled execution
+	ZN_TEST_ASSERT(check_graph_results_are_equal(**generator_debug, **generator));
+}
+
+void test_voxel_graph_cpp_generation() {
+	struct L {
+		static pg::CompilationResult generate(const VoxelGraphFunction &g, StdString &out_code) {
+			StdVector<ShaderOutput> outputs;
+			const pg::CompilationResult result =
+					pg::generate_cpp(g.get_graph(), g.get_input_definitions(), "test_graph", out_code, outputs);
+			if (result.success) {
+				ZN_TEST_ASSERT(outputs.size() == 1);
+				ZN_TEST_ASSERT(outputs[0].type == ShaderOutput::TYPE_SDF);
+			}
+			return result;
+		}
+	};
+	{
+		Ref<VoxelGraphFunction> graph;
+		graph.instantiate();
+		load_graph_with_sphere_on_plane(**graph, 6.f);
+		StdString code;
+		const pg::CompilationResult result = L::generate(**graph, code);
+		ZN_TEST_ASSERT_MSG(result.success, result.message);
+		ZN_TEST_ASSERT(code.find("extern \"C\" void test_graph(") != StdString::npos);
+		ZN_TEST_ASSERT(code.find("vg_sdf_smooth_union") != StdString::npos);
+	}
+	{
+		// Expressions are expanded into regular nodes
+		Ref<VoxelGraphFunction> graph;
+		graph.instantiate();
+		load_graph_with_expression(**graph);
+		StdString code;
+		const pg::CompilationResult result = L::generate(**graph, code);
+		ZN_TEST_ASSERT_MSG(result.success, result.message);
+		ZN_TEST_ASSERT(code.find("extern \"C\" void test_graph(") != StdString::npos);
+	}
+	{
+		// Noise nodes can only be converted to shaders
+		Ref<VoxelGraphFunction> graph;
+		graph.instantiate();
+		load_graph_with_expression_and_noises(**graph, nullptr);
+		StdString code;
+		const pg::CompilationResult result = L::generate(**graph, code);
+		ZN_TEST_ASSERT(!result.success);
+	}
+}
+
+#ifdef VOXEL_TESTS_CAN_LOAD_GENERATED_CPP
+
+namespace {
+
+// Compiles generated code into a shared library and loads its entry point. Returns null if that failed.
+NativeGraphFunction compile_and_load_generated_cpp(
+		const StdString &code,
+		const String &dir,
+		const StdString &function_name,
+		void *&out_library
+) {
+	const String src_path = ProjectSettings::get_singleton()->globalize_path(dir.path_join("graph.cpp"));
+	const String lib_path = ProjectSettings::get_singleton()->globalize_path(
+			dir.path_join(String::utf8(function_name.c_str()) + ".so")
+	);
+	{
+		Ref<FileAccess> f = FileAccess::open(src_path, FileAccess::WRITE);
+		ZN_ASSERT_RETURN_V(f.is_valid(), nullptr);
+		f->store_string(String::utf8(code.c_str()));
+	}
+
+	const StdString command = format(
+			"c++ -std=c++17 -O2 -shared -fPIC -o \"{}\" \"{}\"",
+			zylann::godot::to_std_string(lib_path),
+			zylann::godot::to_std_string(src_path)
+	);
+	if (std::system(command.c_str()) != 0) {
+		ZN_PRINT_ERROR(format("Failed to compile generated code: {}", command));
+		return nullptr;
+	}
+
+	// Local binding so every compiled graph gets its own symbols, even if they have the same name
+	out_library = dlopen(zylann::godot::to_std_string(lib_path).c_str(), RTLD_NOW | RTLD_LOCAL);
+	ZN_ASSERT_RETURN_V_MSG(out_library != nullptr, nullptr, dlerror());
+	return reinterpret_cast<NativeGraphFunction>(dlsym(out_library, function_name.c_str()));
+}
+
+} // namespace
+
+#endif
+
+// Runs C++ code generated from graphs and compares it with the runtime, which is the reference implementation.
+void test_voxel_graph_cpp_generation_matches_runtime() {
+#ifdef VOXEL_TESTS_CAN_LOAD_GENERATED_CPP
+	if (std::system("c++ --version > /dev/null 2>&1") != 0) {
+		ZN_PRINT_WARNING("No C++ compiler found, generated graph code can't be tested");
+		return;
+	}
+
+	struct L {
+		static void check(void (*load_graph)(VoxelGraphFunction &), const StdString &function_name) {
+			Ref<VoxelGeneratorGraph> generator;
+			generator.instantiate();
+			VoxelGraphFunction &g = **generator->get_main_function();
+			load_graph(g);
+
+			StdString code;
+			StdVector<ShaderOutput> outputs;
+			const CompilationResult cpp_result =
+					generate_cpp(g.get_graph(), g.get_input_definitions(), function_name, code, outputs);
+			ZN_TEST_ASSERT_MSG(cpp_result.success, cpp_result.message);
+			ZN_TEST_ASSERT(outputs.size() == 1);
+			ZN_TEST_ASSERT(outputs[0].type == ShaderOutput::TYPE_SDF);
+
+			zylann::testing::TestDirectory test_dir;
+			ZN_TEST_ASSERT(test_dir.is_valid());
+			void *library = nullptr;
+			NativeGraphFunction native_func =
+					compile_and_load_generated_cpp(code, test_dir.get_path(), function_name, library);
+			ZN_TEST_ASSERT(native_func != nullptr);
+
+			// Don't let range analysis clip values, the generated code has no such thing
+			generator->set_sdf_clip_threshold(10000.f);
+			const CompilationResult result = generator->compile(false);
+			ZN_TEST_ASSERT_MSG(result.success, result.message);
+
+			// Integer coordinates go through `generate_single`, others through `generate_points`.
+			// X is never zero, normalizing a zero vector gives NaN.
+			StdVector<float> x;
+			StdVector<float> y;
+			StdVector<float> z;
+			for (int pz = -12; pz <= 12; pz += 3) {
+				for (int py = -12; py <= 12; py += 2) {
+					for (int px = -11; px <= 12; px += 3) {
+						x.push_back(px);
+						y.push_back(py);
+						z.push_back(pz);
+						x.push_back(px + 0.37f);
+						y.push_back(py - 0.61f);
+						z.push_back(pz + 0.25f);
+					}
+				}
+			}
+
+			StdVector<float> native_sdf;
+			native_sdf.resize(x.size());
+			float *native_outputs[] = { native_sdf.data() };
+			native_func(x.data(), y.data(), z.data(), native_outputs, static_cast<unsigned int>(x.size()));
+
+			StdVector<float> runtime_sdf;
+			runtime_sdf.resize(x.size());
+			VoxelGeneratorGraph::PointsOutput points_output;
+			points_output.sdf = to_span(runtime_sdf);
+			generator->generate_points(
+					to_span_const(x), to_span_const(y), to_span_const(z), 1 << VoxelBuffer::CHANNEL_SDF, points_output
+			);
+
+			for (unsigned int i = 0; i < x.size(); ++i) {
+				float expected = runtime_sdf[i];
+				if (i % 2 == 0) {
+					expected = generator->generate_single(Vector3i(x[i], y[i], z[i]), VoxelBuffer::CHANNEL_SDF).f;
+				}
+				// Math functions are not guaranteed to round the same way as those used by the runtime
+				ZN_TEST_ASSERT(Math::abs(native_sdf[i] - expected) <= 0.0001f * math::max(Math::abs(expected), 1.f));
+			}
+
+			dlclose(library);
+		}
+	};
+	L::check([](VoxelGraphFunction &g) { load_graph_with_sphere_on_plane(g, 6.f); }, "test_sphere_on_plane");
+	L::check(load_graph_with_expression, "test_expression");
+	L::check(load_graph_with_elementwise_chain, "test_elementwise_chain");
+#endif
+}
+
+void test_voxel_graph_range_analysis_cache() {
+	static const float RADIUS = 6.f;
+	static const int BLOCK_SIZE = 32;
+
+	struct L {
+		static Ref<VoxelGeneratorGraph> create() {
+			Ref<VoxelGeneratorGraph> generator;
+			generator.instantiate();
+			load_graph_with_sphere_on_plane(**generator->get_main_function(), RADIUS);
+			generator->set_subdivision_size(16);
+			const CompilationResult result = generator->compile(false);
+			ZN_TEST_ASSERT_MSG(result.success, result.message);
+			return generator;
+		}
+
+		static void generate(VoxelGeneratorGraph &generator, VoxelBuffer &vb, Vector3i origin, uint8_t lod) {
+			vb.create(Vector3iUtil::create(BLOCK_SIZE));
+			generator.generate_block(VoxelGenerator::VoxelQueryData{ vb, origin, lod });
+		}
+	};
+
+	Ref<VoxelGeneratorGraph> generator1 = L::create();
+	Ref<VoxelGeneratorGraph> generator2 = L::create();
+
+	// Generate a coarse LOD first, like terrains usually do. Its sections cover those of LOD0 blocks.
+	const int lod1_block_size = BLOCK_SIZE << 1;
+	for (int y = -2; y < 2; ++y) {
+		VoxelBuffer vb(VoxelBuffer::ALLOCATOR_DEFAULT);
+		L::generate(**generator1, vb, Vector3i(0, y, 0) * lod1_block_size, 1);
+	}
+
+	const VoxelBuffer::ChannelId channel = VoxelBuffer::CHANNEL_SDF;
+
+	for (int y = -4; y < 4; ++y) {
+		const Vector3i origin = Vector3i(0, y, 0) * BLOCK_SIZE;
+
+		VoxelBuffer vb_cached(VoxelBuffer::ALLOCATOR_DEFAULT);
+		L::generate(**generator1, vb_cached, origin, 0);
+
+		VoxelBuffer vb_expected(VoxelBuffer::ALLOCATOR_DEFAULT);
+		L::generate(**generator2, vb_expected, origin, 0);
+
+		// Results found from a bigger region may skip computing voxels where the smaller region would have computed
+		// them, but only if they are beyond the clip threshold
+		Vector3i pos;
+		for (pos.z = 0; pos.z < BLOCK_SIZE; ++pos.z) {
+			for (pos.x = 0; pos.x < BLOCK_SIZE; ++pos.x) {
+				for (pos.y = 0; pos.y < BLOCK_SIZE; ++pos.y) {
+					const float sd_cached = vb_cached.get_voxel_f(pos, channel);
+					const float sd_expected = vb_expected.get_voxel_f(pos, channel);
+					ZN_TEST_ASSERT((sd_cached > 0.f) == (sd_expected > 0.f));
+				}
+			}
+		}
+
+		// Generating the same block again must give the same result
+		VoxelBuffer vb_again(VoxelBuffer::ALLOCATOR_DEFAULT);
+		L::generate(**generator2, vb_again, origin, 0);
+		ZN_TEST_ASSERT(vb_again.equals(vb_expected));
+	}
+}
+
+void test_voxel_graph_range_analysis_cache_across_lods() {
+	// Clip thresholds are scaled by LOD. Regions found clipped at LOD0 must not be re-used by lower-detail blocks,
+	// which clip further from the surface.
+	static const int BLOCK_SIZE = 64;
+
+	struct L {
+		static Ref<VoxelGeneratorGraph> create() {
+			Ref<VoxelGeneratorGraph> generator;
+			generator.instantiate();
+			load_graph_with_sphere_on_plane(**generator->get_main_function(), 6.f);
+			generator->set_subdivision_size(16);
+			generator->set_use_adaptive_subdivision(true);
+			// Large enough for regions above the plane to be clipped at LOD0 but not at LOD1
+			generator->set_sdf_clip_threshold(40.f);
+			const CompilationResult result = generator->compile(false);
+			ZN_TEST_ASSERT_MSG(result.success, result.message);
+			return generator;
+		}
+
+		static void generate(VoxelGeneratorGraph &generator, VoxelBuffer &vb, Vector3i origin, uint8_t lod) {
+			vb.create(Vector3iUtil::create(BLOCK_SIZE));
+			// Not quantized, so clipped voxels can be told apart from computed ones
+			vb.set_channel_depth(VoxelBuffer::CHANNEL_SDF, VoxelBuffer::DEPTH_32_BIT);
+			generator.generate_block(VoxelGenerator::VoxelQueryData{ vb, origin, lod });
+		}
+	};
+
+	Ref<VoxelGeneratorGraph> generator_warm = L::create();
+	Ref<VoxelGeneratorGraph> generator_fresh = L::create();
+
+	// LOD0 blocks above the plane, found entirely clipped
+	for (int z = 0; z < 2; ++z) {
+		for (int x = 0; x < 2; ++x) {
+			VoxelBuffer vb(VoxelBuffer::ALLOCATOR_DEFAULT);
+			L::generate(**generator_warm, vb, Vector3i(x, 1, z) * BLOCK_SIZE, 0);
+		}
+	}
+
+	// Lower-detail blocks covering them must be the same as if the cache was empty
+	for (uint8_t lod = 1; lod < 3; ++lod) {
+		VoxelBuffer vb_warm(VoxelBuffer::ALLOCATOR_DEFAULT);
+		L::generate(**generator_warm, vb_warm, Vector3i(), lod);
+
+		VoxelBuffer vb_fresh(VoxelBuffer::ALLOCATOR_DEFAULT);
+		L::generate(**generator_fresh, vb_fresh, Vector3i(), lod);
+
+		ZN_TEST_ASSERT(vb_warm.equals(vb_fresh));
+	}
+}
+
+void test_voxel_graph_adaptive_subdivision() {
+	static const float RADIUS = 6.f;
+	static const int BLOCK_SIZE = 64;
+
+	struct L {
+		static Ref<VoxelGeneratorGraph> create(bool adaptive) {
+			Ref<VoxelGeneratorGraph> generator;
+			generator.instantiate();
+			load_graph_with_sphere_on_plane(**generator->get_main_function(), RADIUS);
+			generator->set_subdivision_size(16);
+			generator->set_use_adaptive_subdivision(adaptive);
+			const CompilationResult result = generator->compile(false);
+			ZN_TEST_ASSERT_MSG(result.success, result.message);
+			return generator;
+		}
+	};
+
+	Ref<VoxelGeneratorGraph> generator_fixed = L::create(false);
+	Ref<VoxelGeneratorGraph> generator_adaptive = L::create(true);
+
+	const VoxelBuffer::ChannelId channel = VoxelBuffer::CHANNEL_SDF;
+
+	for (uint8_t lod = 0; lod < 3; ++lod) {
+		for (int y = -2; y < 2; ++y) {
+			const Vector3i origin = Vector3i(-1, y, -1) * (BLOCK_SIZE << lod);
+
+			VoxelBuffer vb_fixed(VoxelBuffer::ALLOCATOR_DEFAULT);
+			vb_fixed.create(Vector3iUtil::create(BLOCK_SIZE));
+			generator_fixed->generate_block(VoxelGenerator::VoxelQueryData{ vb_fixed, origin, lod });
+
+			VoxelBuffer vb_adaptive(VoxelBuffer::ALLOCATOR_DEFAULT);
+			vb_adaptive.create(Vector3iUtil::create(BLOCK_SIZE));
+			generator_adaptive->generate_block(VoxelGenerator::VoxelQueryData{ vb_adaptive, origin, lod });
+
+			// Larger areas may be clipped where smaller areas would have computed voxels, but only beyond the clip
+			// threshold, so the surface must be the same
+			Vector3i pos;
+			for (pos.z = 0; pos.z < BLOCK_SIZE; ++pos.z) {
+				for (pos.x = 0; pos.x < BLOCK_SIZE; ++pos.x) {
+					for (pos.y = 0; pos.y < BLOCK_SIZE; ++pos.y) {
+						const float sd_fixed = vb_fixed.get_voxel_f(pos, channel);
+						const float sd_adaptive = vb_adaptive.get_voxel_f(pos, channel);
+						ZN_TEST_ASSERT((sd_fixed > 0.f) == (sd_adaptive > 0.f));
+					}
+				}
+			}
+		}
+	}
+}
+
+void test_voxel_graph_adaptive_subdivision_textures() {
+	// Texture outputs can still require per-voxel computation in areas where SDF is found uniform. Those must be
+	// split down to the subdivision size like any other area.
+	static const int BLOCK_SIZE = 64;
+
+	struct L {
+		static Ref<VoxelGeneratorGraph> create(bool adaptive, VoxelGeneratorGraph::TextureMode texture_mode) {
+			Ref<VoxelGeneratorGraph> generator;
+			generator.instantiate();
+			{
+				VoxelGraphFunction &g = **generator->get_main_function();
+
+				//  Y --- Plane --- OutSDF
+				//   \
+				//    Multiply --- Clamp --- OutWeight1 (or OutSingleTexture)
+				//                           OutWeight0
+
+				const uint32_t n_in_y = g.create_node(VoxelGraphFunction::NODE_INPUT_Y);
+				const uint32_t n_plane = g.create_node(VoxelGraphFunction::NODE_SDF_PLANE);
+				const uint32_t n_out_sdf = g.create_node(VoxelGraphFunction::NODE_OUTPUT_SDF);
+				const uint32_t n_mul = g.create_node(VoxelGraphFunction::NODE_MULTIPLY);
+				const uint32_t n_clamp = g.create_node(VoxelGraphFunction::NODE_CLAMP_C);
+
+				g.set_node_default_input(n_plane, 1, 0.f);
+				g.set_node_default_input(n_mul, 1, -0.1f);
+				g.set_node_param(n_clamp, 0, 0.0);
+				g.set_node_param(n_clamp, 1, 3.0);
+
+				g.add_connection(n_in_y, 0, n_plane, 0);
+				g.add_connection(n_plane, 0, n_out_sdf, 0);
+				g.add_connection(n_in_y, 0, n_mul, 0);
+				g.add_connection(n_mul, 0, n_clamp, 0);
+
+				if (texture_mode == VoxelGeneratorGraph::TEXTURE_MODE_SINGLE) {
+					const uint32_t n_out_tex = g.create_node(VoxelGraphFunction::NODE_OUTPUT_SINGLE_TEXTURE);
+					g.add_connection(n_clamp, 0, n_out_tex, 0);
+				} else {
+					const uint32_t n_ow0 = g.create_node(VoxelGraphFunction::NODE_OUTPUT_WEIGHT);
+					const uint32_t n_ow1 = g.create_node(VoxelGraphFunction::NODE_OUTPUT_WEIGHT);
+					g.set_node_param(n_ow0, 0, 0);
+					g.set_node_param(n_ow1, 0, 1);
+					g.set_node_default_input(n_ow0, 0, 1.f);
+					g.add_connection(n_clamp, 0, n_ow1, 0);
+				}
+			}
+			generator->set_texture_mode(texture_mode);
+			generator->set_subdivision_size(16);
+			generator->set_use_adaptive_subdivision(adaptive);
+			const CompilationResult result = generator->compile(false);
+			ZN_TEST_ASSERT_MSG(result.success, result.message);
+			return generator;
+		}
+	};
+
+	const VoxelGeneratorGraph::TextureMode texture_modes[] = {
+		VoxelGeneratorGraph::TEXTURE_MODE_MIXEL4, //
+		VoxelGeneratorGraph::TEXTURE_MODE_SINGLE //
+	};
+
+	for (const VoxelGeneratorGraph::TextureMode texture_mode : texture_modes) {
+		Ref<VoxelGeneratorGraph> generator_fixed = L::create(false, texture_mode);
+		Ref<VoxelGeneratorGraph> generator_adaptive = L::create(true, texture_mode);
+
+		for (uint8_t lod = 0; lod < 2; ++lod) {
+			// Includes blocks entirely underground, where SDF is uniform but textures are not
+			for (int y = -3; y < 2; ++y) {
+				const Vector3i origin = Vector3i(-1, y, -1) * (BLOCK_SIZE << lod);
+
+				VoxelBuffer vb_fixed(VoxelBuffer::ALLOCATOR_DEFAULT);
+				vb_fixed.create(Vector3iUtil::create(BLOCK_SIZE));
+				generator_fixed->generate_block(VoxelGenerator::VoxelQueryData{ vb_fixed, origin, lod });
+
+				VoxelBuffer vb_adaptive(VoxelBuffer::ALLOCATOR_DEFAULT);
+				vb_adaptive.create(Vector3iUtil::create(BLOCK_SIZE));
+				generator_adaptive->generate_block(VoxelGenerator::VoxelQueryData{ vb_adaptive, origin, lod });
+
+				Vector3i pos;
+				for (pos.z = 0; pos.z < BLOCK_SIZE; ++pos.z) {
+					for (pos.x = 0; pos.x < BLOCK_SIZE; ++pos.x) {
+						for (pos.y = 0; pos.y < BLOCK_SIZE; ++pos.y) {
+							const float sd_fixed = vb_fixed.get_voxel_f(pos, VoxelBuffer::CHANNEL_SDF);
+							const float sd_adaptive = vb_adaptive.get_voxel_f(pos, VoxelBuffer::CHANNEL_SDF);
+							ZN_TEST_ASSERT((sd_fixed > 0.f) == (sd_adaptive > 0.f));
+							if (sd_fixed > 0.f) {
+								// Textures are not computed in air
+								continue;
+							}
+							ZN_TEST_ASSERT(
+									vb_fixed.get_voxel(pos, VoxelBuffer::CHANNEL_INDICES) ==
+									vb_adaptive.get_voxel(pos, VoxelBuffer::CHANNEL_INDICES)
+							);
+							ZN_TEST_ASSERT(
+									vb_fixed.get_voxel(pos, VoxelBuffer::CHANNEL_WEIGHTS) ==
+									vb_adaptive.get_voxel(pos, VoxelBuffer::CHANNEL_WEIGHTS)
+							);
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+void test_voxel_graph_slice_evaluation() {
+	// Nodes depending only on Y run once per slice, and nodes depending only on X and Y run once per row. Results
+	// must be the same as running them on every position.
+	//
+	//  Y --- Multiply --- Sin ------------------------ Add --- Add --- OutSDF
+	//                 \                               /       /
+	//                  Add --- Sin -------------------       /
+	//                 /                                     /
+	//  X --- Multiply                     Z --- Multiply ---
+	//
+	struct L {
+		static void create_graph(VoxelGraphFunction &g) {
+			const uint32_t n_in_x = g.create_node(VoxelGraphFunction::NODE_INPUT_X);
+			const uint32_t n_in_y = g.create_node(VoxelGraphFunction::NODE_INPUT_Y);
+			const uint32_t n_in_z = g.create_node(VoxelGraphFunction::NODE_INPUT_Z);
+			const uint32_t n_mul_x = g.create_node(VoxelGraphFunction::NODE_MULTIPLY);
+			const uint32_t n_mul_y = g.create_node(VoxelGraphFunction::NODE_MULTIPLY);
+			const uint32_t n_mul_z = g.create_node(VoxelGraphFunction::NODE_MULTIPLY);
+			const uint32_t n_sin_y = g.create_node(VoxelGraphFunction::NODE_SIN);
+			const uint32_t n_add_xy = g.create_node(VoxelGraphFunction::NODE_ADD);
+			const uint32_t n_sin_xy = g.create_node(VoxelGraphFunction::NODE_SIN);
+			const uint32_t n_add1 = g.create_node(VoxelGraphFunction::NODE_ADD);
+			const uint32_t n_add2 = g.create_node(VoxelGraphFunction::NODE_ADD);
+			const uint32_t n_out_sdf = g.create_node(VoxelGraphFunction::NODE_OUTPUT_SDF);
+
+			g.set_node_default_input(n_mul_x, 1, 0.3f);
+			g.set_node_default_input(n_mul_y, 1, 0.2f);
+			g.set_node_default_input(n_mul_z, 1, 0.05f);
+
+			g.add_connection(n_in_x, 0, n_mul_x, 0);
+			g.add_connection(n_in_y, 0, n_mul_y, 0);
+			g.add_connection(n_in_z, 0, n_mul_z, 0);
+			g.add_connection(n_mul_y, 0, n_sin_y, 0);
+			g.add_connection(n_mul_x, 0, n_add_xy, 0);
+			g.add_connection(n_mul_y, 0, n_add_xy, 1);
+			g.add_connection(n_add_xy, 0, n_sin_xy, 0);
+			g.add_connection(n_sin_y, 0, n_add1, 0);
+			g.add_connection(n_sin_xy, 0, n_add1, 1);
+			g.add_connection(n_add1, 0, n_add2, 0);
+			g.add_connection(n_mul_z, 0, n_add2, 1);
+			g.add_connection(n_add2, 0, n_out_sdf, 0);
+		}
+
+		// Output only depends on Y
+		static void create_graph_y_only(VoxelGraphFunction &g) {
+			const uint32_t n_in_y = g.create_node(VoxelGraphFunction::NODE_INPUT_Y);
+			const uint32_t n_mul_y = g.create_node(VoxelGraphFunction::NODE_MULTIPLY);
+			const uint32_t n_sin_y = g.create_node(VoxelGraphFunction::NODE_SIN);
+			const uint32_t n_out_sdf = g.create_node(VoxelGraphFunction::NODE_OUTPUT_SDF);
+
+			g.set_node_default_input(n_mul_y, 1, 0.2f);
+
+			g.add_connection(n_in_y, 0, n_mul_y, 0);
+			g.add_connection(n_mul_y, 0, n_sin_y, 0);
+			g.add_connection(n_sin_y, 0, n_out_sdf, 0);
+		}
+
+		static Ref<VoxelGeneratorGraph> create(void (*create_graph_func)(VoxelGraphFunction &), bool xz_caching) {
+			Ref<VoxelGeneratorGraph> generator;
+			generator.instantiate();
+			create_graph_func(**generator->get_main_function());
+			generator->set_use_xz_caching(xz_caching);
+			const CompilationResult result = generator->compile(false);
+			ZN_TEST_ASSERT_MSG(result.success, result.message);
+			return generator;
+		}
+	};
+
+	{
+		Ref<VoxelGeneratorGraph> generator_full = L::create(L::create_graph, false);
+		Ref<VoxelGeneratorGraph> generator_sliced = L::create(L::create_graph, true);
+		ZN_TEST_ASSERT(check_graph_results_are_equal(**generator_full, **generator_sliced));
+	}
+	{
+		Ref<VoxelGeneratorGraph> generator_full = L::create(L::create_graph_y_only, false);
+		Ref<VoxelGeneratorGraph> generator_sliced = L::create(L::create_graph_y_only, true);
+		ZN_TEST_ASSERT(check_graph_results_are_equal(**generator_full, **generator_sliced));
+	}
+}
+
+void test_voxel_graph_generate_points() {
+	Ref<VoxelGeneratorGraph> generator;
+	generator.instantiate();
+	{
+		VoxelGraphFunction &g = **generator->get_main_function();
+
+		// SDF = sin(0.1 * X) + 0.2 * Y
+		// Type = 0.05 * Z
+		const uint32_t n_in_x = g.create_node(VoxelGraphFunction::NODE_INPUT_X);
+		const uint32_t n_in_y = g.create_node(VoxelGraphFunction::NODE_INPUT_Y);
+		const uint32_t n_in_z = g.create_node(VoxelGraphFunction::NODE_INPUT_Z);
+		const uint32_t n_mul_x = g.create_node(VoxelGraphFunction::NODE_MULTIPLY);
+		const uint32_t n_sin = g.create_node(VoxelGraphFunction::NODE_SIN);
+		const uint32_t n_mul_y = g.create_node(VoxelGraphFunction::NODE_MULTIPLY);
+		const uint32_t n_add = g.create_node(VoxelGraphFunction::NODE_ADD);
+		const uint32_t n_mul_z = g.create_node(VoxelGraphFunction::NODE_MULTIPLY);
+		const uint32_t n_out_sdf = g.create_node(VoxelGraphFunction::NODE_OUTPUT_SDF);
+		const uint32_t n_out_type = g.create_node(VoxelGraphFunction::NODE_OUTPUT_TYPE);
+
+		g.set_node_default_input(n_mul_x, 1, 0.1f);
+		g.set_node_default_input(n_mul_y, 1, 0.2f);
+		g.set_node_default_input(n_mul_z, 1, 0.05f);
+
+		g.add_connection(n_in_x, 0, n_mul_x, 0);
+		g.add_connection(n_mul_x, 0, n_sin, 0);
+		g.add_connection(n_in_y, 0, n_mul_y, 0);
+		g.add_connection(n_sin, 0, n_add, 0);
+		g.add_connection(n_mul_y, 0, n_add, 1);
+		g.add_connection(n_add, 0, n_out_sdf, 0);
+		g.add_connection(n_in_z, 0, n_mul_z, 0);
+		g.add_connection(n_mul_z, 0, n_out_type, 0);
+	}
+	const CompilationResult result = generator->compile(false);
+	ZN_TEST_ASSERT_MSG(result.success, result.message);
+
+	// More than one chunk of points
+	const unsigned int point_count = 5000;
+	StdVector<float> x;
+	StdVector<float> y;
+	StdVector<float> z;
+	for (unsigned int i = 0; i < point_count; ++i) {
+		// Scattered positions
+		x.push_back(float(int((i * 37) % 211) - 105));
+		y.push_back(float(int((i * 53) % 97) - 48));
+		z.push_back(float(int((i * 71) % 173) - 86));
+	}
+
+	const uint32_t sdf_mask = 1 << VoxelBuffer::CHANNEL_SDF;
+	const uint32_t type_mask = 1 << VoxelBuffer::CHANNEL_TYPE;
+	const uint32_t masks[] = { sdf_mask, type_mask, sdf_mask | type_mask };
+
+	for (const uint32_t mask : masks) {
+		StdVector<float> sdf;
+		StdVector<float> type;
+		VoxelGeneratorGraph::PointsOutput out;
+		if ((mask & sdf_mask) != 0) {
+			sdf.resize(point_count);
+			out.sdf = to_span(sdf);
+		}
+		if ((mask & type_mask) != 0) {
+			type.resize(point_count);
+			out.type = to_span(type);
+		}
+
+		generator->generate_points(to_span_const(x), to_span_const(y), to_span_const(z), mask, out);
+
+		for (unsigned int i = 0; i < point_count; ++i) {
+			const Vector3i pos(x[i], y[i], z[i]);
+			if ((mask & sdf_mask) != 0) {
+				const float expected = generator->generate_single(pos, VoxelBuffer::CHANNEL_SDF).f;
+				ZN_TEST_ASSERT(Math::is_equal_approx(sdf[i], expected));
+			}
+			if ((mask & type_mask) != 0) {
+				const int expected = generator->generate_single(pos, VoxelBuffer::CHANNEL_TYPE).i;
+				ZN_TEST_ASSERT(int(type[i]) == expected);
+			}
+		}
+	}
+}
+
+void test_voxel_graph_state_arena() {
+	Ref<VoxelGeneratorGraph> generator;
+	generator.instantiate();
+	load_graph_with_sphere_on_plane(**generator->get_main_function(), 6.f);
+	const CompilationResult result = generator->compile(false);
+	ZN_TEST_ASSERT_MSG(result.success, result.message);
+
+	const int block_size = 16;
+	VoxelBuffer buffer(VoxelBuffer::ALLOCATOR_DEFAULT);
+	buffer.create(Vector3iUtil::create(block_size));
+
+	generator->generate_block(VoxelGenerator::VoxelQueryData{ buffer, Vector3i(0, -8, 0), 0 });
+
+	const pg::Runtime::State &state = VoxelGeneratorGraph::get_last_state_from_current_thread();
+	const size_t high_water_mark = state.get_arena_high_water_mark();
+	// At least X, Y and Z inputs of a slice come from the arena
+	ZN_TEST_ASSERT(high_water_mark >= 3 * block_size * block_size * sizeof(float));
+
+	// Same sizes again, the arena should not need to grow
+	generator->generate_block(VoxelGenerator::VoxelQueryData{ buffer, Vector3i(-16, -8, 0), 0 });
+	generator->generate_block(VoxelGenerator::VoxelQueryData{ buffer, Vector3i(0, -8, -16), 1 });
+	generator->generate_single(Vector3i(0, 0, 0), VoxelBuffer::CHANNEL_SDF);
+	ZN_TEST_ASSERT(state.get_arena_high_water_mark() == high_water_mark);
+}
+
+inline uint32_t get_float_bits(float f) {
+	uint32_t bits;
+	memcpy(&bits, &f, sizeof(float));
+	return bits;
+}
+
+void test_voxel_graph_deterministic() {
+	Ref<VoxelGeneratorGraph> generator;
+	generator.instantiate();
+	{
+		VoxelGraphFunction &g = **generator->get_main_function();
+
+		// SDF = 4 * sin(0.1 * X) + pow(0.01 * Z + 2, 1.5) + 0.5 * Y
+		const uint32_t n_in_x = g.create_node(VoxelGraphFunction::NODE_INPUT_X);
+		const uint32_t n_in_y = g.create_node(VoxelGraphFunction::NODE_INPUT_Y);
+		const uint32_t n_in_z = g.create_node(VoxelGraphFunction::NODE_INPUT_Z);
+		const uint32_t n_mul_x = g.create_node(VoxelGraphFunction::NODE_MULTIPLY);
+		const uint32_t n_sin = g.create_node(VoxelGraphFunction::NODE_SIN);
+		const uint32_t n_mul_sin = g.create_node(VoxelGraphFunction::NODE_MULTIPLY);
+		const uint32_t n_mul_z = g.create_node(VoxelGraphFunction::NODE_MULTIPLY);
+		const uint32_t n_add_z = g.create_node(VoxelGraphFunction::NODE_ADD);
+		const uint32_t n_pow = g.create_node(VoxelGraphFunction::NODE_POW);
+		const uint32_t n_mul_y = g.create_node(VoxelGraphFunction::NODE_MULTIPLY);
+		const uint32_t n_add1 = g.create_node(VoxelGraphFunction::NODE_ADD);
+		const uint32_t n_add2 = g.create_node(VoxelGraphFunction::NODE_ADD);
+		const uint32_t n_out_sdf = g.create_node(VoxelGraphFunction::NODE_OUTPUT_SDF);
+
+		g.set_node_default_input(n_mul_x, 1, 0.1f);
+		g.set_node_default_input(n_mul_sin, 1, 4.f);
+		g.set_node_default_input(n_mul_z, 1, 0.01f);
+		g.set_node_default_input(n_add_z, 1, 2.f);
+		g.set_node_default_input(n_pow, 1, 1.5f);
+		g.set_node_default_input(n_mul_y, 1, 0.5f);
+
+		g.add_connection(n_in_x, 0, n_mul_x, 0);
+		g.add_connection(n_mul_x, 0, n_sin, 0);
+		g.add_connection(n_sin, 0, n_mul_sin, 0);
+		g.add_connection(n_in_z, 0, n_mul_z, 0);
+		g.add_connection(n_mul_z, 0, n_add_z, 0);
+		g.add_connection(n_add_z, 0, n_pow, 0);
+		g.add_connection(n_mul_sin, 0, n_add1, 0);
+		g.add_connection(n_pow, 0, n_add1, 1);
+		g.add_connection(n_in_y, 0, n_mul_y, 0);
+		g.add_connection(n_add1, 0, n_add2, 0);
+		g.add_connection(n_mul_y, 0, n_add2, 1);
+		g.add_connection(n_add2, 0, n_out_sdf, 0);
+	}
+	generator->set_deterministic(true);
+	const CompilationResult result = generator->compile(false);
+	ZN_TEST_ASSERT_MSG(result.success, result.message);
+
+	const unsigned int point_count = 5000;
+	StdVector<float> x;
+	StdVector<float> y;
+	StdVector<float> z;
+	for (unsigned int i = 0; i < point_count; ++i) {
+		x.push_back(float(int((i * 37) % 211) - 105));
+		y.push_back(float(int((i * 53) % 97) - 48));
+		z.push_back(float(int((i * 71) % 173) - 86));
+	}
+
+	StdVector<float> sdf;
+	sdf.resize(point_count);
+	VoxelGeneratorGraph::PointsOutput out;
+	out.sdf = to_span(sdf);
+	generator->generate_points(
+			to_span_const(x), to_span_const(y), to_span_const(z), 1 << VoxelBuffer::CHANNEL_SDF, out
+	);
+
+	uint32_t hash = 5381;
+	for (unsigned int i = 0; i < point_count; ++i) {
+		hash = hash_djb2_one_32(get_float_bits(sdf[i]), hash);
+
+		// Single queries must give the exact same results
+		const Vector3i pos(x[i], y[i], z[i]);
+		const float single = generator->generate_single(pos, VoxelBuffer::CHANNEL_SDF).f;
+		ZN_TEST_ASSERT(get_float_bits(single) == get_float_bits(sdf[i]));
+	}
+
+	// Golden values were obtained once with a standalone program compiled with -ffp-contract=off, which evaluates
+	// the same formula with plain float operations in the same order as the graph, using `math::deterministic_*`
+	// functions. Hashes chain the bits of each SDF value with `hash_djb2_one_32`, starting from 5381, in the order
+	// points are given. The same value must be found on every platform. If it changes, generated terrains will no
+	// longer match previous versions.
+	// Here, for each point: `(deterministic_sin(x * 0.1f) * 4.f + deterministic_pow(z * 0.01f + 2.f, 1.5f)) + y * 0.5f`
+	ZN_TEST_ASSERT(hash == 0x7962cc3b);
+
+	// Nodes with divisions and noise, which have SIMD paths that may differ between platforms
+	generator.instantiate();
+	{
+		VoxelGraphFunction &g = **generator->get_main_function();
+
+		// SDF = Y * 0.5 + Y / (0.1 * Z + 3.5) + 4 * normalize(X + 0.5, Y, Z).x + 10 * noise(X, Z)
+		const uint32_t n_in_x = g.create_node(VoxelGraphFunction::NODE_INPUT_X);
+		const uint32_t n_in_y = g.create_node(VoxelGraphFunction::NODE_INPUT_Y);
+		const uint32_t n_in_z = g.create_node(VoxelGraphFunction::NODE_INPUT_Z);
+		const uint32_t n_mul_y = g.create_node(VoxelGraphFunction::NODE_MULTIPLY);
+		const uint32_t n_mul_z = g.create_node(VoxelGraphFunction::NODE_MULTIPLY);
+		const uint32_t n_add_z = g.create_node(VoxelGraphFunction::NODE_ADD);
+		const uint32_t n_div = g.create_node(VoxelGraphFunction::NODE_DIVIDE);
+		const uint32_t n_add_x = g.create_node(VoxelGraphFunction::NODE_ADD);
+		const uint32_t n_normalize = g.create_node(VoxelGraphFunction::NODE_NORMALIZE_3D);
+		const uint32_t n_mul_nx = g.create_node(VoxelGraphFunction::NODE_MULTIPLY);
+		const uint32_t n_noise = g.create_node(VoxelGraphFunction::NODE_FAST_NOISE_2D);
+		const uint32_t n_mul_noise = g.create_node(VoxelGraphFunction::NODE_MULTIPLY);
+		const uint32_t n_add1 = g.create_node(VoxelGraphFunction::NODE_ADD);
+		const uint32_t n_add2 = g.create_node(VoxelGraphFunction::NODE_ADD);
+		const uint32_t n_add3 = g.create_node(VoxelGraphFunction::NODE_ADD);
+		const uint32_t n_out_sdf = g.create_node(VoxelGraphFunction::NODE_OUTPUT_SDF);
+
+		Ref<ZN_FastNoiseLite> noise;
+		noise.instantiate();
+		g.set_node_param(n_noise, 0, noise);
+
+		g.set_node_default_input(n_mul_y, 1, 0.5f);
+		g.set_node_default_input(n_mul_z, 1, 0.1f);
+		g.set_node_default_input(n_add_z, 1, 3.5f);
+		g.set_node_default_input(n_add_x, 1, 0.5f);
+		g.set_node_default_input(n_mul_nx, 1, 4.f);
+		g.set_node_default_input(n_mul_noise, 1, 10.f);
+
+		g.add_connection(n_in_y, 0, n_mul_y, 0);
+		g.add_connection(n_in_z, 0, n_mul_z, 0);
+		g.add_connection(n_mul_z, 0, n_add_z, 0);
+		g.add_connection(n_in_y, 0, n_div, 0);
+		g.add_connection(n_add_z, 0, n_div, 1);
+		g.add_connection(n_in_x, 0, n_add_x, 0);
+		g.add_connection(n_add_x, 0, n_normalize, 0);
+		g.add_connection(n_in_y, 0, n_normalize, 1);
+		g.add_connection(n_in_z, 0, n_normalize, 2);
+		g.add_connection(n_normalize, 0, n_mul_nx, 0);
+		g.add_connection(n_in_x, 0, n_noise, 0);
+		g.add_connection(n_in_z, 0, n_noise, 1);
+		g.add_connection(n_noise, 0, n_mul_noise, 0);
+		g.add_connection(n_mul_y, 0, n_add1, 0);
+		g.add_connection(n_div, 0, n_add1, 1);
+		g.add_connection(n_add1, 0, n_add2, 0);
+		g.add_connection(n_mul_nx, 0, n_add2, 1);
+		g.add_connection(n_add2, 0, n_add3, 0);
+		g.add_connection(n_mul_noise, 0, n_add3, 1);
+		g.add_connection(n_add3, 0, n_out_sdf, 0);
+	}
+	generator->set_deterministic(true);
+	// Blocks must be fully computed, not clipped
+	generator->set_sdf_clip_threshold(10000.f);
+	const CompilationResult result2 = generator->compile(false);
+	ZN_TEST_ASSERT_MSG(result2.success, result2.message);
+
+	generator->generate_points(
+			to_span_const(x), to_span_const(y), to_span_const(z), 1 << VoxelBuffer::CHANNEL_SDF, out
+	);
+
+	hash = 5381;
+	for (unsigned int i = 0; i < point_count; ++i) {
+		hash = hash_djb2_one_32(get_float_bits(sdf[i]), hash);
+
+		const Vector3i pos(x[i], y[i], z[i]);
+		const float single = generator->generate_single(pos, VoxelBuffer::CHANNEL_SDF).f;
+		ZN_TEST_ASSERT(get_float_bits(single) == get_float_bits(sdf[i]));
+	}
+	// For each point, with `fnl` being thirdparty/fast_noise/FastNoiseLite.h configured like a default
+	// ZN_FastNoiseLite (OpenSimplex2, seed 0, frequency 1/64, FBm, 3 octaves, lacunarity 2, gain 0.5, weighted
+	// strength 0, ping-pong strength 2):
+	// ```
+	// const float ax = x + 0.5f;
+	// const float nx = ax / sqrtf(ax * ax + y * y + z * z);
+	// const float divisor = z * 0.1f + 3.5f;
+	// const float div = divisor == 0.f ? 0.f : y / divisor;
+	// sdf = ((y * 0.5f + div) + nx * 4.f) + fnl.GetNoise(x, z) * 10.f;
+	// ```
+	ZN_TEST_ASSERT(hash == 0xa202e598);
+
+	// Blocks go through a different path, with buffers processed in slices. Z is chosen so some divisions are by zero.
+	const Vector3i block_origin(-8, -8, -40);
+	VoxelBuffer vb(VoxelBuffer::ALLOCATOR_DEFAULT);
+	vb.create(Vector3i(16, 16, 16));
+	vb.set_channel_depth(VoxelBuffer::CHANNEL_SDF, VoxelBuffer::DEPTH_32_BIT);
+	generator->generate_block(VoxelGenerator::VoxelQueryData{ vb, block_origin, 0 });
+
+	hash = 5381;
+	for (int rz = 0; rz < vb.get_size().z; ++rz) {
+		for (int ry = 0; ry < vb.get_size().y; ++ry) {
+			for (int rx = 0; rx < vb.get_size().x; ++rx) {
+				// 32-bit SDF is stored without quantization
+				const uint32_t bits = static_cast<uint32_t>(vb.get_voxel(rx, ry, rz, VoxelBuffer::CHANNEL_SDF));
+				hash = hash_djb2_one_32(bits, hash);
+
+				const Vector3i pos = block_origin + Vector3i(rx, ry, rz);
+				const float single = generator->generate_single(pos, VoxelBuffer::CHANNEL_SDF).f;
+				ZN_TEST_ASSERT(get_float_bits(single) == bits);
+			}
+		}
+	}
+	// Same formula as above, hashing voxels in ZYX order (X being the innermost loop)
+	ZN_TEST_ASSERT(hash == 0x96d2575f);
+
+	// Constant sub-expressions must not be folded with non-deterministic functions
+	generator.instantiate();
+	{
+		VoxelGraphFunction &g = **generator->get_main_function();
+
+		const uint32_t n_in_x = g.create_node(VoxelGraphFunction::NODE_INPUT_X);
+		const uint32_t n_in_y = g.create_node(VoxelGraphFunction::NODE_INPUT_Y);
+		const uint32_t n_in_z = g.create_node(VoxelGraphFunction::NODE_INPUT_Z);
+		const uint32_t n_expression = g.create_node(VoxelGraphFunction::NODE_EXPRESSION);
+		const uint32_t n_out_sdf = g.create_node(VoxelGraphFunction::NODE_OUTPUT_SDF);
+
+		g.set_node_param(n_expression, 0, "sin(x * 0.1) * 4 + sin(2) * y + 2 ^ 0.5 * z");
+		PackedStringArray var_names;
+		var_names.push_back("x");
+		var_names.push_back("y");
+		var_names.push_back("z");
+		g.set_expression_node_inputs(n_expression, var_names);
+
+		g.add_connection(n_in_x, 0, n_expression, 0);
+		g.add_connection(n_in_y, 0, n_expression, 1);
+		g.add_connection(n_in_z, 0, n_expression, 2);
+		g.add_connection(n_expression, 0, n_out_sdf, 0);
+	}
+	generator->set_deterministic(true);
+	const CompilationResult result3 = generator->compile(false);
+	ZN_TEST_ASSERT_MSG(result3.success, result3.message);
+
+	generator->generate_points(
+			to_span_const(x), to_span_const(y), to_span_const(z), 1 << VoxelBuffer::CHANNEL_SDF, out
+	);
+
+	hash = 5381;
+	for (unsigned int i = 0; i < point_count; ++i) {
+		hash = hash_djb2_one_32(get_float_bits(sdf[i]), hash);
+
+		const Vector3i pos(x[i], y[i], z[i]);
+		const float single = generator->generate_single(pos, VoxelBuffer::CHANNEL_SDF).f;
+		ZN_TEST_ASSERT(get_float_bits(single) == get_float_bits(sdf[i]));
+	}
+	// For each point:
+	// `(deterministic_sin(x * 0.1f) * 4.f + deterministic_sin(2.f) * y) + deterministic_pow(2.f, 0.5f) * z`
+	ZN_TEST_ASSERT(hash == 0xfda07981);
+
+	// SdfSphereHeightmap uses atan2
+	generator.instantiate();
+	{
+		VoxelGraphFunction &g = **generator->get_main_function();
+
+		const uint32_t n_in_x = g.create_node(VoxelGraphFunction::NODE_INPUT_X);
+		const uint32_t n_in_y = g.create_node(VoxelGraphFunction::NODE_INPUT_Y);
+		const uint32_t n_in_z = g.create_node(VoxelGraphFunction::NODE_INPUT_Z);
+		const uint32_t n_sphere = g.create_node(VoxelGraphFunction::NODE_SDF_SPHERE_HEIGHTMAP);
+		const uint32_t n_out_sdf = g.create_node(VoxelGraphFunction::NODE_OUTPUT_SDF);
+
+		// Heights are multiples of 0.25, so they are stored exactly
+		Ref<Image> image = Image::create_empty(64, 32, false, Image::FORMAT_RF);
+		for (int iy = 0; iy < image->get_height(); ++iy) {
+			for (int ix = 0; ix < image->get_width(); ++ix) {
+				const float h = float((ix * 7 + iy * 13) % 16) * 0.25f;
+				image->set_pixel(ix, iy, Color(h, h, h));
+			}
+		}
+
+		g.set_node_param(n_sphere, 0, image);
+		g.set_node_param(n_sphere, 1, 20.f);
+		g.set_node_param(n_sphere, 2, 4.f);
+
+		g.add_connection(n_in_x, 0, n_sphere, 0);
+		g.add_connection(n_in_y, 0, n_sphere, 1);
+		g.add_connection(n_in_z, 0, n_sphere, 2);
+		g.add_connection(n_sphere, 0, n_out_sdf, 0);
+	}
+	generator->set_deterministic(true);
+	generator->set_sdf_clip_threshold(10000.f);
+	const CompilationResult result4 = generator->compile(false);
+	ZN_TEST_ASSERT_MSG(result4.success, result4.message);
+
+	// Points within the radius + height range, where the heightmap is sampled. Some have X and Z equal to zero.
+	for (unsigned int i = 0; i < point_count; ++i) {
+		x[i] = float(int((i * 37) % 41) - 20);
+		y[i] = float(int((i * 53) % 41) - 20);
+		z[i] = float(int((i * 71) % 41) - 20);
+	}
+
+	generator->generate_points(
+			to_span_const(x), to_span_const(y), to_span_const(z), 1 << VoxelBuffer::CHANNEL_SDF, out
+	);
+
+	hash = 5381;
+	for (unsigned int i = 0; i < point_count; ++i) {
+		hash = hash_djb2_one_32(get_float_bits(sdf[i]), hash);
+
+		const Vector3i pos(x[i], y[i], z[i]);
+		const float single = generator->generate_single(pos, VoxelBuffer::CHANNEL_SDF).f;
+		ZN_TEST_ASSERT(get_float_bits(single) == get_float_bits(sdf[i]));
+	}
+	// For each point, `sdf_sphere_heightmap` from generators/graph/nodes/image.h with `deterministic_atan2`, using a
+	// plain float array as image, `min_h = 0`, `max_h = 15`, `norm_x = 64` and `norm_y = 32`
+	ZN_TEST_ASSERT(hash == 0x183cf97d);
+
+	const Vector3i block_origin2(12, -8, -8);
+	generator->generate_block(VoxelGenerator::VoxelQueryData{ vb, block_origin2, 0 });
+
+	hash = 5381;
+	for (int rz = 0; rz < vb.get_size().z; ++rz) {
+		for (int ry = 0; ry < vb.get_size().y; ++ry) {
+			for (int rx = 0; rx < vb.get_size().x; ++rx) {
+				const uint32_t bits = static_cast<uint32_t>(vb.get_voxel(rx, ry, rz, VoxelBuffer::CHANNEL_SDF));
+				hash = hash_djb2_one_32(bits, hash);
+			}
+		}
+	}
+	ZN_TEST_ASSERT(hash == 0x2f132bb5);
+}
+
 } // namespace zylann::voxel::tests
@@ -42,6 +42,18 @@ void test_voxel_graph_non_square_image();
 void test_voxel_graph_4_default_weights();
 void test_voxel_graph_empty_image();
 void test_voxel_graph_constant_reduction();
+void test_voxel_graph_simd_kernels();
+void test_voxel_graph_elementwise_fusion();
+void test_voxel_graph_cpp_generation();
+void test_voxel_graph_cpp_generation_matches_runtime();
+void test_voxel_graph_range_analysis_cache();
+void test_voxel_graph_range_analysis_cache_across_lods();
+void test_voxel_graph_adaptive_subdivision();
+void test_voxel_graph_adaptive_subdivision_textures();
+void test_voxel_graph_slice_evaluation();
+void test_voxel_graph_generate_points();
+void test_voxel_graph_state_arena();
+void test_voxel_graph_deterministic();
 
 } // namespace zylann::voxel::tests
 
@@ -0,0 +1,551 @@
+#include "test_voxel_mesher_blocky.h"
+#include "../../meshers/blocky/voxel_blocky_library.h"
+#include "../../meshers/blocky/voxel_blocky_model_cube.h"
+#include "../../meshers/blocky/voxel_blocky_model_empty.h"
+#include "../../meshers/blocky/voxel_mesher_blocky.h"
+#include "../../meshers/mesh_block_task.h"
+#include "../../meshers/vertex_cache_optimization.h"
+#include "../../storage/voxel_buffer.h"
+#include "../../storage/voxel_buffer_padded_view.h"
+#include "../../util/godot/classes/array_mesh.h"
+#include "../../util/godot/core/packed_arrays.h"
+#include "../../util/math/funcs.h"
+#include "../../util/testing/test_macros.h"
+#include "test_util.h"
+
+namespace zylann::voxel::tests {
+
+namespace {
+
+struct BlockyMeshStats {
+	unsigned int vertex_count = 0;
+	real_t area = 0;
+	real_t uv_area = 0;
+};
+
+BlockyMeshStats get_blocky_mesh_stats(const VoxelMesher::Output &output) {
+	BlockyMeshStats stats;
+	for (const VoxelMesher::Output::Surface &surface : output.surfaces) {
+		if (surface.arrays.size() == 0) {
+			continue;
+		}
+		const PackedVector3Array positions = surface.arrays[Mesh::ARRAY_VERTEX];
+		const PackedVector2Array uvs = surface.arrays[Mesh::ARRAY_TEX_UV];
+		const PackedInt32Array indices = surface.arrays[Mesh::ARRAY_INDEX];
+
+		stats.vertex_count += positions.size();
+
+		for (int i = 0; i + 2 < indices.size(); i += 3) {
+			const int i0 = indices[i];
+			const int i1 = indices[i + 1];
+			const int i2 = indices[i + 2];
+			stats.area += 0.5 * (positions[i1] - positions[i0]).cross(positions[i2] - positions[i0]).length();
+			stats.uv_area += 0.5 * Math::abs((uvs[i1] - uvs[i0]).cross(uvs[i2] - uvs[i0]));
+		}
+	}
+	return stats;
+}
+
+real_t get_collision_surface_area(const VoxelMesher::Output::CollisionSurface &surface) {
+	real_t area = 0;
+	for (unsigned int i = 0; i + 2 < surface.indices.size(); i += 3) {
+		const Vector3f p0 = surface.positions[surface.indices[i]];
+		const Vector3f p1 = surface.positions[surface.indices[i + 1]];
+		const Vector3f p2 = surface.positions[surface.indices[i + 2]];
+		area += 0.5 * math::length(math::cross(p1 - p0, p2 - p0));
+	}
+	return area;
+}
+
+Ref<VoxelMesherBlocky> create_blocky_mesher(bool greedy) {
+	Ref<VoxelBlockyLibrary> library;
+	library.instantiate();
+	{
+		Ref<VoxelBlockyModelEmpty> air;
+		air.instantiate();
+		library->add_model(air);
+	}
+	{
+		// Texture covering all the UV space, can repeat
+		Ref<VoxelBlockyModelCube> cube;
+		cube.instantiate();
+		cube->set_atlas_size_in_tiles(Vector2i(1, 1));
+		library->add_model(cube);
+	}
+	{
+		// Default atlas, faces only use a tile of it
+		Ref<VoxelBlockyModelCube> cube;
+		cube.instantiate();
+		library->add_model(cube);
+	}
+	library->bake();
+
+	Ref<VoxelMesherBlocky> mesher;
+	mesher.instantiate();
+	mesher->set_library(library);
+	mesher->set_greedy_meshing_enabled(greedy);
+	return mesher;
+}
+
+BlockyMeshStats build_blocky_mesh(VoxelMesherBlocky &mesher, const VoxelBuffer &vb) {
+	VoxelMesher::Input input{ vb, nullptr, Vector3i(), 0, false };
+	VoxelMesher::Output output;
+	mesher.build(output, input);
+	return get_blocky_mesh_stats(output);
+}
+
+} // namespace
+
+void test_voxel_mesher_blocky_greedy() {
+	const int repeating_cube_id = 1;
+	const int atlas_cube_id = 2;
+
+	Ref<VoxelMesherBlocky> greedy_mesher = create_blocky_mesher(true);
+	Ref<VoxelMesherBlocky> regular_mesher = create_blocky_mesher(false);
+
+	// A 3x2x3 box floating in air. Ambient occlusion is the same on every face of it.
+	{
+		VoxelBuffer vb(VoxelBuffer::ALLOCATOR_DEFAULT);
+		vb.create(8, 8, 8);
+		vb.fill_area(repeating_cube_id, Vector3i(2, 2, 2), Vector3i(5, 4, 5), VoxelBuffer::CHANNEL_TYPE);
+
+		const BlockyMeshStats regular = build_blocky_mesh(**regular_mesher, vb);
+		const BlockyMeshStats greedy = build_blocky_mesh(**greedy_mesher, vb);
+
+		// 42 faces of 4 vertices each
+		ZN_TEST_ASSERT(regular.vertex_count == 42 * 4);
+		// One quad per side of the box
+		ZN_TEST_ASSERT(greedy.vertex_count == 6 * 4);
+
+		ZN_TEST_ASSERT(Math::is_equal_approx(regular.area, real_t(42)));
+		ZN_TEST_ASSERT(Math::is_equal_approx(greedy.area, real_t(42)));
+		// The texture must repeat once per voxel instead of being stretched
+		ZN_TEST_ASSERT(Math::is_equal_approx(greedy.uv_area, real_t(42)));
+	}
+
+	// Same box, using a tile of a texture atlas. It cannot repeat, so faces are not merged.
+	{
+		VoxelBuffer vb(VoxelBuffer::ALLOCATOR_DEFAULT);
+		vb.create(8, 8, 8);
+		vb.fill_area(atlas_cube_id, Vector3i(2, 2, 2), Vector3i(5, 4, 5), VoxelBuffer::CHANNEL_TYPE);
+
+		const BlockyMeshStats regular = build_blocky_mesh(**regular_mesher, vb);
+		const BlockyMeshStats greedy = build_blocky_mesh(**greedy_mesher, vb);
+
+		ZN_TEST_ASSERT(greedy.vertex_count == regular.vertex_count);
+		ZN_TEST_ASSERT(Math::is_equal_approx(greedy.area, regular.area));
+	}
+
+	// Ground with a cube on top. Faces around the cube are occluded differently, they must still be output.
+	{
+		VoxelBuffer vb(VoxelBuffer::ALLOCATOR_DEFAULT);
+		vb.create(8, 8, 8);
+		vb.fill_area(repeating_cube_id, Vector3i(0, 0, 0), Vector3i(8, 3, 8), VoxelBuffer::CHANNEL_TYPE);
+		vb.set_voxel(repeating_cube_id, Vector3i(4, 3, 4), VoxelBuffer::CHANNEL_TYPE);
+
+		const BlockyMeshStats regular = build_blocky_mesh(**regular_mesher, vb);
+		const BlockyMeshStats greedy = build_blocky_mesh(**greedy_mesher, vb);
+
+		ZN_TEST_ASSERT(greedy.vertex_count < regular.vertex_count);
+		ZN_TEST_ASSERT(Math::is_equal_approx(greedy.area, regular.area));
+		ZN_TEST_ASSERT(Math::is_equal_approx(greedy.uv_area, regular.uv_area));
+	}
+}
+
+void test_voxel_mesher_blocky_culling() {
+	const int air_id = 0;
+	const int cube_id = 1;
+	const int glass_id = 2;
+
+	Ref<VoxelMesherBlocky> mesher;
+	{
+		Ref<VoxelBlockyLibrary> library;
+		library.instantiate();
+		{
+			Ref<VoxelBlockyModelEmpty> air;
+			air.instantiate();
+			library->add_model(air);
+		}
+		{
+			Ref<VoxelBlockyModelCube> cube;
+			cube.instantiate();
+			library->add_model(cube);
+		}
+		{
+			Ref<VoxelBlockyModelCube> glass;
+			glass.instantiate();
+			glass->set_transparency_index(1);
+			library->add_model(glass);
+		}
+		library->bake();
+
+		mesher.instantiate();
+		mesher->set_library(library);
+	}
+
+	// Taller than 64 voxels, so rows of voxels span more than one bitmask word
+	VoxelBuffer vb(VoxelBuffer::ALLOCATOR_DEFAULT);
+	vb.create(6, 70, 6);
+	vb.fill(cube_id, VoxelBuffer::CHANNEL_TYPE);
+
+	{
+		const BlockyMeshStats stats = build_blocky_mesh(**mesher, vb);
+		ZN_TEST_ASSERT(stats.vertex_count == 0);
+	}
+
+	// Holes on each side of the boundary between words. Only the 6 faces around each of them are visible.
+	for (const int hole_y : { 63, 64 }) {
+		const Vector3i hole_pos(2, hole_y, 3);
+
+		vb.set_voxel(air_id, hole_pos, VoxelBuffer::CHANNEL_TYPE);
+		{
+			const BlockyMeshStats stats = build_blocky_mesh(**mesher, vb);
+			ZN_TEST_ASSERT(stats.vertex_count == 6 * 4);
+		}
+
+		// Sides of the glass are hidden by opaque cubes, but cubes can be seen through the glass
+		vb.set_voxel(glass_id, hole_pos, VoxelBuffer::CHANNEL_TYPE);
+		{
+			const BlockyMeshStats stats = build_blocky_mesh(**mesher, vb);
+			ZN_TEST_ASSERT(stats.vertex_count == 6 * 4);
+		}
+
+		vb.set_voxel(cube_id, hole_pos, VoxelBuffer::CHANNEL_TYPE);
+	}
+}
+
+void test_voxel_mesher_blocky_incremental() {
+	const int air_id = 0;
+	const int cube_id = 1;
+
+	Ref<VoxelMesherBlocky> mesher = create_blocky_mesher(false);
+
+	// Block of 16 voxels with padding, so it is made of 2x2x2 bricks
+	VoxelBuffer vb(VoxelBuffer::ALLOCATOR_DEFAULT);
+	vb.create(18, 18, 18);
+	vb.fill_area(cube_id, Vector3i(0, 0, 0), Vector3i(18, 8, 18), VoxelBuffer::CHANNEL_TYPE);
+
+	std::shared_ptr<VoxelMesher::IncrementalCache> cache;
+	{
+		VoxelMesher::Input input{ vb, nullptr, Vector3i(), 0, false, false, false, true, cache, Box3i() };
+		VoxelMesher::Output output;
+		mesher->build(output, input);
+		ZN_TEST_ASSERT(output.incremental_cache != nullptr);
+		cache = output.incremental_cache;
+
+		const BlockyMeshStats stats = get_blocky_mesh_stats(output);
+		const BlockyMeshStats expected_stats = build_blocky_mesh(**mesher, vb);
+		ZN_TEST_ASSERT(stats.vertex_count == expected_stats.vertex_count);
+		ZN_TEST_ASSERT(Math::is_equal_approx(stats.area, expected_stats.area));
+	}
+
+	// Dig next to the corner shared by bricks, faces around the hole are in several of them
+	const Vector3i hole_pos(9, 7, 9);
+	vb.set_voxel(air_id, hole_pos, VoxelBuffer::CHANNEL_TYPE);
+	{
+		// Relative to the block, which excludes padding
+		const Box3i dirty_box(hole_pos - Vector3i(1, 1, 1), Vector3i(1, 1, 1));
+		VoxelMesher::Input input{ vb, nullptr, Vector3i(), 0, false, false, false, true, cache, dirty_box };
+		VoxelMesher::Output output;
+		mesher->build(output, input);
+		ZN_TEST_ASSERT(output.incremental_cache == cache);
+
+		const BlockyMeshStats stats = get_blocky_mesh_stats(output);
+		const BlockyMeshStats expected_stats = build_blocky_mesh(**mesher, vb);
+		ZN_TEST_ASSERT(stats.vertex_count == expected_stats.vertex_count);
+		ZN_TEST_ASSERT(Math::is_equal_approx(stats.area, expected_stats.area));
+		ZN_TEST_ASSERT(Math::is_equal_approx(stats.uv_area, expected_stats.uv_area));
+	}
+}
+
+void test_voxel_mesher_blocky_collision_only() {
+	const int air_id = 0;
+	const int cube_id = 1;
+	const int tile_cube_id = 2;
+
+	Ref<VoxelMesherBlocky> mesher = create_blocky_mesher(false);
+
+	VoxelBuffer vb(VoxelBuffer::ALLOCATOR_DEFAULT);
+	vb.create(18, 18, 18);
+	vb.fill_area(cube_id, Vector3i(0, 0, 0), Vector3i(18, 8, 18), VoxelBuffer::CHANNEL_TYPE);
+	// Different models can still be merged, they have the same collision
+	vb.fill_area(tile_cube_id, Vector3i(0, 6, 0), Vector3i(9, 8, 18), VoxelBuffer::CHANNEL_TYPE);
+	vb.fill_area(air_id, Vector3i(4, 5, 4), Vector3i(9, 8, 12), VoxelBuffer::CHANNEL_TYPE);
+	vb.set_voxel(cube_id, Vector3i(12, 8, 3), VoxelBuffer::CHANNEL_TYPE);
+
+	VoxelMesher::Output full_output;
+	{
+		VoxelMesher::Input input{ vb, nullptr, Vector3i(), 0, true };
+		mesher->build(full_output, input);
+	}
+
+	VoxelMesher::Input input{ vb, nullptr, Vector3i(), 0, true };
+	input.collision_only_hint = true;
+	VoxelMesher::Output output;
+	mesher->build(output, input);
+
+	ZN_TEST_ASSERT(output.surfaces.size() == 0);
+	ZN_TEST_ASSERT(output.collision_surface.indices.size() > 0);
+	// Faces are merged
+	ZN_TEST_ASSERT(output.collision_surface.indices.size() < full_output.collision_surface.indices.size());
+	ZN_TEST_ASSERT(Math::is_equal_approx(
+			get_collision_surface_area(output.collision_surface),
+			get_collision_surface_area(full_output.collision_surface)
+	));
+}
+
+void test_voxel_mesher_blocky_vertex_cache_optimization() {
+	const int air_id = 0;
+	const int cube_id = 1;
+
+	Ref<VoxelMesherBlocky> mesher = create_blocky_mesher(false);
+
+	VoxelBuffer vb(VoxelBuffer::ALLOCATOR_DEFAULT);
+	vb.create(18, 18, 18);
+	vb.fill_area(cube_id, Vector3i(0, 0, 0), Vector3i(18, 8, 18), VoxelBuffer::CHANNEL_TYPE);
+	vb.fill_area(air_id, Vector3i(4, 5, 4), Vector3i(9, 8, 12), VoxelBuffer::CHANNEL_TYPE);
+	vb.set_voxel(cube_id, Vector3i(12, 8, 3), VoxelBuffer::CHANNEL_TYPE);
+
+	const BlockyMeshStats expected_stats = build_blocky_mesh(**mesher, vb);
+
+	VoxelMesher::Input input{ vb, nullptr, Vector3i(), 0, false };
+	VoxelMesher::Output output;
+	mesher->build(output, input);
+
+	const unsigned int cache_size = 16;
+
+	for (VoxelMesher::Output::Surface &surface : output.surfaces) {
+		if (surface.arrays.size() == 0) {
+			continue;
+		}
+
+		const PackedVector3Array positions_before = surface.arrays[Mesh::ARRAY_VERTEX];
+		const PackedInt32Array indices_before = surface.arrays[Mesh::ARRAY_INDEX];
+
+		// Use the first half of faces as sub-mesh. Each face has its own 4 vertices, so the sub-mesh uses vertices
+		// before all the others.
+		const int32_t submesh_index_end = (indices_before.size() / 12) * 6;
+		int32_t submesh_vertex_end = 0;
+		for (int32_t i = 0; i < submesh_index_end; ++i) {
+			submesh_vertex_end = math::max(submesh_vertex_end, indices_before[i] + 1);
+		}
+		ZN_TEST_ASSERT(submesh_index_end > 0);
+
+		optimize_surface_for_vertex_cache(surface.arrays, submesh_vertex_end, submesh_index_end);
+
+		// Triangles must still reference existing vertices
+		const PackedVector3Array positions = surface.arrays[Mesh::ARRAY_VERTEX];
+		const PackedVector3Array normals = surface.arrays[Mesh::ARRAY_NORMAL];
+		const PackedInt32Array indices = surface.arrays[Mesh::ARRAY_INDEX];
+		ZN_TEST_ASSERT(normals.size() == positions.size());
+		ZN_TEST_ASSERT(indices.size() == indices_before.size());
+		for (int i = 0; i < indices.size(); ++i) {
+			ZN_TEST_ASSERT(indices[i] >= 0 && indices[i] < positions.size());
+		}
+
+		// The sub-mesh must still be made of the same triangles, using the first vertices
+		for (int32_t i = 0; i < submesh_index_end; ++i) {
+			ZN_TEST_ASSERT(indices[i] < submesh_vertex_end);
+		}
+		const unsigned int remaining_index_count = indices.size() - submesh_index_end;
+		ZN_TEST_ASSERT(
+				get_sorted_triangles(to_span(positions), to_span(indices).sub(0, submesh_index_end)) ==
+				get_sorted_triangles(to_span(positions_before), to_span(indices_before).sub(0, submesh_index_end))
+		);
+		ZN_TEST_ASSERT(
+				get_sorted_triangles(
+						to_span(positions), to_span(indices).sub(submesh_index_end, remaining_index_count)
+				) ==
+				get_sorted_triangles(
+						to_span(positions_before), to_span(indices_before).sub(submesh_index_end, remaining_index_count)
+				)
+		);
+
+		// Faces don't share vertices, so the mesher's output already has the lowest possible miss count of 4 vertices
+		// per quad. It must not get worse. Meshes sharing vertices are tested with Transvoxel.
+		const unsigned int miss_count_before = get_fifo_vertex_cache_miss_count(to_span(indices_before), cache_size);
+		const unsigned int miss_count = get_fifo_vertex_cache_miss_count(to_span(indices), cache_size);
+		ZN_TEST_ASSERT(miss_count <= miss_count_before);
+	}
+
+	// The same triangles must be present, only their order can change
+	const BlockyMeshStats stats = get_blocky_mesh_stats(output);
+	ZN_TEST_ASSERT(stats.vertex_count == expected_stats.vertex_count);
+	ZN_TEST_ASSERT(Math::is_equal_approx(stats.area, expected_stats.area));
+	ZN_TEST_ASSERT(Math::is_equal_approx(stats.uv_area, expected_stats.uv_area));
+}
+
+void test_voxel_mesher_blocky_vertex_compression() {
+	const int cube_id = 1;
+
+	Ref<VoxelMesherBlocky> mesher = create_blocky_mesher(false);
+	mesher->set_vertex_compression_enabled(true);
+
+	VoxelBuffer vb(VoxelBuffer::ALLOCATOR_DEFAULT);
+	vb.create(18, 18, 18);
+	vb.fill_area(cube_id, Vector3i(0, 0, 0), Vector3i(18, 8, 18), VoxelBuffer::CHANNEL_TYPE);
+	vb.set_voxel(cube_id, Vector3i(12, 8, 3), VoxelBuffer::CHANNEL_TYPE);
+
+	VoxelMesher::Input input{ vb, nullptr, Vector3i(), 0, false };
+	VoxelMesher::Output output;
+	mesher->build(output, input);
+	ZN_TEST_ASSERT((output.mesh_flags & Mesh::ARRAY_FLAG_COMPRESS_ATTRIBUTES) != 0);
+
+	// Attributes packed where the mesh resource is built
+	StdVector<uint16_t> material_indices;
+	Ref<ArrayMesh> mesh_from_arrays =
+			build_mesh(to_span(output.surfaces), output.primitive_type, output.mesh_flags, material_indices);
+
+	// Attributes packed beforehand, like meshing tasks do
+	VoxelMesher::pack_surfaces(output);
+	StdVector<uint16_t> packed_material_indices;
+	Ref<ArrayMesh> mesh_from_packed =
+			build_mesh(to_span(output.surfaces), output.primitive_type, output.mesh_flags, packed_material_indices);
+
+	ZN_TEST_ASSERT(mesh_from_arrays.is_valid());
+	ZN_TEST_ASSERT(mesh_from_packed.is_valid());
+	ZN_TEST_ASSERT(packed_material_indices == material_indices);
+	ZN_TEST_ASSERT(mesh_from_packed->get_surface_count() == mesh_from_arrays->get_surface_count());
+
+	for (int surface_index = 0; surface_index < mesh_from_packed->get_surface_count(); ++surface_index) {
+		const int64_t format = mesh_from_packed->surface_get_format(surface_index);
+		const int64_t expected_format = mesh_from_arrays->surface_get_format(surface_index);
+		ZN_TEST_ASSERT((format & Mesh::ARRAY_FLAG_COMPRESS_ATTRIBUTES) != 0);
+		ZN_TEST_ASSERT(format == expected_format);
+		ZN_TEST_ASSERT(
+				mesh_from_packed->surface_get_array_len(surface_index) ==
+				mesh_from_arrays->surface_get_array_len(surface_index)
+		);
+		ZN_TEST_ASSERT(
+				mesh_from_packed->surface_get_array_index_len(surface_index) ==
+				mesh_from_arrays->surface_get_array_index_len(surface_index)
+		);
+	}
+	ZN_TEST_ASSERT(mesh_from_packed->get_aabb().is_equal_approx(mesh_from_arrays->get_aabb()));
+}
+
+void test_voxel_mesher_blocky_buffer_reuse() {
+	const int air_id = 0;
+	const int cube_id = 1;
+
+	Ref<VoxelMesherBlocky> mesher = create_blocky_mesher(false);
+
+	// Irregular ground so all kinds of geometry are produced
+	VoxelBuffer large_vb(VoxelBuffer::ALLOCATOR_DEFAULT);
+	large_vb.create(34, 34, 34);
+	for (int z = 0; z < 34; ++z) {
+		for (int x = 0; x < 34; ++x) {
+			const int height = 8 + (x * 7 + z * 13) % 16;
+			large_vb.fill_area(cube_id, Vector3i(x, 0, z), Vector3i(x + 1, height, z + 1), VoxelBuffer::CHANNEL_TYPE);
+		}
+	}
+
+	VoxelBuffer small_vb(VoxelBuffer::ALLOCATOR_DEFAULT);
+	small_vb.create(10, 10, 10);
+	small_vb.fill(air_id, VoxelBuffer::CHANNEL_TYPE);
+	small_vb.set_voxel(cube_id, Vector3i(4, 4, 4), VoxelBuffer::CHANNEL_TYPE);
+
+	struct L {
+		static unsigned int build(VoxelMesherBlocky &mesher, const VoxelBuffer &vb) {
+			VoxelMesher::Input input{ vb, nullptr, Vector3i(), 0, true };
+			VoxelMesher::Output output;
+			mesher.build(output, input);
+			unsigned int vertex_count = 0;
+			for (const VoxelMesher::Output::Surface &surface : output.surfaces) {
+				const PackedVector3Array positions = surface.arrays[Mesh::ARRAY_VERTEX];
+				const PackedInt32Array indices = surface.arrays[Mesh::ARRAY_INDEX];
+				// Output arrays are copied from the reused buffers with their final size
+				ZN_TEST_ASSERT(positions.size() > 0);
+				ZN_TEST_ASSERT(indices.size() > 0);
+				vertex_count += positions.size();
+			}
+			return vertex_count;
+		}
+	};
+
+	// The first build grows buffers
+	const unsigned int vertex_count = L::build(**mesher, large_vb);
+	ZN_TEST_ASSERT(vertex_count > 0);
+	const size_t capacity = VoxelMesherBlocky::get_tls_cache_capacity_in_bytes();
+	ZN_TEST_ASSERT(capacity > 0);
+
+	// Next builds of the same size reuse them without allocating
+	ZN_TEST_ASSERT(L::build(**mesher, large_vb) == vertex_count);
+	ZN_TEST_ASSERT(VoxelMesherBlocky::get_tls_cache_capacity_in_bytes() == capacity);
+
+	// Smaller builds keep the capacity for later ones
+	ZN_TEST_ASSERT(L::build(**mesher, small_vb) > 0);
+	ZN_TEST_ASSERT(VoxelMesherBlocky::get_tls_cache_capacity_in_bytes() == capacity);
+	ZN_TEST_ASSERT(L::build(**mesher, large_vb) == vertex_count);
+	ZN_TEST_ASSERT(VoxelMesherBlocky::get_tls_cache_capacity_in_bytes() == capacity);
+}
+
+void test_voxel_mesher_blocky_padded_view() {
+	const int air_id = 0;
+	const int cube_id = 1;
+	const int block_size = 16;
+
+	// 3x3x3 blocks of ground. Bottom blocks are full and top blocks are empty, so they are uniform.
+	VoxelBuffer src(VoxelBuffer::ALLOCATOR_DEFAULT);
+	src.create(Vector3iUtil::create(3 * block_size));
+	src.fill(air_id, VoxelBuffer::CHANNEL_TYPE);
+	for (int z = 0; z < src.get_size().z; ++z) {
+		for (int x = 0; x < src.get_size().x; ++x) {
+			const int height = block_size + 1 + (x * 7 + z * 13) % (block_size - 2);
+			src.fill_area(cube_id, Vector3i(x, 0, z), Vector3i(x + 1, height, z + 1), VoxelBuffer::CHANNEL_TYPE);
+		}
+	}
+	const StdVector<std::shared_ptr<VoxelBuffer>> blocks = split_into_blocks(src, block_size);
+	ZN_TEST_ASSERT(blocks[0]->is_uniform(VoxelBuffer::CHANNEL_TYPE));
+
+	Ref<VoxelMesherBlocky> mesher = create_blocky_mesher(false);
+	ZN_TEST_ASSERT(mesher->supports_padded_view());
+	const int min_padding = mesher->get_minimum_padding();
+	const int max_padding = mesher->get_maximum_padding();
+
+	VoxelBufferPaddedView view;
+	ZN_TEST_ASSERT(view.create(to_span(blocks), block_size, min_padding, max_padding));
+	ZN_TEST_ASSERT(view.get_size() == Vector3iUtil::create(block_size + min_padding + max_padding));
+
+	// Same area copied into a single buffer
+	VoxelBuffer copy(VoxelBuffer::ALLOCATOR_DEFAULT);
+	copy.create(view.get_size());
+	copy.copy_channel_from(
+			src,
+			Vector3iUtil::create(block_size - min_padding),
+			Vector3iUtil::create(2 * block_size + max_padding),
+			Vector3i(),
+			VoxelBuffer::CHANNEL_TYPE
+	);
+	{
+		VoxelBuffer copy_from_view(VoxelBuffer::ALLOCATOR_DEFAULT);
+		copy_from_view.create(view.get_size());
+		view.copy_to(copy_from_view, (1 << VoxelBuffer::CHANNEL_TYPE));
+		ZN_TEST_ASSERT(copy_from_view.equals(copy));
+		const Vector3i pos(3, 5, 7);
+		ZN_TEST_ASSERT(
+				view.get_voxel(pos, VoxelBuffer::CHANNEL_TYPE) == copy.get_voxel(pos, VoxelBuffer::CHANNEL_TYPE)
+		);
+	}
+
+	VoxelMesher::Output copy_output;
+	{
+		VoxelMesher::Input input{ copy, nullptr, Vector3i(), 0, true };
+		mesher->build(copy_output, input);
+	}
+
+	VoxelMesher::Output view_output;
+	{
+		// Only gives the size and format of the area
+		VoxelBuffer area(VoxelBuffer::ALLOCATOR_DEFAULT);
+		area.create(view.get_size());
+		VoxelMesher::Input input{ area, nullptr, Vector3i(), 0, true };
+		input.padded_view = &view;
+		mesher->build(view_output, input);
+	}
+
+	ZN_TEST_ASSERT(get_blocky_mesh_stats(copy_output).vertex_count > 0);
+	ZN_TEST_ASSERT(mesher_outputs_equal(view_output, copy_output));
+}
+
+} // namespace zylann::voxel::tests
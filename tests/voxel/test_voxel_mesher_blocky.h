@@ -0,0 +1,17 @@
+#ifndef VOXEL_TESTS_VOXEL_MESHER_BLOCKY_H
+#define VOXEL_TESTS_VOXEL_MESHER_BLOCKY_H
+
+namespace zylann::voxel::tests {
+
+void test_voxel_mesher_blocky_greedy();
+void test_voxel_mesher_blocky_culling();
+void test_voxel_mesher_blocky_incremental();
+void test_voxel_mesher_blocky_collision_only();
+void test_voxel_mesher_blocky_vertex_cache_optimization();
+void test_voxel_mesher_blocky_vertex_compression();
+void test_voxel_mesher_blocky_buffer_reuse();
+void test_voxel_mesher_blocky_padded_view();
+
+} // namespace zylann::voxel::tests
+
+#endif // VOXEL_TESTS_VOXEL_MESHER_BLOCKY_H
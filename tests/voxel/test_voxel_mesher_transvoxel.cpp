@@ -0,0 +1,420 @@
+#include "test_voxel_mesher_transvoxel.h"
+#include "../../meshers/transvoxel/transvoxel.h"
+#include "../../meshers/mesh_block_task.h"
+#include "../../meshers/transvoxel/voxel_mesher_transvoxel.h"
+#include "../../meshers/vertex_cache_optimization.h"
+#include "../../storage/voxel_buffer.h"
+#include "../../storage/voxel_buffer_padded_view.h"
+#include "../../terrain/variable_lod/voxel_mesh_block_vlt.h"
+#include "../../util/godot/classes/array_mesh.h"
+#include "../../util/godot/classes/mesh.h"
+#include "../../util/godot/core/packed_arrays.h"
+#include "../../util/math/vector3f.h"
+#include "../../util/testing/test_macros.h"
+#include "test_util.h"
+
+namespace zylann::voxel::tests {
+
+namespace {
+
+enum TestSdfShape {
+	// Slightly tilted plane, crossing the sides of the block along X and Z
+	TEST_SDF_TILTED_PLANE,
+	// Plane lining up with integer coordinates, so a whole layer of voxels is exactly zero
+	TEST_SDF_FLAT_PLANE,
+	TEST_SDF_SPHERE,
+	// Values among -1, 0 and 1, covering cells with any combination of zero corners
+	TEST_SDF_NOISE,
+	TEST_SDF_SHAPE_COUNT
+};
+
+void fill_test_sdf(VoxelBuffer &vb, const TestSdfShape shape) {
+	const Vector3i size = vb.get_size();
+	uint32_t seed = 131;
+	for (int z = 0; z < size.z; ++z) {
+		for (int x = 0; x < size.x; ++x) {
+			for (int y = 0; y < size.y; ++y) {
+				float sd = 0.f;
+				switch (shape) {
+					case TEST_SDF_TILTED_PLANE:
+						sd = static_cast<float>(y) - 9.5f + 0.25f * (x - 9) + 0.1f * (z - 9);
+						break;
+					case TEST_SDF_FLAT_PLANE:
+						sd = static_cast<float>(y - 9);
+						break;
+					case TEST_SDF_SPHERE:
+						sd = math::length(Vector3f(x - 9.f, y - 9.f, z - 9.f)) - 6.f;
+						break;
+					case TEST_SDF_NOISE:
+						seed = seed * 1103515245 + 12345;
+						sd = static_cast<float>(static_cast<int>((seed >> 16) % 3) - 1);
+						break;
+					default:
+						ZN_CRASH();
+				}
+				vb.set_voxel_f(sd, x, y, z, VoxelBuffer::CHANNEL_SDF);
+			}
+		}
+	}
+}
+
+struct TransvoxelMeshCounts {
+	unsigned int vertex_count = 0;
+	unsigned int index_count = 0;
+};
+
+TransvoxelMeshCounts get_mesh_counts(const VoxelMesher::Output &output) {
+	ZN_TEST_ASSERT_V(output.surfaces.size() == 1, TransvoxelMeshCounts());
+	const PackedVector3Array positions = output.surfaces[0].arrays[Mesh::ARRAY_VERTEX];
+	const PackedInt32Array indices = output.surfaces[0].arrays[Mesh::ARRAY_INDEX];
+	return { static_cast<unsigned int>(positions.size()), static_cast<unsigned int>(indices.size()) };
+}
+
+} // namespace
+
+void test_voxel_mesher_transvoxel_lazy_transitions() {
+	VoxelBuffer vb(VoxelBuffer::ALLOCATOR_DEFAULT);
+	vb.create(Vector3iUtil::create(16 + transvoxel::MIN_PADDING + transvoxel::MAX_PADDING));
+	fill_test_sdf(vb, TEST_SDF_TILTED_PLANE);
+
+	Ref<VoxelMesherTransvoxel> mesher;
+	mesher.instantiate();
+	mesher->set_lazy_transitions_enabled(true);
+
+	const uint8_t first_mask = (1 << Cube::SIDE_NEGATIVE_X);
+	const uint8_t second_mask = first_mask | (1 << Cube::SIDE_POSITIVE_Z);
+
+	// Only the transition mesh of the first side is built
+	VoxelMesher::Output output1;
+	{
+		VoxelMesher::Input input{
+			vb, nullptr, Vector3i(), 0, false, true, false, true, nullptr, Box3i(), false, first_mask
+		};
+		mesher->build(output1, input);
+	}
+	ZN_TEST_ASSERT(output1.incremental_cache != nullptr);
+
+	// Voxels didn't change, so the regular mesh and the first transition mesh come from the cache
+	VoxelMesher::Output output2;
+	{
+		VoxelMesher::Input input{
+			vb, nullptr, Vector3i(), 0, false, true, false, true, output1.incremental_cache, Box3i(), false, second_mask
+		};
+		mesher->build(output2, input);
+	}
+
+	// Same sides, built without cache
+	VoxelMesher::Output output3;
+	{
+		VoxelMesher::Input input{
+			vb, nullptr, Vector3i(), 0, false, true, false, false, nullptr, Box3i(), false, second_mask
+		};
+		mesher->build(output3, input);
+	}
+
+	// All sides
+	mesher->set_lazy_transitions_enabled(false);
+	VoxelMesher::Output output4;
+	{
+		VoxelMesher::Input input{ vb, nullptr, Vector3i(), 0, false, true };
+		mesher->build(output4, input);
+	}
+
+	const int32_t regular_vertex_count = output3.collision_surface.submesh_vertex_end;
+	ZN_TEST_ASSERT(regular_vertex_count > 0);
+	ZN_TEST_ASSERT(output1.collision_surface.submesh_vertex_end == regular_vertex_count);
+	ZN_TEST_ASSERT(output2.collision_surface.submesh_vertex_end == regular_vertex_count);
+	ZN_TEST_ASSERT(output4.collision_surface.submesh_vertex_end == regular_vertex_count);
+
+	const TransvoxelMeshCounts counts1 = get_mesh_counts(output1);
+	const TransvoxelMeshCounts counts2 = get_mesh_counts(output2);
+	const TransvoxelMeshCounts counts3 = get_mesh_counts(output3);
+	const TransvoxelMeshCounts counts4 = get_mesh_counts(output4);
+
+	ZN_TEST_ASSERT(counts1.vertex_count > static_cast<unsigned int>(regular_vertex_count));
+	ZN_TEST_ASSERT(counts2.vertex_count > counts1.vertex_count);
+	ZN_TEST_ASSERT(counts2.vertex_count == counts3.vertex_count);
+	ZN_TEST_ASSERT(counts2.index_count == counts3.index_count);
+	ZN_TEST_ASSERT(counts4.vertex_count > counts3.vertex_count);
+}
+
+void test_voxel_mesher_transvoxel_delayed_transition_mesh() {
+	// When transitions are built lazily, a block can be asked to show a transition side before the mesh having it
+	// arrives. That side must stay disabled until then, otherwise the shader shrinks the border of the regular mesh
+	// with nothing to fill the gap.
+	const uint8_t nx = 1 << Cube::SIDE_NEGATIVE_X;
+	const uint8_t px = 1 << Cube::SIDE_POSITIVE_X;
+
+	VoxelMeshBlockVLT block(Vector3i(), 16, 0);
+
+	// First mesh, built with only -X
+	block.set_transition_mask(nx);
+	ZN_TEST_ASSERT(block.get_transition_mask() == 0);
+	block.set_meshed_transition_mask(nx);
+	ZN_TEST_ASSERT(block.get_transition_mask() == nx);
+
+	// A neighbor changed LOD, +X is now needed. A remesh is sent with -X and +X, but hasn't completed yet.
+	block.set_transition_mask(nx | px);
+	ZN_TEST_ASSERT(block.get_transition_mask() == nx);
+
+	// Another neighbor changed before the remesh completed, -X is no longer needed
+	block.set_transition_mask(px);
+	ZN_TEST_ASSERT(block.get_transition_mask() == 0);
+
+	// The delayed remesh arrives
+	block.set_meshed_transition_mask(nx | px);
+	ZN_TEST_ASSERT(block.get_transition_mask() == px);
+
+	// Sides the mesh has but which aren't requested stay hidden
+	block.set_transition_mask(0);
+	ZN_TEST_ASSERT(block.get_transition_mask() == 0);
+	ZN_TEST_ASSERT(block.get_meshed_transition_mask() == (nx | px));
+
+	// Visuals dropped, a new mesh will be needed before any side can show again
+	block.set_transition_mask(px);
+	block.drop_visuals();
+	block.set_transition_mask(px);
+	ZN_TEST_ASSERT(block.get_transition_mask() == 0);
+}
+
+void test_voxel_mesher_transvoxel_case_codes() {
+	// Regular cells are classified by a vectorized pre-pass. Its output must match the per-cell case code defined by
+	// Transvoxel, which uses the sign bit of the negated SDF.
+	const VoxelBuffer::Depth depths[] = {
+		VoxelBuffer::DEPTH_8_BIT, //
+		VoxelBuffer::DEPTH_16_BIT, //
+		VoxelBuffer::DEPTH_32_BIT //
+	};
+
+	for (const VoxelBuffer::Depth depth : depths) {
+		for (unsigned int shape = 0; shape < TEST_SDF_SHAPE_COUNT; ++shape) {
+			VoxelBuffer vb(VoxelBuffer::ALLOCATOR_DEFAULT);
+			vb.create(Vector3iUtil::create(16 + transvoxel::MIN_PADDING + transvoxel::MAX_PADDING));
+			vb.set_channel_depth(VoxelBuffer::CHANNEL_SDF, depth);
+			fill_test_sdf(vb, static_cast<TestSdfShape>(shape));
+
+			transvoxel::Cache cache;
+			transvoxel::MeshArrays arrays;
+			StdVector<transvoxel::CellInfo> cell_infos;
+			transvoxel::build_regular_mesh(
+					vb,
+					VoxelBuffer::CHANNEL_SDF,
+					0,
+					transvoxel::TEXTURES_NONE,
+					cache,
+					arrays,
+					&cell_infos,
+					0.f,
+					false
+			);
+
+			// Reference: cells are visited in X, then Y, then Z order, and produce geometry if their case code is
+			// neither 0 nor 255
+			const Vector3i min_pos = Vector3iUtil::create(transvoxel::MIN_PADDING);
+			const Vector3i max_pos = vb.get_size() - Vector3iUtil::create(transvoxel::MAX_PADDING);
+			unsigned int cell_index = 0;
+			unsigned int triangle_count = 0;
+			Vector3i pos;
+			for (pos.z = min_pos.z; pos.z < max_pos.z; ++pos.z) {
+				for (pos.y = min_pos.y; pos.y < max_pos.y; ++pos.y) {
+					for (pos.x = min_pos.x; pos.x < max_pos.x; ++pos.x) {
+						uint8_t case_code = 0;
+						for (unsigned int i = 0; i < 8; ++i) {
+							const Vector3i corner = pos + Vector3i(i & 1, (i >> 1) & 1, (i >> 2) & 1);
+							// Same as `sign_f(sdf_as_float(v))`
+							const float negated_sd = -vb.get_voxel_f(corner, VoxelBuffer::CHANNEL_SDF);
+							case_code |= static_cast<uint8_t>(negated_sd < 0.f) << i;
+						}
+						if (case_code == 0 || case_code == 255) {
+							continue;
+						}
+						ZN_TEST_ASSERT(cell_index < cell_infos.size());
+						const transvoxel::CellInfo &cell_info = cell_infos[cell_index];
+						ZN_TEST_ASSERT(cell_info.position == pos - min_pos);
+						ZN_TEST_ASSERT(cell_info.triangle_count > 0);
+						triangle_count += cell_info.triangle_count;
+						++cell_index;
+					}
+				}
+			}
+			ZN_TEST_ASSERT(cell_index == cell_infos.size());
+			ZN_TEST_ASSERT(triangle_count * 3 == arrays.indices.size());
+
+			if (shape == TEST_SDF_NOISE) {
+				// Normals are not meaningful
+				continue;
+			}
+			ZN_TEST_ASSERT(triangle_count > 0);
+
+			// Front faces are clockwise when seen from the air side, which is where normals point to. Case codes with
+			// inverted bits would flip all triangles.
+			for (unsigned int i = 0; i < arrays.indices.size(); i += 3) {
+				const int32_t i0 = arrays.indices[i];
+				const int32_t i1 = arrays.indices[i + 1];
+				const int32_t i2 = arrays.indices[i + 2];
+				const Vector3f p0 = arrays.vertices[i0];
+				const Vector3f face_normal = math::cross(arrays.vertices[i1] - p0, arrays.vertices[i2] - p0);
+				if (math::length_squared(face_normal) < 0.0001f) {
+					// Degenerate triangles can occur around zero corners
+					continue;
+				}
+				const Vector3f normal = arrays.normals[i0] + arrays.normals[i1] + arrays.normals[i2];
+				ZN_TEST_ASSERT(math::dot(face_normal, normal) < 0.f);
+			}
+		}
+	}
+}
+
+void test_voxel_mesher_transvoxel_vertex_cache_optimization() {
+	VoxelBuffer vb(VoxelBuffer::ALLOCATOR_DEFAULT);
+	vb.create(Vector3iUtil::create(16 + transvoxel::MIN_PADDING + transvoxel::MAX_PADDING));
+	fill_test_sdf(vb, TEST_SDF_SPHERE);
+
+	Ref<VoxelMesherTransvoxel> mesher;
+	mesher.instantiate();
+
+	// With transition meshes, which come after the range of the regular mesh used for collisions
+	VoxelMesher::Output output;
+	VoxelMesher::Input input{ vb, nullptr, Vector3i(), 0, true, true };
+	mesher->build(output, input);
+	ZN_TEST_ASSERT(output.surfaces.size() == 1);
+
+	Array &arrays = output.surfaces[0].arrays;
+	const PackedVector3Array positions_before = arrays[Mesh::ARRAY_VERTEX];
+	const PackedInt32Array indices_before = arrays[Mesh::ARRAY_INDEX];
+	const int32_t submesh_vertex_end = output.collision_surface.submesh_vertex_end;
+	const int32_t submesh_index_end = output.collision_surface.submesh_index_end;
+	ZN_TEST_ASSERT(submesh_index_end > 0 && submesh_index_end < indices_before.size());
+
+	optimize_surface_for_vertex_cache(arrays, submesh_vertex_end, submesh_index_end);
+
+	const PackedVector3Array positions = arrays[Mesh::ARRAY_VERTEX];
+	const PackedVector3Array normals = arrays[Mesh::ARRAY_NORMAL];
+	const PackedInt32Array indices = arrays[Mesh::ARRAY_INDEX];
+	ZN_TEST_ASSERT(normals.size() == positions.size());
+	ZN_TEST_ASSERT(indices.size() == indices_before.size());
+	for (int i = 0; i < indices.size(); ++i) {
+		ZN_TEST_ASSERT(indices[i] >= 0 && indices[i] < positions.size());
+	}
+
+	// The collision sub-mesh is picked from the same ranges after optimization, so it must still be made of the same
+	// triangles, using the first vertices. Same for the rest of the mesh.
+	for (int32_t i = 0; i < submesh_index_end; ++i) {
+		ZN_TEST_ASSERT(indices[i] < submesh_vertex_end);
+	}
+	const unsigned int remaining_index_count = indices.size() - submesh_index_end;
+	ZN_TEST_ASSERT(
+			get_sorted_triangles(to_span(positions), to_span(indices).sub(0, submesh_index_end)) ==
+			get_sorted_triangles(to_span(positions_before), to_span(indices_before).sub(0, submesh_index_end))
+	);
+	ZN_TEST_ASSERT(
+			get_sorted_triangles(to_span(positions), to_span(indices).sub(submesh_index_end, remaining_index_count)) ==
+			get_sorted_triangles(
+					to_span(positions_before), to_span(indices_before).sub(submesh_index_end, remaining_index_count)
+			)
+	);
+
+	// Vertices are shared between triangles, so reordering them must reduce cache misses
+	const unsigned int cache_size = 16;
+	const unsigned int triangle_count = indices.size() / 3;
+	const float acmr_before =
+			static_cast<float>(get_fifo_vertex_cache_miss_count(to_span(indices_before), cache_size)) / triangle_count;
+	const float acmr =
+			static_cast<float>(get_fifo_vertex_cache_miss_count(to_span(indices), cache_size)) / triangle_count;
+	ZN_TEST_ASSERT(acmr < acmr_before);
+}
+
+void test_voxel_mesher_transvoxel_vertex_compression() {
+	VoxelBuffer vb(VoxelBuffer::ALLOCATOR_DEFAULT);
+	vb.create(Vector3iUtil::create(16 + transvoxel::MIN_PADDING + transvoxel::MAX_PADDING));
+	fill_test_sdf(vb, TEST_SDF_SPHERE);
+
+	Ref<VoxelMesherTransvoxel> mesher;
+	mesher.instantiate();
+	mesher->set_vertex_compression_enabled(true);
+
+	VoxelMesher::Output output;
+	VoxelMesher::Input input{ vb, nullptr, Vector3i(), 0, false, true };
+	mesher->build(output, input);
+	ZN_TEST_ASSERT((output.mesh_flags & Mesh::ARRAY_FLAG_COMPRESS_ATTRIBUTES) != 0);
+
+	VoxelMesher::pack_surfaces(output);
+	StdVector<uint16_t> material_indices;
+	Ref<ArrayMesh> mesh =
+			build_mesh(to_span(output.surfaces), output.primitive_type, output.mesh_flags, material_indices);
+	ZN_TEST_ASSERT(mesh.is_valid());
+	ZN_TEST_ASSERT(mesh->get_surface_count() == 1);
+
+	const int64_t format = mesh->surface_get_format(0);
+	ZN_TEST_ASSERT((format & Mesh::ARRAY_FLAG_COMPRESS_ATTRIBUTES) != 0);
+	// Transition data in CUSTOM0 is read as floats by shaders, so it must keep its format
+	const int64_t custom0_mask = Mesh::ARRAY_FORMAT_CUSTOM_MASK << Mesh::ARRAY_FORMAT_CUSTOM0_SHIFT;
+	ZN_TEST_ASSERT((format & custom0_mask) == (static_cast<int64_t>(output.mesh_flags) & custom0_mask));
+	const PackedVector3Array positions = output.surfaces[0].arrays[Mesh::ARRAY_VERTEX];
+	ZN_TEST_ASSERT(mesh->surface_get_array_len(0) == positions.size());
+}
+
+void test_voxel_mesher_transvoxel_padded_view() {
+	const int block_size = 16;
+
+	// 3x3x3 blocks with a wavy ground in the middle layer. SDF is clamped, so bottom and top blocks are uniform.
+	VoxelBuffer src(VoxelBuffer::ALLOCATOR_DEFAULT);
+	src.create(Vector3iUtil::create(3 * block_size));
+	for (int z = 0; z < src.get_size().z; ++z) {
+		for (int x = 0; x < src.get_size().x; ++x) {
+			const float height = 24.f + 3.f * Math::sin(0.4f * x) + 2.f * Math::cos(0.3f * z);
+			for (int y = 0; y < src.get_size().y; ++y) {
+				const float sd = math::clamp(static_cast<float>(y) - height, -2.f, 2.f);
+				src.set_voxel_f(sd, x, y, z, VoxelBuffer::CHANNEL_SDF);
+			}
+		}
+	}
+	const StdVector<std::shared_ptr<VoxelBuffer>> blocks = split_into_blocks(src, block_size);
+	ZN_TEST_ASSERT(blocks[0]->is_uniform(VoxelBuffer::CHANNEL_SDF));
+
+	Ref<VoxelMesherTransvoxel> mesher;
+	mesher.instantiate();
+	ZN_TEST_ASSERT(mesher->supports_padded_view());
+	const int min_padding = mesher->get_minimum_padding();
+	const int max_padding = mesher->get_maximum_padding();
+
+	VoxelBufferPaddedView view;
+	ZN_TEST_ASSERT(view.create(to_span(blocks), block_size, min_padding, max_padding));
+
+	// Same area copied into a single buffer
+	VoxelBuffer copy(VoxelBuffer::ALLOCATOR_DEFAULT);
+	copy.create(view.get_size());
+	copy.copy_channel_from(
+			src,
+			Vector3iUtil::create(block_size - min_padding),
+			Vector3iUtil::create(2 * block_size + max_padding),
+			Vector3i(),
+			VoxelBuffer::CHANNEL_SDF
+	);
+
+	VoxelBuffer area(VoxelBuffer::ALLOCATOR_DEFAULT);
+	area.create(view.get_size());
+
+	// With transition meshes on every side
+	VoxelMesher::Output copy_output;
+	{
+		VoxelMesher::Input input{ copy, nullptr, Vector3i(), 0, false, true };
+		mesher->build(copy_output, input);
+	}
+	VoxelMesher::Output view_output;
+	{
+		VoxelMesher::Input input{ area, nullptr, Vector3i(), 0, false, true };
+		input.padded_view = &view;
+		mesher->build(view_output, input);
+	}
+	ZN_TEST_ASSERT(get_mesh_counts(copy_output).index_count > 0);
+	ZN_TEST_ASSERT(copy_output.collision_surface.submesh_index_end <
+				   static_cast<int32_t>(get_mesh_counts(copy_output).index_count));
+	ZN_TEST_ASSERT(mesher_outputs_equal(view_output, copy_output));
+
+	// Texturing reads other channels, which requires a copy
+	mesher->set_texturing_mode(VoxelMesherTransvoxel::TEXTURES_SINGLE_S4);
+	ZN_TEST_ASSERT(!mesher->supports_padded_view());
+}
+
+} // namespace zylann::voxel::tests
@@ -0,0 +1,15 @@
+#ifndef VOXEL_TESTS_VOXEL_MESHER_TRANSVOXEL_H
+#define VOXEL_TESTS_VOXEL_MESHER_TRANSVOXEL_H
+
+namespace zylann::voxel::tests {
+
+void test_voxel_mesher_transvoxel_lazy_transitions();
+void test_voxel_mesher_transvoxel_delayed_transition_mesh();
+void test_voxel_mesher_transvoxel_case_codes();
+void test_voxel_mesher_transvoxel_vertex_cache_optimization();
+void test_voxel_mesher_transvoxel_vertex_compression();
+void test_voxel_mesher_transvoxel_padded_view();
+
+} // namespace zylann::voxel::tests
+
+#endif // VOXEL_TESTS_VOXEL_MESHER_TRANSVOXEL_H
@@ -31,6 +31,15 @@ inline Error rename_directory(const String &from, const String &to) {
 	return DirAccess::rename_absolute(from, to);
 }
 
+// Replaces the destination if it exists
+inline Error rename_file(const String &from, const String &to) {
+	return DirAccess::rename_absolute(from, to);
+}
+
+inline Error remove_file(const String &path) {
+	return DirAccess::remove_absolute(path);
+}
+
 } // namespace zylann::godot
 
 #endif // ZN_GODOT_DIRECTORY_H
@@ -0,0 +1,108 @@
+#include "hash_funcs.h"
+#include <cstring>
+
+namespace zylann {
+
+namespace {
+
+const uint64_t XXH_PRIME64_1 = 0x9E3779B185EBCA87ULL;
+const uint64_t XXH_PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+const uint64_t XXH_PRIME64_3 = 0x165667B19E3779F9ULL;
+const uint64_t XXH_PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+const uint64_t XXH_PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64_t rotl64(uint64_t x, unsigned int r) {
+	return (x << r) | (x >> (64 - r));
+}
+
+// Reads are done with memcpy so they work with unaligned data. Assumes a little-endian platform.
+inline uint64_t read_u64(const uint8_t *p) {
+	uint64_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+inline uint32_t read_u32(const uint8_t *p) {
+	uint32_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+inline uint64_t xxh64_round(uint64_t acc, uint64_t input) {
+	acc += input * XXH_PRIME64_2;
+	acc = rotl64(acc, 31);
+	acc *= XXH_PRIME64_1;
+	return acc;
+}
+
+inline uint64_t xxh64_merge_round(uint64_t acc, uint64_t val) {
+	val = xxh64_round(0, val);
+	acc ^= val;
+	acc = acc * XXH_PRIME64_1 + XXH_PRIME64_4;
+	return acc;
+}
+
+} // namespace
+
+uint64_t hash_xxh64(const uint8_t *data, size_t size, uint64_t seed) {
+	const uint8_t *p = data;
+	const uint8_t *const end = data + size;
+	uint64_t h;
+
+	if (size >= 32) {
+		const uint8_t *const limit = end - 32;
+		uint64_t v1 = seed + XXH_PRIME64_1 + XXH_PRIME64_2;
+		uint64_t v2 = seed + XXH_PRIME64_2;
+		uint64_t v3 = seed;
+		uint64_t v4 = seed - XXH_PRIME64_1;
+
+		do {
+			v1 = xxh64_round(v1, read_u64(p));
+			v2 = xxh64_round(v2, read_u64(p + 8));
+			v3 = xxh64_round(v3, read_u64(p + 16));
+			v4 = xxh64_round(v4, read_u64(p + 24));
+			p += 32;
+		} while (p <= limit);
+
+		h = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+		h = xxh64_merge_round(h, v1);
+		h = xxh64_merge_round(h, v2);
+		h = xxh64_merge_round(h, v3);
+		h = xxh64_merge_round(h, v4);
+
+	} else {
+		h = seed + XXH_PRIME64_5;
+	}
+
+	h += static_cast<uint64_t>(size);
+
+	while (p + 8 <= end) {
+		const uint64_t k1 = xxh64_round(0, read_u64(p));
+		h ^= k1;
+		h = rotl64(h, 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+		p += 8;
+	}
+
+	if (p + 4 <= end) {
+		h ^= static_cast<uint64_t>(read_u32(p)) * XXH_PRIME64_1;
+		h = rotl64(h, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+		p += 4;
+	}
+
+	while (p < end) {
+		h ^= (*p) * XXH_PRIME64_5;
+		h = rotl64(h, 11) * XXH_PRIME64_1;
+		++p;
+	}
+
+	// Avalanche
+	h ^= h >> 33;
+	h *= XXH_PRIME64_2;
+	h ^= h >> 29;
+	h *= XXH_PRIME64_3;
+	h ^= h >> 32;
+
+	return h;
+}
+
+} // namespace zylann
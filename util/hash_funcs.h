@@ -2,6 +2,7 @@
 #define ZN_HASH_FUNCS_H
 
 #include "math/funcs.h"
+#include <cstddef>
 #include <cstdint>
 
 namespace zylann {
@@ -43,6 +44,10 @@ inline uint32_t hash_fmix32(uint32_t h) {
 	return h;
 }
 
+// xxHash64, suitable to hash large buffers quickly (see https://github.com/Cyan4973/xxHash).
+// Produces the same results as the reference implementation.
+uint64_t hash_xxh64(const uint8_t *data, size_t size, uint64_t seed = 0);
+
 } // namespace zylann
 
 #endif // ZN_HASH_FUNCS_H
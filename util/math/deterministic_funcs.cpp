@@ -0,0 +1,267 @@
+#include "deterministic_funcs.h"
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+// Polynomials and range reductions are those of the Cephes library (single-precision versions), by Stephen L. Moshier.
+// Evaluation order is spelled out on purpose, don't refactor expressions in a way that changes it.
+
+namespace zylann::math {
+
+namespace {
+
+const float INF = std::numeric_limits<float>::infinity();
+const float NAN_F = std::numeric_limits<float>::quiet_NaN();
+
+inline uint32_t float_to_bits(float f) {
+	uint32_t bits;
+	memcpy(&bits, &f, sizeof(float));
+	return bits;
+}
+
+inline float bits_to_float(uint32_t bits) {
+	float f;
+	memcpy(&f, &bits, sizeof(float));
+	return f;
+}
+
+// Returns 2^e for e in [-126, 127]
+inline float make_power_of_2(int e) {
+	return bits_to_float(static_cast<uint32_t>(e + 127) << 23);
+}
+
+// x must be positive and finite
+float deterministic_log2(float x) {
+	uint32_t bits = float_to_bits(x);
+	int e = static_cast<int>((bits >> 23) & 0xff);
+	if (e == 0) {
+		// Subnormal, normalize it first
+		x *= 8388608.f; // 2^23
+		bits = float_to_bits(x);
+		e = static_cast<int>((bits >> 23) & 0xff) - 23;
+	}
+	e -= 127;
+
+	// Mantissa in [1, 2)
+	float m = bits_to_float((bits & 0x007fffff) | 0x3f800000);
+	// Center it around 1, in [sqrt(0.5), sqrt(2)]
+	if (m > 1.41421356f) {
+		m *= 0.5f;
+		++e;
+	}
+
+	const float t = m - 1.f;
+	const float z = t * t;
+	float r = 7.0376836292e-2f;
+	r = r * t - 1.1514610310e-1f;
+	r = r * t + 1.1676998740e-1f;
+	r = r * t - 1.2420140846e-1f;
+	r = r * t + 1.4249322787e-1f;
+	r = r * t - 1.6668057665e-1f;
+	r = r * t + 2.0000714765e-1f;
+	r = r * t - 2.4999993993e-1f;
+	r = r * t + 3.3333331174e-1f;
+	r = r * t * z;
+	r = r - 0.5f * z;
+	const float ln_m = t + r;
+
+	return ln_m * 1.44269504088896341f + static_cast<float>(e);
+}
+
+float deterministic_exp2(float x) {
+	if (x != x) {
+		return x;
+	}
+	if (x >= 128.f) {
+		return INF;
+	}
+	if (x < -150.f) {
+		return 0.f;
+	}
+
+	// Split into an integer and a fraction in [-0.5, 0.5]
+	int i = static_cast<int>(x + 0.5f);
+	if (static_cast<float>(i) > x + 0.5f) {
+		// Conversion truncated towards zero, we want floor
+		--i;
+	}
+	const float f = x - static_cast<float>(i);
+
+	float r = 1.535336188319500e-4f;
+	r = r * f + 1.339887440266574e-3f;
+	r = r * f + 9.618437357674640e-3f;
+	r = r * f + 5.550332471162809e-2f;
+	r = r * f + 2.402264791363012e-1f;
+	r = r * f + 6.931472028550421e-1f;
+	r = r * f;
+	r = r + 1.f;
+
+	// Scale by 2^i, in steps when i is outside the range of normal exponents
+	if (i > 127) {
+		r *= 2.f;
+		--i;
+	}
+	if (i < -126) {
+		r *= make_power_of_2(-24);
+		i += 24;
+	}
+	return r * make_power_of_2(i);
+}
+
+float deterministic_atan(float x) {
+	float sign = 1.f;
+	if (x < 0.f) {
+		x = -x;
+		sign = -1.f;
+	}
+
+	// Reduce to [0, tan(PI/8)]
+	float y;
+	if (x > 2.414213562373095f) {
+		y = 1.5707963267948966f;
+		x = -1.f / x;
+	} else if (x > 0.4142135623730950f) {
+		y = 0.7853981633974483f;
+		x = (x - 1.f) / (x + 1.f);
+	} else {
+		y = 0.f;
+	}
+
+	const float z = x * x;
+	float r = 8.05374449538e-2f;
+	r = r * z - 1.38776856032e-1f;
+	r = r * z + 1.99777106478e-1f;
+	r = r * z - 3.33329491539e-1f;
+	r = r * z * x;
+	r = r + x;
+
+	return sign * (y + r);
+}
+
+inline bool is_integer(float x) {
+	if (x >= 8388608.f || x <= -8388608.f) {
+		// No fractional part left at this magnitude (includes infinities)
+		return true;
+	}
+	return static_cast<float>(static_cast<int32_t>(x)) == x;
+}
+
+inline bool is_odd_integer(float x) {
+	if (x >= 16777216.f || x <= -16777216.f) {
+		// Only even integers are representable at this magnitude
+		return false;
+	}
+	return (static_cast<int32_t>(x) & 1) != 0;
+}
+
+} // namespace
+
+float deterministic_sin(float x) {
+	if (x != x) {
+		return x;
+	}
+
+	float sign = 1.f;
+	if (x < 0.f) {
+		x = -x;
+		sign = -1.f;
+	}
+
+	if (x > 8388608.f) {
+		return x == INF ? NAN_F : 0.f;
+	}
+
+	// Find the octant of x, rounded to an even one so the remainder is in [-PI/4, PI/4]
+	uint32_t j = static_cast<uint32_t>(x * 1.27323954473516f);
+	float y = static_cast<float>(j);
+	if ((j & 1) != 0) {
+		++j;
+		y += 1.f;
+	}
+	j &= 7;
+	if (j > 3) {
+		sign = -sign;
+		j -= 4;
+	}
+
+	// Subtract y * PI/4 with extended precision, PI/4 being split into 3 parts
+	x = x - y * 0.78515625f;
+	x = x - y * 2.4187564849853515625e-4f;
+	x = x - y * 3.77489497744594108e-8f;
+
+	const float z = x * x;
+	float r;
+
+	if (j == 1 || j == 2) {
+		// Cosine polynomial
+		r = 2.443315711809948e-5f;
+		r = r * z - 1.388731625493765e-3f;
+		r = r * z + 4.166664568298827e-2f;
+		r = r * z * z;
+		r = r - 0.5f * z;
+		r = r + 1.f;
+	} else {
+		// Sine polynomial
+		r = -1.9515295891e-4f;
+		r = r * z + 8.3321608736e-3f;
+		r = r * z - 1.6666654611e-1f;
+		r = r * z * x;
+		r = r + x;
+	}
+
+	return sign * r;
+}
+
+float deterministic_pow(float x, float p) {
+	if (p == 0.f) {
+		return 1.f;
+	}
+	if (x != x || p != p) {
+		return NAN_F;
+	}
+
+	float sign = 1.f;
+	if (x < 0.f) {
+		if (!is_integer(p)) {
+			return NAN_F;
+		}
+		if (is_odd_integer(p)) {
+			sign = -1.f;
+		}
+		x = -x;
+	}
+
+	if (x == 1.f) {
+		return sign;
+	}
+	if (x == 0.f) {
+		return p > 0.f ? sign * 0.f : sign * INF;
+	}
+	if (x == INF) {
+		return p > 0.f ? sign * INF : sign * 0.f;
+	}
+
+	return sign * deterministic_exp2(p * deterministic_log2(x));
+}
+
+float deterministic_atan2(float y, float x) {
+	if (x != x || y != y) {
+		return NAN_F;
+	}
+	if (x == 0.f) {
+		if (y > 0.f) {
+			return 1.5707963267948966f;
+		}
+		if (y < 0.f) {
+			return -1.5707963267948966f;
+		}
+		return 0.f;
+	}
+	float a = deterministic_atan(y / x);
+	if (x < 0.f) {
+		a = a + (y < 0.f ? -3.14159265358979f : 3.14159265358979f);
+	}
+	return a;
+}
+
+} // namespace zylann::math
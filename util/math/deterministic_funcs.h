@@ -0,0 +1,22 @@
+#ifndef ZN_MATH_DETERMINISTIC_FUNCS_H
+#define ZN_MATH_DETERMINISTIC_FUNCS_H
+
+namespace zylann::math {
+
+// Transcendental functions giving the same results on every platform and compiler, unlike the ones from the standard
+// library, which are free to differ in their last bits. They only use basic IEEE-754 single-precision operations, in a
+// fixed order, and must be compiled without contraction into FMA instructions.
+// They are approximations accurate to a few ULPs within the ranges voxel generation usually deals with.
+
+// Inputs with a magnitude above 2^23 have no fractional part left, and return 0.
+float deterministic_sin(float x);
+
+// Same special cases as `std::pow` for zero, negative and NaN bases.
+float deterministic_pow(float x, float p);
+
+// Signed zeros are not told apart, both give the result of positive zero. Infinite inputs are not supported.
+float deterministic_atan2(float y, float x);
+
+} // namespace zylann::math
+
+#endif // ZN_MATH_DETERMINISTIC_FUNCS_H
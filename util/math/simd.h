@@ -0,0 +1,767 @@
+#ifndef ZN_MATH_SIMD_H
+#define ZN_MATH_SIMD_H
+
+#include <cmath>
+#include <cstdint>
+
+// Minimal portable wrapper over 4-wide float SIMD registers.
+// Only baseline instruction sets are used (SSE2 on x86_64, NEON on arm64), so no runtime dispatch or special compiler
+// flags are needed. Other targets use a scalar fallback with the same interface.
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ZN_SIMD_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define ZN_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace zylann::simd {
+
+struct Float4 {
+	static const unsigned int SIZE = 4;
+
+#if defined(ZN_SIMD_SSE2)
+	__m128 v;
+#elif defined(ZN_SIMD_NEON)
+	float32x4_t v;
+#else
+	float v[4];
+#endif
+};
+
+// 4 signed 32-bit integers. Arithmetic wraps around on overflow.
+struct Int4 {
+	static const unsigned int SIZE = 4;
+
+#if defined(ZN_SIMD_SSE2)
+	__m128i v;
+#elif defined(ZN_SIMD_NEON)
+	int32x4_t v;
+#else
+	int32_t v[4];
+#endif
+};
+
+#if defined(ZN_SIMD_SSE2)
+
+inline Float4 set1(float x) {
+	return { _mm_set1_ps(x) };
+}
+
+// Pointers don't need to be aligned.
+inline Float4 load(const float *p) {
+	return { _mm_loadu_ps(p) };
+}
+
+inline void store(float *p, Float4 a) {
+	_mm_storeu_ps(p, a.v);
+}
+
+inline Float4 operator+(Float4 a, Float4 b) {
+	return { _mm_add_ps(a.v, b.v) };
+}
+
+inline Float4 operator-(Float4 a, Float4 b) {
+	return { _mm_sub_ps(a.v, b.v) };
+}
+
+inline Float4 operator*(Float4 a, Float4 b) {
+	return { _mm_mul_ps(a.v, b.v) };
+}
+
+inline Float4 operator/(Float4 a, Float4 b) {
+	return { _mm_div_ps(a.v, b.v) };
+}
+
+inline Float4 operator-(Float4 a) {
+	return { _mm_xor_ps(a.v, _mm_set1_ps(-0.f)) };
+}
+
+inline Float4 min(Float4 a, Float4 b) {
+	return { _mm_min_ps(a.v, b.v) };
+}
+
+inline Float4 max(Float4 a, Float4 b) {
+	return { _mm_max_ps(a.v, b.v) };
+}
+
+inline Float4 abs(Float4 a) {
+	return { _mm_andnot_ps(_mm_set1_ps(-0.f), a.v) };
+}
+
+inline Float4 sqrt(Float4 a) {
+	return { _mm_sqrt_ps(a.v) };
+}
+
+// Lanes are all bits set where `a == b`, zero otherwise.
+inline Float4 equal_mask(Float4 a, Float4 b) {
+	return { _mm_cmpeq_ps(a.v, b.v) };
+}
+
+// For each lane, picks `a` where `mask` is set, `b` otherwise.
+inline Float4 select(Float4 mask, Float4 a, Float4 b) {
+	return { _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v)) };
+}
+
+inline Float4 less_mask(Float4 a, Float4 b) {
+	return { _mm_cmplt_ps(a.v, b.v) };
+}
+
+inline Float4 less_equal_mask(Float4 a, Float4 b) {
+	return { _mm_cmple_ps(a.v, b.v) };
+}
+
+inline Float4 greater_mask(Float4 a, Float4 b) {
+	return { _mm_cmpgt_ps(a.v, b.v) };
+}
+
+inline Float4 greater_equal_mask(Float4 a, Float4 b) {
+	return { _mm_cmpge_ps(a.v, b.v) };
+}
+
+// Lanes are set where they are set in both masks.
+inline Float4 mask_and(Float4 a, Float4 b) {
+	return { _mm_and_ps(a.v, b.v) };
+}
+
+inline Int4 set1_int(int32_t x) {
+	return { _mm_set1_epi32(x) };
+}
+
+inline void store(int32_t *p, Int4 a) {
+	_mm_storeu_si128(reinterpret_cast<__m128i *>(p), a.v);
+}
+
+// Converts to integers, rounding towards zero like a C++ cast.
+inline Int4 to_int_truncate(Float4 a) {
+	return { _mm_cvttps_epi32(a.v) };
+}
+
+inline Float4 to_float(Int4 a) {
+	return { _mm_cvtepi32_ps(a.v) };
+}
+
+inline Int4 operator+(Int4 a, Int4 b) {
+	return { _mm_add_epi32(a.v, b.v) };
+}
+
+inline Int4 operator-(Int4 a, Int4 b) {
+	return { _mm_sub_epi32(a.v, b.v) };
+}
+
+inline Int4 operator*(Int4 a, Int4 b) {
+	// SSE2 only has 32x32->64 bit multiplication of even lanes, so odd lanes are done separately
+	const __m128i even = _mm_mul_epu32(a.v, b.v);
+	const __m128i odd = _mm_mul_epu32(_mm_srli_si128(a.v, 4), _mm_srli_si128(b.v, 4));
+	return { _mm_unpacklo_epi32(
+			_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0))
+	) };
+}
+
+inline Int4 operator^(Int4 a, Int4 b) {
+	return { _mm_xor_si128(a.v, b.v) };
+}
+
+inline Int4 operator&(Int4 a, Int4 b) {
+	return { _mm_and_si128(a.v, b.v) };
+}
+
+inline Int4 operator|(Int4 a, Int4 b) {
+	return { _mm_or_si128(a.v, b.v) };
+}
+
+template <int N>
+inline Int4 shift_left(Int4 a) {
+	return { _mm_slli_epi32(a.v, N) };
+}
+
+// Arithmetic shift, preserving sign like `>>` on signed integers.
+template <int N>
+inline Int4 shift_right(Int4 a) {
+	return { _mm_srai_epi32(a.v, N) };
+}
+
+inline Int4 select(Float4 mask, Int4 a, Int4 b) {
+	const __m128i m = _mm_castps_si128(mask.v);
+	return { _mm_or_si128(_mm_and_si128(m, a.v), _mm_andnot_si128(m, b.v)) };
+}
+
+#elif defined(ZN_SIMD_NEON)
+
+inline Float4 set1(float x) {
+	return { vdupq_n_f32(x) };
+}
+
+inline Float4 load(const float *p) {
+	return { vld1q_f32(p) };
+}
+
+inline void store(float *p, Float4 a) {
+	vst1q_f32(p, a.v);
+}
+
+inline Float4 operator+(Float4 a, Float4 b) {
+	return { vaddq_f32(a.v, b.v) };
+}
+
+inline Float4 operator-(Float4 a, Float4 b) {
+	return { vsubq_f32(a.v, b.v) };
+}
+
+inline Float4 operator*(Float4 a, Float4 b) {
+	return { vmulq_f32(a.v, b.v) };
+}
+
+inline Float4 operator/(Float4 a, Float4 b) {
+#if defined(__aarch64__) || defined(_M_ARM64)
+	return { vdivq_f32(a.v, b.v) };
+#else
+	// ARMv7 has no vector division. Use reciprocal estimate refined with two Newton-Raphson steps.
+	float32x4_t r = vrecpeq_f32(b.v);
+	r = vmulq_f32(vrecpsq_f32(b.v, r), r);
+	r = vmulq_f32(vrecpsq_f32(b.v, r), r);
+	return { vmulq_f32(a.v, r) };
+#endif
+}
+
+inline Float4 operator-(Float4 a) {
+	return { vnegq_f32(a.v) };
+}
+
+inline Float4 min(Float4 a, Float4 b) {
+	return { vminq_f32(a.v, b.v) };
+}
+
+inline Float4 max(Float4 a, Float4 b) {
+	return { vmaxq_f32(a.v, b.v) };
+}
+
+inline Float4 abs(Float4 a) {
+	return { vabsq_f32(a.v) };
+}
+
+inline Float4 sqrt(Float4 a) {
+#if defined(__aarch64__) || defined(_M_ARM64)
+	return { vsqrtq_f32(a.v) };
+#else
+	float tmp[4];
+	vst1q_f32(tmp, a.v);
+	for (unsigned int i = 0; i < 4; ++i) {
+		tmp[i] = std::sqrt(tmp[i]);
+	}
+	return { vld1q_f32(tmp) };
+#endif
+}
+
+inline Float4 equal_mask(Float4 a, Float4 b) {
+	return { vreinterpretq_f32_u32(vceqq_f32(a.v, b.v)) };
+}
+
+inline Float4 select(Float4 mask, Float4 a, Float4 b) {
+	return { vbslq_f32(vreinterpretq_u32_f32(mask.v), a.v, b.v) };
+}
+
+inline Float4 less_mask(Float4 a, Float4 b) {
+	return { vreinterpretq_f32_u32(vcltq_f32(a.v, b.v)) };
+}
+
+inline Float4 less_equal_mask(Float4 a, Float4 b) {
+	return { vreinterpretq_f32_u32(vcleq_f32(a.v, b.v)) };
+}
+
+inline Float4 greater_mask(Float4 a, Float4 b) {
+	return { vreinterpretq_f32_u32(vcgtq_f32(a.v, b.v)) };
+}
+
+inline Float4 greater_equal_mask(Float4 a, Float4 b) {
+	return { vreinterpretq_f32_u32(vcgeq_f32(a.v, b.v)) };
+}
+
+inline Float4 mask_and(Float4 a, Float4 b) {
+	return { vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a.v), vreinterpretq_u32_f32(b.v))) };
+}
+
+inline Int4 set1_int(int32_t x) {
+	return { vdupq_n_s32(x) };
+}
+
+inline void store(int32_t *p, Int4 a) {
+	vst1q_s32(p, a.v);
+}
+
+inline Int4 to_int_truncate(Float4 a) {
+	return { vcvtq_s32_f32(a.v) };
+}
+
+inline Float4 to_float(Int4 a) {
+	return { vcvtq_f32_s32(a.v) };
+}
+
+inline Int4 operator+(Int4 a, Int4 b) {
+	return { vaddq_s32(a.v, b.v) };
+}
+
+inline Int4 operator-(Int4 a, Int4 b) {
+	return { vsubq_s32(a.v, b.v) };
+}
+
+inline Int4 operator*(Int4 a, Int4 b) {
+	return { vmulq_s32(a.v, b.v) };
+}
+
+inline Int4 operator^(Int4 a, Int4 b) {
+	return { veorq_s32(a.v, b.v) };
+}
+
+inline Int4 operator&(Int4 a, Int4 b) {
+	return { vandq_s32(a.v, b.v) };
+}
+
+inline Int4 operator|(Int4 a, Int4 b) {
+	return { vorrq_s32(a.v, b.v) };
+}
+
+template <int N>
+inline Int4 shift_left(Int4 a) {
+	return { vshlq_n_s32(a.v, N) };
+}
+
+template <int N>
+inline Int4 shift_right(Int4 a) {
+	return { vshrq_n_s32(a.v, N) };
+}
+
+inline Int4 select(Float4 mask, Int4 a, Int4 b) {
+	return { vbslq_s32(vreinterpretq_u32_f32(mask.v), a.v, b.v) };
+}
+
+#else
+
+namespace detail {
+
+template <typename F>
+inline Float4 map(Float4 a, F f) {
+	Float4 r;
+	for (unsigned int i = 0; i < 4; ++i) {
+		r.v[i] = f(a.v[i]);
+	}
+	return r;
+}
+
+template <typename F>
+inline Float4 map(Float4 a, Float4 b, F f) {
+	Float4 r;
+	for (unsigned int i = 0; i < 4; ++i) {
+		r.v[i] = f(a.v[i], b.v[i]);
+	}
+	return r;
+}
+
+} // namespace detail
+
+inline Float4 set1(float x) {
+	return { { x, x, x, x } };
+}
+
+inline Float4 load(const float *p) {
+	return { { p[0], p[1], p[2], p[3] } };
+}
+
+inline void store(float *p, Float4 a) {
+	for (unsigned int i = 0; i < 4; ++i) {
+		p[i] = a.v[i];
+	}
+}
+
+inline Float4 operator+(Float4 a, Float4 b) {
+	return detail::map(a, b, [](float x, float y) { return x + y; });
+}
+
+inline Float4 operator-(Float4 a, Float4 b) {
+	return detail::map(a, b, [](float x, float y) { return x - y; });
+}
+
+inline Float4 operator*(Float4 a, Float4 b) {
+	return detail::map(a, b, [](float x, float y) { return x * y; });
+}
+
+inline Float4 operator/(Float4 a, Float4 b) {
+	return detail::map(a, b, [](float x, float y) { return x / y; });
+}
+
+inline Float4 operator-(Float4 a) {
+	return detail::map(a, [](float x) { return -x; });
+}
+
+inline Float4 min(Float4 a, Float4 b) {
+	return detail::map(a, b, [](float x, float y) { return x < y ? x : y; });
+}
+
+inline Float4 max(Float4 a, Float4 b) {
+	return detail::map(a, b, [](float x, float y) { return x > y ? x : y; });
+}
+
+inline Float4 abs(Float4 a) {
+	return detail::map(a, [](float x) { return std::abs(x); });
+}
+
+inline Float4 sqrt(Float4 a) {
+	return detail::map(a, [](float x) { return std::sqrt(x); });
+}
+
+inline Float4 equal_mask(Float4 a, Float4 b) {
+	// Store booleans as 0 or 1, `select` only looks at non-zero
+	return detail::map(a, b, [](float x, float y) { return x == y ? 1.f : 0.f; });
+}
+
+inline Float4 select(Float4 mask, Float4 a, Float4 b) {
+	Float4 r;
+	for (unsigned int i = 0; i < 4; ++i) {
+		r.v[i] = mask.v[i] != 0.f ? a.v[i] : b.v[i];
+	}
+	return r;
+}
+
+inline Float4 less_mask(Float4 a, Float4 b) {
+	return detail::map(a, b, [](float x, float y) { return x < y ? 1.f : 0.f; });
+}
+
+inline Float4 less_equal_mask(Float4 a, Float4 b) {
+	return detail::map(a, b, [](float x, float y) { return x <= y ? 1.f : 0.f; });
+}
+
+inline Float4 greater_mask(Float4 a, Float4 b) {
+	return detail::map(a, b, [](float x, float y) { return x > y ? 1.f : 0.f; });
+}
+
+inline Float4 greater_equal_mask(Float4 a, Float4 b) {
+	return detail::map(a, b, [](float x, float y) { return x >= y ? 1.f : 0.f; });
+}
+
+inline Float4 mask_and(Float4 a, Float4 b) {
+	return detail::map(a, b, [](float x, float y) { return x != 0.f && y != 0.f ? 1.f : 0.f; });
+}
+
+namespace detail {
+
+template <typename F>
+inline Int4 map(Int4 a, Int4 b, F f) {
+	Int4 r;
+	for (unsigned int i = 0; i < 4; ++i) {
+		r.v[i] = f(a.v[i], b.v[i]);
+	}
+	return r;
+}
+
+} // namespace detail
+
+inline Int4 set1_int(int32_t x) {
+	return { { x, x, x, x } };
+}
+
+inline void store(int32_t *p, Int4 a) {
+	for (unsigned int i = 0; i < 4; ++i) {
+		p[i] = a.v[i];
+	}
+}
+
+inline Int4 to_int_truncate(Float4 a) {
+	Int4 r;
+	for (unsigned int i = 0; i < 4; ++i) {
+		r.v[i] = static_cast<int32_t>(a.v[i]);
+	}
+	return r;
+}
+
+inline Float4 to_float(Int4 a) {
+	Float4 r;
+	for (unsigned int i = 0; i < 4; ++i) {
+		r.v[i] = static_cast<float>(a.v[i]);
+	}
+	return r;
+}
+
+// Done on unsigned integers, so wrapping around is not undefined behavior
+inline Int4 operator+(Int4 a, Int4 b) {
+	return detail::map(a, b, [](int32_t x, int32_t y) { return int32_t(uint32_t(x) + uint32_t(y)); });
+}
+
+inline Int4 operator-(Int4 a, Int4 b) {
+	return detail::map(a, b, [](int32_t x, int32_t y) { return int32_t(uint32_t(x) - uint32_t(y)); });
+}
+
+inline Int4 operator*(Int4 a, Int4 b) {
+	return detail::map(a, b, [](int32_t x, int32_t y) { return int32_t(uint32_t(x) * uint32_t(y)); });
+}
+
+inline Int4 operator^(Int4 a, Int4 b) {
+	return detail::map(a, b, [](int32_t x, int32_t y) { return x ^ y; });
+}
+
+inline Int4 operator&(Int4 a, Int4 b) {
+	return detail::map(a, b, [](int32_t x, int32_t y) { return x & y; });
+}
+
+inline Int4 operator|(Int4 a, Int4 b) {
+	return detail::map(a, b, [](int32_t x, int32_t y) { return x | y; });
+}
+
+template <int N>
+inline Int4 shift_left(Int4 a) {
+	Int4 r;
+	for (unsigned int i = 0; i < 4; ++i) {
+		r.v[i] = int32_t(uint32_t(a.v[i]) << N);
+	}
+	return r;
+}
+
+template <int N>
+inline Int4 shift_right(Int4 a) {
+	Int4 r;
+	for (unsigned int i = 0; i < 4; ++i) {
+		r.v[i] = a.v[i] >> N;
+	}
+	return r;
+}
+
+inline Int4 select(Float4 mask, Int4 a, Int4 b) {
+	Int4 r;
+	for (unsigned int i = 0; i < 4; ++i) {
+		r.v[i] = mask.v[i] != 0.f ? a.v[i] : b.v[i];
+	}
+	return r;
+}
+
+#endif
+
+// Functions below are defined in terms of the above, so they also work with `float`, which is useful to write kernels
+// once for both vector and scalar parts of a loop.
+
+inline Float4 operator+(Float4 a, float b) {
+	return a + set1(b);
+}
+
+inline Float4 operator+(float a, Float4 b) {
+	return set1(a) + b;
+}
+
+inline Float4 operator-(Float4 a, float b) {
+	return a - set1(b);
+}
+
+inline Float4 operator-(float a, Float4 b) {
+	return set1(a) - b;
+}
+
+inline Float4 operator*(Float4 a, float b) {
+	return a * set1(b);
+}
+
+inline Float4 operator*(float a, Float4 b) {
+	return set1(a) * b;
+}
+
+inline Float4 operator/(Float4 a, float b) {
+	return a / set1(b);
+}
+
+inline Int4 operator+(Int4 a, int32_t b) {
+	return a + set1_int(b);
+}
+
+inline Int4 operator-(Int4 a, int32_t b) {
+	return a - set1_int(b);
+}
+
+inline Int4 operator*(Int4 a, int32_t b) {
+	return a * set1_int(b);
+}
+
+inline Int4 operator^(Int4 a, int32_t b) {
+	return a ^ set1_int(b);
+}
+
+inline Int4 operator&(Int4 a, int32_t b) {
+	return a & set1_int(b);
+}
+
+inline Int4 operator|(Int4 a, int32_t b) {
+	return a | set1_int(b);
+}
+
+inline Float4 clamp(Float4 x, Float4 min_value, Float4 max_value) {
+	return min(max(x, min_value), max_value);
+}
+
+inline Float4 lerp(Float4 a, Float4 b, Float4 t) {
+	return a + t * (b - a);
+}
+
+// Scalar overloads, so generic kernels can call `simd::` functions with either type.
+
+inline float min(float a, float b) {
+	return a < b ? a : b;
+}
+
+inline float max(float a, float b) {
+	return a > b ? a : b;
+}
+
+inline float abs(float a) {
+	return std::abs(a);
+}
+
+inline float sqrt(float a) {
+	return std::sqrt(a);
+}
+
+inline float clamp(float x, float min_value, float max_value) {
+	return min(max(x, min_value), max_value);
+}
+
+inline float lerp(float a, float b, float t) {
+	return a + t * (b - a);
+}
+
+inline bool equal_mask(float a, float b) {
+	return a == b;
+}
+
+inline float select(bool mask, float a, float b) {
+	return mask ? a : b;
+}
+
+inline void store(float *p, float a) {
+	*p = a;
+}
+
+// Type-generic helpers, where `T` is either `float` or `Float4`.
+
+template <typename T>
+T load_as(const float *p);
+
+template <>
+inline float load_as<float>(const float *p) {
+	return *p;
+}
+
+template <>
+inline Float4 load_as<Float4>(const float *p) {
+	return load(p);
+}
+
+template <typename T>
+T splat(float x);
+
+template <>
+inline float splat<float>(float x) {
+	return x;
+}
+
+template <>
+inline Float4 splat<Float4>(float x) {
+	return set1(x);
+}
+
+// Calls `f(i, tag)` over indices `[0, size)`, where `tag` is a `Float4` for groups of 4 items starting at `i`, and a
+// `float` for the remaining ones. This allows to write kernels once with a generic lambda.
+template <typename F>
+inline void for_each(uint32_t size, F f) {
+	uint32_t i = 0;
+	for (; i + Float4::SIZE <= size; i += Float4::SIZE) {
+		f(i, Float4());
+	}
+	for (; i < size; ++i) {
+		f(i, 0.f);
+	}
+}
+
+// Same as `for_each`, but if `exact` is true, `f` is only called with `float` tags. Some `Float4` operations are
+// approximated on some targets (like division on ARMv7), so this is used where results must match on every platform.
+template <typename F>
+inline void for_each(uint32_t size, bool exact, F f) {
+	if (exact) {
+		for (uint32_t i = 0; i < size; ++i) {
+			f(i, 0.f);
+		}
+	} else {
+		for_each(size, f);
+	}
+}
+
+// Compares one register worth of consecutive values (16 bytes) against a threshold, and returns a bitmask where bit `i`
+// is set if `p[i] > threshold`. Pointers don't need to be aligned.
+
+inline uint32_t greater_bits(const int8_t *p, int8_t threshold) {
+#if defined(ZN_SIMD_SSE2)
+	const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+	return _mm_movemask_epi8(_mm_cmpgt_epi8(v, _mm_set1_epi8(threshold)));
+#elif defined(ZN_SIMD_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+	static const uint8_t bit_values[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+	const uint8x16_t bits = vandq_u8(vcgtq_s8(vld1q_s8(p), vdupq_n_s8(threshold)), vld1q_u8(bit_values));
+	return vaddv_u8(vget_low_u8(bits)) | (vaddv_u8(vget_high_u8(bits)) << 8);
+#else
+	uint32_t mask = 0;
+	for (unsigned int i = 0; i < 16; ++i) {
+		mask |= static_cast<uint32_t>(p[i] > threshold) << i;
+	}
+	return mask;
+#endif
+}
+
+inline uint32_t greater_bits(const int16_t *p, int16_t threshold) {
+#if defined(ZN_SIMD_SSE2)
+	const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+	const __m128i cmp = _mm_cmpgt_epi16(v, _mm_set1_epi16(threshold));
+	// Narrow comparison results to bytes, they are either 0 or -1 so saturation preserves them
+	return _mm_movemask_epi8(_mm_packs_epi16(cmp, _mm_setzero_si128()));
+#elif defined(ZN_SIMD_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+	static const uint16_t bit_values[8] = { 1, 2, 4, 8, 16, 32, 64, 128 };
+	return vaddvq_u16(vandq_u16(vcgtq_s16(vld1q_s16(p), vdupq_n_s16(threshold)), vld1q_u16(bit_values)));
+#else
+	uint32_t mask = 0;
+	for (unsigned int i = 0; i < 8; ++i) {
+		mask |= static_cast<uint32_t>(p[i] > threshold) << i;
+	}
+	return mask;
+#endif
+}
+
+inline uint32_t greater_bits(const float *p, float threshold) {
+#if defined(ZN_SIMD_SSE2)
+	return _mm_movemask_ps(_mm_cmpgt_ps(_mm_loadu_ps(p), _mm_set1_ps(threshold)));
+#elif defined(ZN_SIMD_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+	static const uint32_t bit_values[4] = { 1, 2, 4, 8 };
+	return vaddvq_u32(vandq_u32(vcgtq_f32(vld1q_f32(p), vdupq_n_f32(threshold)), vld1q_u32(bit_values)));
+#else
+	uint32_t mask = 0;
+	for (unsigned int i = 0; i < 4; ++i) {
+		mask |= static_cast<uint32_t>(p[i] > threshold) << i;
+	}
+	return mask;
+#endif
+}
+
+// Sets bit `i` of `out_bits` if `p[i] > threshold`, for `i` in `[0, count)`. Bits are packed in 64-bit words, and
+// bits past `count` in the last word are zero.
+template <typename T>
+inline void get_greater_bits(const T *p, const unsigned int count, const T threshold, uint64_t *out_bits) {
+	// Values compared with one `greater_bits` call. Always a divisor of 64, so results don't straddle words.
+	const unsigned int lanes = 16 / sizeof(T);
+	const unsigned int word_count = (count + 63) / 64;
+	for (unsigned int w = 0; w < word_count; ++w) {
+		out_bits[w] = 0;
+	}
+	unsigned int i = 0;
+	for (; i + lanes <= count; i += lanes) {
+		out_bits[i >> 6] |= static_cast<uint64_t>(greater_bits(p + i, threshold)) << (i & 63);
+	}
+	for (; i < count; ++i) {
+		out_bits[i >> 6] |= static_cast<uint64_t>(p[i] > threshold) << (i & 63);
+	}
+}
+
+} // namespace zylann::simd
+
+#endif // ZN_MATH_SIMD_H
@@ -1,6 +1,8 @@
 #include "fast_noise_lite.h"
+#include "../../errors.h"
 #include "../../godot/core/array.h"
 #include "../../math/funcs.h"
+#include "fast_noise_lite_batch.h"
 
 namespace zylann {
 
@@ -222,6 +224,76 @@ ZN_FastNoiseLite::RotationType3D ZN_FastNoiseLite::get_rotation_type_3d() const
 	return _rotation_type_3d;
 }
 
+void ZN_FastNoiseLite::get_noise_2d_series(Span<const float> x, Span<const float> y, Span<float> out) const {
+	if (_warp_noise.is_null()) {
+		get_fnl_noise_2d_series(_fn, x, y, out);
+		return;
+	}
+
+	ZN_ASSERT_RETURN(x.size() == out.size());
+	ZN_ASSERT_RETURN(y.size() == out.size());
+
+	// Domain warp is evaluated one position at a time, into small chunks so we don't need to allocate
+	static constexpr unsigned int CHUNK_SIZE = 64;
+	float warped_x[CHUNK_SIZE];
+	float warped_y[CHUNK_SIZE];
+
+	for (unsigned int begin = 0; begin < out.size(); begin += CHUNK_SIZE) {
+		const unsigned int count = math::min(CHUNK_SIZE, static_cast<unsigned int>(out.size()) - begin);
+		for (unsigned int i = 0; i < count; ++i) {
+			real_t wx = x[begin + i];
+			real_t wy = y[begin + i];
+			_warp_noise->warp_2d(wx, wy);
+			warped_x[i] = wx;
+			warped_y[i] = wy;
+		}
+		get_fnl_noise_2d_series(
+				_fn, Span<const float>(warped_x, count), Span<const float>(warped_y, count), out.sub(begin, count)
+		);
+	}
+}
+
+void ZN_FastNoiseLite::get_noise_3d_series(
+		Span<const float> x,
+		Span<const float> y,
+		Span<const float> z,
+		Span<float> out
+) const {
+	if (_warp_noise.is_null()) {
+		get_fnl_noise_3d_series(_fn, x, y, z, out);
+		return;
+	}
+
+	ZN_ASSERT_RETURN(x.size() == out.size());
+	ZN_ASSERT_RETURN(y.size() == out.size());
+	ZN_ASSERT_RETURN(z.size() == out.size());
+
+	static constexpr unsigned int CHUNK_SIZE = 64;
+	float warped_x[CHUNK_SIZE];
+	float warped_y[CHUNK_SIZE];
+	float warped_z[CHUNK_SIZE];
+
+	for (unsigned int begin = 0; begin < out.size(); begin += CHUNK_SIZE) {
+		const unsigned int count = math::min(CHUNK_SIZE, static_cast<unsigned int>(out.size()) - begin);
+		for (unsigned int i = 0; i < count; ++i) {
+			real_t wx = x[begin + i];
+			real_t wy = y[begin + i];
+			real_t wz = z[begin + i];
+			_warp_noise->warp_3d(wx, wy, wz);
+			warped_x[i] = wx;
+			warped_y[i] = wy;
+			warped_z[i] = wz;
+		}
+		get_fnl_noise_3d_series(
+				_fn,
+				Span<const float>(warped_x, count),
+				Span<const float>(warped_y, count),
+				Span<const float>(warped_z, count),
+				out.sub(begin, count)
+		);
+	}
+}
+
 void ZN_FastNoiseLite::_on_warp_noise_changed() {
 	emit_changed();
 }
@@ -1,6 +1,7 @@
 #ifndef ZYLANN_FAST_NOISE_LITE_H
 #define ZYLANN_FAST_NOISE_LITE_H
 
+#include "../../containers/span.h"
 #include "fast_noise_lite_gradient.h"
 
 namespace zylann {
@@ -140,6 +141,11 @@ public:
 		return _fn.GetNoise(x, y, z);
 	}
 
+	// Evaluates noise at many positions at once. Faster than calling `get_noise_*` for each of them, and gives the
+	// same results.
+	void get_noise_2d_series(Span<const float> x, Span<const float> y, Span<float> out) const;
+	void get_noise_3d_series(Span<const float> x, Span<const float> y, Span<const float> z, Span<float> out) const;
+
 	// TODO Have a separate cell noise? It outputs multiple things, but we only get one.
 	// To get the others the API forces to calculate it a second time, and it's the most expensive noise...
 
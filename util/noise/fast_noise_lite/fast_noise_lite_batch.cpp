@@ -0,0 +1,819 @@
+#include "fast_noise_lite_batch.h"
+#include "../../math/simd.h"
+#include "../../profiling.h"
+
+namespace zylann {
+
+using namespace simd;
+
+namespace {
+
+typedef fast_noise_lite::FastNoiseLite FNL;
+
+// Functions below are transpositions of those found in `FastNoiseLite`. Operations are kept in the same order, so
+// results match those of single-position evaluation.
+
+inline Int4 fast_floor(Float4 f) {
+	// Like `FastNoiseLite::FastFloor`, this returns `f - 1` for negative integers
+	const Int4 t = to_int_truncate(f);
+	return select(greater_equal_mask(f, set1(0.f)), t, t - 1);
+}
+
+inline Int4 fast_round(Float4 f) {
+	return select(greater_equal_mask(f, set1(0.f)), to_int_truncate(f + 0.5f), to_int_truncate(f - 0.5f));
+}
+
+inline Float4 interp_quintic(Float4 t) {
+	return t * t * t * (t * (t * 6.f - 15.f) + 10.f);
+}
+
+inline Float4 ping_pong(Float4 t) {
+	t = t - to_float(to_int_truncate(t * 0.5f) * 2);
+	return select(less_mask(t, set1(1.f)), t, 2.f - t);
+}
+
+// Loads 2D vectors from a lookup table, where each lane has the index of the first component.
+// Components are loaded together, to read indices only once.
+inline void gather_vectors(const float *table, Int4 indices, Float4 &out_x, Float4 &out_y) {
+	int32_t i[4];
+	store(i, indices);
+	const float *v0 = table + i[0];
+	const float *v1 = table + i[1];
+	const float *v2 = table + i[2];
+	const float *v3 = table + i[3];
+	const float xs[4] = { v0[0], v1[0], v2[0], v3[0] };
+	const float ys[4] = { v0[1], v1[1], v2[1], v3[1] };
+	out_x = load(xs);
+	out_y = load(ys);
+}
+
+inline void gather_vectors(const float *table, Int4 indices, Float4 &out_x, Float4 &out_y, Float4 &out_z) {
+	int32_t i[4];
+	store(i, indices);
+	const float *v0 = table + i[0];
+	const float *v1 = table + i[1];
+	const float *v2 = table + i[2];
+	const float *v3 = table + i[3];
+	const float xs[4] = { v0[0], v1[0], v2[0], v3[0] };
+	const float ys[4] = { v0[1], v1[1], v2[1], v3[1] };
+	const float zs[4] = { v0[2], v1[2], v2[2], v3[2] };
+	out_x = load(xs);
+	out_y = load(ys);
+	out_z = load(zs);
+}
+
+inline Int4 hash(int seed, Int4 x_primed, Int4 y_primed) {
+	return (set1_int(seed) ^ x_primed ^ y_primed) * 0x27d4eb2d;
+}
+
+inline Int4 hash(int seed, Int4 x_primed, Int4 y_primed, Int4 z_primed) {
+	return (set1_int(seed) ^ x_primed ^ y_primed ^ z_primed) * 0x27d4eb2d;
+}
+
+inline Float4 grad_coord(int seed, Int4 x_primed, Int4 y_primed, Float4 xd, Float4 yd) {
+	Int4 h = hash(seed, x_primed, y_primed);
+	h = h ^ shift_right<15>(h);
+	h = h & (127 << 1);
+
+	Float4 xg;
+	Float4 yg;
+	gather_vectors(FNL::Lookup<float>::Gradients2D, h, xg, yg);
+
+	return xd * xg + yd * yg;
+}
+
+inline Float4 grad_coord(int seed, Int4 x_primed, Int4 y_primed, Int4 z_primed, Float4 xd, Float4 yd, Float4 zd) {
+	Int4 h = hash(seed, x_primed, y_primed, z_primed);
+	h = h ^ shift_right<15>(h);
+	h = h & (63 << 2);
+
+	Float4 xg;
+	Float4 yg;
+	Float4 zg;
+	gather_vectors(FNL::Lookup<float>::Gradients3D, h, xg, yg, zg);
+
+	return xd * xg + yd * yg + zd * zg;
+}
+
+// Simplex/OpenSimplex2
+
+Float4 single_simplex(int seed, Float4 x, Float4 y) {
+	const float SQRT3 = 1.7320508075688772935274463415059f;
+	const float G2 = (3 - SQRT3) / 6;
+
+	Int4 i = fast_floor(x);
+	Int4 j = fast_floor(y);
+	const Float4 xi = x - to_float(i);
+	const Float4 yi = y - to_float(j);
+
+	const Float4 t = (xi + yi) * G2;
+	const Float4 x0 = xi - t;
+	const Float4 y0 = yi - t;
+
+	i = i * FNL::PrimeX;
+	j = j * FNL::PrimeY;
+
+	const Float4 zero = set1(0.f);
+
+	const Float4 a = 0.5f - x0 * x0 - y0 * y0;
+	const Float4 n0 = select(less_equal_mask(a, zero), zero, (a * a) * (a * a) * grad_coord(seed, i, j, x0, y0));
+
+	const Float4 c = (float)(2 * (1 - 2 * G2) * (1 / G2 - 2)) * t + ((float)(-2 * (1 - 2 * G2) * (1 - 2 * G2)) + a);
+	const Float4 x2 = x0 + (2 * (float)G2 - 1);
+	const Float4 y2 = y0 + (2 * (float)G2 - 1);
+	const Float4 n2 = select(
+			less_equal_mask(c, zero),
+			zero,
+			(c * c) * (c * c) * grad_coord(seed, i + FNL::PrimeX, j + FNL::PrimeY, x2, y2)
+	);
+
+	const Float4 y_greater = greater_mask(y0, x0);
+	const Float4 x1 = select(y_greater, x0 + (float)G2, x0 + ((float)G2 - 1));
+	const Float4 y1 = select(y_greater, y0 + ((float)G2 - 1), y0 + (float)G2);
+	const Int4 i1 = select(y_greater, i, i + FNL::PrimeX);
+	const Int4 j1 = select(y_greater, j + FNL::PrimeY, j);
+	const Float4 b = 0.5f - x1 * x1 - y1 * y1;
+	const Float4 n1 = select(less_equal_mask(b, zero), zero, (b * b) * (b * b) * grad_coord(seed, i1, j1, x1, y1));
+
+	return (n0 + n1 + n2) * 99.83685446303647f;
+}
+
+Float4 single_open_simplex_2(int seed, Float4 x, Float4 y, Float4 z) {
+	Int4 i = fast_round(x);
+	Int4 j = fast_round(y);
+	Int4 k = fast_round(z);
+	Float4 x0 = x - to_float(i);
+	Float4 y0 = y - to_float(j);
+	Float4 z0 = z - to_float(k);
+
+	Int4 x_n_sign = to_int_truncate(-1.0f - x0) | 1;
+	Int4 y_n_sign = to_int_truncate(-1.0f - y0) | 1;
+	Int4 z_n_sign = to_int_truncate(-1.0f - z0) | 1;
+
+	Float4 ax0 = to_float(x_n_sign) * -x0;
+	Float4 ay0 = to_float(y_n_sign) * -y0;
+	Float4 az0 = to_float(z_n_sign) * -z0;
+
+	i = i * FNL::PrimeX;
+	j = j * FNL::PrimeY;
+	k = k * FNL::PrimeZ;
+
+	const Float4 zero = set1(0.f);
+
+	Float4 value = zero;
+	Float4 a = (0.6f - x0 * x0) - (y0 * y0 + z0 * z0);
+
+	for (int l = 0;; l++) {
+		const Float4 na = (a * a) * (a * a) * grad_coord(seed, i, j, k, x0, y0, z0);
+		value = value + select(greater_mask(a, zero), na, zero);
+
+		const Float4 x_n_sign_f = to_float(x_n_sign);
+		const Float4 y_n_sign_f = to_float(y_n_sign);
+		const Float4 z_n_sign_f = to_float(z_n_sign);
+
+		// Each lane moves along the axis closest to the next lattice point
+		const Float4 along_x = mask_and(greater_equal_mask(ax0, ay0), greater_equal_mask(ax0, az0));
+		const Float4 along_y = mask_and(greater_mask(ay0, ax0), greater_equal_mask(ay0, az0));
+
+		const Float4 x1 = select(along_x, x0 + x_n_sign_f, x0);
+		const Float4 y1 = select(along_x, y0, select(along_y, y0 + y_n_sign_f, y0));
+		const Float4 z1 = select(along_x, z0, select(along_y, z0, z0 + z_n_sign_f));
+
+		const Float4 b_delta = select(
+				along_x,
+				to_float(x_n_sign * 2) * x1,
+				select(along_y, to_float(y_n_sign * 2) * y1, to_float(z_n_sign * 2) * z1)
+		);
+		const Float4 b = (a + 1.f) - b_delta;
+
+		const Int4 i1 = select(along_x, i - x_n_sign * FNL::PrimeX, i);
+		const Int4 j1 = select(along_x, j, select(along_y, j - y_n_sign * FNL::PrimeY, j));
+		const Int4 k1 = select(along_x, k, select(along_y, k, k - z_n_sign * FNL::PrimeZ));
+
+		const Float4 nb = (b * b) * (b * b) * grad_coord(seed, i1, j1, k1, x1, y1, z1);
+		value = value + select(greater_mask(b, zero), nb, zero);
+
+		if (l == 1) {
+			break;
+		}
+
+		ax0 = 0.5f - ax0;
+		ay0 = 0.5f - ay0;
+		az0 = 0.5f - az0;
+
+		x0 = x_n_sign_f * ax0;
+		y0 = y_n_sign_f * ay0;
+		z0 = z_n_sign_f * az0;
+
+		a = a + ((0.75f - ax0) - (ay0 + az0));
+
+		i = i + (shift_right<1>(x_n_sign) & FNL::PrimeX);
+		j = j + (shift_right<1>(y_n_sign) & FNL::PrimeY);
+		k = k + (shift_right<1>(z_n_sign) & FNL::PrimeZ);
+
+		x_n_sign = set1_int(0) - x_n_sign;
+		y_n_sign = set1_int(0) - y_n_sign;
+		z_n_sign = set1_int(0) - z_n_sign;
+
+		seed = ~seed;
+	}
+
+	return value * 32.69428253173828125f;
+}
+
+// Perlin
+
+Float4 single_perlin(int seed, Float4 x, Float4 y) {
+	Int4 x0 = fast_floor(x);
+	Int4 y0 = fast_floor(y);
+
+	const Float4 xd0 = x - to_float(x0);
+	const Float4 yd0 = y - to_float(y0);
+	const Float4 xd1 = xd0 - 1.f;
+	const Float4 yd1 = yd0 - 1.f;
+
+	const Float4 xs = interp_quintic(xd0);
+	const Float4 ys = interp_quintic(yd0);
+
+	x0 = x0 * FNL::PrimeX;
+	y0 = y0 * FNL::PrimeY;
+	const Int4 x1 = x0 + FNL::PrimeX;
+	const Int4 y1 = y0 + FNL::PrimeY;
+
+	const Float4 xf0 = lerp(grad_coord(seed, x0, y0, xd0, yd0), grad_coord(seed, x1, y0, xd1, yd0), xs);
+	const Float4 xf1 = lerp(grad_coord(seed, x0, y1, xd0, yd1), grad_coord(seed, x1, y1, xd1, yd1), xs);
+
+	return lerp(xf0, xf1, ys) * 1.4247691104677813f;
+}
+
+Float4 single_perlin(int seed, Float4 x, Float4 y, Float4 z) {
+	Int4 x0 = fast_floor(x);
+	Int4 y0 = fast_floor(y);
+	Int4 z0 = fast_floor(z);
+
+	const Float4 xd0 = x - to_float(x0);
+	const Float4 yd0 = y - to_float(y0);
+	const Float4 zd0 = z - to_float(z0);
+	const Float4 xd1 = xd0 - 1.f;
+	const Float4 yd1 = yd0 - 1.f;
+	const Float4 zd1 = zd0 - 1.f;
+
+	const Float4 xs = interp_quintic(xd0);
+	const Float4 ys = interp_quintic(yd0);
+	const Float4 zs = interp_quintic(zd0);
+
+	x0 = x0 * FNL::PrimeX;
+	y0 = y0 * FNL::PrimeY;
+	z0 = z0 * FNL::PrimeZ;
+	const Int4 x1 = x0 + FNL::PrimeX;
+	const Int4 y1 = y0 + FNL::PrimeY;
+	const Int4 z1 = z0 + FNL::PrimeZ;
+
+	const Float4 xf00 =
+			lerp(grad_coord(seed, x0, y0, z0, xd0, yd0, zd0), grad_coord(seed, x1, y0, z0, xd1, yd0, zd0), xs);
+	const Float4 xf10 =
+			lerp(grad_coord(seed, x0, y1, z0, xd0, yd1, zd0), grad_coord(seed, x1, y1, z0, xd1, yd1, zd0), xs);
+	const Float4 xf01 =
+			lerp(grad_coord(seed, x0, y0, z1, xd0, yd0, zd1), grad_coord(seed, x1, y0, z1, xd1, yd0, zd1), xs);
+	const Float4 xf11 =
+			lerp(grad_coord(seed, x0, y1, z1, xd0, yd1, zd1), grad_coord(seed, x1, y1, z1, xd1, yd1, zd1), xs);
+
+	const Float4 yf0 = lerp(xf00, xf10, ys);
+	const Float4 yf1 = lerp(xf01, xf11, ys);
+
+	return lerp(yf0, yf1, zs) * 0.964921414852142333984375f;
+}
+
+// Cellular
+
+struct CellularDistances {
+	Float4 distance0;
+	Float4 distance1;
+	Int4 closest_hash;
+
+	inline void add(Float4 new_distance, Int4 h) {
+		distance1 = max(min(distance1, new_distance), distance0);
+		const Float4 closer = less_mask(new_distance, distance0);
+		distance0 = select(closer, new_distance, distance0);
+		closest_hash = select(closer, h, closest_hash);
+	}
+};
+
+Float4 get_cellular_result(const FNL &fn, CellularDistances d) {
+	if (fn.mCellularDistanceFunction == FNL::CellularDistanceFunction_Euclidean &&
+		fn.mCellularReturnType >= FNL::CellularReturnType_Distance) {
+		d.distance0 = sqrt(d.distance0);
+
+		if (fn.mCellularReturnType >= FNL::CellularReturnType_Distance2) {
+			d.distance1 = sqrt(d.distance1);
+		}
+	}
+
+	switch (fn.mCellularReturnType) {
+		case FNL::CellularReturnType_CellValue:
+			return to_float(d.closest_hash) * (1 / 2147483648.0f);
+		case FNL::CellularReturnType_Distance:
+			return d.distance0 - 1.f;
+		case FNL::CellularReturnType_Distance2:
+			return d.distance1 - 1.f;
+		case FNL::CellularReturnType_Distance2Add:
+			return (d.distance1 + d.distance0) * 0.5f - 1.f;
+		case FNL::CellularReturnType_Distance2Sub:
+			return d.distance1 - d.distance0 - 1.f;
+		case FNL::CellularReturnType_Distance2Mul:
+			return d.distance1 * d.distance0 * 0.5f - 1.f;
+		case FNL::CellularReturnType_Distance2Div:
+			return d.distance0 / d.distance1 - 1.f;
+		default:
+			return set1(0.f);
+	}
+}
+
+template <typename FDistance>
+Float4 single_cellular(const FNL &fn, int seed, Float4 x, Float4 y, FDistance distance_func) {
+	const Int4 xr = fast_round(x);
+	const Int4 yr = fast_round(y);
+
+	CellularDistances d{ set1(1e10f), set1(1e10f), set1_int(0) };
+
+	const float cellular_jitter = 0.43701595f * fn.mCellularJitterModifier;
+
+	Int4 x_primed = (xr - 1) * FNL::PrimeX;
+	const Int4 y_primed_base = (yr - 1) * FNL::PrimeY;
+
+	for (int xo = -1; xo <= 1; ++xo) {
+		const Float4 xd = to_float(xr + xo) - x;
+		Int4 y_primed = y_primed_base;
+
+		for (int yo = -1; yo <= 1; ++yo) {
+			const Int4 h = hash(seed, x_primed, y_primed);
+			const Int4 idx = h & (255 << 1);
+
+			Float4 rx;
+			Float4 ry;
+			gather_vectors(FNL::Lookup<float>::RandVecs2D, idx, rx, ry);
+
+			const Float4 vec_x = xd + rx * cellular_jitter;
+			const Float4 vec_y = (to_float(yr + yo) - y) + ry * cellular_jitter;
+
+			d.add(distance_func(vec_x, vec_y), h);
+
+			y_primed = y_primed + FNL::PrimeY;
+		}
+		x_primed = x_primed + FNL::PrimeX;
+	}
+
+	return get_cellular_result(fn, d);
+}
+
+template <typename FDistance>
+Float4 single_cellular(const FNL &fn, int seed, Float4 x, Float4 y, Float4 z, FDistance distance_func) {
+	const Int4 xr = fast_round(x);
+	const Int4 yr = fast_round(y);
+	const Int4 zr = fast_round(z);
+
+	CellularDistances d{ set1(1e10f), set1(1e10f), set1_int(0) };
+
+	const float cellular_jitter = 0.39614353f * fn.mCellularJitterModifier;
+
+	Int4 x_primed = (xr - 1) * FNL::PrimeX;
+	const Int4 y_primed_base = (yr - 1) * FNL::PrimeY;
+	const Int4 z_primed_base = (zr - 1) * FNL::PrimeZ;
+
+	for (int xo = -1; xo <= 1; ++xo) {
+		const Float4 xd = to_float(xr + xo) - x;
+		Int4 y_primed = y_primed_base;
+
+		for (int yo = -1; yo <= 1; ++yo) {
+			const Float4 yd = to_float(yr + yo) - y;
+			Int4 z_primed = z_primed_base;
+
+			for (int zo = -1; zo <= 1; ++zo) {
+				const Int4 h = hash(seed, x_primed, y_primed, z_primed);
+				const Int4 idx = h & (255 << 2);
+
+				Float4 rx;
+				Float4 ry;
+				Float4 rz;
+				gather_vectors(FNL::Lookup<float>::RandVecs3D, idx, rx, ry, rz);
+
+				const Float4 vec_x = xd + rx * cellular_jitter;
+				const Float4 vec_y = yd + ry * cellular_jitter;
+				const Float4 vec_z = (to_float(zr + zo) - z) + rz * cellular_jitter;
+
+				d.add(distance_func(vec_x, vec_y, vec_z), h);
+
+				z_primed = z_primed + FNL::PrimeZ;
+			}
+			y_primed = y_primed + FNL::PrimeY;
+		}
+		x_primed = x_primed + FNL::PrimeX;
+	}
+
+	return get_cellular_result(fn, d);
+}
+
+struct DistanceEuclidean {
+	inline Float4 operator()(Float4 x, Float4 y) const {
+		return x * x + y * y;
+	}
+	inline Float4 operator()(Float4 x, Float4 y, Float4 z) const {
+		return x * x + y * y + z * z;
+	}
+};
+
+struct DistanceManhattan {
+	inline Float4 operator()(Float4 x, Float4 y) const {
+		return abs(x) + abs(y);
+	}
+	inline Float4 operator()(Float4 x, Float4 y, Float4 z) const {
+		return abs(x) + abs(y) + abs(z);
+	}
+};
+
+struct DistanceHybrid {
+	inline Float4 operator()(Float4 x, Float4 y) const {
+		return (abs(x) + abs(y)) + (x * x + y * y);
+	}
+	inline Float4 operator()(Float4 x, Float4 y, Float4 z) const {
+		return (abs(x) + abs(y) + abs(z)) + (x * x + y * y + z * z);
+	}
+};
+
+// Fractals.
+// `FSingle` is a function evaluating one octave, taking a seed and coordinates.
+
+template <typename FSingle>
+Float4 gen_fractal(const FNL &fn, FSingle single, Float4 x, Float4 y) {
+	switch (fn.mFractalType) {
+		case FNL::FractalType_FBm: {
+			int seed = fn.mSeed;
+			Float4 sum = set1(0.f);
+			Float4 amp = set1(fn.mFractalBounding);
+
+			for (int i = 0; i < fn.mOctaves; i++) {
+				const Float4 noise = single(seed++, x, y);
+				sum = sum + noise * amp;
+				amp = amp * lerp(set1(1.0f), min(noise + 1.f, set1(2.f)) * 0.5f, set1(fn.mWeightedStrength));
+
+				x = x * fn.mLacunarity;
+				y = y * fn.mLacunarity;
+				amp = amp * fn.mGain;
+			}
+
+			return sum;
+		}
+
+		case FNL::FractalType_Ridged: {
+			int seed = fn.mSeed;
+			Float4 sum = set1(0.f);
+			Float4 amp = set1(fn.mFractalBounding);
+
+			for (int i = 0; i < fn.mOctaves; i++) {
+				const Float4 noise = abs(single(seed++, x, y));
+				sum = sum + (noise * -2.f + 1.f) * amp;
+				amp = amp * lerp(set1(1.0f), 1.f - noise, set1(fn.mWeightedStrength));
+
+				x = x * fn.mLacunarity;
+				y = y * fn.mLacunarity;
+				amp = amp * fn.mGain;
+			}
+
+			return sum;
+		}
+
+		case FNL::FractalType_PingPong: {
+			int seed = fn.mSeed;
+			Float4 sum = set1(0.f);
+			Float4 amp = set1(fn.mFractalBounding);
+
+			for (int i = 0; i < fn.mOctaves; i++) {
+				const Float4 noise = ping_pong((single(seed++, x, y) + 1.f) * fn.mPingPongStrength);
+				sum = sum + (noise - 0.5f) * 2.f * amp;
+				amp = amp * lerp(set1(1.0f), noise, set1(fn.mWeightedStrength));
+
+				x = x * fn.mLacunarity;
+				y = y * fn.mLacunarity;
+				amp = amp * fn.mGain;
+			}
+
+			return sum;
+		}
+
+		default:
+			return single(fn.mSeed, x, y);
+	}
+}
+
+template <typename FSingle>
+Float4 gen_fractal(const FNL &fn, FSingle single, Float4 x, Float4 y, Float4 z) {
+	switch (fn.mFractalType) {
+		case FNL::FractalType_FBm: {
+			int seed = fn.mSeed;
+			Float4 sum = set1(0.f);
+			Float4 amp = set1(fn.mFractalBounding);
+
+			for (int i = 0; i < fn.mOctaves; i++) {
+				const Float4 noise = single(seed++, x, y, z);
+				sum = sum + noise * amp;
+				amp = amp * lerp(set1(1.0f), (noise + 1.f) * 0.5f, set1(fn.mWeightedStrength));
+
+				x = x * fn.mLacunarity;
+				y = y * fn.mLacunarity;
+				z = z * fn.mLacunarity;
+				amp = amp * fn.mGain;
+			}
+
+			return sum;
+		}
+
+		case FNL::FractalType_Ridged: {
+			int seed = fn.mSeed;
+			Float4 sum = set1(0.f);
+			Float4 amp = set1(fn.mFractalBounding);
+
+			for (int i = 0; i < fn.mOctaves; i++) {
+				const Float4 noise = abs(single(seed++, x, y, z));
+				sum = sum + (noise * -2.f + 1.f) * amp;
+				amp = amp * lerp(set1(1.0f), 1.f - noise, set1(fn.mWeightedStrength));
+
+				x = x * fn.mLacunarity;
+				y = y * fn.mLacunarity;
+				z = z * fn.mLacunarity;
+				amp = amp * fn.mGain;
+			}
+
+			return sum;
+		}
+
+		case FNL::FractalType_PingPong: {
+			int seed = fn.mSeed;
+			Float4 sum = set1(0.f);
+			Float4 amp = set1(fn.mFractalBounding);
+
+			for (int i = 0; i < fn.mOctaves; i++) {
+				const Float4 noise = ping_pong((single(seed++, x, y, z) + 1.f) * fn.mPingPongStrength);
+				sum = sum + (noise - 0.5f) * 2.f * amp;
+				amp = amp * lerp(set1(1.0f), noise, set1(fn.mWeightedStrength));
+
+				x = x * fn.mLacunarity;
+				y = y * fn.mLacunarity;
+				z = z * fn.mLacunarity;
+				amp = amp * fn.mGain;
+			}
+
+			return sum;
+		}
+
+		default:
+			return single(fn.mSeed, x, y, z);
+	}
+}
+
+// Processes groups of 4 positions, and returns how many positions were processed. The remaining ones must be
+// processed with the single-position API.
+
+template <typename FSingle>
+unsigned int generate_series_2d(
+		const FNL &fn,
+		FSingle single,
+		const float *xs,
+		const float *ys,
+		float *out,
+		unsigned int count
+) {
+	const float SQRT3 = 1.7320508075688772935274463415059f;
+	const float F2 = 0.5f * (SQRT3 - 1);
+	const bool skew = fn.mNoiseType == FNL::NoiseType_OpenSimplex2;
+
+	unsigned int i = 0;
+	for (; i + Float4::SIZE <= count; i += Float4::SIZE) {
+		// Same as `FastNoiseLite::TransformNoiseCoordinate`
+		Float4 x = load(xs + i) * fn.mFrequency;
+		Float4 y = load(ys + i) * fn.mFrequency;
+		if (skew) {
+			const Float4 t = (x + y) * F2;
+			x = x + t;
+			y = y + t;
+		}
+		store(out + i, gen_fractal(fn, single, x, y));
+	}
+	return i;
+}
+
+template <typename FSingle>
+unsigned int generate_series_3d(
+		const FNL &fn,
+		FSingle single,
+		const float *xs,
+		const float *ys,
+		const float *zs,
+		float *out,
+		unsigned int count
+) {
+	unsigned int i = 0;
+	for (; i + Float4::SIZE <= count; i += Float4::SIZE) {
+		// Same as `FastNoiseLite::TransformNoiseCoordinate`
+		Float4 x = load(xs + i) * fn.mFrequency;
+		Float4 y = load(ys + i) * fn.mFrequency;
+		Float4 z = load(zs + i) * fn.mFrequency;
+
+		switch (fn.mTransformType3D) {
+			case FNL::TransformType3D_ImproveXYPlanes: {
+				const Float4 xy = x + y;
+				const Float4 s2 = xy * -(float)0.211324865405187;
+				z = z * (float)0.577350269189626;
+				x = x + (s2 - z);
+				y = y + s2 - z;
+				z = z + xy * (float)0.577350269189626;
+			} break;
+
+			case FNL::TransformType3D_ImproveXZPlanes: {
+				const Float4 xz = x + z;
+				const Float4 s2 = xz * -(float)0.211324865405187;
+				y = y * (float)0.577350269189626;
+				x = x + (s2 - y);
+				z = z + (s2 - y);
+				y = y + xz * (float)0.577350269189626;
+			} break;
+
+			case FNL::TransformType3D_DefaultOpenSimplex2: {
+				const float R3 = (float)(2.0 / 3.0);
+				const Float4 r = (x + y + z) * R3; // Rotation, not skew
+				x = r - x;
+				y = r - y;
+				z = r - z;
+			} break;
+
+			default:
+				break;
+		}
+
+		store(out + i, gen_fractal(fn, single, x, y, z));
+	}
+	return i;
+}
+
+template <typename FDistance>
+unsigned int generate_cellular_series_2d(
+		const FNL &fn,
+		FDistance distance_func,
+		const float *xs,
+		const float *ys,
+		float *out,
+		unsigned int count
+) {
+	return generate_series_2d(
+			fn,
+			[&fn, distance_func](int seed, Float4 x, Float4 y) { //
+				return single_cellular(fn, seed, x, y, distance_func);
+			},
+			xs,
+			ys,
+			out,
+			count
+	);
+}
+
+template <typename FDistance>
+unsigned int generate_cellular_series_3d(
+		const FNL &fn,
+		FDistance distance_func,
+		const float *xs,
+		const float *ys,
+		const float *zs,
+		float *out,
+		unsigned int count
+) {
+	return generate_series_3d(
+			fn,
+			[&fn, distance_func](int seed, Float4 x, Float4 y, Float4 z) { //
+				return single_cellular(fn, seed, x, y, z, distance_func);
+			},
+			xs,
+			ys,
+			zs,
+			out,
+			count
+	);
+}
+
+} // namespace
+
+void get_fnl_noise_2d_series(const FNL &fn, Span<const float> x, Span<const float> y, Span<float> out) {
+	ZN_PROFILE_SCOPE();
+	ZN_ASSERT_RETURN(x.size() == out.size());
+	ZN_ASSERT_RETURN(y.size() == out.size());
+
+	const unsigned int count = out.size();
+	unsigned int done_count = 0;
+
+	switch (fn.mNoiseType) {
+		case FNL::NoiseType_OpenSimplex2:
+			done_count = generate_series_2d(fn, single_simplex, x.data(), y.data(), out.data(), count);
+			break;
+
+		case FNL::NoiseType_Perlin:
+			done_count = generate_series_2d(
+					fn,
+					[](int seed, Float4 px, Float4 py) { return single_perlin(seed, px, py); },
+					x.data(),
+					y.data(),
+					out.data(),
+					count
+			);
+			break;
+
+		case FNL::NoiseType_Cellular:
+			switch (fn.mCellularDistanceFunction) {
+				case FNL::CellularDistanceFunction_Manhattan:
+					done_count =
+							generate_cellular_series_2d(fn, DistanceManhattan(), x.data(), y.data(), out.data(), count);
+					break;
+				case FNL::CellularDistanceFunction_Hybrid:
+					done_count =
+							generate_cellular_series_2d(fn, DistanceHybrid(), x.data(), y.data(), out.data(), count);
+					break;
+				default:
+					done_count =
+							generate_cellular_series_2d(fn, DistanceEuclidean(), x.data(), y.data(), out.data(), count);
+					break;
+			}
+			break;
+
+		default:
+			break;
+	}
+
+	for (unsigned int i = done_count; i < count; ++i) {
+		out[i] = fn.GetNoise(x[i], y[i]);
+	}
+}
+
+void get_fnl_noise_3d_series(
+		const FNL &fn,
+		Span<const float> x,
+		Span<const float> y,
+		Span<const float> z,
+		Span<float> out
+) {
+	ZN_PROFILE_SCOPE();
+	ZN_ASSERT_RETURN(x.size() == out.size());
+	ZN_ASSERT_RETURN(y.size() == out.size());
+	ZN_ASSERT_RETURN(z.size() == out.size());
+
+	const unsigned int count = out.size();
+	unsigned int done_count = 0;
+
+	switch (fn.mNoiseType) {
+		case FNL::NoiseType_OpenSimplex2:
+			done_count =
+					generate_series_3d(fn, single_open_simplex_2, x.data(), y.data(), z.data(), out.data(), count);
+			break;
+
+		case FNL::NoiseType_Perlin:
+			done_count = generate_series_3d(
+					fn,
+					[](int seed, Float4 px, Float4 py, Float4 pz) { return single_perlin(seed, px, py, pz); },
+					x.data(),
+					y.data(),
+					z.data(),
+					out.data(),
+					count
+			);
+			break;
+
+		case FNL::NoiseType_Cellular:
+			switch (fn.mCellularDistanceFunction) {
+				case FNL::CellularDistanceFunction_Euclidean:
+				case FNL::CellularDistanceFunction_EuclideanSq:
+					done_count = generate_cellular_series_3d(
+							fn, DistanceEuclidean(), x.data(), y.data(), z.data(), out.data(), count
+					);
+					break;
+				case FNL::CellularDistanceFunction_Manhattan:
+					done_count = generate_cellular_series_3d(
+							fn, DistanceManhattan(), x.data(), y.data(), z.data(), out.data(), count
+					);
+					break;
+				case FNL::CellularDistanceFunction_Hybrid:
+					done_count = generate_cellular_series_3d(
+							fn, DistanceHybrid(), x.data(), y.data(), z.data(), out.data(), count
+					);
+					break;
+				default:
+					// Not handled by `FastNoiseLite` either, let it do whatever it does
+					break;
+			}
+			break;
+
+		default:
+			break;
+	}
+
+	for (unsigned int i = done_count; i < count; ++i) {
+		out[i] = fn.GetNoise(x[i], y[i], z[i]);
+	}
+}
+
+} // namespace zylann
@@ -0,0 +1,30 @@
+#ifndef FAST_NOISE_LITE_BATCH_H
+#define FAST_NOISE_LITE_BATCH_H
+
+#include "../../../thirdparty/fast_noise/FastNoiseLite.h"
+#include "../../containers/span.h"
+
+// Evaluation of FastNoiseLite over many positions at once.
+// OpenSimplex2, Perlin and Cellular noises (including their fractal variants) process 4 positions at a time using
+// SIMD, and give the same results as `FastNoiseLite::GetNoise`. Other noise types fall back to the single-position API.
+
+namespace zylann {
+
+void get_fnl_noise_2d_series(
+		const fast_noise_lite::FastNoiseLite &fn,
+		Span<const float> x,
+		Span<const float> y,
+		Span<float> out
+);
+
+void get_fnl_noise_3d_series(
+		const fast_noise_lite::FastNoiseLite &fn,
+		Span<const float> x,
+		Span<const float> y,
+		Span<const float> z,
+		Span<float> out
+);
+
+} // namespace zylann
+
+#endif // FAST_NOISE_LITE_BATCH_H
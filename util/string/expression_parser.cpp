@@ -668,7 +668,7 @@ bool precompute_constants(UniquePtr<Node> &node, float &out_number, Span<const F
 	}
 }
 
-Result parse(std::string_view text, Span<const Function> functions) {
+Result parse(std::string_view text, Span<const Function> functions, bool precompute) {
 	for (unsigned int i = 0; i < functions.size(); ++i) {
 		const Function &f = functions[i];
 		ZN_ASSERT(f.name != "");
@@ -679,7 +679,7 @@ Result parse(std::string_view text, Span<const Function> functions) {
 	if (result.error.id != ERROR_NONE) {
 		return result;
 	}
-	if (result.root != nullptr) {
+	if (result.root != nullptr && precompute) {
 		float _;
 		precompute_constants(result.root, _, functions);
 	}
@@ -108,7 +108,8 @@ struct Function {
 };
 
 // TODO `text` should be `const`
-Result parse(std::string_view text, Span<const Function> functions);
+// If `precompute` is false, constant sub-expressions are kept in the tree instead of being evaluated with `functions`.
+Result parse(std::string_view text, Span<const Function> functions, bool precompute = true);
 bool is_tree_equal(const Node &root_a, const Node &root_b, Span<const Function> functions);
 StdString tree_to_string(const Node &node, Span<const Function> functions);
 StdString to_string(const Error error);